@@ -305,6 +305,112 @@ export namespace Assets {
         DescriptorHandle descriptor;
     };
 
+    enum class MipFilter : uint8_t
+    {
+        None,
+        Box,
+        Kaiser, // windowed sinc, sharper than Box at a few more taps
+    };
+
+    struct MipGenerationDesc
+    {
+        MipFilter filter = MipFilter::Box;
+        bool isSRGB = false;       // filtered in linear space
+        bool isNormalMap = false;  // texels are renormalized after filtering
+        float alphaCutoff = 0.0f;  // when non zero alpha is scaled per level to keep the alpha tested coverage of level 0
+    };
+
+    enum class TextureCompression : uint8_t
+    {
+        None,   // RGBA8
+        BC1,    // RGB, 8 bytes per 4x4 block
+        BC3,    // RGBA, 16 bytes
+        BC4,    // R, 8 bytes
+        BC5,    // RG, 16 bytes
+        BC7,    // RGBA, 16 bytes
+    };
+
+    // How the material samples the texture, picks the block compression format
+    enum class TextureUsage : uint8_t
+    {
+        Color,
+        Normal, // BC5, z is reconstructed from xy when sampling
+        Data,   // linear channels packed together, metallic roughness
+        Mask,   // single channel read from r, BC4
+    };
+
+    // GPU format of .hdr images, which decode to RGB32_FLOAT
+    enum class HDRTextureFormat : uint8_t
+    {
+        RGB32Float,     // 12 bytes per texel, as decoded
+        RGBA16Float,    // 8 bytes
+        R11G11B10Float, // 4 bytes, unsigned, 6 and 5 bit mantissas
+        BC6H,           // 1 byte, unsigned, sizes that are not a multiple of 4 fall back to RGBA16Float
+    };
+
+    // RGBA8 texels or compressed blocks of every level, tightly packed
+    struct MipChain
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        TextureCompression compression = TextureCompression::None;
+        std::vector<uint8_t> data;
+        std::vector<size_t> levelOffsets;
+
+        uint32_t GetLevelCount() const { return (uint32_t)levelOffsets.size(); }
+        uint32_t GetLevelWidth(uint32_t level) const { return std::max(width >> level, 1u); }
+        uint32_t GetLevelHeight(uint32_t level) const { return std::max(height >> level, 1u); }
+        const uint8_t* GetLevelData(uint32_t level) const { return data.data() + levelOffsets[level]; }
+
+        uint32_t GetLevelRowCount(uint32_t level) const { return compression == TextureCompression::None ? GetLevelHeight(level) : (GetLevelHeight(level) + 3) / 4; }
+        size_t GetLevelRowPitch(uint32_t level) const
+        {
+            if (compression == TextureCompression::None)
+                return size_t(GetLevelWidth(level)) * 4;
+
+            size_t blockSize = compression == TextureCompression::BC1 || compression == TextureCompression::BC4 ? 8 : 16;
+            return size_t((GetLevelWidth(level) + 3) / 4) * blockSize;
+        }
+    };
+
+    // Texture stored ready for upload in a .dds or .ktx2 container
+    struct TextureSubresource
+    {
+        uint32_t arraySlice = 0; // layer * 6 + face for cube maps
+        uint32_t mipLevel = 0;
+        const uint8_t* data = nullptr;
+        size_t rowPitch = 0;
+        size_t depthPitch = 0;
+    };
+
+    struct MappedFile;
+
+    // subresources point into the mapped file, or into storage for supercompressed KTX2 levels and chains built in memory
+    struct TextureFile
+    {
+        nvrhi::TextureDesc desc;
+        std::vector<TextureSubresource> subresources;
+        HE::Ref<MappedFile> file;
+        std::vector<std::vector<uint8_t>> storage;
+        std::filesystem::path path; // file the subresources were read from, empty when they were built in memory
+
+        bool IsFileBacked() const { return file && storage.empty() && !path.empty(); }
+    };
+
+    struct TextureImportSettings
+    {
+        MipFilter mipFilter = MipFilter::Box;
+        bool blockCompression = false;  // LDR textures with a multiple of 4 size, also applied when cooking
+        bool preferBC7 = true;          // BC1/BC3 otherwise, faster to encode at lower quality
+        HDRTextureFormat hdrFormat = HDRTextureFormat::RGBA16Float;
+
+        bool streaming = false;                 // only the mip tail is uploaded on import, finer levels follow the TextureStreamer feedback
+        uint32_t streamingTailSize = 128;       // levels at most this large stay resident
+        uint64_t streamingBudget = 1ull << 30;  // GPU bytes of every streamed texture, 0 for unlimited
+        uint32_t streamingMaxRequests = 8;      // stream ins in flight
+        uint32_t streamingRetainFrames = 60;    // frames without feedback before a texture falls back to its tail
+    };
+
     //////////////////////////////////////////////////////////////////////////
     // Material
     //////////////////////////////////////////////////////////////////////////
@@ -339,6 +445,57 @@ export namespace Assets {
         float rotation = 0.0f;
     };
 
+    //////////////////////////////////////////////////////////////////////////
+    // Animation
+    //////////////////////////////////////////////////////////////////////////
+
+    struct BoneTransform
+    {
+        Math::float3 translation = { 0.0f, 0.0f, 0.0f };
+        Math::quat rotation = Math::quat(1.0f, 0.0f, 0.0f, 0.0f);
+        Math::float3 scale = { 1.0f, 1.0f, 1.0f };
+    };
+
+    enum class AnimationPath : uint8_t
+    {
+        Translation,
+        Rotation,
+        Scale,
+    };
+
+    // Keys of one animated property of one bone, key reduced at import
+    struct AnimationTrack
+    {
+        uint32_t bone = 0;
+        AnimationPath path = AnimationPath::Translation;
+        bool step = false;          // STEP interpolation, otherwise LINEAR
+        uint32_t keyOffset = 0;     // into AnimationClip::times
+        uint32_t keyCount = 0;
+        uint32_t valueOffset = 0;   // into AnimationClip::rotationKeys for rotations, AnimationClip::vectorKeys otherwise
+    };
+
+    struct AnimationClip
+    {
+        std::string name = "None";
+        float duration = 0.0f;
+        std::vector<uint32_t> boneNodes;        // MeshSourecHierarchy node of each bone
+        std::vector<BoneTransform> restPose;    // per bone, used for the paths without a track
+        std::vector<AnimationTrack> tracks;
+        std::vector<float> times;
+        std::vector<Math::float3> vectorKeys;
+        std::vector<uint64_t> rotationKeys;     // smallest three, see PackRotation
+
+        uint32_t GetBoneCount() const { return (uint32_t)restPose.size(); }
+    };
+
+    struct Skin
+    {
+        std::string name = "None";
+        std::vector<uint32_t> joints;                    // MeshSourecHierarchy node of each joint, BoneIndices index this array
+        std::vector<Math::float4x4> inverseBindMatrices;
+        uint32_t skeleton = c_Invalid;
+    };
+
     //////////////////////////////////////////////////////////////////////////
     // MeshSource
     //////////////////////////////////////////////////////////////////////////
@@ -352,6 +509,7 @@ export namespace Assets {
         TexCoord1,
         BoneIndices,
         BoneWeights,
+        Radius,     // curves, imported from the _RADIUS attribute
     };
 
     enum class MeshGeometryPrimitiveType : uint8_t
@@ -369,12 +527,400 @@ export namespace Assets {
         CurveLinearSweptSpheres,
     };
 
+    enum class VertexFormat : uint8_t
+    {
+        Float2,
+        Float3,
+        Float4,
+        Half2,
+        Unorm16x2,
+        Unorm16x4,
+        Unorm8x4,
+        Snorm8x4,
+        Uint16x4,
+        Oct16,      // normals, 2 x snorm16 octahedral
+        Oct8,       // normals, 2 x snorm8 octahedral
+        OctSign16,  // tangents, 16 + 15 bit octahedral and the bitangent sign in the top bit
+        OctSign8,   // tangents, 8 + 7 bit octahedral and the bitangent sign in the top bit
+        Float1,
+    };
+
+    constexpr uint32_t c_VertexAttributeCount = (uint32_t)magic_enum::enum_count<VertexAttribute>();
+
+    // Formats used by the importer unless MeshSourceImportSettings selects a compact one
+    constexpr std::array<VertexFormat, c_VertexAttributeCount> c_DefaultVertexFormats = {
+        VertexFormat::Float3,   // Position
+        VertexFormat::Snorm8x4, // Normal
+        VertexFormat::Snorm8x4, // Tangent
+        VertexFormat::Float2,   // TexCoord0
+        VertexFormat::Float2,   // TexCoord1
+        VertexFormat::Uint16x4, // BoneIndices
+        VertexFormat::Float4,   // BoneWeights
+        VertexFormat::Float1,   // Radius
+    };
+
     ASSETS_API uint32_t GetVertexAttributeSize(VertexAttribute attr);
+    ASSETS_API uint32_t GetVertexFormatSize(VertexFormat format);
+    ASSETS_API nvrhi::Format GetVertexFormatNvrhiFormat(VertexFormat format);
+    ASSETS_API Math::float4 DecodeVertexElement(VertexFormat format, const uint8_t* src);
+    ASSETS_API void EncodeVertexElement(VertexFormat format, const Math::float4& value, uint8_t* dst);
+
+    // Octahedral encoding, the scalar versions are the reference for tooling, the batch versions are SIMD
+    ASSETS_API bool IsOctahedralFormat(VertexFormat format);
+    ASSETS_API Math::float2 OctEncode(const Math::float3& n);
+    ASSETS_API Math::float3 OctDecode(const Math::float2& e);
+    ASSETS_API void EncodeOctahedralBatch(VertexFormat format, const Math::float4* src, uint32_t count, uint8_t* dst);
+    ASSETS_API void DecodeOctahedralBatch(VertexFormat format, const uint8_t* src, uint32_t count, Math::float4* dst);
+
+    // Strided view over a vertex attribute that decodes elements on access
+    struct DecodedVertexAttribute
+    {
+        const uint8_t* data = nullptr;
+        size_t count = 0;
+        uint32_t stride = 0;
+        VertexFormat format = VertexFormat::Float3;
+        Math::float4 scale = { 1.0f, 1.0f, 1.0f, 1.0f };
+        Math::float4 offset = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        Math::float4 operator[](size_t i) const { return DecodeVertexElement(format, data + i * stride) * scale + offset; }
+        Math::float3 GetFloat3(size_t i) const { return Math::float3((*this)[i]); }
+        Math::float2 GetFloat2(size_t i) const { return Math::float2((*this)[i]); }
+    };
+
+    enum class VertexLayout : uint8_t
+    {
+        Separate,       // one range per attribute
+        Interleaved,    // a single stream holding every attribute
+        Hybrid,         // a position stream followed by an interleaved stream of the remaining attributes
+    };
+
+    // Strided view over a vertex attribute, the stride is the stream stride of the attribute's layout
+    template<typename T>
+    struct VertexSpan
+    {
+        using Byte = std::conditional_t<std::is_const_v<T>, const uint8_t, uint8_t>;
+
+        struct Iterator
+        {
+            Byte* ptr;
+            uint32_t stride;
+
+            T& operator*() const { return *reinterpret_cast<T*>(ptr); }
+            Iterator& operator++() { ptr += stride; return *this; }
+            bool operator==(const Iterator& other) const { return ptr == other.ptr; }
+        };
+
+        Byte* data = nullptr;
+        size_t count = 0;
+        uint32_t stride = sizeof(T);
+
+        VertexSpan() = default;
+        VertexSpan(Byte* data, size_t count, uint32_t stride) : data(data), count(count), stride(stride) {}
+        template<typename U> requires std::is_convertible_v<U*, T*>
+        VertexSpan(const VertexSpan<U>& other) : data(other.data), count(other.count), stride(other.stride) {}
+
+        T& operator[](size_t i) const { return *reinterpret_cast<T*>(data + i * stride); }
+        size_t size() const { return count; }
+        bool empty() const { return count == 0; }
+        bool IsContiguous() const { return stride == sizeof(T); }
+        Iterator begin() const { return { data, stride }; }
+        Iterator end() const { return { data + count * stride, stride }; }
+    };
+
+    // Whole file view, either memory mapped (copy on write) or read into memory with a single read
+    struct MappedFile
+    {
+        uint8_t* data = nullptr;
+        size_t size = 0;
+        uint64_t offset = 0; // file offset of data
+        bool isMapped = false;
+        std::vector<uint8_t> storage;
+        void* fileHandle = nullptr;
+        void* mappingHandle = nullptr;
+        void* view = nullptr;
+        size_t viewSize = 0;
+
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ASSETS_API ~MappedFile();
+
+        ASSETS_API static HE::Ref<MappedFile> Open(const std::filesystem::path& filePath, bool map = true);
+        ASSETS_API static HE::Ref<MappedFile> Open(const std::filesystem::path& filePath, uint64_t offset, uint64_t size, bool map = true); // window clamped to the file, offset needs no alignment
+    };
+
+    // CPU side buffer that either owns its elements or references them in place inside a MappedFile.
+    // Any operation that changes the size detaches a referenced buffer into owned storage first.
+    template<typename T>
+    struct CpuBuffer
+    {
+        std::vector<T> storage;
+        HE::Ref<MappedFile> file;
+        T* external = nullptr;
+        size_t externalCount = 0;
+
+        CpuBuffer() = default;
+        CpuBuffer(std::vector<T>&& other) : storage(std::move(other)) {}
+        CpuBuffer& operator=(std::vector<T>&& other) { storage = std::move(other); Release(); return *this; }
+
+        static CpuBuffer Reference(HE::Ref<MappedFile> mappedFile, T* ptr, size_t count)
+        {
+            CpuBuffer buffer;
+            buffer.file = std::move(mappedFile);
+            buffer.external = ptr;
+            buffer.externalCount = count;
+            return buffer;
+        }
+
+        bool IsReference() const { return file != nullptr; }
+        T* data() { return file ? external : storage.data(); }
+        const T* data() const { return file ? external : storage.data(); }
+        size_t size() const { return file ? externalCount : storage.size(); }
+        bool empty() const { return size() == 0; }
+        T* begin() { return data(); }
+        T* end() { return data() + size(); }
+        const T* begin() const { return data(); }
+        const T* end() const { return data() + size(); }
+        T& operator[](size_t i) { return data()[i]; }
+        const T& operator[](size_t i) const { return data()[i]; }
+
+        void Detach()
+        {
+            if (!file)
+                return;
+
+            storage.assign(external, external + externalCount);
+            Release();
+        }
+
+        void resize(size_t count) { Detach(); storage.resize(count); }
+        void reserve(size_t count) { Detach(); storage.reserve(count); }
+        void clear() { storage.clear(); Release(); }
+        void Free() { std::vector<T>().swap(storage); Release(); } // unlike clear, returns the memory
+
+    private:
+        void Release() { file.reset(); external = nullptr; externalCount = 0; }
+    };
+
+    // a std::mutex that keeps its owner copyable, copies get their own unlocked mutex
+    struct CopyableMutex
+    {
+        std::mutex mutex;
+
+        CopyableMutex() = default;
+        CopyableMutex(const CopyableMutex&) {}
+        CopyableMutex& operator=(const CopyableMutex&) { return *this; }
+    };
+
+    enum class GeometryResidency : uint8_t
+    {
+        KeepCpu,            // CPU copies live as long as the asset
+        DropAfterUpload,    // CPU copies are freed once the GPU buffers are filled, MeshSource::AcquireCpuGeometry brings them back, the BVH build frees them again
+        Stream,             // as DropAfterUpload, but CPU queries re-fetch the geometry and free it again when done
+        Paged,              // as Stream, and the cooked vertex and index data is also reachable as fixed size pages, see GeometryPageTable
+    };
+
+    enum class GeometryStream : uint8_t
+    {
+        Vertex,
+        Index,
+
+        Count
+    };
+
+    // Window of the cooked vertex or index data, the file is null while the page is evicted
+    struct GeometryPage
+    {
+        uint64_t byteOffset = 0; // into the vertex or index data
+        uint64_t byteSize = 0;
+        HE::Ref<MappedFile> file;
+        uint64_t lastUse = 0;
+    };
 
-    struct Mesh;
+    // Pages are mapped from the cooked .hmesh one at a time so the geometry never has to fit the address space at once,
+    // the table is not synchronized.
+    struct GeometryPageTable
+    {
+        std::filesystem::path path;
+        uint64_t pageSize = 0;
+        uint64_t budget = 0;         // resident bytes before the least recently used pages are evicted, 0 for unlimited
+        uint64_t residentSize = 0;
+        uint64_t useCounter = 0;
+        std::array<uint64_t, (int)GeometryStream::Count> fileOffsets = {};
+        std::array<uint64_t, (int)GeometryStream::Count> byteSizes = {};
+        std::array<std::vector<GeometryPage>, (int)GeometryStream::Count> pages;
+
+        bool empty() const { return pageSize == 0; }
+        uint32_t GetPageIndex(uint64_t byteOffset) const { return uint32_t(byteOffset / pageSize); }
+    };
+
+    struct MeshSourceImportSettings
+    {
+        bool weldVertices = false;
+        float weldEpsilon = 0.0f;           // 0 welds bit identical vertices only
+
+        bool generateMeshlets = false;
+        uint32_t maxMeshletVertices = 64;   // Range(3, 256)
+        uint32_t maxMeshletTriangles = 124; // Range(1, 512)
+
+        bool generateLODs = false;
+        uint32_t lodCount = 4;
+        float lodReduction = 0.5f;          // target triangle ratio between consecutive LODs
+        float lodMaxError = 0.02f;          // relative to the geometry extents
+
+        bool mergeIdenticalMeshes = false;  // content identical meshes become instances of one mesh
+
+        bool importAnimations = true;
+        float animationTolerance = 0.0001f; // key reduction error, in units for translation and scale, quaternion components for rotation
+
+        bool buildBVH = false;              // otherwise built on the first MeshSource::Raycast
+
+        VertexFormat positionFormat = VertexFormat::Float3;     // Float3, Unorm16x4 (relative to Mesh::aabb)
+        VertexFormat normalFormat = VertexFormat::Snorm8x4;     // Snorm8x4, Oct16, Oct8
+        VertexFormat tangentFormat = VertexFormat::Snorm8x4;    // Snorm8x4, OctSign16, OctSign8
+        VertexFormat texCoordFormat = VertexFormat::Float2;     // Float2, Half2, Unorm16x2 (falls back to Half2 outside [0, 1])
+        VertexFormat boneWeightFormat = VertexFormat::Float4;   // Float4, Unorm16x4, Unorm8x4
+        VertexLayout vertexLayout = VertexLayout::Separate;
+
+        bool processCurves = false;         // line and line strip geometries are converted into curveType
+        MeshType curveType = MeshType::CurveLinearSweptSpheres;
+        float curveTolerance = 0.0f;        // per strand simplification error in mesh units, 0 keeps every point
+        float curveRadius = 0.001f;         // for sources without a _RADIUS attribute
+        uint32_t curveChunkSegments = 64;   // segments per CurveChunk
+        uint32_t curveTubeSides = 4;        // CurvePolytubes, Range(3, 16)
+        bool keepCurveRadius = false;       // VertexAttribute::Radius on triangulated curves, always kept for CurveLinearSweptSpheres
+
+        bool sortGeometriesByMaterial = false; // groups the geometries of each Mesh by material and merges neighbours sharing material and primitive type
+
+        bool mapFiles = true;               // .glb and .hmesh files are memory mapped, otherwise loaded with a single read
+
+        bool uploadGeometry = false;        // the importer creates and fills MeshSource::vertexBuffer and indexBuffer, implied by a residency other than KeepCpu
+        GeometryResidency geometryResidency = GeometryResidency::KeepCpu;
+        uint64_t geometryPageSize = 64ull << 20;    // GeometryResidency::Paged, rounded up to 64 KB
+        uint64_t geometryPageBudget = 1ull << 30;   // resident page bytes, 0 for unlimited
+    };
+
+    struct MeshSourceImportStats
+    {
+        uint64_t vertexCountBeforeWeld = 0;
+        uint64_t vertexCountAfterWeld = 0;
+        uint64_t vertexBytesSaved = 0;
+
+        // stage timings in ms
+        float parseTime = 0.0f;
+        float bufferTime = 0.0f;    // external buffers, loaded in parallel
+        float decodeTime = 0.0f;    // EXT_meshopt_compression buffer views, decoded in parallel
+        float animationTime = 0.0f; // key reduction and quantization
+        float textureTime = 0.0f;   // image loading and decoding, overlaps meshTime and processTime
+        float meshTime = 0.0f;
+        float processTime = 0.0f;
+    };
+
+    // Cluster of triangles of a single MeshGeometry, bounds are in mesh space.
+    struct Meshlet
+    {
+        Math::float3 center;
+        float radius = 0.0f;
+        Math::float3 coneApex;
+        float coneCutoff = 1.0f; // cone never culls when >= 1
+        Math::float3 coneAxis;
+        uint32_t vertexOffset = 0;   // into MeshSource::meshletVertices
+        uint32_t triangleOffset = 0; // into MeshSource::meshletTriangles, 3 micro-indices per triangle
+        uint32_t vertexCount = 0;
+        uint32_t triangleCount = 0;
+    };
+
+    // Consecutive segments of a curve geometry, the unit for culling and partial acceleration structure builds.
+    struct CurveChunk
+    {
+        Math::box3 aabb;            // mesh space, includes the radius
+        uint32_t indexOffset = 0;   // within the geometry's index range
+        uint32_t indexCount = 0;
+        uint32_t segmentCount = 0;
+    };
+
+    // Changed vertex of a MorphTarget, the deltas are quantized against the scales of the target.
+    struct MorphDelta
+    {
+        uint32_t vertex = 0;        // mesh local
+        int16_t position[3] = {};   // snorm16 * MorphTarget::positionScale
+        int8_t normal[3] = {};      // snorm8 * MorphTarget::normalScale
+        int8_t tangent[3] = {};     // snorm8 * MorphTarget::tangentScale
+    };
+
+    // Sparse blend shape of a Mesh, only the vertices it moves are stored, sorted by vertex.
+    struct MorphTarget
+    {
+        std::string name = "None";
+        uint32_t deltaOffset = 0;   // into MeshSource::morphDeltas
+        uint32_t deltaCount = 0;
+        float positionScale = 0.0f;
+        float normalScale = 0.0f;
+        float tangentScale = 0.0f;
+        float defaultWeight = 0.0f;
+    };
+
+    // Simplified index range of a MeshGeometry, shares the vertices of the geometry.
+    struct MeshGeometryLOD
+    {
+        uint64_t indexOffset = 0; // into MeshSource::cpuIndexBuffer
+        uint32_t indexCount = 0;
+        float error = 0.0f;       // mesh space deviation from the full detail geometry
+    };
+
+    // Flattened in depth first order, the left child of an interior node is the next node.
+    struct MeshBVHNode
+    {
+        Math::float3 aabbMin;
+        uint32_t offset = 0;    // interior: right child, leaf: packet index
+        Math::float3 aabbMax;
+        uint32_t count = 0;     // triangles in the leaf packet, 0 for interior nodes
+    };
+
+    // Up to 4 triangles stored SoA for SIMD intersection, unused lanes are degenerate.
+    struct MeshBVHPacket
+    {
+        float v0[3][4];
+        float e1[3][4];
+        float e2[3][4];
+        uint32_t geometryIndex[4];
+        uint32_t triangleIndex[4];
+    };
+
+    struct MeshBVH
+    {
+        std::vector<MeshBVHNode> nodes;
+        std::vector<MeshBVHPacket> packets;
+    };
+
+    struct Ray
+    {
+        Math::float3 origin;
+        Math::float3 direction;
+        float tMin = 0.0f;
+        float tMax = std::numeric_limits<float>::max();
+    };
+
+    struct RayHit
+    {
+        float t = std::numeric_limits<float>::max();
+        float u = 0.0f;
+        float v = 0.0f;
+        uint32_t meshIndex = c_Invalid;
+        uint32_t geometryIndex = c_Invalid;  // into MeshSource::geometries
+        uint32_t triangleIndex = c_Invalid;  // within the geometry
+
+        bool IsValid() const { return meshIndex != c_Invalid; }
+    };
+
+    // Cross references are indices so a MeshSource can be moved, copied or mapped without fixups,
+    // the accessors resolve them through the owning MeshSource.
+    struct MeshSource;
     struct MeshGeometry
     {
-        Mesh* mesh = nullptr;
+        uint32_t mesh = c_Invalid; // into MeshSource::meshes
         MeshGeometryPrimitiveType type = MeshGeometryPrimitiveType::Triangles;
         Math::box3 aabb;
         uint32_t indexOffsetInMesh = 0;
@@ -383,35 +929,48 @@ export namespace Assets {
         uint32_t vertexCount = 0;
         AssetHandle materailHandle = 0;
         uint32_t index = 0;
-
-        template<typename T> T* GetAttribute(VertexAttribute attr);
-        template<typename T> std::span<T> GetAttributeSpan(VertexAttribute attr);
-        ASSETS_API const nvrhi::BufferRange GetVertexRange(VertexAttribute attr) const;
-        ASSETS_API const nvrhi::BufferRange GetIndexRange() const;
-        ASSETS_API uint32_t* Getindices();
+        uint32_t meshletOffset = 0;
+        uint32_t meshletCount = 0;
+        uint32_t lodOffset = 0;
+        uint32_t lodCount = 0;
+        uint32_t curveChunkOffset = 0;
+        uint32_t curveChunkCount = 0;
+
+        template<typename T> T* GetAttribute(MeshSource& meshSource, VertexAttribute attr);
+        template<typename T> VertexSpan<T> GetAttributeSpan(MeshSource& meshSource, VertexAttribute attr);
+        ASSETS_API const nvrhi::BufferRange GetVertexRange(const MeshSource& meshSource, VertexAttribute attr) const;
+        ASSETS_API const nvrhi::BufferRange GetIndexRange(const MeshSource& meshSource) const;
+        ASSETS_API uint32_t* Getindices(MeshSource& meshSource);
+        ASSETS_API DecodedVertexAttribute GetDecodedAttribute(const MeshSource& meshSource, VertexAttribute attr) const;
+        ASSETS_API std::span<Meshlet> GetMeshletSpan(MeshSource& meshSource);
+        ASSETS_API std::span<MeshGeometryLOD> GetLODSpan(MeshSource& meshSource);
+        ASSETS_API std::span<CurveChunk> GetCurveChunkSpan(MeshSource& meshSource);
+        ASSETS_API const nvrhi::BufferRange GetLODIndexRange(const MeshSource& meshSource, uint32_t lod) const; // lod 0 is the full detail range
     };
 
-    struct MeshSource;
     struct Mesh
     {
         std::string name = "None";
-        MeshSource* meshSource = nullptr;
         MeshType type = MeshType::Triangles;
         Math::box3 aabb;
-        uint32_t indexOffset = 0;
+        uint64_t indexOffset = 0;   // into MeshSource::cpuIndexBuffer
         uint32_t indexCount = 0;
-        uint32_t vertexOffset = 0;
+        uint64_t vertexOffset = 0;  // in vertices
         uint32_t vertexCount = 0;
         uint32_t geometryOffset = 0;
         uint32_t geometryCount = 0;
+        uint32_t morphTargetOffset = 0; // into MeshSource::morphTargets
+        uint32_t morphTargetCount = 0;
         uint32_t index = 0;
         nvrhi::rt::AccelStructHandle accelStruct;
 
-        template<typename T> T* GetAttribute(VertexAttribute attr);
-        template<typename T> std::span<T> GetAttributeSpan(VertexAttribute attr);
-        ASSETS_API uint32_t* Getindices();
+        template<typename T> T* GetAttribute(MeshSource& meshSource, VertexAttribute attr);
+        template<typename T> VertexSpan<T> GetAttributeSpan(MeshSource& meshSource, VertexAttribute attr);
+        ASSETS_API uint32_t* Getindices(MeshSource& meshSource);
         ASSETS_API const nvrhi::BufferRange GetIndexRange() const;
-        ASSETS_API std::span<MeshGeometry> GetGeometrySpan();
+        ASSETS_API std::span<MeshGeometry> GetGeometrySpan(MeshSource& meshSource);
+        ASSETS_API std::span<const MorphTarget> GetMorphTargetSpan(const MeshSource& meshSource) const;
+        ASSETS_API DecodedVertexAttribute GetDecodedAttribute(const MeshSource& meshSource, VertexAttribute attr) const;
     };
 
     enum class NodeType
@@ -424,20 +983,54 @@ export namespace Assets {
     struct MeshSourecHierarchy;
     struct Node
     {
-        std::string name = "None";
-        Math::float4x4 transform;
+        uint32_t name = c_Invalid; // into MeshSourecHierarchy::names
+        Math::float4x4 transform;  // local
         uint32_t childrenOffset = 0;
         uint32_t childrenCount = 0;
         uint32_t index = c_Invalid;
+        uint32_t skin = c_Invalid; // into MeshSource::skins for skinned mesh nodes
         NodeType type = NodeType::None;
 
         ASSETS_API std::span<Node> GetChildren(MeshSourecHierarchy& meshSourecHierarchy);
     };
 
+    struct MeshInstanceRange
+    {
+        uint32_t transformOffset = 0; // into MeshSourecHierarchy::instanceTransforms
+        uint32_t transformCount = 0;
+    };
+
+    // Nodes are stored breadth first, the children of a node are contiguous and every parent precedes its children,
+    // so world data is resolved in a single linear pass.
     struct MeshSourecHierarchy
     {
         std::vector<Node> nodes;
         Node root;
+
+        // per node, built by UpdateHierarchy
+        std::vector<uint32_t> parents;                  // c_Invalid for the children of the root
+        std::vector<Math::float4x4> worldTransforms;
+        std::vector<Math::box3> worldBounds;            // mesh bounds of the node and its descendants, empty (mins > maxs) without meshes
+
+        std::vector<char> names;                        // pool of null terminated node names
+
+        const char* GetName(const Node& node) const { return node.name < names.size() ? names.data() + node.name : "None"; }
+        ASSETS_API uint32_t AddName(std::string_view name);
+
+        // instance tables, built by BuildMeshInstances
+        std::vector<MeshInstanceRange> meshInstances;   // per mesh
+        std::vector<Math::float4x4> instanceTransforms; // world transforms grouped by mesh
+        std::vector<uint32_t> instanceNodes;            // node of each instance, c_Invalid for the root
+
+        ASSETS_API std::span<const Math::float4x4> GetInstanceTransforms(uint32_t meshIndex) const;
+    };
+
+    // Geometries of one material, see MeshSource::materialRanges
+    struct MaterialRange
+    {
+        AssetHandle material = 0;
+        uint32_t geometryOffset = 0; // into MeshSource::materialGeometries
+        uint32_t geometryCount = 0;
     };
 
     struct CameraNode
@@ -452,73 +1045,163 @@ export namespace Assets {
 
     struct MeshSource
     {
-        std::array<nvrhi::BufferRange, magic_enum::enum_count<VertexAttribute>()> vertexBufferRanges;
-        std::vector<uint32_t> cpuIndexBuffer;
-        std::vector<uint8_t>  cpuVertexBuffer; // [position][Normal][Tangent][...]
+        std::array<nvrhi::BufferRange, c_VertexAttributeCount> vertexBufferRanges;
+        std::array<VertexFormat, c_VertexAttributeCount> vertexFormats = c_DefaultVertexFormats;
+        VertexLayout vertexLayout = VertexLayout::Separate;
+        uint32_t vertexStride = 0; // stride of the interleaved stream, 0 for VertexLayout::Separate
+        CpuBuffer<uint32_t> cpuIndexBuffer;
+        CpuBuffer<uint8_t>  cpuVertexBuffer; // Separate: [position][Normal][Tangent][...], Interleaved: [PNT..][PNT..], Hybrid: [position][NT..][NT..]
         std::vector<Mesh> meshes;
         std::vector<MeshGeometry> geometries;
         std::vector<CameraNode> cameras;
-        uint32_t vertexCount = 0;
+        std::vector<Skin> skins;
+
+        // Meshlets
+        std::vector<Meshlet> meshlets;
+        std::vector<uint32_t> meshletVertices; // geometry local vertex indices
+        std::vector<uint8_t> meshletTriangles;
+
+        // LODs, index ranges are appended after the full detail indices
+        std::vector<MeshGeometryLOD> lods;
+
+        // segment chunks of curve geometries, built by BuildCurves
+        std::vector<CurveChunk> curveChunks;
+
+        // sparse morph targets, contiguous per Mesh
+        std::vector<MorphTarget> morphTargets;
+        std::vector<MorphDelta> morphDeltas;
+
+        // geometry indices grouped by material, built by BuildMaterialRanges on import
+        std::vector<MaterialRange> materialRanges;
+        std::vector<uint32_t> materialGeometries;
+
+        // CPU BVH per Mesh, empty until BuildBVH or the first raycast
+        std::vector<MeshBVH> bvhs;
+        CopyableMutex bvhMutex; // the first raycasts of a source build its BVHs once, other sources are not blocked
+
+        uint64_t vertexCount = 0;
         uint32_t materialCount = 0;
         uint32_t textureCount = 0;
+        uint32_t animationCount = 0; // AnimationClip dependencies after the textures
+
+        // GPU copies, created by the importer when MeshSourceImportSettings::uploadGeometry is set
+        nvrhi::BufferHandle vertexBuffer;
+        nvrhi::BufferHandle indexBuffer;
 
-        template<typename T> T* GetAttribute(VertexAttribute attr);
-        template<typename T> std::span<T> GetAttributeSpan(VertexAttribute attr);
+        GeometryResidency residency = GeometryResidency::KeepCpu;
+        std::filesystem::path sourcePath;           // dropped CPU geometry is re-fetched from the cooked .hmesh or .hgeom cache next to it
+        MeshSourceImportSettings importSettings;    // settings the source geometry was processed with
+        uint64_t geometryHash = 0;                  // HashGeometry of the bytes the GPU copies were filled with
+        CopyableMutex cpuGeometryMutex;             // guards the acquire and release of the CPU geometry
+
+        template<typename T> T* GetAttribute(VertexAttribute attr); // first element, step by GetVertexStride unless the layout is Separate
+        template<typename T> VertexSpan<T> GetAttributeSpan(VertexAttribute attr);
+        ASSETS_API DecodedVertexAttribute GetDecodedAttribute(VertexAttribute attr) const; // positions must not be quantized, use Mesh::GetDecodedAttribute for those
         bool HasAttribute(VertexAttribute attr) const { return vertexBufferRanges[int(attr)].byteSize != 0; }
+        bool IsInterleaved(VertexAttribute attr) const { return vertexLayout == VertexLayout::Interleaved || (vertexLayout == VertexLayout::Hybrid && attr != VertexAttribute::Position); }
+        uint32_t GetVertexElementSize(VertexAttribute attr) const { return GetVertexFormatSize(vertexFormats[int(attr)]); }
+        uint32_t GetVertexStride(VertexAttribute attr) const { return IsInterleaved(attr) ? vertexStride : GetVertexElementSize(attr); }
         const nvrhi::BufferRange& getVertexBufferRange(VertexAttribute attr) const { return vertexBufferRanges[int(attr)]; }
+
+        bool HasCpuGeometry() const { return vertexCount == 0 || !cpuVertexBuffer.empty(); }
+        ASSETS_API bool AcquireCpuGeometry(); // re-fetches dropped CPU geometry, the non-const CPU accessors call it, call it before GetDecodedAttribute
+        ASSETS_API void ReleaseCpuGeometry(); // frees the CPU geometry once it has GPU copies, no-op for GeometryResidency::KeepCpu
+
+        // GeometryResidency::Paged, a loaded page stays valid until it is evicted, loading other pages evicts it once over budget
+        GeometryPageTable pageTable;
+        ASSETS_API std::span<const uint8_t> LoadPage(GeometryStream stream, uint32_t page);
+        ASSETS_API void EvictPage(GeometryStream stream, uint32_t page);
+        ASSETS_API bool ReadPaged(GeometryStream stream, uint64_t byteOffset, std::span<uint8_t> output); // copies a range that may span pages
+
+        // Rays are in mesh space, the BVHs are built on first use
+        ASSETS_API bool Raycast(const Ray& ray, RayHit& hit);
+        ASSETS_API bool RaycastMesh(uint32_t meshIndex, const Ray& ray, RayHit& hit);
+        ASSETS_API void RaycastBatch(std::span<const Ray> rays, std::span<RayHit> hits);
     };
 
-    const nvrhi::BufferRange MeshGeometry::GetVertexRange(VertexAttribute attr) const
+    const nvrhi::BufferRange MeshGeometry::GetVertexRange(const MeshSource& meshSource, VertexAttribute attr) const
     {
-        auto attrSize = GetVertexAttributeSize(attr);
-        return nvrhi::BufferRange(mesh->meshSource->getVertexBufferRange(attr).byteOffset + (mesh->vertexOffset + vertexOffsetInMesh) * attrSize, vertexCount * attrSize);
+        const Mesh& m = meshSource.meshes[mesh];
+        auto stride = meshSource.GetVertexStride(attr);
+        uint64_t byteSize = vertexCount ? uint64_t(vertexCount - 1) * stride + meshSource.GetVertexElementSize(attr) : 0;
+        return nvrhi::BufferRange(meshSource.getVertexBufferRange(attr).byteOffset + (m.vertexOffset + vertexOffsetInMesh) * stride, byteSize);
     }
 
-    const nvrhi::BufferRange MeshGeometry::GetIndexRange() const { return nvrhi::BufferRange((mesh->indexOffset + indexOffsetInMesh) * sizeof(uint32_t), indexCount * sizeof(uint32_t)); }
+    const nvrhi::BufferRange MeshGeometry::GetIndexRange(const MeshSource& meshSource) const { return nvrhi::BufferRange((meshSource.meshes[mesh].indexOffset + indexOffsetInMesh) * sizeof(uint32_t), uint64_t(indexCount) * sizeof(uint32_t)); }
 
     template<typename T>
-    T* MeshGeometry::GetAttribute(VertexAttribute attr) { return reinterpret_cast<T*>(mesh->meshSource->cpuVertexBuffer.data() + (mesh->vertexOffset + vertexOffsetInMesh) * sizeof(T)); }
+    T* MeshGeometry::GetAttribute(MeshSource& meshSource, VertexAttribute attr) { return &GetAttributeSpan<T>(meshSource, attr)[0]; }
 
     template<typename T>
-    std::span<T> MeshGeometry::GetAttributeSpan(VertexAttribute attr)
+    VertexSpan<T> MeshGeometry::GetAttributeSpan(MeshSource& meshSource, VertexAttribute attr)
     {
-        const auto& range = mesh->meshSource->vertexBufferRanges[int(attr)];
-        T* ptr = reinterpret_cast<T*>(mesh->meshSource->cpuVertexBuffer.data() + range.byteOffset + (mesh->vertexOffset + vertexOffsetInMesh) * sizeof(T));
-        return std::span<T>(ptr, vertexCount);
+        meshSource.AcquireCpuGeometry();
+        const auto& range = meshSource.vertexBufferRanges[int(attr)];
+        uint32_t stride = meshSource.GetVertexStride(attr);
+        uint8_t* ptr = meshSource.cpuVertexBuffer.data() + range.byteOffset + (meshSource.meshes[mesh].vertexOffset + vertexOffsetInMesh) * stride;
+        return VertexSpan<T>(ptr, vertexCount, stride);
     }
 
-    uint32_t* MeshGeometry::Getindices() { return mesh->meshSource->cpuIndexBuffer.data() + mesh->indexOffset + indexOffsetInMesh; }
+    uint32_t* MeshGeometry::Getindices(MeshSource& meshSource)
+    {
+        meshSource.AcquireCpuGeometry();
+        return meshSource.cpuIndexBuffer.data() + meshSource.meshes[mesh].indexOffset + indexOffsetInMesh;
+    }
+
+    std::span<MeshGeometryLOD> MeshGeometry::GetLODSpan(MeshSource& meshSource) { return lodCount ? std::span<MeshGeometryLOD>(meshSource.lods.data() + lodOffset, lodCount) : std::span<MeshGeometryLOD>(); }
 
-    std::span<MeshGeometry> Assets::Mesh::GetGeometrySpan() { return std::span<MeshGeometry>(meshSource->geometries.data() + geometryOffset, geometryCount); }
+    const nvrhi::BufferRange MeshGeometry::GetLODIndexRange(const MeshSource& meshSource, uint32_t lod) const
+    {
+        if (lod == 0 || lod > lodCount)
+            return GetIndexRange(meshSource);
+
+        const auto& l = meshSource.lods[lodOffset + lod - 1];
+        return nvrhi::BufferRange(l.indexOffset * sizeof(uint32_t), uint64_t(l.indexCount) * sizeof(uint32_t));
+    }
+
+    std::span<Meshlet> MeshGeometry::GetMeshletSpan(MeshSource& meshSource) { return meshletCount ? std::span<Meshlet>(meshSource.meshlets.data() + meshletOffset, meshletCount) : std::span<Meshlet>(); }
+
+    std::span<CurveChunk> MeshGeometry::GetCurveChunkSpan(MeshSource& meshSource) { return curveChunkCount ? std::span<CurveChunk>(meshSource.curveChunks.data() + curveChunkOffset, curveChunkCount) : std::span<CurveChunk>(); }
+
+    std::span<MeshGeometry> Assets::Mesh::GetGeometrySpan(MeshSource& meshSource) { return std::span<MeshGeometry>(meshSource.geometries.data() + geometryOffset, geometryCount); }
+
+    std::span<const MorphTarget> Mesh::GetMorphTargetSpan(const MeshSource& meshSource) const { return morphTargetCount ? std::span<const MorphTarget>(meshSource.morphTargets.data() + morphTargetOffset, morphTargetCount) : std::span<const MorphTarget>(); }
 
     template<typename T>
-    T* Mesh::GetAttribute(VertexAttribute attr) { return reinterpret_cast<T*>(meshSource->cpuVertexBuffer.data() + vertexOffset * sizeof(T)); }
+    T* Mesh::GetAttribute(MeshSource& meshSource, VertexAttribute attr) { return &GetAttributeSpan<T>(meshSource, attr)[0]; }
 
     template<typename T>
-    std::span<T> Mesh::GetAttributeSpan(VertexAttribute attr)
+    VertexSpan<T> Mesh::GetAttributeSpan(MeshSource& meshSource, VertexAttribute attr)
     {
-        const auto& range = meshSource->vertexBufferRanges[int(attr)];
-        T* ptr = reinterpret_cast<T*>(meshSource->cpuVertexBuffer.data() + range.byteOffset + vertexOffset * sizeof(T));
-        return std::span<T>(ptr, vertexCount);
+        meshSource.AcquireCpuGeometry();
+        const auto& range = meshSource.vertexBufferRanges[int(attr)];
+        uint32_t stride = meshSource.GetVertexStride(attr);
+        uint8_t* ptr = meshSource.cpuVertexBuffer.data() + range.byteOffset + vertexOffset * stride;
+        return VertexSpan<T>(ptr, vertexCount, stride);
     }
 
-    uint32_t* Mesh::Getindices() { return meshSource->cpuIndexBuffer.data() + indexOffset; }
+    uint32_t* Mesh::Getindices(MeshSource& meshSource)
+    {
+        meshSource.AcquireCpuGeometry();
+        return meshSource.cpuIndexBuffer.data() + indexOffset;
+    }
 
-    const nvrhi::BufferRange Mesh::GetIndexRange() const { return nvrhi::BufferRange(indexOffset * sizeof(uint32_t), indexCount * sizeof(uint32_t)); }
+    const nvrhi::BufferRange Mesh::GetIndexRange() const { return nvrhi::BufferRange(indexOffset * sizeof(uint32_t), uint64_t(indexCount) * sizeof(uint32_t)); }
 
     template<typename T>
     T* MeshSource::GetAttribute(VertexAttribute attr)
     {
+        AcquireCpuGeometry();
         const auto& range = vertexBufferRanges[int(attr)];
         return reinterpret_cast<T*>(cpuVertexBuffer.data() + range.byteOffset);
     }
 
     template<typename T>
-    std::span<T> MeshSource::GetAttributeSpan(VertexAttribute attr)
+    VertexSpan<T> MeshSource::GetAttributeSpan(VertexAttribute attr)
     {
+        AcquireCpuGeometry();
         const auto& range = vertexBufferRanges[int(attr)];
-        T* ptr = reinterpret_cast<T*>(cpuVertexBuffer.data() + range.byteOffset);
-        return std::span<T>(ptr, vertexCount);
+        return VertexSpan<T>(cpuVertexBuffer.data() + range.byteOffset, vertexCount, GetVertexStride(attr));
     }
 
     std::span<Node> Node::GetChildren(MeshSourecHierarchy& meshSourecHierarchy)
@@ -800,11 +1483,52 @@ export namespace Assets {
         AssetType GetAssetTypeFromFileExtension(const std::filesystem::path& extension);
     };
 
+    // Mip level residency of a streamed texture, Texture::texture holds the levels from residentMip to the last one
+    // and is reallocated whenever residentMip changes
+    struct TextureStreamingEntry
+    {
+        HE::Ref<TextureFile> source;        // layout of every level, the data is only kept for sources that are not file backed
+        std::vector<uint64_t> fileOffsets;  // per source subresource, finer levels are read back from TextureFile::path
+        std::vector<uint64_t> levelSizes;   // GPU bytes of each level over every slice
+        uint32_t tailMip = 0;
+        uint32_t residentMip = 0;
+        uint32_t targetMip = 0;
+        uint32_t requestedMip = 0;
+        uint64_t lastRequestFrame = 0;
+        bool isPending = false;
+
+        ASSETS_API void Init(HE::Ref<TextureFile> source, uint32_t tailSize); // nothing resident, the tail is the first level at most tailSize large
+        ASSETS_API uint64_t GetResidentSize(uint32_t firstMip) const;
+        ASSETS_API bool IsValidFirstMip(uint32_t mip) const; // block compressed levels can only start a texture at a multiple of the block size
+    };
+
+    // Keeps the streamed textures within TextureImportSettings::streamingBudget. Each frame the renderer reports the finest level
+    // it sampled from each texture with RequestMip then calls Update, both on the main thread. Finer levels are read on a worker
+    // and swapped in on the main thread, subscribers get OnAssetReloaded whenever Texture::texture changes.
+    struct TextureStreamer
+    {
+        AssetManager* assetManager = nullptr;
+        std::unordered_map<AssetHandle, TextureStreamingEntry> entries;
+        uint64_t frameIndex = 0;
+        uint64_t residentSize = 0;
+        uint32_t pendingCount = 0;
+        uint64_t generation = 0;    // bumped by Clear, stream ins of an older generation are dropped
+
+        ASSETS_API void Add(Asset asset, HE::Ref<TextureFile> source); // creates Texture::texture with the mip tail
+        ASSETS_API void Remove(AssetHandle handle);
+        ASSETS_API void RequestMip(AssetHandle handle, uint32_t mipLevel);
+        ASSETS_API void Update();
+        ASSETS_API uint64_t UpdateTargets(); // the CPU part of Update, picks each targetMip within the budget and returns their total size
+        ASSETS_API void Clear();
+    };
+
     struct AssetManagerDesc
     {
         AssetImportingMode importMode = AssetImportingMode::Async;
         std::filesystem::path assetsDirectory;
         std::filesystem::path assetsRegistryFilePath;
+        MeshSourceImportSettings meshSourceImportSettings;
+        TextureImportSettings textureImportSettings;
     };
 
     struct AssetManager
@@ -817,6 +1541,7 @@ export namespace Assets {
         std::unordered_map<std::filesystem::path, AssetHandle> pathToHandleMap;
         std::unordered_map<SubscriberHandle, AssetEventCallback*> subscribers;
         AssetImporter assetImporter;
+        TextureStreamer textureStreamer;
         uint32_t asyncTaskCount = 0;
         std::mutex registryMutex;
         std::mutex metaMutex;
@@ -952,6 +1677,17 @@ export namespace Assets {
         bool  IsSupportAsyncLoading() override { return true; }
     };
 
+    struct AnimationClipImporter : public IAssetImporter
+    {
+        AssetManager* assetManager;
+
+        AnimationClipImporter(AssetManager* assetManager);
+        Asset Import(AssetHandle handle, const std::filesystem::path& filePath) override;
+        Asset Create(AssetHandle handle, const std::filesystem::path& filePath) override;
+        void  Save(Asset asset, const std::filesystem::path& filePath) override;
+        bool  IsSupportAsyncLoading() override { return false; }
+    };
+
     struct MeshSourceImporter : public IAssetImporter
     {
         AssetManager* assetManager;
@@ -968,9 +1704,204 @@ export namespace Assets {
     // Utils
     //////////////////////////////////////////////////////////////////////////
 
-    ASSETS_API nvrhi::TextureHandle LoadTexture(const std::filesystem::path& filePath, nvrhi::IDevice* device, nvrhi::ICommandList* commandList);
+    ASSETS_API uint16_t FloatToHalf(float value);
+    ASSETS_API float HalfToFloat(uint16_t value);
+    ASSETS_API bool DecodeBase64(std::string_view input, std::vector<uint8_t>& output); // standard and url alphabets, padding optional
+    ASSETS_API bool DecodeZstd(std::span<const uint8_t> input, std::vector<uint8_t>& output); // appends, no dictionaries
+    ASSETS_API bool DecodeZlib(std::span<const uint8_t> input, std::vector<uint8_t>& output); // appends, checks the Adler-32
+
+    // EXT_meshopt_compression decoders, return false on malformed input
+    enum class MeshoptFilter : uint8_t
+    {
+        None,
+        Octahedral,
+        Quaternion,
+        Exponential,
+    };
+
+    ASSETS_API bool DecodeMeshoptVertexBuffer(void* destination, size_t count, size_t stride, const uint8_t* buffer, size_t size);
+    ASSETS_API bool DecodeMeshoptIndexBuffer(void* destination, size_t count, size_t indexSize, const uint8_t* buffer, size_t size);
+    ASSETS_API bool DecodeMeshoptIndexSequence(void* destination, size_t count, size_t indexSize, const uint8_t* buffer, size_t size);
+    ASSETS_API bool DecodeMeshoptFilter(MeshoptFilter filter, void* data, size_t count, size_t stride);
+
+    ASSETS_API nvrhi::TextureHandle LoadTexture(const std::filesystem::path& filePath, nvrhi::IDevice* device, nvrhi::ICommandList* commandList, HDRTextureFormat hdrFormat = HDRTextureFormat::RGBA16Float);
     ASSETS_API nvrhi::TextureHandle LoadTexture(HE::Buffer buffer, nvrhi::IDevice* device, nvrhi::ICommandList* commandList, const std::string_view& name = {});
 
+    // Mip chains are built on the CPU from RGBA8 level 0, levels and row tiles are filtered in parallel
+    ASSETS_API uint32_t GetMipLevelCount(uint32_t width, uint32_t height);
+    ASSETS_API void InitMipChain(MipChain& chain, uint32_t width, uint32_t height, uint32_t levelCount, TextureCompression compression);
+    ASSETS_API void GenerateMips(const uint8_t* rgba, uint32_t width, uint32_t height, const MipGenerationDesc& desc, MipChain& chain);
+    ASSETS_API void WriteMipChain(nvrhi::ICommandList* commandList, nvrhi::ITexture* texture, const MipChain& chain);
+
+    // .dds and .ktx2 are recognized by their signature. Levels, array layers, cube faces and volume slices are uploaded as stored,
+    // Zstandard and zlib supercompressed KTX2 levels are inflated in parallel. BasisLZ and UASTC payloads need a Basis Universal
+    // transcoder, which is not part of the plugin, they fail to load with an error and must be re-exported with a BCn format
+    ASSETS_API bool IsTextureFile(const std::filesystem::path& extension);
+    ASSETS_API bool LoadTextureFile(const std::filesystem::path& filePath, TextureFile& textureFile);
+    ASSETS_API bool ParseTextureFile(const uint8_t* data, size_t size, TextureFile& textureFile); // data must outlive the subresources
+    ASSETS_API void WriteTextureFile(nvrhi::ICommandList* commandList, nvrhi::ITexture* texture, const TextureFile& textureFile);
+    ASSETS_API HE::Ref<TextureFile> CreateTextureFile(MipChain&& chain, nvrhi::Format format); // the chain data is moved into storage
+    ASSETS_API HE::Ref<TextureFile> ReferenceTextureFile(HE::Ref<MappedFile> file, std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t mipLevels, nvrhi::Format format); // packed levels left in place, null when they do not fit
+
+    // Streamed textures read their finer levels back from a file, sources held in memory are saved once as .dds next to their source
+    ASSETS_API bool SaveTextureFile(const std::filesystem::path& filePath, const TextureFile& textureFile); // .dds with a DX10 header
+    ASSETS_API HE::Ref<TextureFile> CacheTextureFile(HE::Ref<TextureFile> textureFile, const std::filesystem::path& cachePath); // returned as is when already file backed or the save fails
+    ASSETS_API HE::Ref<TextureFile> LoadTextureCache(const std::filesystem::path& cachePath, const std::filesystem::path& sourcePath); // null unless the cache is newer than its source
+
+    // RGB32_FLOAT texels to a compact HDR format, rows or block rows are converted in parallel. Halves are clamped to 65504,
+    // R11G11B10 and BC6H clamp negative values to 0. False for BC6H when the size is not a multiple of 4.
+    ASSETS_API nvrhi::Format GetHDRTextureFormat(HDRTextureFormat format);
+    ASSETS_API bool ConvertHDRImage(const float* rgb, uint32_t width, uint32_t height, HDRTextureFormat format, std::vector<uint8_t>& output, size_t& rowPitch);
+
+    // Block compression of RGBA8 chains, the block rows of every level are encoded in parallel
+    ASSETS_API TextureCompression ChooseTextureCompression(const MipChain& chain, TextureUsage usage, bool preferBC7);
+    ASSETS_API bool CompressMipChain(const MipChain& source, TextureCompression compression, MipChain& result); // false when level 0 is not a multiple of 4
+    ASSETS_API nvrhi::Format GetTextureFormat(TextureCompression compression, bool isSRGB);
+
+    //////////////////////////////////////////////////////////////////////////
+    // Mesh Processing
+    //////////////////////////////////////////////////////////////////////////
+
+    // Merges vertices whose attributes match within epsilon, drops unreferenced vertices and compacts cpuVertexBuffer, returns the number of bytes saved
+    ASSETS_API uint64_t WeldVertices(MeshSource& meshSource, float epsilon);
+
+    // Re-encodes every present attribute into the given formats, positions are quantized relative to their Mesh::aabb
+    ASSETS_API void ConvertVertexFormats(MeshSource& meshSource, const std::array<VertexFormat, c_VertexAttributeCount>& formats);
+
+    // Repacks cpuVertexBuffer into the given layout, GetVertexRange and the GetAttribute* accessors follow the recorded stride
+    ASSETS_API void SetVertexLayout(MeshSource& meshSource, VertexLayout layout);
+
+    // Keeps one copy of meshes with identical geometries, materials, indices and vertices, returns old mesh index -> new mesh index.
+    // Must run before BuildLODs and BuildMeshlets.
+    ASSETS_API std::vector<uint32_t> MergeIdenticalMeshes(MeshSource& meshSource);
+
+    // Content hash of cpuVertexBuffer and cpuIndexBuffer, re-fetched CPU geometry must match MeshSource::geometryHash
+    ASSETS_API uint64_t HashGeometry(const MeshSource& meshSource);
+
+    // Orders the geometries of each Mesh by material and merges neighbours that share material and primitive type into one index range,
+    // returns the new geometry count. Must run before BuildLODs and BuildMeshlets.
+    ASSETS_API uint32_t SortGeometriesByMaterial(MeshSource& meshSource);
+
+    // Fills MeshSource::materialRanges and materialGeometries from the current geometries
+    ASSETS_API void BuildMaterialRanges(MeshSource& meshSource);
+
+    // Parents, world transforms and world bounds of the nodes, one pass in storage order
+    ASSETS_API void UpdateHierarchy(MeshSourecHierarchy& hierarchy, const MeshSource& meshSource);
+
+    // Groups the world transforms of the mesh nodes by mesh, after UpdateHierarchy
+    ASSETS_API void BuildMeshInstances(MeshSourecHierarchy& hierarchy, uint32_t meshCount);
+
+    //////////////////////////////////////////////////////////////////////////
+    // Meshlets
+    //////////////////////////////////////////////////////////////////////////
+
+    // Meshlets grow through neighbouring triangles to keep their bounds and normal cones tight
+    ASSETS_API void BuildMeshlets(MeshSource& meshSource, uint32_t maxVertices, uint32_t maxTriangles);
+    ASSETS_API std::array<Math::float4, 6> ExtractFrustumPlanes(const Math::float4x4& viewProjection); // planes point inward, normalized
+    ASSETS_API bool IsMeshletCulled(const Meshlet& meshlet, const Math::float3& cameraPosition, const std::array<Math::float4, 6>& frustumPlanes);
+    ASSETS_API uint32_t CullMeshlets(std::span<const Meshlet> meshlets, const Math::float3& cameraPosition, const std::array<Math::float4, 6>& frustumPlanes, std::vector<uint32_t>& visibleMeshlets);
+
+    //////////////////////////////////////////////////////////////////////////
+    // LOD
+    //////////////////////////////////////////////////////////////////////////
+
+    // Replaces the LODs of every triangle geometry, their indices follow the full detail ones in cpuIndexBuffer
+    ASSETS_API void BuildLODs(MeshSource& meshSource, uint32_t lodCount, float reduction, float maxError);
+
+    // projectionScale = viewportHeight / (2 * tan(fovY / 2)), returns 0 for the full detail geometry or lod index + 1
+    ASSETS_API uint32_t SelectLOD(std::span<const MeshGeometryLOD> lods, float distance, float projectionScale, float pixelThreshold = 1.0f);
+
+    //////////////////////////////////////////////////////////////////////////
+    // Curves
+    //////////////////////////////////////////////////////////////////////////
+
+    // Converts line and line strip geometries into strands of the given curve MeshType, simplifying each strand within tolerance.
+    // CurveLinearSweptSpheres keeps segment lists with a radius per vertex, CurvePolytubes and CurveDisjointOrthogonalTriangleStrips are triangulated.
+    // Must run before BuildLODs and BuildMeshlets.
+    ASSETS_API void BuildCurves(MeshSource& meshSource, MeshType type, float tolerance, float radius, uint32_t chunkSegments, uint32_t tubeSides, bool keepRadius);
+
+    //////////////////////////////////////////////////////////////////////////
+    // Morph Targets
+    //////////////////////////////////////////////////////////////////////////
+
+    // Appends a target to the mesh, keeping the vertices whose quantized deltas are not zero. normals and tangents may be empty.
+    // The targets of a mesh must be appended one after another.
+    ASSETS_API void AppendMorphTarget(MeshSource& meshSource, Mesh& mesh, std::string_view name, float defaultWeight, std::span<const uint32_t> vertices, std::span<const Math::float3> positions, std::span<const Math::float3> normals, std::span<const Math::float3> tangents);
+
+    // Adds the weighted deltas of the mesh targets, one weight per target. The spans hold the mesh vertices on input and may be empty to skip an attribute.
+    // normals and tangents are not renormalized.
+    ASSETS_API void BlendMorphTargets(const MeshSource& meshSource, const Mesh& mesh, std::span<const float> weights, std::span<Math::float3> positions, std::span<Math::float3> normals, std::span<Math::float3> tangents);
+
+    //////////////////////////////////////////////////////////////////////////
+    // BVH
+    //////////////////////////////////////////////////////////////////////////
+
+    ASSETS_API void BuildBVH(MeshSource& meshSource);
+    ASSETS_API bool RaycastBVH(const MeshBVH& bvh, const Ray& ray, RayHit& hit); // hit.t bounds the search, returns true if hit was updated
+
+    //////////////////////////////////////////////////////////////////////////
+    // Animation
+    //////////////////////////////////////////////////////////////////////////
+
+    // 3 x 16 bit smallest three quaternion, the index of the dropped component in bits 48-49
+    ASSETS_API uint64_t PackRotation(const Math::quat& rotation);
+    ASSETS_API Math::quat UnpackRotation(uint64_t packed);
+
+    // Appends a track, dropping keys that interpolation of their neighbours reproduces within tolerance.
+    // values are xyz for translation and scale, xyzw for rotation.
+    ASSETS_API void AppendAnimationTrack(AnimationClip& clip, uint32_t bone, AnimationPath path, bool step, std::span<const float> times, std::span<const Math::float4> values, float tolerance);
+
+    // Samples every bone of the clip at each time, output[instance * boneCount + bone], times are clamped to the clip
+    ASSETS_API void SampleAnimationClip(const AnimationClip& clip, std::span<const float> times, std::span<BoneTransform> output);
+
+    ASSETS_API void SerializeAnimationClip(const AnimationClip& clip, std::vector<uint8_t>& output);
+    ASSETS_API bool DeserializeAnimationClip(std::span<const uint8_t> data, AnimationClip& clip);
+
+    //////////////////////////////////////////////////////////////////////////
+    // Benchmarks
+    //////////////////////////////////////////////////////////////////////////
+
+    // Best time of the runs, quality is the PSNR in dB for lossy encoders and 0 otherwise
+    struct BenchmarkResult
+    {
+        std::string name;
+        double milliseconds = 0.0;
+        double throughput = 0.0;
+        std::string unit;       // of throughput, per second
+        double quality = 0.0;
+        std::string detail;     // what the benchmark saved or skipped, when it reports that
+    };
+
+    ASSETS_API void LogBenchmarkResults(std::span<const BenchmarkResult> results);
+
+    // Encodes level 0 in every block format and decodes it back with reference decoders, the chain must be RGBA8 with a size multiple of 4
+    ASSETS_API std::vector<BenchmarkResult> BenchmarkTextureCompression(const MipChain& chain, uint32_t runs = 3);
+    ASSETS_API std::vector<BenchmarkResult> BenchmarkTextureCompression(const std::filesystem::path& imagePath, uint32_t runs = 3);
+
+    // Cameras on a ring around the source bounds look at its center, each one culls every meshlet in mesh space.
+    // The detail is the share of the meshlet triangles culled.
+    ASSETS_API std::vector<BenchmarkResult> BenchmarkMeshletCulling(const MeshSource& meshSource, uint32_t viewCount = 64, uint32_t runs = 3);
+
+    // Times BuildLODs over the geometries of a source with CPU geometry, which is restored afterwards
+    ASSETS_API std::vector<BenchmarkResult> BenchmarkLODs(MeshSource& meshSource, uint32_t lodCount = 4, float reduction = 0.5f, float maxError = 0.02f, uint32_t runs = 3);
+
+    // Indexed fetch of position, normal and uv, the attributes a raster pass reads together, in every VertexLayout.
+    // The source needs CPU geometry and is left in its original layout.
+    ASSETS_API std::vector<BenchmarkResult> BenchmarkVertexLayouts(MeshSource& meshSource, uint32_t runs = 3);
+
+    // BuildBVH, then rays from a ring around the bounds toward random points inside them, one at a time and with RaycastBatch.
+    // The source needs CPU geometry and keeps the built BVHs.
+    ASSETS_API std::vector<BenchmarkResult> BenchmarkBVH(MeshSource& meshSource, uint32_t rayCount = 1 << 20, uint32_t runs = 3);
+
+    // Samples every bone of the clip for instances spread over its duration. The second overload builds a clip with
+    // translation, rotation and scale tracks on every bone first.
+    ASSETS_API std::vector<BenchmarkResult> BenchmarkAnimationSampling(const AnimationClip& clip, uint32_t instanceCount = 1000, uint32_t runs = 3);
+    ASSETS_API std::vector<BenchmarkResult> BenchmarkAnimationSampling(uint32_t instanceCount = 1000, uint32_t boneCount = 100, uint32_t runs = 3);
+
+    // Runs RequestMip and the target selection of TextureStreamer::Update over synthetic layouts, no device or file is needed.
+    // Logs an error when a target breaks the budget, the feedback or the retention.
+    ASSETS_API std::vector<BenchmarkResult> BenchmarkTextureStreaming(uint32_t textureCount = 1024, uint32_t frameCount = 600, uint64_t budget = 256ull << 20);
+
 }
 
 
@@ -0,0 +1,652 @@
+#include "HydraEngine/Base.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+import Assets;
+import HE;
+import Math;
+import std;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+#pragma region Rotation
+
+    // the three smallest components of a unit quaternion lie within +-1/sqrt(2)
+    constexpr float c_RotationRange = 0.70710678f;
+    constexpr float c_RotationStep = 2.0f * c_RotationRange / 65535.0f;
+
+    uint64_t PackRotation(const Math::quat& rotation)
+    {
+        float q[4] = { rotation.x, rotation.y, rotation.z, rotation.w };
+
+        float length = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        float invLength = length > 0.0f ? 1.0f / length : 0.0f;
+
+        uint32_t largest = 3;
+        for (uint32_t i = 0; i < 3; i++)
+        {
+            if (std::abs(q[i]) > std::abs(q[largest]))
+                largest = i;
+        }
+
+        // q and -q are the same rotation, keep the dropped component positive
+        float sign = q[largest] < 0.0f ? -invLength : invLength;
+
+        uint64_t packed = uint64_t(largest) << 48;
+        uint32_t shift = 0;
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            if (i == largest)
+                continue;
+
+            float v = std::clamp((q[i] * sign + c_RotationRange) / c_RotationStep, 0.0f, 65535.0f);
+            packed |= uint64_t(v + 0.5f) << shift;
+            shift += 16;
+        }
+
+        return packed;
+    }
+
+    Math::quat UnpackRotation(uint64_t packed)
+    {
+        uint32_t largest = uint32_t(packed >> 48) & 3;
+
+        float q[4];
+        float sum = 0.0f;
+        uint32_t shift = 0;
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            if (i == largest)
+                continue;
+
+            q[i] = float((packed >> shift) & 0xFFFF) * c_RotationStep - c_RotationRange;
+            sum += q[i] * q[i];
+            shift += 16;
+        }
+        q[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+
+        return Math::quat(q[3], q[0], q[1], q[2]);
+    }
+
+#pragma endregion
+
+#pragma region Tracks
+
+    static Math::float4 InterpolateKey(AnimationPath path, const Math::float4& a, const Math::float4& b, float t)
+    {
+        Math::float4 r = a + (b - a) * t;
+        if (path == AnimationPath::Rotation)
+        {
+            float length = std::sqrt(Math::dot(r, r));
+            r = length > 0.0f ? r / length : a;
+        }
+
+        return r;
+    }
+
+    static bool KeyEqual(const Math::float4& a, const Math::float4& b, float tolerance)
+    {
+        return std::abs(a.x - b.x) <= tolerance && std::abs(a.y - b.y) <= tolerance && std::abs(a.z - b.z) <= tolerance && std::abs(a.w - b.w) <= tolerance;
+    }
+
+    static Math::float4 GetRestValue(const BoneTransform& rest, AnimationPath path)
+    {
+        switch (path)
+        {
+        case AnimationPath::Translation: return Math::float4(rest.translation, 0.0f);
+        case AnimationPath::Rotation:    return Math::float4(rest.rotation.x, rest.rotation.y, rest.rotation.z, rest.rotation.w);
+        case AnimationPath::Scale:       return Math::float4(rest.scale, 0.0f);
+        }
+
+        return Math::float4(0.0f);
+    }
+
+    void AppendAnimationTrack(AnimationClip& clip, uint32_t bone, AnimationPath path, bool step, std::span<const float> times, std::span<const Math::float4> values, float tolerance)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        const uint32_t count = (uint32_t)std::min(times.size(), values.size());
+        if (count == 0)
+            return;
+
+        std::vector<Math::float4> keys(values.begin(), values.begin() + count);
+        if (path == AnimationPath::Rotation)
+        {
+            // normalized and on the hemisphere of the previous key, so neighbours interpolate the short way
+            for (uint32_t i = 0; i < count; i++)
+            {
+                float length = std::sqrt(Math::dot(keys[i], keys[i]));
+                keys[i] = length > 0.0f ? keys[i] / length : Math::float4(0.0f, 0.0f, 0.0f, 1.0f);
+                if (i > 0 && Math::dot(keys[i], keys[i - 1]) < 0.0f)
+                    keys[i] = -keys[i];
+            }
+        }
+        else
+        {
+            for (auto& key : keys)
+                key.w = 0.0f;
+        }
+
+        std::vector<uint32_t> kept = { 0 };
+        if (step)
+        {
+            for (uint32_t i = 1; i < count; i++)
+            {
+                if (!KeyEqual(keys[i], keys[kept.back()], tolerance))
+                    kept.push_back(i);
+            }
+        }
+        else
+        {
+            // greedy : extend the segment from the last kept key while every skipped key stays within tolerance
+            uint32_t anchor = 0;
+            for (uint32_t end = 2; end < count; end++)
+            {
+                float span = times[end] - times[anchor];
+                for (uint32_t i = anchor + 1; i < end; i++)
+                {
+                    float t = span > 0.0f ? (times[i] - times[anchor]) / span : 0.0f;
+                    if (!KeyEqual(InterpolateKey(path, keys[anchor], keys[end], t), keys[i], tolerance))
+                    {
+                        anchor = end - 1;
+                        kept.push_back(anchor);
+                        break;
+                    }
+                }
+            }
+
+            if (count > 1)
+                kept.push_back(count - 1);
+
+            if (kept.size() == 2 && KeyEqual(keys[kept[0]], keys[kept[1]], tolerance))
+                kept.pop_back();
+        }
+
+        clip.duration = std::max(clip.duration, times[count - 1]);
+
+        // a constant track at the rest pose is what the sampler produces without one
+        if (kept.size() == 1 && bone < clip.restPose.size())
+        {
+            Math::float4 rest = GetRestValue(clip.restPose[bone], path);
+            if (KeyEqual(keys[kept[0]], rest, tolerance) || (path == AnimationPath::Rotation && KeyEqual(-keys[kept[0]], rest, tolerance)))
+                return;
+        }
+
+        auto& track = clip.tracks.emplace_back();
+        track.bone = bone;
+        track.path = path;
+        track.step = step;
+        track.keyOffset = (uint32_t)clip.times.size();
+        track.keyCount = (uint32_t)kept.size();
+
+        for (uint32_t i : kept)
+            clip.times.push_back(times[i]);
+
+        if (path == AnimationPath::Rotation)
+        {
+            track.valueOffset = (uint32_t)clip.rotationKeys.size();
+            for (uint32_t i : kept)
+                clip.rotationKeys.push_back(PackRotation(Math::quat(keys[i].w, keys[i].x, keys[i].y, keys[i].z)));
+        }
+        else
+        {
+            track.valueOffset = (uint32_t)clip.vectorKeys.size();
+            for (uint32_t i : kept)
+                clip.vectorKeys.push_back(Math::float3(keys[i]));
+        }
+    }
+
+#pragma endregion
+
+#pragma region Sampling
+
+    // key and next key around time, alpha is 0 before the first key, after the last and for step tracks
+    static inline void FindKey(const float* times, uint32_t count, bool step, float time, uint32_t& key, uint32_t& next, float& alpha)
+    {
+        if (count < 2 || time <= times[0])
+        {
+            key = next = 0;
+            alpha = 0.0f;
+            return;
+        }
+
+        if (time >= times[count - 1])
+        {
+            key = next = count - 1;
+            alpha = 0.0f;
+            return;
+        }
+
+        key = uint32_t(std::upper_bound(times, times + count, time) - times) - 1;
+        next = key + 1;
+        alpha = step ? 0.0f : (time - times[key]) / (times[next] - times[key]);
+    }
+
+    static inline Math::float3& GetVectorTarget(BoneTransform& transform, AnimationPath path)
+    {
+        return path == AnimationPath::Scale ? transform.scale : transform.translation;
+    }
+
+    static void SampleTrack(const AnimationClip& clip, const AnimationTrack& track, float time, BoneTransform& output)
+    {
+        const float* times = clip.times.data() + track.keyOffset;
+
+        uint32_t key, next;
+        float alpha;
+        FindKey(times, track.keyCount, track.step, time, key, next, alpha);
+
+        if (track.path == AnimationPath::Rotation)
+        {
+            Math::quat a = UnpackRotation(clip.rotationKeys[track.valueOffset + key]);
+            Math::quat b = UnpackRotation(clip.rotationKeys[track.valueOffset + next]);
+
+            float dot = a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+            float sign = dot < 0.0f ? -1.0f : 1.0f;
+
+            float x = a.x + (b.x * sign - a.x) * alpha;
+            float y = a.y + (b.y * sign - a.y) * alpha;
+            float z = a.z + (b.z * sign - a.z) * alpha;
+            float w = a.w + (b.w * sign - a.w) * alpha;
+            float invLength = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+
+            output.rotation = Math::quat(w * invLength, x * invLength, y * invLength, z * invLength);
+        }
+        else
+        {
+            const Math::float3& a = clip.vectorKeys[track.valueOffset + key];
+            const Math::float3& b = clip.vectorKeys[track.valueOffset + next];
+            GetVectorTarget(output, track.path) = a + (b - a) * alpha;
+        }
+    }
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+
+    static inline __m128 Select(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // 4 smallest three rotations to SoA xyzw
+    static inline void UnpackRotations(const uint64_t packed[4], __m128& x, __m128& y, __m128& z, __m128& w)
+    {
+        const __m128 step = _mm_set1_ps(c_RotationStep);
+        const __m128 range = _mm_set1_ps(c_RotationRange);
+
+        auto component = [&](uint32_t shift) {
+            __m128i v = _mm_setr_epi32(int((packed[0] >> shift) & 0xFFFF), int((packed[1] >> shift) & 0xFFFF), int((packed[2] >> shift) & 0xFFFF), int((packed[3] >> shift) & 0xFFFF));
+            return _mm_sub_ps(_mm_mul_ps(_mm_cvtepi32_ps(v), step), range);
+        };
+
+        __m128 s0 = component(0);
+        __m128 s1 = component(16);
+        __m128 s2 = component(32);
+        __m128i largest = _mm_setr_epi32(int(packed[0] >> 48) & 3, int(packed[1] >> 48) & 3, int(packed[2] >> 48) & 3, int(packed[3] >> 48) & 3);
+
+        __m128 sum = _mm_add_ps(_mm_add_ps(_mm_mul_ps(s0, s0), _mm_mul_ps(s1, s1)), _mm_mul_ps(s2, s2));
+        __m128 d = _mm_sqrt_ps(_mm_max_ps(_mm_setzero_ps(), _mm_sub_ps(_mm_set1_ps(1.0f), sum)));
+
+        __m128 m0 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(0)));
+        __m128 m1 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(1)));
+        __m128 m2 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(2)));
+        __m128 m3 = _mm_castsi128_ps(_mm_cmpeq_epi32(largest, _mm_set1_epi32(3)));
+
+        // the stored components fill the remaining slots in order
+        x = Select(m0, d, s0);
+        y = Select(m0, s0, Select(m1, d, s1));
+        z = Select(m3, s2, Select(m2, d, s1));
+        w = Select(m3, d, s2);
+    }
+
+    static void SampleTrack4(const AnimationClip& clip, const AnimationTrack& track, const float time[4], BoneTransform* output[4])
+    {
+        const float* times = clip.times.data() + track.keyOffset;
+
+        uint32_t key[4], next[4];
+        alignas(16) float alpha[4];
+        for (int l = 0; l < 4; l++)
+            FindKey(times, track.keyCount, track.step, time[l], key[l], next[l], alpha[l]);
+
+        __m128 t = _mm_load_ps(alpha);
+
+        if (track.path == AnimationPath::Rotation)
+        {
+            const uint64_t* keys = clip.rotationKeys.data() + track.valueOffset;
+            const uint64_t pa[4] = { keys[key[0]], keys[key[1]], keys[key[2]], keys[key[3]] };
+            const uint64_t pb[4] = { keys[next[0]], keys[next[1]], keys[next[2]], keys[next[3]] };
+
+            __m128 ax, ay, az, aw, bx, by, bz, bw;
+            UnpackRotations(pa, ax, ay, az, aw);
+            UnpackRotations(pb, bx, by, bz, bw);
+
+            __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+            __m128 sign = _mm_and_ps(_mm_cmplt_ps(dot, _mm_setzero_ps()), _mm_set1_ps(-0.0f));
+
+            __m128 x = _mm_add_ps(ax, _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(bx, sign), ax), t));
+            __m128 y = _mm_add_ps(ay, _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(by, sign), ay), t));
+            __m128 z = _mm_add_ps(az, _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(bz, sign), az), t));
+            __m128 w = _mm_add_ps(aw, _mm_mul_ps(_mm_sub_ps(_mm_xor_ps(bw, sign), aw), t));
+
+            __m128 length = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w))));
+            __m128 invLength = _mm_div_ps(_mm_set1_ps(1.0f), length);
+
+            alignas(16) float rx[4], ry[4], rz[4], rw[4];
+            _mm_store_ps(rx, _mm_mul_ps(x, invLength));
+            _mm_store_ps(ry, _mm_mul_ps(y, invLength));
+            _mm_store_ps(rz, _mm_mul_ps(z, invLength));
+            _mm_store_ps(rw, _mm_mul_ps(w, invLength));
+
+            for (int l = 0; l < 4; l++)
+                output[l]->rotation = Math::quat(rw[l], rx[l], ry[l], rz[l]);
+        }
+        else
+        {
+            const Math::float3* keys = clip.vectorKeys.data() + track.valueOffset;
+
+            // one lane per component, the 4 instances are 3 lerps of 4 floats
+            for (int l = 0; l < 4; l++)
+            {
+                const Math::float3& a = keys[key[l]];
+                const Math::float3& b = keys[next[l]];
+                __m128 va = _mm_setr_ps(a.x, a.y, a.z, 0.0f);
+                __m128 vb = _mm_setr_ps(b.x, b.y, b.z, 0.0f);
+                __m128 r = _mm_add_ps(va, _mm_mul_ps(_mm_sub_ps(vb, va), _mm_set1_ps(alpha[l])));
+
+                alignas(16) float v[4];
+                _mm_store_ps(v, r);
+                GetVectorTarget(*output[l], track.path) = Math::float3(v[0], v[1], v[2]);
+            }
+        }
+    }
+
+#endif
+
+    constexpr size_t c_SampleBlockSize = 16;
+
+    void SampleAnimationClip(const AnimationClip& clip, std::span<const float> times, std::span<BoneTransform> output)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        const size_t boneCount = clip.restPose.size();
+        if (boneCount == 0)
+            return;
+
+        const size_t instanceCount = std::min(times.size(), output.size() / boneCount);
+
+        // blocks of instances keep their poses in cache while every track is applied
+        for (size_t first = 0; first < instanceCount; first += c_SampleBlockSize)
+        {
+            const size_t last = std::min(first + c_SampleBlockSize, instanceCount);
+
+            for (size_t i = first; i < last; i++)
+                std::copy(clip.restPose.begin(), clip.restPose.end(), output.begin() + i * boneCount);
+
+            for (const auto& track : clip.tracks)
+            {
+                if (track.keyCount == 0 || track.bone >= boneCount)
+                    continue;
+
+                size_t i = first;
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+                for (; i + 4 <= last; i += 4)
+                {
+                    BoneTransform* targets[4];
+                    for (int l = 0; l < 4; l++)
+                        targets[l] = &output[(i + l) * boneCount + track.bone];
+
+                    SampleTrack4(clip, track, times.data() + i, targets);
+                }
+#endif
+
+                for (; i < last; i++)
+                    SampleTrack(clip, track, times[i], output[i * boneCount + track.bone]);
+            }
+        }
+    }
+
+#pragma endregion
+
+#pragma region Serialization
+
+    // .animation layout : [AnimationClipHeader][name][boneNodes][restPose][tracks][times][vectorKeys][rotationKeys]
+    constexpr uint32_t c_AnimationClipMagic = 0x4D4E4148; // "HANM"
+    constexpr uint32_t c_AnimationClipVersion = 1;
+
+    struct AnimationClipHeader
+    {
+        uint32_t magic = c_AnimationClipMagic;
+        uint32_t version = c_AnimationClipVersion;
+        float duration = 0.0f;
+        uint32_t nameSize = 0;
+        uint32_t boneCount = 0;
+        uint32_t trackCount = 0;
+        uint32_t timeCount = 0;
+        uint32_t vectorKeyCount = 0;
+        uint32_t rotationKeyCount = 0;
+    };
+
+    struct AnimationTrackRecord
+    {
+        uint32_t bone;
+        uint8_t path;
+        uint8_t step;
+        uint16_t padding;
+        uint32_t keyOffset;
+        uint32_t keyCount;
+        uint32_t valueOffset;
+    };
+
+    struct BoneTransformRecord
+    {
+        float translation[3];
+        float rotation[4]; // xyzw
+        float scale[3];
+    };
+
+    void SerializeAnimationClip(const AnimationClip& clip, std::vector<uint8_t>& output)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        auto write = [&output](const void* data, size_t size) {
+            const uint8_t* bytes = (const uint8_t*)data;
+            output.insert(output.end(), bytes, bytes + size);
+        };
+
+        AnimationClipHeader header;
+        header.duration = clip.duration;
+        header.nameSize = (uint32_t)clip.name.size();
+        header.boneCount = (uint32_t)clip.restPose.size();
+        header.trackCount = (uint32_t)clip.tracks.size();
+        header.timeCount = (uint32_t)clip.times.size();
+        header.vectorKeyCount = (uint32_t)clip.vectorKeys.size();
+        header.rotationKeyCount = (uint32_t)clip.rotationKeys.size();
+
+        write(&header, sizeof(header));
+        write(clip.name.data(), clip.name.size());
+
+        for (uint32_t i = 0; i < header.boneCount; i++)
+        {
+            uint32_t node = i < clip.boneNodes.size() ? clip.boneNodes[i] : c_Invalid;
+            write(&node, sizeof(node));
+        }
+
+        for (const auto& rest : clip.restPose)
+        {
+            BoneTransformRecord r = {
+                { rest.translation.x, rest.translation.y, rest.translation.z },
+                { rest.rotation.x, rest.rotation.y, rest.rotation.z, rest.rotation.w },
+                { rest.scale.x, rest.scale.y, rest.scale.z }
+            };
+            write(&r, sizeof(r));
+        }
+
+        for (const auto& track : clip.tracks)
+        {
+            AnimationTrackRecord r = { track.bone, (uint8_t)track.path, (uint8_t)track.step, 0, track.keyOffset, track.keyCount, track.valueOffset };
+            write(&r, sizeof(r));
+        }
+
+        write(clip.times.data(), clip.times.size() * sizeof(float));
+        for (const auto& key : clip.vectorKeys)
+        {
+            float v[3] = { key.x, key.y, key.z };
+            write(v, sizeof(v));
+        }
+        write(clip.rotationKeys.data(), clip.rotationKeys.size() * sizeof(uint64_t));
+    }
+
+    bool DeserializeAnimationClip(std::span<const uint8_t> data, AnimationClip& clip)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        size_t position = 0;
+        auto read = [&](void* dst, size_t size) {
+            if (size > data.size() - position)
+                return false;
+
+            if (size)
+                std::memcpy(dst, data.data() + position, size);
+            position += size;
+            return true;
+        };
+
+        AnimationClipHeader header;
+        if (!read(&header, sizeof(header)) || header.magic != c_AnimationClipMagic || header.version != c_AnimationClipVersion)
+            return false;
+
+        uint64_t expected = sizeof(header) + uint64_t(header.nameSize) + uint64_t(header.boneCount) * (sizeof(uint32_t) + sizeof(BoneTransformRecord)) +
+            uint64_t(header.trackCount) * sizeof(AnimationTrackRecord) + uint64_t(header.timeCount) * sizeof(float) +
+            uint64_t(header.vectorKeyCount) * sizeof(float) * 3 + uint64_t(header.rotationKeyCount) * sizeof(uint64_t);
+        if (expected != data.size())
+            return false;
+
+        clip.duration = header.duration;
+        clip.name.resize(header.nameSize);
+        read(clip.name.data(), header.nameSize);
+
+        clip.boneNodes.resize(header.boneCount);
+        read(clip.boneNodes.data(), header.boneCount * sizeof(uint32_t));
+
+        clip.restPose.resize(header.boneCount);
+        for (auto& rest : clip.restPose)
+        {
+            BoneTransformRecord r;
+            read(&r, sizeof(r));
+            rest.translation = { r.translation[0], r.translation[1], r.translation[2] };
+            rest.rotation = Math::quat(r.rotation[3], r.rotation[0], r.rotation[1], r.rotation[2]);
+            rest.scale = { r.scale[0], r.scale[1], r.scale[2] };
+        }
+
+        clip.tracks.resize(header.trackCount);
+        for (auto& track : clip.tracks)
+        {
+            AnimationTrackRecord r;
+            read(&r, sizeof(r));
+            track.bone = r.bone;
+            track.path = AnimationPath(r.path);
+            track.step = r.step;
+            track.keyOffset = r.keyOffset;
+            track.keyCount = r.keyCount;
+            track.valueOffset = r.valueOffset;
+
+            uint64_t valueCount = track.path == AnimationPath::Rotation ? header.rotationKeyCount : header.vectorKeyCount;
+            if (r.path > (uint8_t)AnimationPath::Scale || track.bone >= header.boneCount ||
+                uint64_t(track.keyOffset) + track.keyCount > header.timeCount || uint64_t(track.valueOffset) + track.keyCount > valueCount)
+                return false;
+        }
+
+        clip.times.resize(header.timeCount);
+        read(clip.times.data(), header.timeCount * sizeof(float));
+
+        clip.vectorKeys.resize(header.vectorKeyCount);
+        for (auto& key : clip.vectorKeys)
+        {
+            float v[3];
+            read(v, sizeof(v));
+            key = { v[0], v[1], v[2] };
+        }
+
+        clip.rotationKeys.resize(header.rotationKeyCount);
+        read(clip.rotationKeys.data(), header.rotationKeyCount * sizeof(uint64_t));
+
+        return true;
+    }
+
+#pragma endregion
+
+#pragma region Importer
+
+    AnimationClipImporter::AnimationClipImporter(AssetManager* pAssetManager)
+        : assetManager(pAssetManager)
+    {
+    }
+
+    static bool WriteAnimationClip(const AnimationClip& clip, const std::filesystem::path& path)
+    {
+        std::vector<uint8_t> data;
+        SerializeAnimationClip(clip, data);
+
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        if (!stream.is_open())
+        {
+            HE_ERROR("AnimationClipImporter : unable to open {} for writing", path.string());
+            return false;
+        }
+
+        stream.write((const char*)data.data(), data.size());
+        return true;
+    }
+
+    Asset AnimationClipImporter::Import(AssetHandle handle, const std::filesystem::path& filePath)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        auto path = assetManager->desc.assetsDirectory / filePath;
+        auto file = MappedFile::Open(path, false);
+        if (!file)
+            return {};
+
+        Asset asset = assetManager->CreateAsset(handle);
+        auto& assetState = asset.Get<AssetState>();
+        auto& clip = asset.Add<AnimationClip>();
+
+        assetState = AssetState::Loading;
+
+        if (!DeserializeAnimationClip(std::span<const uint8_t>(file->data, file->size), clip))
+        {
+            HE_ERROR("AnimationClipImporter : invalid animation clip {}", path.string());
+            assetManager->DestroyAsset(asset);
+            return {};
+        }
+
+        assetState = AssetState::Loaded;
+        assetManager->OnAssetLoaded(asset);
+
+        HE_INFO("Import AnimationClip [{}][{} tracks][{}ms]", path.filename().string(), clip.tracks.size(), t.ElapsedMilliseconds());
+
+        return asset;
+    }
+
+    void AnimationClipImporter::Save(Asset asset, const std::filesystem::path& filePath)
+    {
+        auto& clip = asset.Get<AnimationClip>();
+        WriteAnimationClip(clip, assetManager->desc.assetsDirectory / filePath);
+    }
+
+    Asset AnimationClipImporter::Create(AssetHandle handle, const std::filesystem::path& filePath)
+    {
+        Asset asset = assetManager->CreateAsset(handle);
+        auto& clip = asset.Add<AnimationClip>();
+
+        WriteAnimationClip(clip, assetManager->desc.assetsDirectory / filePath);
+        return asset;
+    }
+
+#pragma endregion
+}
@@ -21,7 +21,11 @@ namespace Assets {
         else if (extension == ".jpg")             return AssetType::Texture2D;
         else if (extension == ".hdr")             return AssetType::Texture2D;
         else if (extension == ".exr")             return AssetType::Texture2D;
+        else if (extension == ".dds")             return AssetType::Texture2D;
+        else if (extension == ".ktx2")            return AssetType::Texture2D;
         else if (extension == ".glb")             return AssetType::MeshSource;
+        else if (extension == ".gltf")            return AssetType::MeshSource;
+        else if (extension == ".hmesh")           return AssetType::MeshSource;
         else if (extension == ".mp3")             return AssetType::AudioSource;
         else if (extension == ".wav")             return AssetType::AudioSource;
         else if (extension == ".material")        return AssetType::Material;
@@ -35,9 +39,10 @@ namespace Assets {
 
     void AssetImporter::Init(AssetManager* assetManager)
     {
-        importers[(int)AssetType::Texture2D]  = HE::CreateScope<TextureImporter>(assetManager);
-        importers[(int)AssetType::Scene]      = HE::CreateScope<SceneImporter>(assetManager);
-        importers[(int)AssetType::MeshSource] = HE::CreateScope<MeshSourceImporter>(assetManager);
+        importers[(int)AssetType::Texture2D]     = HE::CreateScope<TextureImporter>(assetManager);
+        importers[(int)AssetType::Scene]         = HE::CreateScope<SceneImporter>(assetManager);
+        importers[(int)AssetType::MeshSource]    = HE::CreateScope<MeshSourceImporter>(assetManager);
+        importers[(int)AssetType::AnimationClip] = HE::CreateScope<AnimationClipImporter>(assetManager);
     }
 
     Asset AssetImporter::ImportAsset(AssetHandle handle, const std::filesystem::path& filePath, AssetImportingMode mode)
@@ -115,13 +120,15 @@ namespace Assets {
         , desc(pDesc)
     {
         assetImporter.Init(this);
+        textureStreamer.assetManager = this;
     }
 
     void AssetManager::Init(nvrhi::DeviceHandle pDevice, const AssetManagerDesc& pDesc)
     {
-      device = pDevice;
-      desc = pDesc;
-      assetImporter.Init(this);
+        device = pDevice;
+        desc = pDesc;
+        assetImporter.Init(this);
+        textureStreamer.assetManager = this;
     }
 
     Asset AssetManager::GetAsset(AssetHandle handle)
@@ -317,6 +324,7 @@ namespace Assets {
                 UnloadAsset(handle);
         }
 
+        textureStreamer.Remove(handle);
         DestroyAsset(asset);
     }
 
@@ -358,6 +366,7 @@ namespace Assets {
         for (auto& [id, subscriber] : subscribers)
             subscriber->OnAssetRemoved(handle);
 
+        textureStreamer.Remove(handle);
         DestroyAsset(handle);
         UnRegisterMetadata(handle);
         Serialize();
@@ -593,6 +602,7 @@ namespace Assets {
         metaMap.clear();
         pathToHandleMap.clear();
         subscribers.clear();
+        textureStreamer.Clear();
         asyncTaskCount = 0;
     }
 }
\ No newline at end of file
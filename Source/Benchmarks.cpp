@@ -0,0 +1,723 @@
+#include "HydraEngine/Base.h"
+
+import Assets;
+import HE;
+import nvrhi;
+import Math;
+import magic_enum;
+import std;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+    // best of the runs, the first one also warms the caches and the job system. reset runs untimed before each run.
+    template<typename R, typename F>
+    static double MeasureMilliseconds(uint32_t runs, R&& reset, F&& f)
+    {
+        double best = std::numeric_limits<double>::max();
+        for (uint32_t run = 0; run < std::max(runs, 1u); run++)
+        {
+            reset();
+
+            HE::Timer t;
+            f();
+            best = std::min(best, (double)t.ElapsedMilliseconds());
+        }
+
+        return best;
+    }
+
+    template<typename F>
+    static double MeasureMilliseconds(uint32_t runs, F&& f)
+    {
+        return MeasureMilliseconds(runs, []() {}, std::forward<F>(f));
+    }
+
+    void LogBenchmarkResults(std::span<const BenchmarkResult> results)
+    {
+        for (const auto& r : results)
+        {
+            std::string quality = r.quality > 0.0 ? std::format("[{:.2f} dB]", r.quality) : std::string();
+            std::string detail = r.detail.empty() ? std::string() : std::format("[{}]", r.detail);
+            HE_INFO("Benchmark {} [{:.3f}ms][{:.2f} {}/s]{}{}", r.name, r.milliseconds, r.throughput, r.unit, quality, detail);
+        }
+    }
+
+#pragma region Texture Compression
+
+    using DecodedBlock = std::array<std::array<uint8_t, 4>, 16>;
+
+    // BC bit fields are little endian, least significant bit first
+    struct BlockBitReader
+    {
+        const uint8_t* block;
+        uint32_t position = 0;
+
+        uint32_t Read(uint32_t count)
+        {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < count; i++, position++)
+                value |= uint32_t((block[position >> 3] >> (position & 7)) & 1) << i;
+
+            return value;
+        }
+    };
+
+    // the color block of BC3 always interpolates 4 colors, BC1 switches to 3 colors and transparent black when c0 <= c1
+    static void DecodeBC1(const uint8_t* block, bool isBC1, DecodedBlock& texels)
+    {
+        const uint16_t c0 = uint16_t(block[0] | block[1] << 8);
+        const uint16_t c1 = uint16_t(block[2] | block[3] << 8);
+
+        int palette[4][4];
+        for (int e = 0; e < 2; e++)
+        {
+            const uint16_t c = e == 0 ? c0 : c1;
+            const int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+            palette[e][0] = (r << 3) | (r >> 2);
+            palette[e][1] = (g << 2) | (g >> 4);
+            palette[e][2] = (b << 3) | (b >> 2);
+            palette[e][3] = 255;
+        }
+
+        const bool fourColors = !isBC1 || c0 > c1;
+        for (int c = 0; c < 3; c++)
+        {
+            palette[2][c] = fourColors ? (2 * palette[0][c] + palette[1][c]) / 3 : (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = fourColors ? (palette[0][c] + 2 * palette[1][c]) / 3 : 0;
+        }
+        palette[2][3] = 255;
+        palette[3][3] = fourColors ? 255 : 0;
+
+        const uint32_t indices = uint32_t(block[4]) | uint32_t(block[5]) << 8 | uint32_t(block[6]) << 16 | uint32_t(block[7]) << 24;
+        for (int i = 0; i < 16; i++)
+        {
+            const int index = (indices >> (2 * i)) & 3;
+            for (int c = 0; c < (isBC1 ? 4 : 3); c++)
+                texels[i][c] = uint8_t(palette[index][c]);
+        }
+    }
+
+    static void DecodeBC4(const uint8_t* block, int channel, DecodedBlock& texels)
+    {
+        const int e0 = block[0], e1 = block[1];
+
+        int palette[8] = { e0, e1 };
+        if (e0 > e1)
+        {
+            for (int i = 1; i < 7; i++)
+                palette[i + 1] = ((7 - i) * e0 + i * e1) / 7;
+        }
+        else
+        {
+            for (int i = 1; i < 5; i++)
+                palette[i + 1] = ((5 - i) * e0 + i * e1) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        BlockBitReader bits = { block, 16 };
+        for (int i = 0; i < 16; i++)
+            texels[i][channel] = uint8_t(palette[bits.Read(3)]);
+    }
+
+    // mode 6 only, the only mode the encoder writes
+    static bool DecodeBC7(const uint8_t* block, DecodedBlock& texels)
+    {
+        constexpr uint8_t weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+        BlockBitReader bits = { block };
+        if (bits.Read(7) != 1u << 6)
+            return false;
+
+        int endpoints[2][4];
+        for (int c = 0; c < 4; c++)
+        {
+            endpoints[0][c] = bits.Read(7) << 1;
+            endpoints[1][c] = bits.Read(7) << 1;
+        }
+
+        for (int e = 0; e < 2; e++)
+        {
+            const uint32_t p = bits.Read(1);
+            for (int c = 0; c < 4; c++)
+                endpoints[e][c] |= p;
+        }
+
+        for (int i = 0; i < 16; i++)
+        {
+            const uint32_t w = weights[bits.Read(i == 0 ? 3 : 4)];
+            for (int c = 0; c < 4; c++)
+                texels[i][c] = uint8_t(((64 - w) * endpoints[0][c] + w * endpoints[1][c] + 32) >> 6);
+        }
+
+        return true;
+    }
+
+    // level 0 decoded back with the reference decoders, over the channels the format stores
+    static double MeasurePSNR(const MipChain& source, const MipChain& compressed)
+    {
+        uint32_t channels = 4;
+        switch (compressed.compression)
+        {
+        case TextureCompression::BC1: channels = 3; break;
+        case TextureCompression::BC4: channels = 1; break;
+        case TextureCompression::BC5: channels = 2; break;
+        default: break;
+        }
+
+        const uint32_t blocksX = (compressed.width + 3) / 4;
+        const uint32_t blocksY = compressed.GetLevelRowCount(0);
+        const size_t blockSize = compressed.GetLevelRowPitch(0) / blocksX;
+        const uint8_t* rgba = source.GetLevelData(0);
+
+        double squaredError = 0.0;
+        uint64_t count = 0;
+        for (uint32_t by = 0; by < blocksY; by++)
+        {
+            for (uint32_t bx = 0; bx < blocksX; bx++)
+            {
+                const uint8_t* block = compressed.GetLevelData(0) + (size_t(by) * blocksX + bx) * blockSize;
+
+                DecodedBlock texels = {};
+                switch (compressed.compression)
+                {
+                case TextureCompression::BC1: DecodeBC1(block, true, texels); break;
+                case TextureCompression::BC3: DecodeBC4(block, 3, texels); DecodeBC1(block + 8, false, texels); break;
+                case TextureCompression::BC4: DecodeBC4(block, 0, texels); break;
+                case TextureCompression::BC5: DecodeBC4(block, 0, texels); DecodeBC4(block + 8, 1, texels); break;
+                case TextureCompression::BC7:
+                    if (!DecodeBC7(block, texels))
+                        return 0.0;
+                    break;
+                default: return 0.0;
+                }
+
+                for (uint32_t i = 0; i < 16; i++)
+                {
+                    const uint32_t x = bx * 4 + i % 4, y = by * 4 + i / 4;
+                    if (x >= source.width || y >= source.height)
+                        continue;
+
+                    const uint8_t* texel = rgba + (size_t(y) * source.width + x) * 4;
+                    for (uint32_t c = 0; c < channels; c++)
+                    {
+                        const double e = double(texels[i][c]) - double(texel[c]);
+                        squaredError += e * e;
+                    }
+                    count += channels;
+                }
+            }
+        }
+
+        const double mse = squaredError / double(std::max(count, uint64_t(1)));
+        return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+    }
+
+    std::vector<BenchmarkResult> BenchmarkTextureCompression(const MipChain& chain, uint32_t runs)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        if (chain.compression != TextureCompression::None || chain.GetLevelCount() == 0 || chain.width % 4 || chain.height % 4)
+        {
+            HE_ERROR("BenchmarkTextureCompression : needs an RGBA8 chain with a size multiple of 4");
+            return {};
+        }
+
+        MipChain level0;
+        InitMipChain(level0, chain.width, chain.height, 1, TextureCompression::None);
+        std::memcpy(level0.data.data(), chain.GetLevelData(0), level0.data.size());
+
+        std::vector<BenchmarkResult> results;
+        for (auto compression : { TextureCompression::BC1, TextureCompression::BC3, TextureCompression::BC4, TextureCompression::BC5, TextureCompression::BC7 })
+        {
+            MipChain compressed;
+            const double ms = MeasureMilliseconds(runs, [&]() { CompressMipChain(level0, compression, compressed); });
+
+            auto& r = results.emplace_back();
+            r.name = std::format("CompressMipChain {}", magic_enum::enum_name(compression));
+            r.milliseconds = ms;
+            r.throughput = double(level0.width) * level0.height / (ms * 1000.0);
+            r.unit = "Mpix";
+            r.quality = MeasurePSNR(level0, compressed);
+        }
+
+        return results;
+    }
+
+    std::vector<BenchmarkResult> BenchmarkTextureCompression(const std::filesystem::path& imagePath, uint32_t runs)
+    {
+        HE::Image image(imagePath);
+        if (!image.GetData())
+        {
+            HE_ERROR("BenchmarkTextureCompression : unable to load {}", imagePath.string());
+            return {};
+        }
+
+        MipChain chain;
+        InitMipChain(chain, image.GetWidth(), image.GetHeight(), 1, TextureCompression::None);
+        std::memcpy(chain.data.data(), image.GetData(), chain.data.size());
+
+        return BenchmarkTextureCompression(chain, runs);
+    }
+
+#pragma endregion
+
+#pragma region Meshlets
+
+    static Math::box3 GetSourceBounds(const MeshSource& meshSource)
+    {
+        Math::box3 bounds = Math::box3::empty();
+        for (const auto& mesh : meshSource.meshes)
+            bounds |= mesh.aabb;
+
+        return bounds;
+    }
+
+    // evenly spread around the center, slightly above it
+    static Math::float3 GetRingPosition(const Math::float3& center, float distance, uint32_t index, uint32_t count)
+    {
+        const float angle = 6.2831853f * float(index) / float(std::max(count, 1u));
+        return center + Math::float3(std::cos(angle), 0.25f, std::sin(angle)) * distance;
+    }
+
+    // inward planes of a symmetric perspective frustum, built from the camera basis
+    static std::array<Math::float4, 6> MakeFrustumPlanes(const Math::float3& position, const Math::float3& forward, float fovY, float aspect, float zNear, float zFar)
+    {
+        const Math::float3 right = Math::normalize(Math::cross(forward, Math::float3(0.0f, 1.0f, 0.0f)));
+        const Math::float3 up = Math::cross(right, forward);
+        const float halfY = fovY * 0.5f;
+        const float halfX = std::atan(std::tan(halfY) * aspect);
+
+        auto plane = [](const Math::float3& normal, const Math::float3& point) { return Math::float4(normal, -Math::dot(normal, point)); };
+
+        return {
+            plane(Math::normalize(right * std::cos(halfX) + forward * std::sin(halfX)), position),
+            plane(Math::normalize(-right * std::cos(halfX) + forward * std::sin(halfX)), position),
+            plane(Math::normalize(up * std::cos(halfY) + forward * std::sin(halfY)), position),
+            plane(Math::normalize(-up * std::cos(halfY) + forward * std::sin(halfY)), position),
+            plane(forward, position + forward * zNear),
+            plane(-forward, position + forward * zFar),
+        };
+    }
+
+    std::vector<BenchmarkResult> BenchmarkMeshletCulling(const MeshSource& meshSource, uint32_t viewCount, uint32_t runs)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        if (meshSource.meshlets.empty() || viewCount == 0)
+        {
+            HE_ERROR("BenchmarkMeshletCulling : the source has no meshlets, import it with generateMeshlets");
+            return {};
+        }
+
+        const Math::box3 bounds = GetSourceBounds(meshSource);
+        const Math::float3 center = (bounds.m_mins + bounds.m_maxs) * 0.5f;
+        const float radius = std::max(Math::length(bounds.m_maxs - bounds.m_mins) * 0.5f, 0.001f);
+
+        std::vector<Math::float3> positions(viewCount);
+        std::vector<std::array<Math::float4, 6>> planes(viewCount);
+        for (uint32_t v = 0; v < viewCount; v++)
+        {
+            positions[v] = GetRingPosition(center, radius, v, viewCount);
+            planes[v] = MakeFrustumPlanes(positions[v], Math::normalize(center - positions[v]), 1.0472f, 16.0f / 9.0f, radius * 0.01f, radius * 4.0f);
+        }
+
+        std::vector<uint32_t> visible;
+        visible.reserve(meshSource.meshlets.size());
+        const double ms = MeasureMilliseconds(runs, [&]() {
+            for (uint32_t v = 0; v < viewCount; v++)
+            {
+                visible.clear();
+                CullMeshlets(meshSource.meshlets, positions[v], planes[v], visible);
+            }
+        });
+
+        uint64_t totalTriangles = 0, visibleTriangles = 0;
+        for (const auto& meshlet : meshSource.meshlets)
+            totalTriangles += meshlet.triangleCount;
+
+        for (uint32_t v = 0; v < viewCount; v++)
+        {
+            visible.clear();
+            CullMeshlets(meshSource.meshlets, positions[v], planes[v], visible);
+            for (uint32_t i : visible)
+                visibleTriangles += meshSource.meshlets[i].triangleCount;
+        }
+
+        BenchmarkResult r;
+        r.name = "CullMeshlets";
+        r.milliseconds = ms;
+        r.throughput = double(meshSource.meshlets.size()) * viewCount / (ms * 1000.0);
+        r.unit = "Mmeshlets";
+        r.detail = std::format("{} views, {:.1f}% of the triangles culled", viewCount, 100.0 * (1.0 - double(visibleTriangles) / double(std::max(totalTriangles * viewCount, uint64_t(1)))));
+
+        return { r };
+    }
+
+#pragma endregion
+
+#pragma region LOD
+
+    std::vector<BenchmarkResult> BenchmarkLODs(MeshSource& meshSource, uint32_t lodCount, float reduction, float maxError, uint32_t runs)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        if (!meshSource.HasCpuGeometry())
+        {
+            HE_ERROR("BenchmarkLODs : the source has no CPU geometry");
+            return {};
+        }
+
+        // BuildLODs replaces the LODs of the source, which are restored afterwards
+        const std::vector<uint32_t> indices(meshSource.cpuIndexBuffer.begin(), meshSource.cpuIndexBuffer.end());
+        const std::vector<MeshGeometryLOD> lods = meshSource.lods;
+        const std::vector<MeshGeometry> geometries = meshSource.geometries;
+
+        size_t baseIndexCount = indices.size();
+        for (const auto& lod : lods)
+            baseIndexCount = std::min(baseIndexCount, (size_t)lod.indexOffset);
+
+        const double ms = MeasureMilliseconds(runs, [&]() { BuildLODs(meshSource, lodCount, reduction, maxError); });
+
+        BenchmarkResult r;
+        r.name = "BuildLODs";
+        r.milliseconds = ms;
+        r.throughput = double(baseIndexCount / 3) / (ms * 1000.0);
+        r.unit = "Mtri";
+        r.detail = std::format("{} geometries, {} LODs, {} extra indices", meshSource.geometries.size(), meshSource.lods.size(), meshSource.cpuIndexBuffer.size() - baseIndexCount);
+
+        meshSource.cpuIndexBuffer = std::vector<uint32_t>(indices.begin(), indices.end());
+        meshSource.lods = lods;
+        meshSource.geometries = geometries;
+
+        return { r };
+    }
+
+#pragma endregion
+
+#pragma region Vertex Layout
+
+    // indexed fetch of the attributes a raster pass reads together, the way a vertex shader walks the buffer
+    static uint64_t FetchVertices(MeshSource& meshSource)
+    {
+        constexpr VertexAttribute attributes[] = { VertexAttribute::Position, VertexAttribute::Normal, VertexAttribute::TexCoord0 };
+
+        const uint8_t* streams[3] = {};
+        uint32_t strides[3] = {};
+        uint32_t sizes[3] = {};
+        for (int a = 0; a < 3; a++)
+        {
+            if (!meshSource.HasAttribute(attributes[a]))
+                continue;
+
+            streams[a] = meshSource.cpuVertexBuffer.data() + meshSource.vertexBufferRanges[int(attributes[a])].byteOffset;
+            strides[a] = meshSource.GetVertexStride(attributes[a]);
+            sizes[a] = meshSource.GetVertexElementSize(attributes[a]);
+        }
+
+        uint64_t sum = 0;
+        for (auto& mesh : meshSource.meshes)
+        {
+            for (auto& geometry : mesh.GetGeometrySpan(meshSource))
+            {
+                if (geometry.type != MeshGeometryPrimitiveType::Triangles || geometry.indexCount == 0)
+                    continue;
+
+                const uint32_t* indices = geometry.Getindices(meshSource);
+                const uint64_t firstVertex = mesh.vertexOffset + geometry.vertexOffsetInMesh;
+                for (uint32_t i = 0; i < geometry.indexCount; i++)
+                {
+                    const uint64_t vertex = firstVertex + indices[i];
+                    for (int a = 0; a < 3; a++)
+                    {
+                        const uint8_t* element = streams[a] + vertex * strides[a];
+                        for (uint32_t offset = 0; offset < sizes[a]; offset += 4)
+                        {
+                            uint32_t value = 0;
+                            std::memcpy(&value, element + offset, std::min(sizes[a] - offset, 4u));
+                            sum += value;
+                        }
+                    }
+                }
+            }
+        }
+
+        return sum;
+    }
+
+    std::vector<BenchmarkResult> BenchmarkVertexLayouts(MeshSource& meshSource, uint32_t runs)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        if (!meshSource.HasCpuGeometry())
+        {
+            HE_ERROR("BenchmarkVertexLayouts : the source has no CPU geometry");
+            return {};
+        }
+
+        uint64_t indexCount = 0;
+        for (const auto& geometry : meshSource.geometries)
+        {
+            if (geometry.type == MeshGeometryPrimitiveType::Triangles)
+                indexCount += geometry.indexCount;
+        }
+
+        const VertexLayout originalLayout = meshSource.vertexLayout;
+
+        std::vector<BenchmarkResult> results;
+        for (auto layout : { VertexLayout::Separate, VertexLayout::Interleaved, VertexLayout::Hybrid })
+        {
+            if (meshSource.vertexLayout != layout)
+                SetVertexLayout(meshSource, layout);
+
+            // the sum keeps the fetches from being optimized away
+            uint64_t sum = 0;
+            const double ms = MeasureMilliseconds(runs, [&]() { sum += FetchVertices(meshSource); });
+
+            auto& r = results.emplace_back();
+            r.name = std::format("FetchVertices {}", magic_enum::enum_name(layout));
+            r.milliseconds = ms;
+            r.throughput = double(indexCount) / (ms * 1000.0);
+            r.unit = "Mvertices";
+            r.detail = std::format("stride {}, checksum {:x}", meshSource.vertexStride, sum);
+        }
+
+        if (meshSource.vertexLayout != originalLayout)
+            SetVertexLayout(meshSource, originalLayout);
+
+        return results;
+    }
+
+#pragma endregion
+
+#pragma region BVH
+
+    std::vector<BenchmarkResult> BenchmarkBVH(MeshSource& meshSource, uint32_t rayCount, uint32_t runs)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        if (!meshSource.HasCpuGeometry() || meshSource.meshes.empty() || rayCount == 0)
+        {
+            HE_ERROR("BenchmarkBVH : the source has no CPU geometry");
+            return {};
+        }
+
+        uint64_t triangleCount = 0;
+        for (const auto& geometry : meshSource.geometries)
+        {
+            if (geometry.type == MeshGeometryPrimitiveType::Triangles)
+                triangleCount += (geometry.indexCount ? geometry.indexCount : geometry.vertexCount) / 3;
+        }
+
+        std::vector<BenchmarkResult> results;
+
+        const double buildMs = MeasureMilliseconds(runs, [&]() { BuildBVH(meshSource); });
+        {
+            size_t nodeCount = 0;
+            for (const auto& bvh : meshSource.bvhs)
+                nodeCount += bvh.nodes.size();
+
+            auto& r = results.emplace_back();
+            r.name = "BuildBVH";
+            r.milliseconds = buildMs;
+            r.throughput = double(triangleCount) / (buildMs * 1000.0);
+            r.unit = "Mtri";
+            r.detail = std::format("{} triangles, {} nodes", triangleCount, nodeCount);
+        }
+
+        // from a ring around the bounds toward random points inside them, the same rays for every run
+        const Math::box3 bounds = GetSourceBounds(meshSource);
+        const Math::float3 center = (bounds.m_mins + bounds.m_maxs) * 0.5f;
+        const float radius = std::max(Math::length(bounds.m_maxs - bounds.m_mins) * 0.5f, 0.001f);
+
+        std::mt19937 random(1234);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        std::vector<Ray> rays(rayCount);
+        for (uint32_t i = 0; i < rayCount; i++)
+        {
+            const Math::float3 target = bounds.m_mins + (bounds.m_maxs - bounds.m_mins) * Math::float3(unit(random), unit(random), unit(random));
+            rays[i].origin = GetRingPosition(center, radius * 1.5f, i, rayCount);
+            rays[i].direction = Math::normalize(target - rays[i].origin);
+        }
+
+        std::vector<RayHit> hits(rayCount);
+        auto resetHits = [&]() { std::fill(hits.begin(), hits.end(), RayHit()); };
+
+        const double singleMs = MeasureMilliseconds(runs, resetHits, [&]() {
+            for (uint32_t i = 0; i < rayCount; i++)
+                meshSource.Raycast(rays[i], hits[i]);
+        });
+
+        const double batchMs = MeasureMilliseconds(runs, resetHits, [&]() { meshSource.RaycastBatch(rays, hits); });
+
+        const size_t hitCount = std::count_if(hits.begin(), hits.end(), [](const RayHit& hit) { return hit.meshIndex != c_Invalid; });
+        const std::string detail = std::format("{} rays, {:.1f}% hit", rayCount, 100.0 * double(hitCount) / double(rayCount));
+
+        results.push_back({ "Raycast", singleMs, double(rayCount) / (singleMs * 1000.0), "Mrays", 0.0, detail });
+        results.push_back({ "RaycastBatch", batchMs, double(rayCount) / (batchMs * 1000.0), "Mrays", 0.0, detail });
+
+        return results;
+    }
+
+#pragma endregion
+
+#pragma region Animation
+
+    std::vector<BenchmarkResult> BenchmarkAnimationSampling(const AnimationClip& clip, uint32_t instanceCount, uint32_t runs)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        const uint32_t boneCount = clip.GetBoneCount();
+        if (boneCount == 0 || instanceCount == 0)
+        {
+            HE_ERROR("BenchmarkAnimationSampling : the clip has no bones");
+            return {};
+        }
+
+        // every instance at its own phase of the clip
+        std::vector<float> times(instanceCount);
+        for (uint32_t i = 0; i < instanceCount; i++)
+            times[i] = clip.duration * float(i) / float(instanceCount);
+
+        std::vector<BoneTransform> poses(size_t(instanceCount) * boneCount);
+        const double ms = MeasureMilliseconds(runs, [&]() { SampleAnimationClip(clip, times, poses); });
+
+        BenchmarkResult r;
+        r.name = std::format("SampleAnimationClip {}", clip.name);
+        r.milliseconds = ms;
+        r.throughput = double(poses.size()) / (ms * 1000.0);
+        r.unit = "Mbones";
+        r.detail = std::format("{} instances x {} bones, {} tracks, {} keys", instanceCount, boneCount, clip.tracks.size(), clip.times.size());
+
+        return { r };
+    }
+
+    std::vector<BenchmarkResult> BenchmarkAnimationSampling(uint32_t instanceCount, uint32_t boneCount, uint32_t runs)
+    {
+        // 2 seconds at 30 frames per second, smooth motion on every path so key reduction keeps a realistic share of the keys
+        constexpr uint32_t frameCount = 61;
+
+        AnimationClip clip;
+        clip.name = "Synthetic";
+        clip.duration = 2.0f;
+        clip.boneNodes.resize(boneCount);
+        clip.restPose.resize(boneCount);
+
+        std::vector<float> times(frameCount);
+        for (uint32_t f = 0; f < frameCount; f++)
+            times[f] = clip.duration * float(f) / float(frameCount - 1);
+
+        std::vector<Math::float4> values(frameCount);
+        for (uint32_t bone = 0; bone < boneCount; bone++)
+        {
+            clip.boneNodes[bone] = bone;
+            const float phase = float(bone) * 0.37f;
+
+            for (uint32_t f = 0; f < frameCount; f++)
+                values[f] = Math::float4(std::sin(times[f] * 3.0f + phase) * 0.1f, 1.0f, 0.0f, 0.0f);
+            AppendAnimationTrack(clip, bone, AnimationPath::Translation, false, times, values, 0.0001f);
+
+            for (uint32_t f = 0; f < frameCount; f++)
+            {
+                const float angle = std::sin(times[f] * 2.0f + phase) * 0.5f;
+                values[f] = Math::float4(std::sin(angle * 0.5f), 0.0f, 0.0f, std::cos(angle * 0.5f));
+            }
+            AppendAnimationTrack(clip, bone, AnimationPath::Rotation, false, times, values, 0.0001f);
+
+            for (uint32_t f = 0; f < frameCount; f++)
+                values[f] = Math::float4(Math::float3(1.0f + std::sin(times[f] * 4.0f + phase) * 0.05f), 0.0f);
+            AppendAnimationTrack(clip, bone, AnimationPath::Scale, false, times, values, 0.0001f);
+        }
+
+        return BenchmarkAnimationSampling(clip, instanceCount, runs);
+    }
+
+#pragma endregion
+
+#pragma region Texture Streaming
+
+    // Drives the streamer without a device: a window of textures sweeps over the set requesting levels, the targets become
+    // resident at once. Every frame is checked against the budget, the feedback and the retention.
+    std::vector<BenchmarkResult> BenchmarkTextureStreaming(uint32_t textureCount, uint32_t frameCount, uint64_t budget)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        AssetManager assetManager;
+        auto& settings = assetManager.desc.textureImportSettings;
+        settings.streamingBudget = budget;
+
+        auto& streamer = assetManager.textureStreamer;
+        streamer.assetManager = &assetManager;
+
+        // BC7 layouts from 512 to 4096, nothing behind them
+        std::mt19937 random(7);
+        for (uint32_t i = 0; i < textureCount; i++)
+        {
+            auto layout = HE::CreateRef<TextureFile>();
+            auto& desc = layout->desc;
+            desc.width = desc.height = 512u << (random() % 4);
+            desc.format = nvrhi::Format::BC7_UNORM;
+            desc.mipLevels = GetMipLevelCount(desc.width, desc.height);
+
+            for (uint32_t level = 0; level < desc.mipLevels; level++)
+            {
+                auto& sub = layout->subresources.emplace_back();
+                sub.mipLevel = level;
+                sub.rowPitch = size_t((std::max(desc.width >> level, 1u) + 3) / 4) * 16;
+                sub.depthPitch = sub.rowPitch * ((std::max(desc.height >> level, 1u) + 3) / 4);
+            }
+
+            TextureStreamingEntry entry;
+            entry.Init(layout, settings.streamingTailSize);
+            entry.residentMip = entry.tailMip;
+            streamer.entries[AssetHandle(i + 1)] = std::move(entry);
+        }
+
+        const uint32_t visibleCount = std::max(textureCount / 8, 1u);
+        uint64_t peakSize = 0;
+        uint32_t violations = 0;
+        double milliseconds = 0.0;
+        for (uint32_t frame = 0; frame < frameCount; frame++)
+        {
+            const uint32_t first = frame * visibleCount / 32;
+            for (uint32_t v = 0; v < visibleCount; v++)
+                streamer.RequestMip(AssetHandle((first + v) % textureCount + 1), v % 3);
+
+            HE::Timer t;
+            const uint64_t targetSize = streamer.UpdateTargets();
+            milliseconds += t.ElapsedMilliseconds();
+
+            // the budget may only be exceeded by the tails, no target is finer than its feedback and stale textures sit at their tail
+            bool overBudget = budget != 0 && targetSize > budget;
+            for (auto& [handle, entry] : streamer.entries)
+            {
+                const bool isRequested = entry.lastRequestFrame + settings.streamingRetainFrames >= streamer.frameIndex;
+                if ((overBudget || !isRequested) && entry.targetMip < entry.tailMip)
+                    violations++;
+                if (isRequested && entry.targetMip < std::min(entry.requestedMip, entry.tailMip))
+                    violations++;
+
+                entry.residentMip = entry.targetMip;
+            }
+
+            peakSize = std::max(peakSize, targetSize);
+            streamer.frameIndex++;
+        }
+
+        if (violations)
+            HE_ERROR("BenchmarkTextureStreaming : {} targets broke the budget, the feedback or the retention", violations);
+
+        BenchmarkResult r;
+        r.name = "TextureStreamer::UpdateTargets";
+        r.milliseconds = milliseconds / std::max(frameCount, 1u);
+        r.throughput = double(textureCount) / (r.milliseconds * 1000.0);
+        r.unit = "Mtextures";
+        r.detail = std::format("{} textures, {} frames, peak {} MB of {} MB, {} violations", textureCount, frameCount, peakSize >> 20, budget >> 20, violations);
+
+        return { r };
+    }
+
+#pragma endregion
+}
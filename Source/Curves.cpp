@@ -0,0 +1,588 @@
+#include "HydraEngine/Base.h"
+
+import Assets;
+import HE;
+import Math;
+import std;
+import magic_enum;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+    struct CurvePoint
+    {
+        Math::float3 position;
+        float radius;
+    };
+
+    struct Strand
+    {
+        size_t pointOffset = 0;     // into the point list
+        uint32_t pointCount = 0;    // after simplification
+        uint32_t curve = 0;         // into the curve geometry list
+        uint32_t vertexOffset = 0;  // geometry local
+        uint32_t indexOffset = 0;   // geometry local
+        uint32_t segmentOffset = 0; // geometry local
+    };
+
+    struct CurveGeometry
+    {
+        uint32_t geometry = 0;      // into MeshSource::geometries
+        size_t strandOffset = 0;
+        size_t strandCount = 0;
+        uint64_t segmentBase = 0;   // into the segment bounds
+        uint32_t vertexCount = 0;
+        uint32_t indexCount = 0;
+        uint32_t segmentCount = 0;
+    };
+
+    struct CurveOutput
+    {
+        uint32_t verticesPerPoint = 1;
+        uint32_t indicesPerSegment = 2;
+    };
+
+    static CurveOutput GetCurveOutput(MeshType type, uint32_t tubeSides)
+    {
+        switch (type)
+        {
+        case MeshType::CurvePolytubes:                         return { tubeSides, tubeSides * 6 };
+        case MeshType::CurveDisjointOrthogonalTriangleStrips:  return { 4, 12 };
+        default:                                               return { 1, 2 };
+        }
+    }
+
+#pragma region Strands
+
+    // Lines are chained into a strand while a segment starts where the previous one ended, strips are one strand
+    static void ExtractStrands(MeshSource& meshSource, const MeshGeometry& geometry, std::vector<uint32_t>& vertices, std::vector<uint32_t>& strandSizes)
+    {
+        const uint32_t* indices = geometry.indexCount ? geometry.Getindices(meshSource) : nullptr;
+        const uint32_t count = geometry.indexCount ? geometry.indexCount : geometry.vertexCount;
+        auto at = [&](uint32_t i) { return indices ? indices[i] : i; };
+
+        auto closeStrand = [&](size_t start) {
+            size_t size = vertices.size() - start;
+            if (size < 2)
+                vertices.resize(start);
+            else
+                strandSizes.push_back((uint32_t)size);
+        };
+
+        if (geometry.type == MeshGeometryPrimitiveType::LineStrip)
+        {
+            for (uint32_t i = 0; i < count; i++)
+                vertices.push_back(at(i));
+            closeStrand(0);
+            return;
+        }
+
+        size_t start = 0;
+        for (uint32_t s = 0; s + 1 < count; s += 2)
+        {
+            uint32_t a = at(s);
+            uint32_t b = at(s + 1);
+            if (vertices.size() == start || vertices.back() != a)
+            {
+                closeStrand(start);
+                start = vertices.size();
+                vertices.push_back(a);
+            }
+            vertices.push_back(b);
+        }
+        closeStrand(start);
+    }
+
+    static float PointSegmentDistance(const Math::float3& p, const Math::float3& a, const Math::float3& b, float& t)
+    {
+        Math::float3 ab = b - a;
+        float lengthSq = Math::dot(ab, ab);
+        t = lengthSq > 0.0f ? std::clamp(Math::dot(p - a, ab) / lengthSq, 0.0f, 1.0f) : 0.0f;
+        return Math::length(p - (a + ab * t));
+    }
+
+    // Douglas-Peucker on position and radius, the kept points are moved to the front of the strand
+    static uint32_t SimplifyStrand(std::span<CurvePoint> points, float tolerance)
+    {
+        const uint32_t count = (uint32_t)points.size();
+        if (tolerance <= 0.0f || count <= 2)
+            return count;
+
+        std::vector<uint8_t> keep(count, 0);
+        keep[0] = keep[count - 1] = 1;
+
+        std::vector<std::pair<uint32_t, uint32_t>> stack = { { 0, count - 1 } };
+        while (!stack.empty())
+        {
+            auto [first, last] = stack.back();
+            stack.pop_back();
+
+            float maxError = 0.0f;
+            uint32_t split = first;
+            for (uint32_t i = first + 1; i < last; i++)
+            {
+                float t;
+                float distance = PointSegmentDistance(points[i].position, points[first].position, points[last].position, t);
+                float radius = std::abs(points[i].radius - std::lerp(points[first].radius, points[last].radius, t));
+                float error = std::max(distance, radius);
+                if (error > maxError)
+                {
+                    maxError = error;
+                    split = i;
+                }
+            }
+
+            if (maxError > tolerance)
+            {
+                keep[split] = 1;
+                stack.push_back({ first, split });
+                stack.push_back({ split, last });
+            }
+        }
+
+        uint32_t kept = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (keep[i])
+                points[kept++] = points[i];
+        }
+
+        return kept;
+    }
+
+#pragma endregion
+
+#pragma region Generation
+
+    struct CurveWriter
+    {
+        uint8_t* buffer;
+        const std::array<nvrhi::BufferRange, c_VertexAttributeCount>& ranges;
+        const std::array<VertexFormat, c_VertexAttributeCount>& formats;
+
+        void Write(VertexAttribute attr, uint64_t vertex, const Math::float4& value) const
+        {
+            if (ranges[int(attr)].byteSize == 0)
+                return;
+
+            VertexFormat format = formats[int(attr)];
+            EncodeVertexElement(format, value, buffer + ranges[int(attr)].byteOffset + vertex * GetVertexFormatSize(format));
+        }
+    };
+
+    static Math::float3 GetStrandTangent(std::span<const CurvePoint> points, uint32_t i)
+    {
+        uint32_t prev = i > 0 ? i - 1 : i;
+        uint32_t next = i + 1 < points.size() ? i + 1 : i;
+        Math::float3 d = points[next].position - points[prev].position;
+        float length = Math::length(d);
+        return length > 0.0f ? d / length : Math::float3(0.0f, 1.0f, 0.0f);
+    }
+
+    static Math::float3 GetPerpendicular(const Math::float3& t)
+    {
+        Math::float3 axis = std::abs(t.x) < 0.9f ? Math::float3(1.0f, 0.0f, 0.0f) : Math::float3(0.0f, 1.0f, 0.0f);
+        return Math::normalize(Math::cross(t, axis));
+    }
+
+    // Vertices and geometry local indices of one strand, the frame is parallel transported along the strand so tubes and ribbons do not twist
+    static void WriteStrand(
+        std::span<const CurvePoint> points,
+        MeshType type,
+        uint32_t tubeSides,
+        const CurveWriter& writer,
+        uint64_t firstVertex,       // in the new vertex buffer
+        uint32_t localVertex,       // geometry local index of the first vertex
+        uint32_t* indices,
+        Math::box3* segmentBounds
+    )
+    {
+        const uint32_t count = (uint32_t)points.size();
+        const CurveOutput output = GetCurveOutput(type, tubeSides);
+
+        float totalLength = 0.0f;
+        for (uint32_t i = 1; i < count; i++)
+            totalLength += Math::length(points[i].position - points[i - 1].position);
+
+        float length = 0.0f;
+        Math::float3 normal = GetPerpendicular(GetStrandTangent(points, 0));
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const CurvePoint& point = points[i];
+            if (i > 0)
+                length += Math::length(point.position - points[i - 1].position);
+
+            Math::float3 tangent = GetStrandTangent(points, i);
+            normal -= tangent * Math::dot(normal, tangent);
+            float normalLength = Math::length(normal);
+            normal = normalLength > 1e-6f ? normal / normalLength : GetPerpendicular(tangent);
+            Math::float3 bitangent = Math::cross(tangent, normal);
+
+            float u = totalLength > 0.0f ? length / totalLength : 0.0f;
+            uint64_t v = firstVertex + uint64_t(i) * output.verticesPerPoint;
+
+            auto writeVertex = [&](uint64_t vertex, const Math::float3& position, const Math::float3& n, float side) {
+                writer.Write(VertexAttribute::Position, vertex, Math::float4(position, 0.0f));
+                writer.Write(VertexAttribute::Normal, vertex, Math::float4(n, 0.0f));
+                writer.Write(VertexAttribute::Tangent, vertex, Math::float4(tangent, 1.0f));
+                writer.Write(VertexAttribute::TexCoord0, vertex, Math::float4(u, side, 0.0f, 0.0f));
+                writer.Write(VertexAttribute::Radius, vertex, Math::float4(point.radius, 0.0f, 0.0f, 0.0f));
+            };
+
+            switch (type)
+            {
+            case MeshType::CurvePolytubes:
+                for (uint32_t c = 0; c < tubeSides; c++)
+                {
+                    float angle = 2.0f * std::numbers::pi_v<float> * float(c) / float(tubeSides);
+                    Math::float3 direction = normal * std::cos(angle) + bitangent * std::sin(angle);
+                    writeVertex(v + c, point.position + direction * point.radius, direction, float(c) / float(tubeSides));
+                }
+                break;
+            case MeshType::CurveDisjointOrthogonalTriangleStrips:
+                writeVertex(v + 0, point.position - normal * point.radius, bitangent, 0.0f);
+                writeVertex(v + 1, point.position + normal * point.radius, bitangent, 1.0f);
+                writeVertex(v + 2, point.position - bitangent * point.radius, normal, 0.0f);
+                writeVertex(v + 3, point.position + bitangent * point.radius, normal, 1.0f);
+                break;
+            default:
+                writeVertex(v, point.position, normal, 0.0f);
+                break;
+            }
+        }
+
+        for (uint32_t s = 0; s + 1 < count; s++)
+        {
+            const CurvePoint& a = points[s];
+            const CurvePoint& b = points[s + 1];
+
+            Math::box3& bounds = segmentBounds[s];
+            bounds.m_mins = Math::min(a.position - Math::float3(a.radius), b.position - Math::float3(b.radius));
+            bounds.m_maxs = Math::max(a.position + Math::float3(a.radius), b.position + Math::float3(b.radius));
+
+            uint32_t v0 = localVertex + s * output.verticesPerPoint;
+            uint32_t v1 = v0 + output.verticesPerPoint;
+            uint32_t* dst = indices + size_t(s) * output.indicesPerSegment;
+
+            switch (type)
+            {
+            case MeshType::CurvePolytubes:
+                for (uint32_t c = 0; c < tubeSides; c++)
+                {
+                    uint32_t c2 = (c + 1) % tubeSides;
+                    uint32_t quad[6] = { v0 + c, v0 + c2, v1 + c, v0 + c2, v1 + c2, v1 + c };
+                    std::memcpy(dst + c * 6, quad, sizeof(quad));
+                }
+                break;
+            case MeshType::CurveDisjointOrthogonalTriangleStrips:
+            {
+                uint32_t quads[12] = {
+                    v0 + 0, v0 + 1, v1 + 0, v0 + 1, v1 + 1, v1 + 0,
+                    v0 + 2, v0 + 3, v1 + 2, v0 + 3, v1 + 3, v1 + 2,
+                };
+                std::memcpy(dst, quads, sizeof(quads));
+                break;
+            }
+            default:
+                dst[0] = v0;
+                dst[1] = v1;
+                break;
+            }
+        }
+    }
+
+#pragma endregion
+
+    void BuildCurves(MeshSource& meshSource, MeshType type, float tolerance, float radius, uint32_t chunkSegments, uint32_t tubeSides, bool keepRadius)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        if (type == MeshType::Triangles)
+            return;
+
+        if (!meshSource.lods.empty() || !meshSource.meshlets.empty())
+        {
+            HE_WARN("BuildCurves : must run before BuildLODs and BuildMeshlets, skipped");
+            return;
+        }
+
+        meshSource.AcquireCpuGeometry();
+
+        tubeSides = std::clamp(tubeSides, 3u, 16u);
+        chunkSegments = std::max(chunkSegments, 1u);
+        const CurveOutput output = GetCurveOutput(type, tubeSides);
+
+        std::vector<CurveGeometry> curves;
+        std::vector<uint32_t> curveIndex(meshSource.geometries.size(), c_Invalid);
+        for (uint32_t i = 0; i < (uint32_t)meshSource.geometries.size(); i++)
+        {
+            // morph deltas address the source vertices, morphed lines stay lines
+            const auto& geometry = meshSource.geometries[i];
+            bool isLine = geometry.type == MeshGeometryPrimitiveType::Lines || geometry.type == MeshGeometryPrimitiveType::LineStrip;
+            if (isLine && meshSource.meshes[geometry.mesh].morphTargetCount == 0)
+            {
+                curveIndex[i] = (uint32_t)curves.size();
+                curves.push_back({ .geometry = i });
+            }
+        }
+
+        if (curves.empty())
+            return;
+
+        // strands and their points, gathered per geometry in parallel then concatenated
+        std::vector<std::vector<CurvePoint>> curvePoints(curves.size());
+        std::vector<std::vector<uint32_t>> curveStrandSizes(curves.size());
+        const bool hasRadius = meshSource.HasAttribute(VertexAttribute::Radius);
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), curves.size(), size_t(1), [&](size_t c) {
+
+            const MeshGeometry& geometry = meshSource.geometries[curves[c].geometry];
+
+            std::vector<uint32_t> vertices;
+            ExtractStrands(meshSource, geometry, vertices, curveStrandSizes[c]);
+
+            auto positions = geometry.GetDecodedAttribute(meshSource, VertexAttribute::Position);
+            auto radii = hasRadius ? geometry.GetDecodedAttribute(meshSource, VertexAttribute::Radius) : DecodedVertexAttribute();
+
+            auto& points = curvePoints[c];
+            points.resize(vertices.size());
+            for (size_t i = 0; i < vertices.size(); i++)
+            {
+                uint32_t v = std::min(vertices[i], geometry.vertexCount - 1);
+                float r = hasRadius ? radii[v].x : 0.0f;
+                points[i] = { positions.GetFloat3(v), r > 0.0f ? r : radius };
+            }
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        std::vector<CurvePoint> points;
+        std::vector<Strand> strands;
+        size_t pointsBefore = 0;
+        for (size_t c = 0; c < curves.size(); c++)
+        {
+            curves[c].strandOffset = strands.size();
+            curves[c].strandCount = curveStrandSizes[c].size();
+
+            size_t offset = points.size();
+            for (uint32_t size : curveStrandSizes[c])
+            {
+                strands.push_back({ .pointOffset = offset, .pointCount = size, .curve = (uint32_t)c });
+                offset += size;
+            }
+
+            points.insert(points.end(), curvePoints[c].begin(), curvePoints[c].end());
+            pointsBefore += curvePoints[c].size();
+            std::vector<CurvePoint>().swap(curvePoints[c]);
+        }
+
+        tf.clear();
+        tf.for_each_index(size_t(0), strands.size(), size_t(1), [&](size_t s) {
+            Strand& strand = strands[s];
+            strand.pointCount = SimplifyStrand(std::span<CurvePoint>(points.data() + strand.pointOffset, strand.pointCount), tolerance);
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        // output sizes, strands are laid out back to back within their geometry
+        uint64_t segmentCount = 0;
+        size_t pointsAfter = 0;
+        for (auto& curve : curves)
+        {
+            uint64_t vertexCount = 0, indexCount = 0;
+            curve.segmentBase = segmentCount;
+
+            for (size_t s = curve.strandOffset; s < curve.strandOffset + curve.strandCount; s++)
+            {
+                Strand& strand = strands[s];
+                strand.vertexOffset = (uint32_t)vertexCount;
+                strand.indexOffset = (uint32_t)indexCount;
+                strand.segmentOffset = curve.segmentCount;
+
+                vertexCount += uint64_t(strand.pointCount) * output.verticesPerPoint;
+                indexCount += uint64_t(strand.pointCount - 1) * output.indicesPerSegment;
+                curve.segmentCount += strand.pointCount - 1;
+                pointsAfter += strand.pointCount;
+            }
+
+            HE_ASSERT(vertexCount <= std::numeric_limits<uint32_t>::max() && indexCount <= std::numeric_limits<uint32_t>::max());
+            curve.vertexCount = (uint32_t)vertexCount;
+            curve.indexCount = (uint32_t)indexCount;
+            segmentCount += curve.segmentCount;
+        }
+
+        // new offsets, the old ones are kept to copy the other geometries
+        std::vector<uint64_t> oldFirstVertex(meshSource.geometries.size());
+        std::vector<uint64_t> oldFirstIndex(meshSource.geometries.size());
+        uint64_t vertexCount = 0, indexCount = 0;
+        for (auto& mesh : meshSource.meshes)
+        {
+            const uint64_t oldVertexOffset = mesh.vertexOffset;
+            const uint64_t oldIndexOffset = mesh.indexOffset;
+            mesh.vertexOffset = vertexCount;
+            mesh.indexOffset = indexCount;
+            mesh.vertexCount = 0;
+            mesh.indexCount = 0;
+
+            uint32_t curveGeometryCount = 0;
+            for (auto& geometry : mesh.GetGeometrySpan(meshSource))
+            {
+                size_t g = &geometry - meshSource.geometries.data();
+                oldFirstVertex[g] = oldVertexOffset + geometry.vertexOffsetInMesh;
+                oldFirstIndex[g] = oldIndexOffset + geometry.indexOffsetInMesh;
+
+                if (curveIndex[g] != c_Invalid)
+                {
+                    const auto& curve = curves[curveIndex[g]];
+                    geometry.vertexCount = curve.vertexCount;
+                    geometry.indexCount = curve.indexCount;
+                    geometry.type = type == MeshType::CurveLinearSweptSpheres ? MeshGeometryPrimitiveType::Lines : MeshGeometryPrimitiveType::Triangles;
+                    curveGeometryCount++;
+                }
+
+                geometry.vertexOffsetInMesh = mesh.vertexCount;
+                geometry.indexOffsetInMesh = mesh.indexCount;
+                mesh.vertexCount += geometry.vertexCount;
+                mesh.indexCount += geometry.indexCount;
+            }
+
+            // a mesh mixing curves with triangles stays a triangle mesh, its curve geometries are the ones with a curveChunkCount
+            if (curveGeometryCount && curveGeometryCount == mesh.geometryCount)
+                mesh.type = type;
+            else if (curveGeometryCount)
+                HE_WARN("BuildCurves : mesh {} mixes curve and triangle geometries, kept as {}", mesh.name, magic_enum::enum_name(mesh.type));
+
+            vertexCount += mesh.vertexCount;
+            indexCount += mesh.indexCount;
+        }
+
+        // Separate layout, radius only where the representation needs it
+        std::array<nvrhi::BufferRange, c_VertexAttributeCount> ranges = {};
+        const bool writeRadius = type == MeshType::CurveLinearSweptSpheres || keepRadius;
+        uint64_t bufferSize = 0;
+        for (uint32_t a = 0; a < c_VertexAttributeCount; a++)
+        {
+            VertexAttribute attr = VertexAttribute(a);
+            bool present = attr == VertexAttribute::Radius ? writeRadius : meshSource.HasAttribute(attr) || attr == VertexAttribute::Normal || attr == VertexAttribute::Tangent || attr == VertexAttribute::TexCoord0;
+            if (!present)
+                continue;
+
+            uint64_t byteSize = vertexCount * meshSource.GetVertexElementSize(attr);
+            ranges[a] = nvrhi::BufferRange(bufferSize, byteSize);
+            bufferSize += byteSize;
+        }
+
+        std::vector<uint8_t> buffer(bufferSize);
+        std::vector<uint32_t> indices(indexCount);
+        std::vector<Math::box3> segmentBounds(segmentCount);
+        const CurveWriter writer = { buffer.data(), ranges, meshSource.vertexFormats };
+
+        tf.clear();
+        tf.for_each_index(size_t(0), meshSource.geometries.size(), size_t(1), [&](size_t g) {
+
+            if (curveIndex[g] != c_Invalid)
+                return;
+
+            const auto& geometry = meshSource.geometries[g];
+            const auto& mesh = meshSource.meshes[geometry.mesh];
+            uint64_t dstFirstVertex = mesh.vertexOffset + geometry.vertexOffsetInMesh;
+
+            for (uint32_t a = 0; a < c_VertexAttributeCount; a++)
+            {
+                if (ranges[a].byteSize == 0 || !meshSource.HasAttribute(VertexAttribute(a)))
+                    continue;
+
+                uint32_t size = meshSource.GetVertexElementSize(VertexAttribute(a));
+                uint32_t srcStride = meshSource.GetVertexStride(VertexAttribute(a));
+                const uint8_t* src = meshSource.cpuVertexBuffer.data() + meshSource.vertexBufferRanges[a].byteOffset + oldFirstVertex[g] * srcStride;
+                uint8_t* dst = buffer.data() + ranges[a].byteOffset + dstFirstVertex * size;
+
+                for (uint32_t v = 0; v < geometry.vertexCount; v++)
+                    std::memcpy(dst + size_t(v) * size, src + size_t(v) * srcStride, size);
+            }
+
+            const uint32_t* src = meshSource.cpuIndexBuffer.data() + oldFirstIndex[g];
+            std::copy(src, src + geometry.indexCount, indices.begin() + (mesh.indexOffset + geometry.indexOffsetInMesh));
+        });
+
+        tf.for_each_index(size_t(0), strands.size(), size_t(1), [&](size_t s) {
+
+            const Strand& strand = strands[s];
+            const CurveGeometry& curve = curves[strand.curve];
+            const auto& geometry = meshSource.geometries[curve.geometry];
+            const auto& mesh = meshSource.meshes[geometry.mesh];
+
+            WriteStrand(
+                std::span<const CurvePoint>(points.data() + strand.pointOffset, strand.pointCount),
+                type,
+                tubeSides,
+                writer,
+                mesh.vertexOffset + geometry.vertexOffsetInMesh + strand.vertexOffset,
+                strand.vertexOffset,
+                indices.data() + mesh.indexOffset + geometry.indexOffsetInMesh + strand.indexOffset,
+                segmentBounds.data() + curve.segmentBase + strand.segmentOffset
+            );
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        // chunks of consecutive segments may span strands, strands are contiguous in the index range
+        meshSource.curveChunks.clear();
+        for (auto& curve : curves)
+        {
+            auto& geometry = meshSource.geometries[curve.geometry];
+            geometry.curveChunkOffset = (uint32_t)meshSource.curveChunks.size();
+            geometry.curveChunkCount = (curve.segmentCount + chunkSegments - 1) / chunkSegments;
+
+            for (uint32_t first = 0; first < curve.segmentCount; first += chunkSegments)
+            {
+                auto& chunk = meshSource.curveChunks.emplace_back();
+                chunk.segmentCount = std::min(chunkSegments, curve.segmentCount - first);
+                chunk.indexOffset = first * output.indicesPerSegment;
+                chunk.indexCount = chunk.segmentCount * output.indicesPerSegment;
+            }
+        }
+
+        tf.clear();
+        tf.for_each_index(size_t(0), curves.size(), size_t(1), [&](size_t c) {
+
+            const auto& curve = curves[c];
+            auto& geometry = meshSource.geometries[curve.geometry];
+            geometry.aabb = Math::box3::empty();
+
+            for (auto& chunk : geometry.GetCurveChunkSpan(meshSource))
+            {
+                uint64_t first = curve.segmentBase + chunk.indexOffset / output.indicesPerSegment;
+                chunk.aabb = Math::box3::empty();
+                for (uint32_t s = 0; s < chunk.segmentCount; s++)
+                    chunk.aabb |= segmentBounds[first + s];
+
+                geometry.aabb |= chunk.aabb;
+            }
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        for (auto& mesh : meshSource.meshes)
+        {
+            if (mesh.type != type)
+                continue;
+
+            mesh.aabb = Math::box3::empty();
+            for (const auto& geometry : mesh.GetGeometrySpan(meshSource))
+                mesh.aabb |= geometry.aabb;
+        }
+
+        meshSource.cpuVertexBuffer = std::move(buffer);
+        meshSource.cpuIndexBuffer = std::move(indices);
+        meshSource.vertexBufferRanges = ranges;
+        meshSource.vertexLayout = VertexLayout::Separate;
+        meshSource.vertexStride = 0;
+        meshSource.vertexCount = vertexCount;
+        meshSource.bvhs.clear();
+
+        HE_INFO("Import BuildCurves [{}][{} strands][{} -> {} points][{} chunks][{}ms]",
+            magic_enum::enum_name(type), strands.size(), pointsBefore, pointsAfter, meshSource.curveChunks.size(), t.ElapsedMilliseconds());
+    }
+}
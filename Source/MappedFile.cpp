@@ -0,0 +1,158 @@
+#include "HydraEngine/Base.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+import Assets;
+import HE;
+import std;
+
+namespace Assets {
+
+    MappedFile::~MappedFile()
+    {
+        if (!isMapped)
+            return;
+
+#ifdef _WIN32
+        UnmapViewOfFile(view);
+        CloseHandle((HANDLE)mappingHandle);
+        CloseHandle((HANDLE)fileHandle);
+#else
+        munmap(view, viewSize);
+#endif
+    }
+
+    HE::Ref<MappedFile> MappedFile::Open(const std::filesystem::path& filePath, bool map)
+    {
+        return Open(filePath, 0, std::numeric_limits<uint64_t>::max(), map);
+    }
+
+    // views start at the allocation granularity below offset, data points at offset inside the view
+    HE::Ref<MappedFile> MappedFile::Open(const std::filesystem::path& filePath, uint64_t offset, uint64_t size, bool map)
+    {
+        HE_PROFILE_FUNCTION();
+
+        auto file = HE::CreateRef<MappedFile>();
+        file->offset = offset;
+
+        if (!map)
+        {
+            std::ifstream stream(filePath, std::ios::binary | std::ios::ate);
+            if (!stream.is_open())
+            {
+                HE_ERROR("MappedFile : unable to open {}", filePath.string());
+                return nullptr;
+            }
+
+            uint64_t fileSize = (uint64_t)stream.tellg();
+            if (offset > fileSize)
+            {
+                HE_ERROR("MappedFile : offset {} is past the end of {}", offset, filePath.string());
+                return nullptr;
+            }
+
+            file->storage.resize((size_t)std::min(size, fileSize - offset));
+            stream.seekg((std::streamoff)offset);
+            stream.read((char*)file->storage.data(), file->storage.size());
+            file->data = file->storage.data();
+            file->size = file->storage.size();
+
+            return file;
+        }
+
+#ifdef _WIN32
+        HANDLE fileHandle = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, offset == 0 ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_FLAG_RANDOM_ACCESS, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+        {
+            HE_ERROR("MappedFile : unable to open {}", filePath.string());
+            return nullptr;
+        }
+
+        LARGE_INTEGER fileSize;
+        GetFileSizeEx(fileHandle, &fileSize);
+        if (offset > (uint64_t)fileSize.QuadPart)
+        {
+            HE_ERROR("MappedFile : offset {} is past the end of {}", offset, filePath.string());
+            CloseHandle(fileHandle);
+            return nullptr;
+        }
+
+        size = std::min(size, (uint64_t)fileSize.QuadPart - offset);
+        if (size == 0)
+        {
+            CloseHandle(fileHandle);
+            return file;
+        }
+
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        uint64_t viewOffset = offset - offset % info.dwAllocationGranularity;
+        uint64_t viewSize = offset - viewOffset + size;
+
+        HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        void* view = mappingHandle ? MapViewOfFile(mappingHandle, FILE_MAP_COPY, DWORD(viewOffset >> 32), DWORD(viewOffset & 0xFFFFFFFF), (SIZE_T)viewSize) : nullptr;
+        if (!view)
+        {
+            HE_ERROR("MappedFile : unable to map {}", filePath.string());
+            if (mappingHandle)
+                CloseHandle(mappingHandle);
+            CloseHandle(fileHandle);
+            return nullptr;
+        }
+
+        file->fileHandle = fileHandle;
+        file->mappingHandle = mappingHandle;
+#else
+        int fd = open(filePath.c_str(), O_RDONLY);
+        if (fd < 0)
+        {
+            HE_ERROR("MappedFile : unable to open {}", filePath.string());
+            return nullptr;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || offset > (uint64_t)st.st_size)
+        {
+            HE_ERROR("MappedFile : offset {} is past the end of {}", offset, filePath.string());
+            close(fd);
+            return nullptr;
+        }
+
+        size = std::min(size, (uint64_t)st.st_size - offset);
+        if (size == 0)
+        {
+            close(fd);
+            return file;
+        }
+
+        uint64_t granularity = (uint64_t)sysconf(_SC_PAGESIZE);
+        uint64_t viewOffset = offset - offset % granularity;
+        uint64_t viewSize = offset - viewOffset + size;
+
+        void* view = mmap(nullptr, (size_t)viewSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, (off_t)viewOffset);
+        close(fd);
+
+        if (view == MAP_FAILED)
+        {
+            HE_ERROR("MappedFile : unable to map {}", filePath.string());
+            return nullptr;
+        }
+#endif
+
+        file->view = view;
+        file->viewSize = (size_t)viewSize;
+        file->data = (uint8_t*)view + (offset - viewOffset);
+        file->size = (size_t)size;
+        file->isMapped = true;
+        return file;
+    }
+}
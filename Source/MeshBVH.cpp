@@ -0,0 +1,663 @@
+#include "HydraEngine/Base.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#define ASSETS_BVH_SSE 1
+#endif
+
+import Assets;
+import HE;
+import Math;
+import std;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+    constexpr uint32_t c_BinCount = 16;
+    constexpr uint32_t c_LeafSize = 4;          // one packet per leaf
+    constexpr uint32_t c_JobPrimitives = 4096;  // below this a subtree is built by a single task
+    constexpr uint32_t c_TopDepth = 8;
+
+    struct Bounds
+    {
+        Math::float3 min = Math::float3(std::numeric_limits<float>::max());
+        Math::float3 max = Math::float3(-std::numeric_limits<float>::max());
+
+        void Grow(const Math::float3& p) { min = Math::min(min, p); max = Math::max(max, p); }
+        void Grow(const Bounds& b) { min = Math::min(min, b.min); max = Math::max(max, b.max); }
+
+        float Area() const
+        {
+            Math::float3 d = max - min;
+            return d.x < 0.0f ? 0.0f : 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+        }
+    };
+
+    struct BuildPrimitive
+    {
+        Bounds bounds;
+        Math::float3 centroid;
+        Math::float3 p0, p1, p2;
+        uint32_t geometryIndex;
+        uint32_t triangleIndex;
+    };
+
+    struct BuildJob
+    {
+        uint32_t begin;
+        uint32_t end;
+        std::vector<MeshBVHNode> nodes;
+        std::vector<MeshBVHPacket> packets;
+    };
+
+    struct TopNode
+    {
+        Bounds bounds;
+        uint32_t left = c_Invalid;
+        uint32_t right = c_Invalid;
+        uint32_t job = c_Invalid;
+    };
+
+    struct MeshBuild
+    {
+        std::vector<BuildPrimitive> primitives;
+        std::vector<uint32_t> refs;
+        std::vector<TopNode> top;
+        uint32_t firstJob = 0;
+        uint32_t jobCount = 0;
+    };
+
+    static Bounds ComputeBounds(const MeshBuild& build, uint32_t begin, uint32_t end, Bounds& centroidBounds)
+    {
+        Bounds bounds;
+        for (uint32_t i = begin; i < end; i++)
+        {
+            const auto& prim = build.primitives[build.refs[i]];
+            bounds.Grow(prim.bounds);
+            centroidBounds.Grow(prim.centroid);
+        }
+
+        return bounds;
+    }
+
+    // Binned SAH, falls back to an object median split when every centroid coincides. Returns the first ref of the right child.
+    static uint32_t Split(MeshBuild& build, uint32_t begin, uint32_t end, const Bounds& centroidBounds)
+    {
+        struct Bin { Bounds bounds; uint32_t count = 0; };
+
+        float bestCost = std::numeric_limits<float>::max();
+        int bestAxis = -1;
+        uint32_t bestBin = 0;
+
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+            if (extent <= 0.0f)
+                continue;
+
+            Bin bins[c_BinCount];
+            float scale = c_BinCount / extent;
+            for (uint32_t i = begin; i < end; i++)
+            {
+                const auto& prim = build.primitives[build.refs[i]];
+                uint32_t b = std::min(c_BinCount - 1, uint32_t((prim.centroid[axis] - centroidBounds.min[axis]) * scale));
+                bins[b].bounds.Grow(prim.bounds);
+                bins[b].count++;
+            }
+
+            float rightArea[c_BinCount];
+            uint32_t rightCount[c_BinCount];
+            Bounds right;
+            uint32_t count = 0;
+            for (uint32_t b = c_BinCount - 1; b > 0; b--)
+            {
+                right.Grow(bins[b].bounds);
+                count += bins[b].count;
+                rightArea[b] = right.Area();
+                rightCount[b] = count;
+            }
+
+            Bounds left;
+            count = 0;
+            for (uint32_t b = 1; b < c_BinCount; b++)
+            {
+                left.Grow(bins[b - 1].bounds);
+                count += bins[b - 1].count;
+
+                float cost = left.Area() * count + rightArea[b] * rightCount[b];
+                if (count > 0 && rightCount[b] > 0 && cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = b;
+                }
+            }
+        }
+
+        if (bestAxis < 0)
+            return begin + (end - begin) / 2;
+
+        float scale = c_BinCount / (centroidBounds.max[bestAxis] - centroidBounds.min[bestAxis]);
+        auto it = std::partition(build.refs.begin() + begin, build.refs.begin() + end, [&](uint32_t ref) {
+            const auto& prim = build.primitives[ref];
+            return std::min(c_BinCount - 1, uint32_t((prim.centroid[bestAxis] - centroidBounds.min[bestAxis]) * scale)) < bestBin;
+        });
+
+        return uint32_t(it - build.refs.begin());
+    }
+
+    static void MakePacket(const MeshBuild& build, uint32_t begin, uint32_t end, MeshBVHPacket& packet)
+    {
+        packet = {};
+        for (uint32_t lane = 0; lane < 4; lane++)
+        {
+            packet.geometryIndex[lane] = c_Invalid;
+            packet.triangleIndex[lane] = c_Invalid;
+
+            if (begin + lane >= end)
+                continue;
+
+            const auto& prim = build.primitives[build.refs[begin + lane]];
+            Math::float3 e1 = prim.p1 - prim.p0;
+            Math::float3 e2 = prim.p2 - prim.p0;
+            for (int axis = 0; axis < 3; axis++)
+            {
+                packet.v0[axis][lane] = prim.p0[axis];
+                packet.e1[axis][lane] = e1[axis];
+                packet.e2[axis][lane] = e2[axis];
+            }
+
+            packet.geometryIndex[lane] = prim.geometryIndex;
+            packet.triangleIndex[lane] = prim.triangleIndex;
+        }
+    }
+
+    static void BuildSubtree(MeshBuild& build, BuildJob& job, uint32_t begin, uint32_t end)
+    {
+        Bounds centroidBounds;
+        Bounds bounds = ComputeBounds(build, begin, end, centroidBounds);
+
+        uint32_t nodeIndex = (uint32_t)job.nodes.size();
+        job.nodes.push_back({ bounds.min, 0, bounds.max, 0 });
+
+        if (end - begin <= c_LeafSize)
+        {
+            job.nodes[nodeIndex].offset = (uint32_t)job.packets.size();
+            job.nodes[nodeIndex].count = end - begin;
+            MakePacket(build, begin, end, job.packets.emplace_back());
+            return;
+        }
+
+        uint32_t mid = Split(build, begin, end, centroidBounds);
+        BuildSubtree(build, job, begin, mid);
+        job.nodes[nodeIndex].offset = (uint32_t)job.nodes.size();
+        BuildSubtree(build, job, mid, end);
+    }
+
+    // Splits the top of the tree serially until the remaining subtrees are small enough to be built as independent jobs
+    static uint32_t BuildTop(MeshBuild& build, std::vector<BuildJob>& jobs, uint32_t begin, uint32_t end, uint32_t depth)
+    {
+        Bounds centroidBounds;
+        Bounds bounds = ComputeBounds(build, begin, end, centroidBounds);
+
+        uint32_t nodeIndex = (uint32_t)build.top.size();
+        build.top.push_back({ bounds });
+
+        if (depth >= c_TopDepth || end - begin <= c_JobPrimitives)
+        {
+            build.top[nodeIndex].job = (uint32_t)jobs.size();
+            jobs.push_back({ begin, end });
+            return nodeIndex;
+        }
+
+        uint32_t mid = Split(build, begin, end, centroidBounds);
+        uint32_t left = BuildTop(build, jobs, begin, mid, depth + 1);
+        uint32_t right = BuildTop(build, jobs, mid, end, depth + 1);
+        build.top[nodeIndex].left = left;
+        build.top[nodeIndex].right = right;
+
+        return nodeIndex;
+    }
+
+    static void Flatten(const MeshBuild& build, std::vector<BuildJob>& jobs, uint32_t topIndex, MeshBVH& bvh)
+    {
+        const TopNode& top = build.top[topIndex];
+
+        if (top.job != c_Invalid)
+        {
+            BuildJob& job = jobs[top.job];
+            uint32_t nodeBase = (uint32_t)bvh.nodes.size();
+            uint32_t packetBase = (uint32_t)bvh.packets.size();
+
+            for (auto node : job.nodes)
+            {
+                node.offset += node.count ? packetBase : nodeBase;
+                bvh.nodes.push_back(node);
+            }
+
+            bvh.packets.insert(bvh.packets.end(), job.packets.begin(), job.packets.end());
+            job = {};
+            return;
+        }
+
+        uint32_t nodeIndex = (uint32_t)bvh.nodes.size();
+        bvh.nodes.push_back({ top.bounds.min, 0, top.bounds.max, 0 });
+        Flatten(build, jobs, top.left, bvh);
+        bvh.nodes[nodeIndex].offset = (uint32_t)bvh.nodes.size();
+        Flatten(build, jobs, top.right, bvh);
+    }
+
+    static void CollectPrimitives(MeshSource& meshSource, uint32_t meshIndex, MeshBuild& build)
+    {
+        Mesh& mesh = meshSource.meshes[meshIndex];
+        auto positions = mesh.GetDecodedAttribute(meshSource, VertexAttribute::Position);
+
+        for (auto& geometry : mesh.GetGeometrySpan(meshSource))
+        {
+            if (geometry.type != MeshGeometryPrimitiveType::Triangles)
+                continue;
+
+            const uint32_t* indices = geometry.indexCount ? geometry.Getindices(meshSource) : nullptr;
+            uint32_t triangleCount = (geometry.indexCount ? geometry.indexCount : geometry.vertexCount) / 3;
+            uint32_t geometryIndex = uint32_t(&geometry - meshSource.geometries.data());
+
+            for (uint32_t t = 0; t < triangleCount; t++)
+            {
+                BuildPrimitive prim;
+                uint32_t i0 = indices ? indices[t * 3 + 0] : t * 3 + 0;
+                uint32_t i1 = indices ? indices[t * 3 + 1] : t * 3 + 1;
+                uint32_t i2 = indices ? indices[t * 3 + 2] : t * 3 + 2;
+
+                prim.p0 = positions.GetFloat3(geometry.vertexOffsetInMesh + i0);
+                prim.p1 = positions.GetFloat3(geometry.vertexOffsetInMesh + i1);
+                prim.p2 = positions.GetFloat3(geometry.vertexOffsetInMesh + i2);
+                prim.bounds.Grow(prim.p0);
+                prim.bounds.Grow(prim.p1);
+                prim.bounds.Grow(prim.p2);
+                prim.centroid = (prim.bounds.min + prim.bounds.max) * 0.5f;
+                prim.geometryIndex = geometryIndex;
+                prim.triangleIndex = t;
+
+                build.primitives.push_back(prim);
+            }
+        }
+
+        build.refs.resize(build.primitives.size());
+        std::iota(build.refs.begin(), build.refs.end(), 0u);
+    }
+
+    void BuildBVH(MeshSource& meshSource)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        std::vector<MeshBuild> builds(meshSource.meshes.size());
+        std::vector<std::vector<BuildJob>> meshJobs(meshSource.meshes.size());
+
+        // top levels per mesh, then every subtree of every mesh in one parallel pass
+        {
+            HE::Jops::Taskflow tf;
+            tf.for_each_index(size_t(0), meshSource.meshes.size(), size_t(1), [&](size_t i) {
+
+                CollectPrimitives(meshSource, (uint32_t)i, builds[i]);
+                if (!builds[i].refs.empty())
+                    BuildTop(builds[i], meshJobs[i], 0, (uint32_t)builds[i].refs.size(), 0);
+            });
+            HE::Jops::RunTaskflow(tf).wait();
+        }
+
+        std::vector<std::pair<uint32_t, uint32_t>> jobs;
+        for (uint32_t m = 0; m < (uint32_t)meshJobs.size(); m++)
+            for (uint32_t j = 0; j < (uint32_t)meshJobs[m].size(); j++)
+                jobs.push_back({ m, j });
+
+        {
+            HE::Jops::Taskflow tf;
+            tf.for_each_index(size_t(0), jobs.size(), size_t(1), [&](size_t i) {
+
+                auto [m, j] = jobs[i];
+                BuildJob& job = meshJobs[m][j];
+                BuildSubtree(builds[m], job, job.begin, job.end);
+            });
+            HE::Jops::RunTaskflow(tf).wait();
+        }
+
+        meshSource.bvhs.clear();
+        meshSource.bvhs.resize(meshSource.meshes.size());
+
+        size_t nodeCount = 0;
+        {
+            HE::Jops::Taskflow tf;
+            tf.for_each_index(size_t(0), meshSource.meshes.size(), size_t(1), [&](size_t i) {
+
+                if (!builds[i].top.empty())
+                    Flatten(builds[i], meshJobs[i], 0, meshSource.bvhs[i]);
+
+                builds[i] = {};
+            });
+            HE::Jops::RunTaskflow(tf).wait();
+        }
+
+        for (auto& bvh : meshSource.bvhs)
+            nodeCount += bvh.nodes.size();
+
+        HE_INFO("Import BuildBVH [{} nodes][{}ms]", nodeCount, t.ElapsedMilliseconds());
+    }
+
+    struct RayData
+    {
+        Math::float3 origin;
+        Math::float3 direction;
+        Math::float3 invDirection;
+        float tMin;
+    };
+
+    static RayData MakeRayData(const Ray& ray)
+    {
+        RayData r;
+        r.origin = ray.origin;
+        r.direction = ray.direction;
+        r.tMin = ray.tMin;
+
+        // finite reciprocals keep 0 * inf out of the slab test
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float d = ray.direction[axis];
+            r.invDirection[axis] = std::abs(d) > 1e-30f ? 1.0f / d : std::copysign(1e30f, d);
+        }
+
+        return r;
+    }
+
+#ifdef ASSETS_BVH_SSE
+
+    static bool IntersectNode(const MeshBVHNode& node, const RayData& r, float tMax, float& tEntry)
+    {
+        const __m128 lanes = _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+        __m128 origin = _mm_set_ps(0.0f, r.origin.z, r.origin.y, r.origin.x);
+        __m128 invDirection = _mm_set_ps(0.0f, r.invDirection.z, r.invDirection.y, r.invDirection.x);
+
+        __m128 t0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&node.aabbMin.x), origin), invDirection);
+        __m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&node.aabbMax.x), origin), invDirection);
+
+        // the 4th lane holds offset / count, replace it with the ray interval
+        __m128 tNear = _mm_or_ps(_mm_and_ps(lanes, _mm_min_ps(t0, t1)), _mm_andnot_ps(lanes, _mm_set1_ps(r.tMin)));
+        __m128 tFar = _mm_or_ps(_mm_and_ps(lanes, _mm_max_ps(t0, t1)), _mm_andnot_ps(lanes, _mm_set1_ps(tMax)));
+
+        tNear = _mm_max_ps(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(2, 3, 0, 1)));
+        tNear = _mm_max_ps(tNear, _mm_shuffle_ps(tNear, tNear, _MM_SHUFFLE(1, 0, 3, 2)));
+        tFar = _mm_min_ps(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(2, 3, 0, 1)));
+        tFar = _mm_min_ps(tFar, _mm_shuffle_ps(tFar, tFar, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        tEntry = _mm_cvtss_f32(tNear);
+        return tEntry <= _mm_cvtss_f32(tFar);
+    }
+
+    // Two sided Moller-Trumbore against the 4 triangles of a packet
+    static bool IntersectPacket(const MeshBVHPacket& packet, const RayData& r, RayHit& hit)
+    {
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 epsilon = _mm_set1_ps(1e-12f);
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+
+        __m128 dx = _mm_set1_ps(r.direction.x), dy = _mm_set1_ps(r.direction.y), dz = _mm_set1_ps(r.direction.z);
+        __m128 e1x = _mm_loadu_ps(packet.e1[0]), e1y = _mm_loadu_ps(packet.e1[1]), e1z = _mm_loadu_ps(packet.e1[2]);
+        __m128 e2x = _mm_loadu_ps(packet.e2[0]), e2y = _mm_loadu_ps(packet.e2[1]), e2z = _mm_loadu_ps(packet.e2[2]);
+
+        // p = d x e2
+        __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+        __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+        __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+
+        __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+        __m128 valid = _mm_cmpgt_ps(_mm_andnot_ps(signMask, det), epsilon);
+        __m128 invDet = _mm_div_ps(one, _mm_or_ps(_mm_and_ps(valid, det), _mm_andnot_ps(valid, one)));
+
+        __m128 sx = _mm_sub_ps(_mm_set1_ps(r.origin.x), _mm_loadu_ps(packet.v0[0]));
+        __m128 sy = _mm_sub_ps(_mm_set1_ps(r.origin.y), _mm_loadu_ps(packet.v0[1]));
+        __m128 sz = _mm_sub_ps(_mm_set1_ps(r.origin.z), _mm_loadu_ps(packet.v0[2]));
+
+        __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), invDet);
+
+        // q = s x e1
+        __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+        __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+        __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+
+        __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+        __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(u, zero));
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(v, zero));
+        valid = _mm_and_ps(valid, _mm_cmple_ps(_mm_add_ps(u, v), one));
+        valid = _mm_and_ps(valid, _mm_cmpge_ps(t, _mm_set1_ps(r.tMin)));
+        valid = _mm_and_ps(valid, _mm_cmplt_ps(t, _mm_set1_ps(hit.t)));
+
+        int mask = _mm_movemask_ps(valid);
+        if (mask == 0)
+            return false;
+
+        alignas(16) float ts[4], us[4], vs[4];
+        _mm_store_ps(ts, t);
+        _mm_store_ps(us, u);
+        _mm_store_ps(vs, v);
+
+        for (int lane = 0; lane < 4; lane++)
+        {
+            if ((mask >> lane) & 1 && ts[lane] < hit.t)
+            {
+                hit.t = ts[lane];
+                hit.u = us[lane];
+                hit.v = vs[lane];
+                hit.geometryIndex = packet.geometryIndex[lane];
+                hit.triangleIndex = packet.triangleIndex[lane];
+            }
+        }
+
+        return true;
+    }
+
+#else
+
+    static bool IntersectNode(const MeshBVHNode& node, const RayData& r, float tMax, float& tEntry)
+    {
+        float tNear = r.tMin;
+        float tFar = tMax;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            float t0 = (node.aabbMin[axis] - r.origin[axis]) * r.invDirection[axis];
+            float t1 = (node.aabbMax[axis] - r.origin[axis]) * r.invDirection[axis];
+            tNear = std::max(tNear, std::min(t0, t1));
+            tFar = std::min(tFar, std::max(t0, t1));
+        }
+
+        tEntry = tNear;
+        return tNear <= tFar;
+    }
+
+    static bool IntersectPacket(const MeshBVHPacket& packet, const RayData& r, RayHit& hit)
+    {
+        bool result = false;
+        for (int lane = 0; lane < 4; lane++)
+        {
+            Math::float3 e1 = { packet.e1[0][lane], packet.e1[1][lane], packet.e1[2][lane] };
+            Math::float3 e2 = { packet.e2[0][lane], packet.e2[1][lane], packet.e2[2][lane] };
+            Math::float3 v0 = { packet.v0[0][lane], packet.v0[1][lane], packet.v0[2][lane] };
+
+            Math::float3 p = Math::cross(r.direction, e2);
+            float det = Math::dot(e1, p);
+            if (std::abs(det) <= 1e-12f)
+                continue;
+
+            float invDet = 1.0f / det;
+            Math::float3 s = r.origin - v0;
+            float u = Math::dot(s, p) * invDet;
+            Math::float3 q = Math::cross(s, e1);
+            float v = Math::dot(r.direction, q) * invDet;
+            float t = Math::dot(e2, q) * invDet;
+
+            if (u >= 0.0f && v >= 0.0f && u + v <= 1.0f && t >= r.tMin && t < hit.t)
+            {
+                hit.t = t;
+                hit.u = u;
+                hit.v = v;
+                hit.geometryIndex = packet.geometryIndex[lane];
+                hit.triangleIndex = packet.triangleIndex[lane];
+                result = true;
+            }
+        }
+
+        return result;
+    }
+
+#endif
+
+    bool RaycastBVH(const MeshBVH& bvh, const Ray& ray, RayHit& hit)
+    {
+        if (bvh.nodes.empty())
+            return false;
+
+        RayData r = MakeRayData(ray);
+        hit.t = std::min(hit.t, ray.tMax);
+
+        float tEntry;
+        if (!IntersectNode(bvh.nodes[0], r, hit.t, tEntry))
+            return false;
+
+        // SAH trees of clustered input can get deeper than the local stack, it spills to the heap then
+        uint32_t localStack[64];
+        std::vector<uint32_t> heapStack;
+        uint32_t* stack = localStack;
+        uint32_t stackCapacity = (uint32_t)std::size(localStack);
+        uint32_t stackSize = 0;
+        uint32_t current = 0;
+        bool result = false;
+
+        while (true)
+        {
+            const MeshBVHNode& node = bvh.nodes[current];
+
+            if (node.count)
+            {
+                result |= IntersectPacket(bvh.packets[node.offset], r, hit);
+            }
+            else
+            {
+                uint32_t left = current + 1;
+                uint32_t right = node.offset;
+
+                float tLeft, tRight;
+                bool hitLeft = IntersectNode(bvh.nodes[left], r, hit.t, tLeft);
+                bool hitRight = IntersectNode(bvh.nodes[right], r, hit.t, tRight);
+
+                if (hitLeft && hitRight)
+                {
+                    if (tRight < tLeft)
+                        std::swap(left, right);
+
+                    if (stackSize == stackCapacity)
+                    {
+                        heapStack.resize(size_t(stackCapacity) * 2);
+                        if (stack == localStack)
+                            std::copy(localStack, localStack + stackSize, heapStack.begin());
+
+                        stack = heapStack.data();
+                        stackCapacity = (uint32_t)heapStack.size();
+                    }
+
+                    stack[stackSize++] = right;
+                    current = left;
+                    continue;
+                }
+
+                if (hitLeft || hitRight)
+                {
+                    current = hitLeft ? left : right;
+                    continue;
+                }
+            }
+
+            if (stackSize == 0)
+                break;
+
+            current = stack[--stackSize];
+        }
+
+        return result;
+    }
+
+    static void EnsureBVH(MeshSource& meshSource)
+    {
+        std::scoped_lock<std::mutex> lock(meshSource.bvhMutex.mutex);
+        if (meshSource.bvhs.size() == meshSource.meshes.size())
+            return;
+
+        // the BVH keeps its own triangles, streamed geometry is only needed while building
+        bool acquired = !meshSource.HasCpuGeometry();
+        if (acquired && !meshSource.AcquireCpuGeometry())
+            return;
+
+        BuildBVH(meshSource);
+
+        if (acquired)
+            meshSource.ReleaseCpuGeometry();
+    }
+
+    static bool RaycastAllMeshes(MeshSource& meshSource, const Ray& ray, RayHit& hit)
+    {
+        bool result = false;
+        for (uint32_t i = 0; i < (uint32_t)meshSource.bvhs.size(); i++)
+        {
+            if (RaycastBVH(meshSource.bvhs[i], ray, hit))
+            {
+                hit.meshIndex = i;
+                result = true;
+            }
+        }
+
+        return result;
+    }
+
+    bool MeshSource::Raycast(const Ray& ray, RayHit& hit)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        EnsureBVH(*this);
+        return RaycastAllMeshes(*this, ray, hit);
+    }
+
+    bool MeshSource::RaycastMesh(uint32_t meshIndex, const Ray& ray, RayHit& hit)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        EnsureBVH(*this);
+        if (meshIndex >= bvhs.size() || !RaycastBVH(bvhs[meshIndex], ray, hit))
+            return false;
+
+        hit.meshIndex = meshIndex;
+        return true;
+    }
+
+    void MeshSource::RaycastBatch(std::span<const Ray> rays, std::span<RayHit> hits)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE_ASSERT(rays.size() == hits.size());
+        EnsureBVH(*this);
+
+        constexpr size_t chunkSize = 256;
+        size_t chunkCount = (rays.size() + chunkSize - 1) / chunkSize;
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), chunkCount, size_t(1), [&](size_t chunk) {
+
+            size_t end = std::min(rays.size(), (chunk + 1) * chunkSize);
+            for (size_t i = chunk * chunkSize; i < end; i++)
+                RaycastAllMeshes(*this, rays[i], hits[i]);
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+    }
+}
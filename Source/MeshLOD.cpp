@@ -0,0 +1,417 @@
+#include "HydraEngine/Base.h"
+
+import Assets;
+import HE;
+import Math;
+import std;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+    struct Quadric
+    {
+        double a00 = 0, a01 = 0, a02 = 0, a11 = 0, a12 = 0, a22 = 0;
+        double b0 = 0, b1 = 0, b2 = 0;
+        double c = 0;
+        double weight = 0;
+
+        Quadric& operator+=(const Quadric& o)
+        {
+            a00 += o.a00; a01 += o.a01; a02 += o.a02; a11 += o.a11; a12 += o.a12; a22 += o.a22;
+            b0 += o.b0; b1 += o.b1; b2 += o.b2;
+            c += o.c;
+            weight += o.weight;
+            return *this;
+        }
+    };
+
+    static Quadric MakePlaneQuadric(const Math::float3& p0, const Math::float3& p1, const Math::float3& p2)
+    {
+        Math::float3 n = Math::cross(p1 - p0, p2 - p0);
+        double area = Math::length(n);
+
+        Quadric q;
+        if (area == 0.0)
+            return q;
+
+        double nx = n.x / area, ny = n.y / area, nz = n.z / area;
+        double d = -(nx * p0.x + ny * p0.y + nz * p0.z);
+        double w = area * 0.5;
+
+        q.a00 = w * nx * nx; q.a01 = w * nx * ny; q.a02 = w * nx * nz;
+        q.a11 = w * ny * ny; q.a12 = w * ny * nz; q.a22 = w * nz * nz;
+        q.b0 = w * nx * d; q.b1 = w * ny * d; q.b2 = w * nz * d;
+        q.c = w * d * d;
+        q.weight = w;
+
+        return q;
+    }
+
+    // Squared mean distance of p to the planes accumulated in q
+    static double EvaluateQuadric(const Quadric& q, const Math::float3& p)
+    {
+        double x = p.x, y = p.y, z = p.z;
+        double r = q.a00 * x * x + q.a11 * y * y + q.a22 * z * z
+            + 2.0 * (q.a01 * x * y + q.a02 * x * z + q.a12 * y * z)
+            + 2.0 * (q.b0 * x + q.b1 * y + q.b2 * z)
+            + q.c;
+
+        return std::max(r, 0.0) / std::max(q.weight, 1e-12);
+    }
+
+    struct Collapse
+    {
+        uint32_t v0;
+        uint32_t v1;
+        double cost;
+    };
+
+    struct Simplifier
+    {
+        std::span<const Math::float3> positions;
+        std::vector<uint8_t> locked;    // vertex may not move
+        std::vector<uint8_t> seam;      // vertex shares its position with another vertex
+        std::vector<Quadric> quadrics;
+        std::vector<uint32_t> triangleOffsets;
+        std::vector<uint32_t> triangleList;
+        std::vector<uint32_t> remap;
+        std::vector<uint8_t> dirty;
+        std::vector<Collapse> best;
+        double error = 0.0;
+
+        void Init(const std::vector<uint32_t>& indices)
+        {
+            uint32_t vertexCount = (uint32_t)positions.size();
+
+            // vertices sharing a position are attribute seams, they can neither move nor be a collapse target
+            std::vector<uint32_t> order(vertexCount);
+            std::iota(order.begin(), order.end(), 0u);
+            std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+                const auto& pa = positions[a];
+                const auto& pb = positions[b];
+                if (pa.x != pb.x) return pa.x < pb.x;
+                if (pa.y != pb.y) return pa.y < pb.y;
+                if (pa.z != pb.z) return pa.z < pb.z;
+                return a < b;
+            });
+
+            std::vector<uint32_t> canonical(vertexCount);
+            seam.assign(vertexCount, 0);
+            for (uint32_t i = 0; i < vertexCount;)
+            {
+                uint32_t j = i + 1;
+                while (j < vertexCount && positions[order[j]] == positions[order[i]])
+                    j++;
+
+                for (uint32_t k = i; k < j; k++)
+                {
+                    canonical[order[k]] = order[i];
+                    seam[order[k]] = (j - i) > 1;
+                }
+
+                i = j;
+            }
+
+            // open and non-manifold edges are locked to keep silhouettes and cracks in place
+            std::vector<uint64_t> edges;
+            edges.reserve(indices.size());
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                for (int e = 0; e < 3; e++)
+                {
+                    uint32_t a = canonical[indices[i + e]];
+                    uint32_t b = canonical[indices[i + (e + 1) % 3]];
+                    edges.push_back((uint64_t(std::min(a, b)) << 32) | std::max(a, b));
+                }
+            }
+            std::sort(edges.begin(), edges.end());
+
+            std::vector<uint8_t> lockedCanonical(vertexCount, 0);
+            for (size_t i = 0; i < edges.size();)
+            {
+                size_t j = i + 1;
+                while (j < edges.size() && edges[j] == edges[i])
+                    j++;
+
+                if (j - i != 2)
+                {
+                    lockedCanonical[uint32_t(edges[i] >> 32)] = 1;
+                    lockedCanonical[uint32_t(edges[i] & 0xffffffff)] = 1;
+                }
+
+                i = j;
+            }
+
+            locked.resize(vertexCount);
+            for (uint32_t v = 0; v < vertexCount; v++)
+                locked[v] = seam[v] || lockedCanonical[canonical[v]];
+
+            quadrics.assign(vertexCount, Quadric());
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                Quadric q = MakePlaneQuadric(positions[indices[i]], positions[indices[i + 1]], positions[indices[i + 2]]);
+                quadrics[indices[i + 0]] += q;
+                quadrics[indices[i + 1]] += q;
+                quadrics[indices[i + 2]] += q;
+            }
+
+            remap.resize(vertexCount);
+            dirty.resize(vertexCount);
+        }
+
+        void BuildAdjacency(const std::vector<uint32_t>& indices)
+        {
+            uint32_t vertexCount = (uint32_t)positions.size();
+
+            triangleOffsets.assign(vertexCount + 1, 0);
+            for (uint32_t index : indices)
+                triangleOffsets[index + 1]++;
+
+            for (uint32_t v = 0; v < vertexCount; v++)
+                triangleOffsets[v + 1] += triangleOffsets[v];
+
+            triangleList.resize(indices.size());
+            std::vector<uint32_t> cursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+            for (uint32_t i = 0; i < (uint32_t)indices.size(); i++)
+                triangleList[cursor[indices[i]]++] = i / 3;
+        }
+
+        bool HasFlip(const std::vector<uint32_t>& indices, uint32_t v0, uint32_t v1) const
+        {
+            const Math::float3& target = positions[v1];
+
+            for (uint32_t k = triangleOffsets[v0]; k < triangleOffsets[v0 + 1]; k++)
+            {
+                const uint32_t* tri = &indices[triangleList[k] * 3];
+                if (tri[0] == v1 || tri[1] == v1 || tri[2] == v1)
+                    continue;
+
+                Math::float3 p[3] = { positions[tri[0]], positions[tri[1]], positions[tri[2]] };
+                Math::float3 before = Math::cross(p[1] - p[0], p[2] - p[0]);
+
+                for (int i = 0; i < 3; i++)
+                    if (tri[i] == v0) p[i] = target;
+
+                Math::float3 after = Math::cross(p[1] - p[0], p[2] - p[0]);
+                if (Math::dot(before, after) <= 0.0f)
+                    return true;
+            }
+
+            return false;
+        }
+
+        // Performs a batch of independent half edge collapses, returns false when nothing could be collapsed
+        bool CollapsePass(std::vector<uint32_t>& indices, size_t targetTriangles, double maxErrorSq)
+        {
+            uint32_t vertexCount = (uint32_t)positions.size();
+            BuildAdjacency(indices);
+
+            best.assign(vertexCount, Collapse{ c_Invalid, c_Invalid, std::numeric_limits<double>::max() });
+
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                for (int e = 0; e < 3; e++)
+                {
+                    uint32_t a = indices[i + e];
+                    uint32_t b = indices[i + (e + 1) % 3];
+
+                    for (int dir = 0; dir < 2; dir++)
+                    {
+                        uint32_t v0 = dir ? b : a;
+                        uint32_t v1 = dir ? a : b;
+
+                        if (locked[v0] || seam[v1])
+                            continue;
+
+                        Quadric q = quadrics[v0];
+                        q += quadrics[v1];
+                        double cost = EvaluateQuadric(q, positions[v1]);
+
+                        if (cost < best[v0].cost)
+                            best[v0] = { v0, v1, cost };
+                    }
+                }
+            }
+
+            std::vector<Collapse> collapses;
+            for (uint32_t v = 0; v < vertexCount; v++)
+            {
+                if (best[v].v0 != c_Invalid && best[v].cost <= maxErrorSq)
+                    collapses.push_back(best[v]);
+            }
+
+            if (collapses.empty())
+                return false;
+
+            std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.cost < b.cost; });
+
+            std::iota(remap.begin(), remap.end(), 0u);
+            std::fill(dirty.begin(), dirty.end(), uint8_t(0));
+
+            size_t triangleCount = indices.size() / 3;
+            uint32_t collapsed = 0;
+
+            for (const Collapse& c : collapses)
+            {
+                if (triangleCount <= targetTriangles)
+                    break;
+
+                if (dirty[c.v0] || dirty[c.v1] || HasFlip(indices, c.v0, c.v1))
+                    continue;
+
+                for (uint32_t k = triangleOffsets[c.v0]; k < triangleOffsets[c.v0 + 1]; k++)
+                {
+                    const uint32_t* tri = &indices[triangleList[k] * 3];
+                    dirty[tri[0]] = dirty[tri[1]] = dirty[tri[2]] = 1;
+
+                    if (tri[0] == c.v1 || tri[1] == c.v1 || tri[2] == c.v1)
+                        triangleCount--;
+                }
+
+                remap[c.v0] = c.v1;
+                quadrics[c.v1] += quadrics[c.v0];
+                error = std::max(error, std::sqrt(c.cost));
+                collapsed++;
+            }
+
+            if (collapsed == 0)
+                return false;
+
+            size_t write = 0;
+            for (size_t i = 0; i < indices.size(); i += 3)
+            {
+                uint32_t a = remap[indices[i + 0]];
+                uint32_t b = remap[indices[i + 1]];
+                uint32_t c = remap[indices[i + 2]];
+
+                if (a == b || b == c || c == a)
+                    continue;
+
+                indices[write++] = a;
+                indices[write++] = b;
+                indices[write++] = c;
+            }
+            indices.resize(write);
+
+            return true;
+        }
+    };
+
+    struct GeometryLODs
+    {
+        std::vector<std::vector<uint32_t>> indices;
+        std::vector<float> errors;
+    };
+
+    static void BuildGeometryLODs(MeshSource& meshSource, MeshGeometry& geometry, GeometryLODs& out, uint32_t lodCount, float reduction, float maxError)
+    {
+        if (geometry.type != MeshGeometryPrimitiveType::Triangles || geometry.indexCount < 3)
+            return;
+
+        // quantized positions are decoded once, the simplifier revisits them for every collapse
+        auto decoded = geometry.GetDecodedAttribute(meshSource, VertexAttribute::Position);
+        std::vector<Math::float3> positions(decoded.size());
+        for (size_t v = 0; v < positions.size(); v++)
+            positions[v] = decoded.GetFloat3(v);
+
+        Simplifier simplifier;
+        simplifier.positions = positions;
+
+        const uint32_t* src = geometry.Getindices(meshSource);
+        std::vector<uint32_t> indices(src, src + geometry.indexCount - geometry.indexCount % 3);
+
+        Math::float3 extents = geometry.aabb.m_maxs - geometry.aabb.m_mins;
+        double maxErrorAbs = double(maxError) * std::max({ extents.x, extents.y, extents.z });
+        double maxErrorSq = maxErrorAbs * maxErrorAbs;
+
+        simplifier.Init(indices);
+
+        for (uint32_t lod = 0; lod < lodCount; lod++)
+        {
+            size_t previousCount = indices.size();
+            size_t targetTriangles = size_t(double(previousCount / 3) * reduction);
+
+            while (indices.size() / 3 > targetTriangles && simplifier.CollapsePass(indices, targetTriangles, maxErrorSq)) {}
+
+            // stop once the error bound prevents any meaningful reduction
+            if (indices.empty() || indices.size() > previousCount * 95 / 100)
+                break;
+
+            out.indices.push_back(indices);
+            out.errors.push_back(float(simplifier.error));
+        }
+    }
+
+    void BuildLODs(MeshSource& meshSource, uint32_t lodCount, float reduction, float maxError)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        // the decoded positions read the CPU geometry directly, dropped sources are re-fetched once here
+        meshSource.AcquireCpuGeometry();
+
+        reduction = std::clamp(reduction, 0.05f, 0.95f);
+        std::vector<GeometryLODs> perGeometry(meshSource.geometries.size());
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), meshSource.geometries.size(), size_t(1), [&](size_t i) {
+            BuildGeometryLODs(meshSource, meshSource.geometries[i], perGeometry[i], lodCount, reduction, maxError);
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        size_t extraIndices = 0;
+        for (auto& g : perGeometry)
+            for (auto& indices : g.indices)
+                extraIndices += indices.size();
+
+        // indices of previous LODs follow the full detail ones and are replaced
+        size_t indexOffset = meshSource.cpuIndexBuffer.size();
+        for (const auto& lod : meshSource.lods)
+            indexOffset = std::min(indexOffset, (size_t)lod.indexOffset);
+
+        meshSource.cpuIndexBuffer.resize(indexOffset + extraIndices);
+        meshSource.lods.clear();
+
+        for (size_t i = 0; i < perGeometry.size(); i++)
+        {
+            auto& g = perGeometry[i];
+            auto& geometry = meshSource.geometries[i];
+
+            geometry.lodOffset = (uint32_t)meshSource.lods.size();
+            geometry.lodCount = (uint32_t)g.indices.size();
+
+            for (size_t lod = 0; lod < g.indices.size(); lod++)
+            {
+                auto& indices = g.indices[lod];
+                std::copy(indices.begin(), indices.end(), meshSource.cpuIndexBuffer.begin() + indexOffset);
+
+                MeshGeometryLOD& l = meshSource.lods.emplace_back();
+                l.indexOffset = indexOffset;
+                l.indexCount = (uint32_t)indices.size();
+                l.error = g.errors[lod];
+
+                indexOffset += indices.size();
+            }
+        }
+
+        HE_INFO("Import BuildLODs [{}][{} extra indices][{}ms]", meshSource.lods.size(), extraIndices, t.ElapsedMilliseconds());
+    }
+
+    uint32_t SelectLOD(std::span<const MeshGeometryLOD> lods, float distance, float projectionScale, float pixelThreshold)
+    {
+        float scale = projectionScale / std::max(distance, 1e-4f);
+
+        uint32_t selected = 0;
+        for (uint32_t i = 0; i < (uint32_t)lods.size(); i++)
+        {
+            if (lods[i].error * scale > pixelThreshold)
+                break;
+
+            selected = i + 1;
+        }
+
+        return selected;
+    }
+}
@@ -0,0 +1,842 @@
+#include "HydraEngine/Base.h"
+
+import Assets;
+import HE;
+import Math;
+import std;
+import magic_enum;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+    constexpr uint32_t c_AttributeCount = (uint32_t)magic_enum::enum_count<VertexAttribute>();
+
+    // Moves the morph deltas of the mesh to the new mesh local vertices, deltas of dropped vertices are removed
+    static void RemapMorphTargets(MeshSource& meshSource, const Mesh& mesh, const std::vector<uint32_t>& oldToNew)
+    {
+        for (uint32_t t = mesh.morphTargetOffset; t < mesh.morphTargetOffset + mesh.morphTargetCount; t++)
+        {
+            auto& target = meshSource.morphTargets[t];
+            auto deltas = meshSource.morphDeltas.begin() + target.deltaOffset;
+
+            uint32_t kept = 0;
+            for (uint32_t i = 0; i < target.deltaCount; i++)
+            {
+                uint32_t vertex = deltas[i].vertex < oldToNew.size() ? oldToNew[deltas[i].vertex] : c_Invalid;
+                if (vertex == c_Invalid)
+                    continue;
+
+                deltas[kept] = deltas[i];
+                deltas[kept++].vertex = vertex;
+            }
+
+            // removed deltas leave a gap after the target
+            std::sort(deltas, deltas + kept, [](const MorphDelta& a, const MorphDelta& b) { return a.vertex < b.vertex; });
+            target.deltaCount = kept;
+        }
+    }
+
+    // Rebuilds cpuVertexBuffer from per geometry lists of source vertices (geometry local), updating vertex offsets and counts.
+    static void CompactVertices(MeshSource& meshSource, const std::vector<std::vector<uint32_t>>& newToOld)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        std::vector<uint64_t> srcFirstVertex(meshSource.geometries.size());
+        for (size_t i = 0; i < meshSource.geometries.size(); i++)
+        {
+            const auto& geometry = meshSource.geometries[i];
+            srcFirstVertex[i] = uint64_t(meshSource.meshes[geometry.mesh].vertexOffset) + geometry.vertexOffsetInMesh;
+        }
+
+        std::vector<uint32_t> oldToNew;
+        uint64_t vertexCount = 0;
+        for (auto& mesh : meshSource.meshes)
+        {
+            if (mesh.morphTargetCount)
+                oldToNew.assign(mesh.vertexCount, c_Invalid);
+
+            mesh.vertexOffset = vertexCount;
+            mesh.vertexCount = 0;
+
+            for (auto& geometry : mesh.GetGeometrySpan(meshSource))
+            {
+                const auto& remap = newToOld[&geometry - meshSource.geometries.data()];
+                if (mesh.morphTargetCount)
+                {
+                    for (uint32_t v = 0; v < (uint32_t)remap.size(); v++)
+                        oldToNew[geometry.vertexOffsetInMesh + remap[v]] = mesh.vertexCount + v;
+                }
+
+                geometry.vertexOffsetInMesh = mesh.vertexCount;
+                geometry.vertexCount = (uint32_t)remap.size();
+                mesh.vertexCount += geometry.vertexCount;
+            }
+
+            if (mesh.morphTargetCount)
+                RemapMorphTargets(meshSource, mesh, oldToNew);
+
+            vertexCount += mesh.vertexCount;
+        }
+
+        std::vector<uint8_t> buffer;
+        std::array<nvrhi::BufferRange, c_AttributeCount> ranges = {};
+
+        uint64_t bufferSize = 0;
+        for (uint32_t a = 0; a < c_AttributeCount; a++)
+        {
+            if (!meshSource.HasAttribute(VertexAttribute(a)))
+                continue;
+
+            uint64_t byteSize = vertexCount * meshSource.GetVertexElementSize(VertexAttribute(a));
+            ranges[a] = nvrhi::BufferRange(bufferSize, byteSize);
+            bufferSize += byteSize;
+        }
+
+        buffer.resize(bufferSize);
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), meshSource.geometries.size(), size_t(1), [&](size_t i) {
+
+            const auto& geometry = meshSource.geometries[i];
+            const auto& remap = newToOld[i];
+            uint64_t dstFirstVertex = uint64_t(meshSource.meshes[geometry.mesh].vertexOffset) + geometry.vertexOffsetInMesh;
+
+            for (uint32_t a = 0; a < c_AttributeCount; a++)
+            {
+                if (ranges[a].byteSize == 0)
+                    continue;
+
+                uint32_t size = meshSource.GetVertexElementSize(VertexAttribute(a));
+                uint32_t srcStride = meshSource.GetVertexStride(VertexAttribute(a));
+                const uint8_t* src = meshSource.cpuVertexBuffer.data() + meshSource.vertexBufferRanges[a].byteOffset + srcFirstVertex[i] * srcStride;
+                uint8_t* dst = buffer.data() + ranges[a].byteOffset + dstFirstVertex * size;
+
+                for (size_t v = 0; v < remap.size(); v++)
+                    std::memcpy(dst + v * size, src + uint64_t(remap[v]) * srcStride, size);
+            }
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        meshSource.cpuVertexBuffer = std::move(buffer);
+        meshSource.vertexBufferRanges = ranges;
+        meshSource.vertexLayout = VertexLayout::Separate;
+        meshSource.vertexStride = 0;
+        meshSource.vertexCount = vertexCount;
+    }
+
+    struct VertexKeyTable
+    {
+        std::vector<uint32_t> keys;
+        uint32_t wordCount = 0;
+
+        const uint32_t* Key(uint32_t v) const { return keys.data() + size_t(v) * wordCount; }
+
+        size_t Hash(uint32_t v) const
+        {
+            const uint32_t* key = Key(v);
+            uint64_t h = 0xcbf29ce484222325ull;
+            for (uint32_t i = 0; i < wordCount; i++)
+            {
+                h ^= key[i];
+                h *= 0x100000001b3ull;
+            }
+
+            return size_t(h ^ (h >> 29));
+        }
+
+        bool Equal(uint32_t a, uint32_t b) const { return std::memcmp(Key(a), Key(b), wordCount * sizeof(uint32_t)) == 0; }
+    };
+
+    static uint32_t QuantizeFloat(float value, double invEpsilon)
+    {
+        if (invEpsilon == 0.0)
+        {
+            if (value == 0.0f)
+                value = 0.0f; // -0 and +0 weld
+
+            return std::bit_cast<uint32_t>(value);
+        }
+
+        return uint32_t(int64_t(std::floor(double(value) * invEpsilon)));
+    }
+
+    static void BuildVertexKeys(MeshSource& meshSource, const MeshGeometry& geometry, double invEpsilon, VertexKeyTable& table)
+    {
+        uint64_t firstVertex = uint64_t(meshSource.meshes[geometry.mesh].vertexOffset) + geometry.vertexOffsetInMesh;
+
+        table.wordCount = 0;
+        for (uint32_t a = 0; a < c_AttributeCount; a++)
+        {
+            if (meshSource.HasAttribute(VertexAttribute(a)))
+                table.wordCount += (meshSource.GetVertexElementSize(VertexAttribute(a)) + 3) / sizeof(uint32_t);
+        }
+
+        table.keys.resize(size_t(geometry.vertexCount) * table.wordCount);
+
+        uint32_t word = 0;
+        for (uint32_t a = 0; a < c_AttributeCount; a++)
+        {
+            auto attr = VertexAttribute(a);
+            if (!meshSource.HasAttribute(attr))
+                continue;
+
+            uint32_t stride = meshSource.GetVertexStride(attr);
+            uint32_t size = meshSource.GetVertexElementSize(attr);
+            uint32_t words = (size + 3) / sizeof(uint32_t); // 2 byte formats (Oct8) occupy a zero padded word
+            const uint8_t* src = meshSource.cpuVertexBuffer.data() + meshSource.vertexBufferRanges[a].byteOffset + firstVertex * stride;
+
+            // packed attributes are compared bit exact, float attributes are snapped to the epsilon grid
+            VertexFormat format = meshSource.vertexFormats[a];
+            bool isFloat = format == VertexFormat::Float2 || format == VertexFormat::Float3 || format == VertexFormat::Float4;
+
+            for (uint32_t v = 0; v < geometry.vertexCount; v++)
+            {
+                uint32_t* key = table.keys.data() + size_t(v) * table.wordCount + word;
+                const uint8_t* element = src + size_t(v) * stride;
+
+                for (uint32_t w = 0; w < words; w++)
+                {
+                    uint32_t bits = 0;
+                    std::memcpy(&bits, element + w * sizeof(uint32_t), std::min<uint32_t>(sizeof(uint32_t), size - w * sizeof(uint32_t)));
+                    key[w] = isFloat ? QuantizeFloat(std::bit_cast<float>(bits), invEpsilon) : bits;
+                }
+            }
+
+            word += words;
+        }
+    }
+
+    static void WeldGeometry(MeshSource& meshSource, MeshGeometry& geometry, double invEpsilon, std::vector<uint32_t>& newToOld)
+    {
+        newToOld.clear();
+
+        // nothing references the vertices of non indexed geometries, and morph deltas are per vertex, keep them as they are
+        if (geometry.indexCount == 0 || meshSource.meshes[geometry.mesh].morphTargetCount)
+        {
+            newToOld.resize(geometry.vertexCount);
+            std::iota(newToOld.begin(), newToOld.end(), 0u);
+            return;
+        }
+
+        VertexKeyTable table;
+        BuildVertexKeys(meshSource, geometry, invEpsilon, table);
+
+        size_t capacity = std::bit_ceil(size_t(geometry.vertexCount) * 2 + 1);
+        std::vector<uint32_t> buckets(capacity, c_Invalid); // new vertex index
+        std::vector<uint32_t> remap(geometry.vertexCount, c_Invalid);
+
+        uint32_t* indices = geometry.Getindices(meshSource);
+        for (uint32_t i = 0; i < geometry.indexCount; i++)
+        {
+            uint32_t v = indices[i];
+            if (remap[v] == c_Invalid)
+            {
+                size_t bucket = table.Hash(v) & (capacity - 1);
+                while (buckets[bucket] != c_Invalid && !table.Equal(newToOld[buckets[bucket]], v))
+                    bucket = (bucket + 1) & (capacity - 1);
+
+                if (buckets[bucket] == c_Invalid)
+                {
+                    buckets[bucket] = (uint32_t)newToOld.size();
+                    newToOld.push_back(v);
+                }
+
+                remap[v] = buckets[bucket];
+            }
+
+            indices[i] = remap[v];
+        }
+    }
+
+    uint64_t WeldVertices(MeshSource& meshSource, float epsilon)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        uint64_t bytesBefore = meshSource.cpuVertexBuffer.size();
+        uint64_t verticesBefore = meshSource.vertexCount;
+        double invEpsilon = epsilon > 0.0f ? 1.0 / double(epsilon) : 0.0;
+
+        std::vector<std::vector<uint32_t>> newToOld(meshSource.geometries.size());
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), meshSource.geometries.size(), size_t(1), [&](size_t i) {
+            WeldGeometry(meshSource, meshSource.geometries[i], invEpsilon, newToOld[i]);
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        CompactVertices(meshSource, newToOld);
+
+        uint64_t saved = bytesBefore - meshSource.cpuVertexBuffer.size();
+        HE_INFO("Import WeldVertices [{} -> {} vertices][{} bytes saved][{}ms]", verticesBefore, meshSource.vertexCount, saved, t.ElapsedMilliseconds());
+
+        return saved;
+    }
+
+    void SetVertexLayout(MeshSource& meshSource, VertexLayout layout)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        auto isInterleaved = [layout](VertexAttribute attr) {
+            return layout == VertexLayout::Interleaved || (layout == VertexLayout::Hybrid && attr != VertexAttribute::Position);
+        };
+
+        // attribute offsets inside the interleaved vertex, 4 byte aligned unless the element is smaller
+        std::array<uint32_t, c_AttributeCount> elementOffsets = {};
+        uint32_t stride = 0;
+        for (uint32_t a = 0; a < c_AttributeCount; a++)
+        {
+            auto attr = VertexAttribute(a);
+            if (!meshSource.HasAttribute(attr) || !isInterleaved(attr))
+                continue;
+
+            uint32_t size = meshSource.GetVertexElementSize(attr);
+            uint32_t alignment = size % 4 == 0 ? 4 : 2;
+            stride = (stride + alignment - 1) & ~(alignment - 1);
+            elementOffsets[a] = stride;
+            stride += size;
+        }
+        stride = (stride + 3) & ~3u;
+
+        uint64_t vertexCount = meshSource.vertexCount;
+        std::array<nvrhi::BufferRange, c_AttributeCount> ranges = {};
+        uint64_t bufferSize = 0;
+
+        for (uint32_t a = 0; a < c_AttributeCount; a++)
+        {
+            auto attr = VertexAttribute(a);
+            if (!meshSource.HasAttribute(attr) || isInterleaved(attr))
+                continue;
+
+            uint64_t byteSize = vertexCount * meshSource.GetVertexElementSize(attr);
+            ranges[a] = nvrhi::BufferRange(bufferSize, byteSize);
+            bufferSize += byteSize;
+        }
+
+        uint64_t streamOffset = bufferSize;
+        if (stride != 0)
+        {
+            for (uint32_t a = 0; a < c_AttributeCount; a++)
+            {
+                auto attr = VertexAttribute(a);
+                if (!meshSource.HasAttribute(attr) || !isInterleaved(attr))
+                    continue;
+
+                uint64_t byteSize = vertexCount ? (vertexCount - 1) * stride + meshSource.GetVertexElementSize(attr) : 0;
+                ranges[a] = nvrhi::BufferRange(streamOffset + elementOffsets[a], byteSize);
+            }
+
+            bufferSize += vertexCount * stride;
+        }
+
+        std::vector<uint8_t> buffer(bufferSize);
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), meshSource.meshes.size(), size_t(1), [&](size_t i) {
+
+            const Mesh& mesh = meshSource.meshes[i];
+
+            for (uint32_t a = 0; a < c_AttributeCount; a++)
+            {
+                auto attr = VertexAttribute(a);
+                if (!meshSource.HasAttribute(attr))
+                    continue;
+
+                uint32_t size = meshSource.GetVertexElementSize(attr);
+                uint32_t srcStride = meshSource.GetVertexStride(attr);
+                uint32_t dstStride = isInterleaved(attr) ? stride : size;
+
+                const uint8_t* src = meshSource.cpuVertexBuffer.data() + meshSource.vertexBufferRanges[a].byteOffset + uint64_t(mesh.vertexOffset) * srcStride;
+                uint8_t* dst = buffer.data() + ranges[a].byteOffset + uint64_t(mesh.vertexOffset) * dstStride;
+
+                if (srcStride == size && dstStride == size)
+                {
+                    std::memcpy(dst, src, size_t(mesh.vertexCount) * size);
+                    continue;
+                }
+
+                for (uint32_t v = 0; v < mesh.vertexCount; v++)
+                    std::memcpy(dst + size_t(v) * dstStride, src + size_t(v) * srcStride, size);
+            }
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        meshSource.cpuVertexBuffer = std::move(buffer);
+        meshSource.vertexBufferRanges = ranges;
+        meshSource.vertexLayout = layout;
+        meshSource.vertexStride = stride;
+
+        HE_INFO("Import SetVertexLayout [{}][stride {}][{}ms]", magic_enum::enum_name(layout), stride, t.ElapsedMilliseconds());
+    }
+
+    static uint64_t HashBytes(const uint8_t* data, size_t size, uint64_t h)
+    {
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, data + i, sizeof(word));
+            h = (h ^ word) * 0x9E3779B97F4A7C15ull;
+            h ^= h >> 32;
+        }
+
+        for (; i < size; i++)
+            h = (h ^ data[i]) * 0x100000001b3ull;
+
+        return h;
+    }
+
+    // Calls f(bytes, size) over every attribute of the mesh vertices, whole ranges for Separate attributes and per vertex otherwise
+    template<typename F>
+    static void ForEachVertexBytes(const MeshSource& meshSource, const Mesh& mesh, F&& f)
+    {
+        for (uint32_t a = 0; a < c_AttributeCount; a++)
+        {
+            if (!meshSource.HasAttribute(VertexAttribute(a)))
+                continue;
+
+            uint32_t size = meshSource.GetVertexElementSize(VertexAttribute(a));
+            uint32_t stride = meshSource.GetVertexStride(VertexAttribute(a));
+            const uint8_t* src = meshSource.cpuVertexBuffer.data() + meshSource.vertexBufferRanges[a].byteOffset + uint64_t(mesh.vertexOffset) * stride;
+
+            if (size == stride)
+            {
+                f(src, size_t(mesh.vertexCount) * size);
+                continue;
+            }
+
+            for (uint32_t v = 0; v < mesh.vertexCount; v++)
+                f(src + uint64_t(v) * stride, size);
+        }
+    }
+
+    static bool GeometriesEqual(const MeshGeometry& a, const MeshGeometry& b)
+    {
+        return a.type == b.type && a.indexOffsetInMesh == b.indexOffsetInMesh && a.vertexOffsetInMesh == b.vertexOffsetInMesh &&
+            a.indexCount == b.indexCount && a.vertexCount == b.vertexCount && a.materailHandle == b.materailHandle;
+    }
+
+    static uint64_t HashMesh(const MeshSource& meshSource, const Mesh& mesh)
+    {
+        uint64_t h = 0xcbf29ce484222325ull;
+        h = HashBytes((const uint8_t*)&mesh.type, sizeof(mesh.type), h);
+        h = HashBytes((const uint8_t*)&mesh.geometryCount, sizeof(mesh.geometryCount), h);
+        h = HashBytes((const uint8_t*)(meshSource.cpuIndexBuffer.data() + mesh.indexOffset), size_t(mesh.indexCount) * sizeof(uint32_t), h);
+        ForEachVertexBytes(meshSource, mesh, [&h](const uint8_t* data, size_t size) { h = HashBytes(data, size, h); });
+
+        return h;
+    }
+
+    static bool MeshesEqual(const MeshSource& meshSource, const Mesh& a, const Mesh& b)
+    {
+        // morph targets are not compared, meshes with targets are kept as they are
+        if (a.type != b.type || a.geometryCount != b.geometryCount || a.indexCount != b.indexCount || a.vertexCount != b.vertexCount || a.morphTargetCount || b.morphTargetCount)
+            return false;
+
+        for (uint32_t g = 0; g < a.geometryCount; g++)
+        {
+            if (!GeometriesEqual(meshSource.geometries[a.geometryOffset + g], meshSource.geometries[b.geometryOffset + g]))
+                return false;
+        }
+
+        const uint32_t* indices = meshSource.cpuIndexBuffer.data();
+        if (std::memcmp(indices + a.indexOffset, indices + b.indexOffset, size_t(a.indexCount) * sizeof(uint32_t)) != 0)
+            return false;
+
+        std::vector<std::pair<const uint8_t*, size_t>> bytesA;
+        ForEachVertexBytes(meshSource, a, [&bytesA](const uint8_t* data, size_t size) { bytesA.emplace_back(data, size); });
+
+        size_t i = 0;
+        bool equal = true;
+        ForEachVertexBytes(meshSource, b, [&](const uint8_t* data, size_t size) { equal = equal && std::memcmp(bytesA[i++].first, data, size) == 0; });
+
+        return equal;
+    }
+
+    std::vector<uint32_t> MergeIdenticalMeshes(MeshSource& meshSource)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        const uint32_t meshCount = (uint32_t)meshSource.meshes.size();
+        std::vector<uint32_t> remap(meshCount);
+        std::iota(remap.begin(), remap.end(), 0u);
+
+        if (!meshSource.lods.empty() || !meshSource.meshlets.empty())
+        {
+            HE_WARN("MergeIdenticalMeshes : must run before BuildLODs and BuildMeshlets, skipped");
+            return remap;
+        }
+
+        std::vector<uint64_t> hashes(meshCount);
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), size_t(meshCount), size_t(1), [&](size_t i) {
+            hashes[i] = HashMesh(meshSource, meshSource.meshes[i]);
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        // the first mesh with given content is kept, hash collisions are resolved by a full compare
+        std::unordered_map<uint64_t, std::vector<uint32_t>> buckets;
+        std::vector<uint32_t> canonical(meshCount);
+        for (uint32_t m = 0; m < meshCount; m++)
+        {
+            auto& candidates = buckets[hashes[m]];
+            auto it = std::find_if(candidates.begin(), candidates.end(), [&](uint32_t c) { return MeshesEqual(meshSource, meshSource.meshes[c], meshSource.meshes[m]); });
+
+            canonical[m] = it != candidates.end() ? *it : m;
+            if (canonical[m] == m)
+                candidates.push_back(m);
+        }
+
+        std::vector<uint32_t> newIndex(meshCount, c_Invalid);
+        uint32_t keptCount = 0;
+        for (uint32_t m = 0; m < meshCount; m++)
+        {
+            if (canonical[m] == m)
+                newIndex[m] = keptCount++;
+        }
+
+        for (uint32_t m = 0; m < meshCount; m++)
+            remap[m] = newIndex[canonical[m]];
+
+        if (keptCount == meshCount)
+            return remap;
+
+        std::vector<Mesh> meshes;
+        std::vector<MeshGeometry> geometries;
+        std::vector<uint32_t> indices;
+        std::vector<std::vector<uint32_t>> newToOld;
+        meshes.reserve(keptCount);
+
+        for (uint32_t m = 0; m < meshCount; m++)
+        {
+            if (canonical[m] != m)
+                continue;
+
+            // vertexOffset keeps pointing at the old vertices until CompactVertices
+            Mesh& mesh = meshes.emplace_back(meshSource.meshes[m]);
+            const uint32_t oldGeometryOffset = mesh.geometryOffset;
+            mesh.index = newIndex[m];
+            mesh.geometryOffset = (uint32_t)geometries.size();
+
+            indices.insert(indices.end(), meshSource.cpuIndexBuffer.begin() + mesh.indexOffset, meshSource.cpuIndexBuffer.begin() + mesh.indexOffset + mesh.indexCount);
+            mesh.indexOffset = indices.size() - mesh.indexCount;
+
+            for (uint32_t g = 0; g < mesh.geometryCount; g++)
+            {
+                auto& geometry = geometries.emplace_back(meshSource.geometries[oldGeometryOffset + g]);
+                geometry.mesh = mesh.index;
+                geometry.index = uint32_t(geometries.size() - 1);
+
+                auto& remapVertices = newToOld.emplace_back(geometry.vertexCount);
+                std::iota(remapVertices.begin(), remapVertices.end(), 0u);
+            }
+        }
+
+        meshSource.meshes = std::move(meshes);
+        meshSource.geometries = std::move(geometries);
+        meshSource.cpuIndexBuffer = std::move(indices);
+        meshSource.bvhs.clear();
+
+        CompactVertices(meshSource, newToOld);
+
+        HE_INFO("Import MergeIdenticalMeshes [{} -> {} meshes][{}ms]", meshCount, keptCount, t.ElapsedMilliseconds());
+
+        return remap;
+    }
+
+    uint64_t HashGeometry(const MeshSource& meshSource)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        // fixed size blocks are hashed in parallel and folded in order, the result only depends on the bytes
+        constexpr size_t c_BlockSize = 1 << 20;
+        const uint8_t* streams[2] = { meshSource.cpuVertexBuffer.data(), (const uint8_t*)meshSource.cpuIndexBuffer.data() };
+        uint64_t sizes[2] = { meshSource.cpuVertexBuffer.size(), meshSource.cpuIndexBuffer.size() * sizeof(uint32_t) };
+        size_t vertexBlocks = (sizes[0] + c_BlockSize - 1) / c_BlockSize;
+        size_t indexBlocks = (sizes[1] + c_BlockSize - 1) / c_BlockSize;
+
+        std::vector<uint64_t> hashes(vertexBlocks + indexBlocks);
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), hashes.size(), size_t(1), [&](size_t b) {
+            int s = b < vertexBlocks ? 0 : 1;
+            size_t offset = (s ? b - vertexBlocks : b) * c_BlockSize;
+            hashes[b] = HashBytes(streams[s] + offset, std::min<size_t>(c_BlockSize, sizes[s] - offset), 0xcbf29ce484222325ull);
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        uint64_t h = HashBytes((const uint8_t*)sizes, sizeof(sizes), 0xcbf29ce484222325ull);
+        return HashBytes((const uint8_t*)hashes.data(), hashes.size() * sizeof(uint64_t), h);
+    }
+
+    static bool CanMergeGeometries(const MeshGeometry& a, const MeshGeometry& b)
+    {
+        // strips can not be concatenated, non indexed geometries have no index range to extend
+        return a.materailHandle == b.materailHandle && a.type == b.type && a.type != MeshGeometryPrimitiveType::LineStrip && a.indexCount && b.indexCount;
+    }
+
+    uint32_t SortGeometriesByMaterial(MeshSource& meshSource)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        const uint32_t geometryCount = (uint32_t)meshSource.geometries.size();
+
+        if (!meshSource.lods.empty() || !meshSource.meshlets.empty())
+        {
+            HE_WARN("SortGeometriesByMaterial : must run before BuildLODs and BuildMeshlets, skipped");
+            return geometryCount;
+        }
+
+        // materials keep the order of their first use in the mesh, so the result does not depend on handle values
+        std::vector<MeshGeometry> geometries;
+        std::vector<uint32_t> indices;
+        std::vector<std::vector<uint32_t>> newToOld;
+        geometries.reserve(geometryCount);
+        indices.reserve(meshSource.cpuIndexBuffer.size());
+
+        for (auto& mesh : meshSource.meshes)
+        {
+            auto span = mesh.GetGeometrySpan(meshSource);
+
+            std::vector<std::pair<uint32_t, uint32_t>> keys; // (first use, geometry)
+            keys.reserve(span.size());
+            for (uint32_t g = 0; g < (uint32_t)span.size(); g++)
+            {
+                uint32_t first = g;
+                for (uint32_t p = 0; p < g; p++)
+                {
+                    if (span[p].materailHandle == span[g].materailHandle && span[p].type == span[g].type)
+                    {
+                        first = p;
+                        break;
+                    }
+                }
+                keys.push_back({ first, g });
+            }
+            std::sort(keys.begin(), keys.end());
+
+            // vertexOffset keeps pointing at the old vertices until CompactVertices
+            const uint64_t oldIndexOffset = mesh.indexOffset;
+            mesh.geometryOffset = (uint32_t)geometries.size();
+            mesh.indexOffset = indices.size();
+
+            for (auto [first, g] : keys)
+            {
+                auto& geometry = geometries.emplace_back(span[g]);
+                geometry.index = uint32_t(geometries.size() - 1);
+
+                const uint32_t* src = meshSource.cpuIndexBuffer.data() + oldIndexOffset + geometry.indexOffsetInMesh;
+                geometry.indexOffsetInMesh = uint32_t(indices.size() - mesh.indexOffset);
+                indices.insert(indices.end(), src, src + geometry.indexCount);
+
+                auto& remapVertices = newToOld.emplace_back(geometry.vertexCount);
+                std::iota(remapVertices.begin(), remapVertices.end(), 0u);
+            }
+
+            mesh.indexCount = uint32_t(indices.size() - mesh.indexOffset);
+        }
+
+        meshSource.geometries = std::move(geometries);
+        meshSource.cpuIndexBuffer = std::move(indices);
+        meshSource.bvhs.clear();
+
+        // vertices now follow the geometry order, so neighbours that share a material are contiguous in both buffers
+        CompactVertices(meshSource, newToOld);
+
+        geometries.clear();
+        geometries.reserve(geometryCount);
+        for (auto& mesh : meshSource.meshes)
+        {
+            auto span = mesh.GetGeometrySpan(meshSource);
+            mesh.geometryOffset = (uint32_t)geometries.size();
+
+            for (uint32_t g = 0; g < (uint32_t)span.size(); g++)
+            {
+                const auto& geometry = span[g];
+                if (g == 0 || !CanMergeGeometries(geometries.back(), geometry))
+                {
+                    auto& kept = geometries.emplace_back(geometry);
+                    kept.index = uint32_t(geometries.size() - 1);
+                    continue;
+                }
+
+                auto& merged = geometries.back();
+                uint32_t vertexBase = geometry.vertexOffsetInMesh - merged.vertexOffsetInMesh;
+                uint32_t* dst = meshSource.cpuIndexBuffer.data() + mesh.indexOffset + geometry.indexOffsetInMesh;
+                for (uint32_t i = 0; i < geometry.indexCount; i++)
+                    dst[i] += vertexBase;
+
+                merged.indexCount += geometry.indexCount;
+                merged.vertexCount = vertexBase + geometry.vertexCount;
+                merged.aabb |= geometry.aabb;
+            }
+
+            mesh.geometryCount = uint32_t(geometries.size() - mesh.geometryOffset);
+        }
+
+        meshSource.geometries = std::move(geometries);
+
+        HE_INFO("Import SortGeometriesByMaterial [{} -> {} geometries][{}ms]", geometryCount, meshSource.geometries.size(), t.ElapsedMilliseconds());
+
+        return (uint32_t)meshSource.geometries.size();
+    }
+
+    void BuildMaterialRanges(MeshSource& meshSource)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        auto& order = meshSource.materialGeometries;
+        order.resize(meshSource.geometries.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return meshSource.geometries[a].materailHandle < meshSource.geometries[b].materailHandle; });
+
+        meshSource.materialRanges.clear();
+        for (uint32_t i = 0; i < (uint32_t)order.size(); i++)
+        {
+            AssetHandle material = meshSource.geometries[order[i]].materailHandle;
+            if (meshSource.materialRanges.empty() || meshSource.materialRanges.back().material != material)
+                meshSource.materialRanges.push_back({ material, i, 0 });
+
+            meshSource.materialRanges.back().geometryCount++;
+        }
+    }
+
+    uint32_t MeshSourecHierarchy::AddName(std::string_view name)
+    {
+        uint32_t offset = (uint32_t)names.size();
+        names.insert(names.end(), name.begin(), name.end());
+        names.push_back('\0');
+        return offset;
+    }
+
+    static Math::box3 TransformBounds(const Math::box3& box, const Math::float4x4& m)
+    {
+        Math::float3 center = (box.m_mins + box.m_maxs) * 0.5f;
+        Math::float3 extents = (box.m_maxs - box.m_mins) * 0.5f;
+
+        Math::float3 worldCenter = Math::float3(m * Math::float4(center, 1.0f));
+        Math::float3 worldExtents = Math::abs(Math::float3(m[0])) * extents.x + Math::abs(Math::float3(m[1])) * extents.y + Math::abs(Math::float3(m[2])) * extents.z;
+
+        Math::box3 result;
+        result.m_mins = worldCenter - worldExtents;
+        result.m_maxs = worldCenter + worldExtents;
+        return result;
+    }
+
+    void UpdateHierarchy(MeshSourecHierarchy& hierarchy, const MeshSource& meshSource)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        const uint32_t nodeCount = (uint32_t)hierarchy.nodes.size();
+
+        hierarchy.parents.assign(nodeCount, c_Invalid);
+        for (uint32_t i = 0; i < nodeCount; i++)
+        {
+            const Node& node = hierarchy.nodes[i];
+            for (uint32_t c = 0; c < node.childrenCount && node.childrenOffset + c < nodeCount; c++)
+                hierarchy.parents[node.childrenOffset + c] = i;
+        }
+
+        // parents precede their children
+        hierarchy.worldTransforms.resize(nodeCount);
+        for (uint32_t i = 0; i < nodeCount; i++)
+        {
+            uint32_t parent = hierarchy.parents[i];
+            HE_ASSERT(parent == c_Invalid || parent < i);
+
+            const Math::float4x4& parentTransform = parent == c_Invalid ? hierarchy.root.transform : hierarchy.worldTransforms[parent];
+            hierarchy.worldTransforms[i] = parentTransform * hierarchy.nodes[i].transform;
+        }
+
+        Math::box3 empty;
+        empty.m_mins = Math::float3(std::numeric_limits<float>::max());
+        empty.m_maxs = Math::float3(-std::numeric_limits<float>::max());
+
+        hierarchy.worldBounds.assign(nodeCount, empty);
+        for (uint32_t i = 0; i < nodeCount; i++)
+        {
+            const Node& node = hierarchy.nodes[i];
+            if (node.type == NodeType::Mesh && node.index < meshSource.meshes.size())
+                hierarchy.worldBounds[i] = TransformBounds(meshSource.meshes[node.index].aabb, hierarchy.worldTransforms[i]);
+        }
+
+        // children follow their parents, so a reverse pass folds every subtree into its root
+        for (uint32_t i = nodeCount; i-- > 0;)
+        {
+            uint32_t parent = hierarchy.parents[i];
+            if (parent == c_Invalid)
+                continue;
+
+            auto& bounds = hierarchy.worldBounds[parent];
+            bounds.m_mins = Math::min(bounds.m_mins, hierarchy.worldBounds[i].m_mins);
+            bounds.m_maxs = Math::max(bounds.m_maxs, hierarchy.worldBounds[i].m_maxs);
+        }
+    }
+
+    void BuildMeshInstances(MeshSourecHierarchy& hierarchy, uint32_t meshCount)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE_ASSERT(hierarchy.worldTransforms.size() == hierarchy.nodes.size());
+
+        struct Instance
+        {
+            uint32_t mesh;
+            uint32_t node;
+            Math::float4x4 transform;
+        };
+
+        std::vector<Instance> instances;
+
+        if (hierarchy.root.type == NodeType::Mesh && hierarchy.root.index < meshCount)
+            instances.push_back({ hierarchy.root.index, c_Invalid, hierarchy.root.transform });
+
+        for (uint32_t i = 0; i < (uint32_t)hierarchy.nodes.size(); i++)
+        {
+            const Node& node = hierarchy.nodes[i];
+            if (node.type == NodeType::Mesh && node.index < meshCount)
+                instances.push_back({ node.index, i, hierarchy.worldTransforms[i] });
+        }
+
+        // counting sort by mesh
+        hierarchy.meshInstances.assign(meshCount, {});
+        for (const auto& instance : instances)
+            hierarchy.meshInstances[instance.mesh].transformCount++;
+
+        uint32_t offset = 0;
+        for (auto& range : hierarchy.meshInstances)
+        {
+            range.transformOffset = offset;
+            offset += range.transformCount;
+            range.transformCount = 0;
+        }
+
+        hierarchy.instanceTransforms.resize(instances.size());
+        hierarchy.instanceNodes.resize(instances.size());
+        for (const auto& instance : instances)
+        {
+            auto& range = hierarchy.meshInstances[instance.mesh];
+            uint32_t slot = range.transformOffset + range.transformCount++;
+            hierarchy.instanceTransforms[slot] = instance.transform;
+            hierarchy.instanceNodes[slot] = instance.node;
+        }
+    }
+
+    std::span<const Math::float4x4> MeshSourecHierarchy::GetInstanceTransforms(uint32_t meshIndex) const
+    {
+        if (meshIndex >= meshInstances.size())
+            return {};
+
+        const auto& range = meshInstances[meshIndex];
+        return std::span<const Math::float4x4>(instanceTransforms.data() + range.transformOffset, range.transformCount);
+    }
+}
@@ -14,7 +14,9 @@ namespace Assets {
 
     struct TextureInfo
     {
-        bool isSRGB;
+        bool isSRGB = false;
+        TextureUsage usage = TextureUsage::Color;
+        float alphaCutoff = 0.0f;
     };
 
     MeshSourceImporter::MeshSourceImporter(AssetManager* pAssetManager)
@@ -83,14 +85,171 @@ namespace Assets {
         bitangent2 = Math::normalize(bitangent0 - Math::dot(bitangent0, n2) * n2);
     }
 
+    static const uint8_t* BufferViewData(const cgltf_buffer_view* view)
+    {
+        return view->data ? (uint8_t*)view->data : (uint8_t*)view->buffer->data + view->offset; // decoded EXT_meshopt_compression views
+    }
+
     static std::pair<const uint8_t*, size_t> BufferIterator(const cgltf_accessor* accessor, size_t defaultStride)
     {
         const cgltf_buffer_view* view = accessor->buffer_view;
-        const uint8_t* data = (uint8_t*)view->buffer->data + view->offset + accessor->offset;
+        const uint8_t* data = BufferViewData(view) + accessor->offset;
         const size_t stride = view->stride ? view->stride : defaultStride;
         return std::make_pair(data, stride);
     }
 
+    static float ReadComponent(const uint8_t* src, cgltf_component_type type, bool normalized, size_t& size)
+    {
+        auto read = [&]<typename T>(T, float scale) {
+            T value;
+            std::memcpy(&value, src, sizeof(T));
+            size = sizeof(T);
+            return normalized ? std::max(float(value) / scale, -1.0f) : float(value);
+        };
+
+        switch (type)
+        {
+        case cgltf_component_type_r_8:   return read(int8_t(), 127.0f);
+        case cgltf_component_type_r_8u:  return read(uint8_t(), 255.0f);
+        case cgltf_component_type_r_16:  return read(int16_t(), 32767.0f);
+        case cgltf_component_type_r_16u: return read(uint16_t(), 65535.0f);
+        case cgltf_component_type_r_32u: return read(uint32_t(), 4294967295.0f);
+        case cgltf_component_type_r_32f: return read(float(), 1.0f);
+        default:                         size = 0; return 0.0f;
+        }
+    }
+
+    // index components are integers, a float read rounds uint32 indices past 2^24
+    static uint32_t ReadIndexComponent(const uint8_t* src, cgltf_component_type type, size_t& size)
+    {
+        auto read = [&]<typename T>(T) {
+            T value;
+            std::memcpy(&value, src, sizeof(T));
+            size = sizeof(T);
+            return uint32_t(value);
+        };
+
+        switch (type)
+        {
+        case cgltf_component_type_r_8u:  return read(uint8_t());
+        case cgltf_component_type_r_16u: return read(uint16_t());
+        case cgltf_component_type_r_32u: return read(uint32_t());
+        default:                         size = 0; return 0;
+        }
+    }
+
+    // Calls f(element, value) for the non zero elements of a vec3 accessor.
+    // Sparse accessors without a base view are read from their index and value views only, cgltf_accessor_read_float rejects sparse accessors.
+    template<typename F>
+    static void ForEachNonZeroElement(const cgltf_accessor* accessor, F&& f)
+    {
+        const Math::float3 zero(0.0f);
+
+        std::vector<uint32_t> sparseIndices;
+        std::vector<Math::float3> sparseValues;
+        if (accessor->is_sparse)
+        {
+            const auto& sparse = accessor->sparse;
+            sparseIndices.resize(sparse.count);
+            sparseValues.resize(sparse.count);
+
+            const uint8_t* indices = BufferViewData(sparse.indices_buffer_view) + sparse.indices_byte_offset;
+            const uint8_t* values = BufferViewData(sparse.values_buffer_view) + sparse.values_byte_offset;
+            for (cgltf_size i = 0; i < sparse.count; i++)
+            {
+                size_t size = 0;
+                sparseIndices[i] = ReadIndexComponent(indices, sparse.indices_component_type, size);
+                indices += size;
+
+                for (int c = 0; c < 3; c++)
+                {
+                    sparseValues[i][c] = ReadComponent(values, accessor->component_type, accessor->normalized, size);
+                    values += size;
+                }
+            }
+
+            if (!accessor->buffer_view)
+            {
+                for (size_t i = 0; i < sparseIndices.size(); i++)
+                {
+                    if (sparseValues[i] != zero && sparseIndices[i] < accessor->count)
+                        f(sparseIndices[i], sparseValues[i]);
+                }
+                return;
+            }
+        }
+
+        // dense, or the base view with the sparse values applied, sparse indices are strictly increasing
+        cgltf_accessor base = *accessor;
+        base.is_sparse = false;
+
+        size_t s = 0;
+        for (cgltf_size i = 0; i < accessor->count; i++)
+        {
+            Math::float3 value;
+            if (s < sparseIndices.size() && sparseIndices[s] == i)
+                value = sparseValues[s++];
+            else
+                cgltf_accessor_read_float(&base, i, Math::value_ptr(value), 3);
+
+            if (value != zero)
+                f(uint32_t(i), value);
+        }
+    }
+
+    struct MorphTargetDeltas
+    {
+        std::vector<uint32_t> vertices;
+        std::vector<Math::float3> positions;
+        std::vector<Math::float3> normals;
+        std::vector<Math::float3> tangents;
+    };
+
+    // Gathers the changed vertices of each target of the primitive, mesh local
+    static void AppendMorphDeltas(const cgltf_primitive& prim, uint32_t firstVertex, uint32_t vertexCount, std::vector<MorphTargetDeltas>& targets, std::vector<uint32_t>& slots)
+    {
+        slots.assign(vertexCount, c_Invalid);
+        if (targets.size() < prim.targets_count)
+            targets.resize(prim.targets_count);
+
+        for (cgltf_size t = 0; t < prim.targets_count; t++)
+        {
+            auto& deltas = targets[t];
+            const size_t first = deltas.vertices.size();
+
+            for (cgltf_size a = 0; a < prim.targets[t].attributes_count; a++)
+            {
+                const cgltf_attribute& attr = prim.targets[t].attributes[a];
+                if (attr.data->type != cgltf_type_vec3 || attr.data->count != vertexCount)
+                    continue;
+
+                std::vector<Math::float3>* dst = nullptr;
+                switch (attr.type)
+                {
+                case cgltf_attribute_type_position: dst = &deltas.positions; break;
+                case cgltf_attribute_type_normal:   dst = &deltas.normals;   break;
+                case cgltf_attribute_type_tangent:  dst = &deltas.tangents;  break;
+                default: continue;
+                }
+
+                ForEachNonZeroElement(attr.data, [&](uint32_t v, const Math::float3& value) {
+                    if (slots[v] == c_Invalid)
+                    {
+                        slots[v] = (uint32_t)deltas.vertices.size();
+                        deltas.vertices.push_back(firstVertex + v);
+                        deltas.positions.emplace_back(0.0f);
+                        deltas.normals.emplace_back(0.0f);
+                        deltas.tangents.emplace_back(0.0f);
+                    }
+                    (*dst)[slots[v]] = value;
+                });
+            }
+
+            for (size_t i = first; i < deltas.vertices.size(); i++)
+                slots[deltas.vertices[i] - firstVertex] = c_Invalid;
+        }
+    }
+
     static const char* CgltfErrorToString(cgltf_result res)
     {
         switch (res)
@@ -109,86 +268,209 @@ namespace Assets {
         }
     }
 
-    static void AppendNodes(Asset asset, Node& node, cgltf_node* cgltfNode, const cgltf_data* data)
+    // Texture caches of a glTF or .hmesh are named after the source and the texture index
+    static std::filesystem::path GetTextureCachePath(const std::filesystem::path& sourcePath, size_t index)
+    {
+        return sourcePath.parent_path() / std::format("{}.texture{}.dds", sourcePath.stem().string(), index);
+    }
+
+    // Creates the texture and uploads every level with one command list on the main thread.
+    // Streamed textures are created by the streamer with their mip tail only, from the cache when the source is held in memory.
+    static void UploadTexture(AssetManager* assetManager, Asset asset, nvrhi::IDevice* device, const std::string& name, HE::Ref<TextureFile> source, const std::filesystem::path& cachePath)
+    {
+        auto& texture = asset.Get<Texture>();
+        asset.Get<AssetState>() = AssetState::Loading;
+
+        const bool streaming = assetManager->desc.textureImportSettings.streaming;
+        if (streaming)
+            source = CacheTextureFile(source, cachePath);
+
+        auto& desc = source->desc;
+        desc.initialState = nvrhi::ResourceStates::ShaderResource;
+        desc.debugName = name;
+        desc.keepInitialState = true;
+
+        if (!streaming)
+            texture.texture = device->createTexture(desc);
+
+        HE::Jops::SubmitToMainThread([assetManager, device, asset, source, streaming]() mutable {
+
+            auto& texture = asset.Get<Texture>();
+            auto& state = asset.Get<AssetState>();
+            assetManager->MarkAsMemoryOnlyAsset(asset, AssetType::Texture2D);
+
+            if (streaming)
+            {
+                assetManager->textureStreamer.Add(asset, source);
+            }
+            else
+            {
+                auto commandList = device->createCommandList({ .enableImmediateExecution = false });
+                commandList->open();
+                WriteTextureFile(commandList, texture.texture, *source);
+                commandList->close();
+                device->executeCommandList(commandList);
+            }
+
+            source.reset();
+            state = AssetState::Loaded;
+            assetManager->OnAssetLoaded(asset);
+
+            assetManager->asyncTaskCount--;
+        });
+    }
+
+    // Decodes the image and builds its mip chain, block compressed when the texture settings ask for it
+    static HE::Ref<MipChain> BuildTextureChain(AssetManager* assetManager, HE::Buffer buffer, const TextureInfo& info)
     {
         HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
 
-        if (cgltfNode->mesh)
-        {
-            node.index = (uint32_t)cgltf_mesh_index(data, cgltfNode->mesh);
-            node.type = NodeType::Mesh;
-        }
+        const auto& settings = assetManager->desc.textureImportSettings;
+        HE::Image image(buffer);
+
+        MipGenerationDesc mipDesc;
+        mipDesc.filter = settings.mipFilter;
+        mipDesc.isSRGB = info.isSRGB;
+        mipDesc.isNormalMap = info.usage == TextureUsage::Normal;
+        mipDesc.alphaCutoff = info.alphaCutoff;
 
-        if (cgltfNode->camera)
+        auto chain = HE::CreateRef<MipChain>();
+        GenerateMips(image.GetData(), image.GetWidth(), image.GetHeight(), mipDesc, *chain);
+
+        if (settings.blockCompression)
         {
-            node.index = (uint32_t)cgltf_camera_index(data, cgltfNode->camera);
-            node.type = NodeType::Camera;
+            auto compressed = HE::CreateRef<MipChain>();
+            if (CompressMipChain(*chain, ChooseTextureCompression(*chain, info.usage, settings.preferBC7), *compressed))
+                return compressed;
         }
 
-        auto& hierarchy = asset.Get<MeshSourecHierarchy>();
+        return chain;
+    }
 
-        node.childrenOffset = (uint32_t)hierarchy.nodes.size();
-        node.childrenCount = (uint32_t)cgltfNode->children_count;
+    // The mip chain is built here on the worker, the main thread only records the upload.
+    // Streamed textures reuse the cache of the source when it is up to date.
+    static void ImportTexture(AssetManager* assetManager, Asset asset, HE::Buffer buffer, nvrhi::IDevice* device, const std::string& name, const TextureInfo& info, const std::filesystem::path& sourcePath, size_t index)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
 
-        for (cgltf_size i = 0; i < cgltfNode->children_count; i++)
-        {
-            cgltf_node* child = cgltfNode->children[i];
-            Node& newNode = hierarchy.nodes.emplace_back();
-            newNode.name = child->name ? child->name : "None";
-            newNode.transform = GetNodeTransform(child);
-        }
+        asset.Get<AssetState>() = AssetState::Loading;
 
-        for (cgltf_size i = 0; i < cgltfNode->children_count; i++)
+        auto cachePath = GetTextureCachePath(sourcePath, index);
+        if (assetManager->desc.textureImportSettings.streaming)
         {
-            Node& newNode = hierarchy.nodes[node.childrenOffset + i];
-            cgltf_node* child = cgltfNode->children[i];
-
-            AppendNodes(asset, newNode, child, data);
+            if (auto cached = LoadTextureCache(cachePath, sourcePath))
+            {
+                UploadTexture(assetManager, asset, device, name, cached, {});
+                return;
+            }
         }
+
+        auto chain = BuildTextureChain(assetManager, buffer, info);
+        const nvrhi::Format format = GetTextureFormat(chain->compression, info.isSRGB);
+        UploadTexture(assetManager, asset, device, name, CreateTextureFile(std::move(*chain), format), cachePath);
     }
 
-    static void ImportTexture(AssetManager* assetManager, Asset asset, HE::Buffer buffer, nvrhi::IDevice* device, const std::string& name, bool isSRGB)
+    // Creates the GPU buffers and fills them on the main thread, the CPU copies are dropped there unless the residency keeps them.
+    // Paged sources without CPU geometry are filled one page per main thread task, each page is mapped only for its copy.
+    static void UploadGeometry(AssetManager* assetManager, Asset asset, const std::string& name)
     {
         HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
 
-        auto handle = asset.GetHandle();
-        auto& texture = asset.Get<Texture>();
-        auto& state = asset.Get<AssetState>();
-        state = AssetState::Loading;
+        auto& meshSource = asset.Get<MeshSource>();
+        nvrhi::IDevice* device = assetManager->device;
+        bool paged = meshSource.cpuVertexBuffer.empty() && !meshSource.pageTable.empty();
+        uint64_t vertexBytes = paged ? meshSource.pageTable.byteSizes[(int)GeometryStream::Vertex] : meshSource.cpuVertexBuffer.size();
+        uint64_t indexBytes = paged ? meshSource.pageTable.byteSizes[(int)GeometryStream::Index] : meshSource.cpuIndexBuffer.size() * sizeof(uint32_t);
+        if (!device || vertexBytes == 0 || indexBytes == 0)
+            return;
 
-        HE::Image image(buffer);
-        uint8_t* data = image.ExtractData();
+        nvrhi::BufferDesc vertexDesc;
+        vertexDesc.byteSize = vertexBytes;
+        vertexDesc.debugName = name + " vertices";
+        vertexDesc.isVertexBuffer = true;
+        vertexDesc.canHaveRawViews = true;
+        vertexDesc.isAccelStructBuildInput = true;
+        vertexDesc.initialState = nvrhi::ResourceStates::VertexBuffer | nvrhi::ResourceStates::ShaderResource;
+        vertexDesc.keepInitialState = true;
+        meshSource.vertexBuffer = device->createBuffer(vertexDesc);
+
+        nvrhi::BufferDesc indexDesc;
+        indexDesc.byteSize = indexBytes;
+        indexDesc.debugName = name + " indices";
+        indexDesc.isIndexBuffer = true;
+        indexDesc.canHaveRawViews = true;
+        indexDesc.isAccelStructBuildInput = true;
+        indexDesc.initialState = nvrhi::ResourceStates::IndexBuffer | nvrhi::ResourceStates::ShaderResource;
+        indexDesc.keepInitialState = true;
+        meshSource.indexBuffer = device->createBuffer(indexDesc);
+
+        if (paged)
+        {
+            for (int s = 0; s < (int)GeometryStream::Count; s++)
+            {
+                for (const auto& page : meshSource.pageTable.pages[s])
+                {
+                    assetManager->asyncTaskCount++;
+                    HE::Jops::SubmitToMainThread([assetManager, device, asset, s, byteOffset = page.byteOffset, byteSize = page.byteSize]() mutable {
 
-        nvrhi::TextureDesc desc;
-        desc.width = image.GetWidth();
-        desc.height = image.GetHeight();
-        desc.format = isSRGB ? nvrhi::Format::SRGBA8_UNORM : nvrhi::Format::RGBA8_UNORM;
-        desc.initialState = nvrhi::ResourceStates::ShaderResource;
-        desc.debugName = name;
-        desc.keepInitialState = true;
-        texture.texture = device->createTexture(desc);
+                        auto& meshSource = asset.Get<MeshSource>();
+                        auto& table = meshSource.pageTable;
+                        auto file = MappedFile::Open(table.path, table.fileOffsets[s] + byteOffset, byteSize, true);
+                        if (file && file->size == byteSize)
+                        {
+                            auto commandList = device->createCommandList({ .enableImmediateExecution = false });
+                            commandList->open();
+                            commandList->writeBuffer(s == (int)GeometryStream::Vertex ? meshSource.vertexBuffer : meshSource.indexBuffer, file->data, file->size, byteOffset);
+                            commandList->close();
+                            device->executeCommandList(commandList);
+                        }
+                        else
+                        {
+                            HE_ERROR("MeshSource : unable to upload a page of {}", table.path.string());
+                        }
 
-        HE::Jops::SubmitToMainThread([assetManager, device, asset, data]() mutable {
+                        assetManager->asyncTaskCount--;
+                    });
+                }
+            }
 
-            auto& texture = asset.Get<Texture>();
-            auto& state = asset.Get<AssetState>();
-            assetManager->MarkAsMemoryOnlyAsset(asset, AssetType::Texture2D);
+            return;
+        }
+
+        assetManager->asyncTaskCount++;
+        HE::Jops::SubmitToMainThread([assetManager, device, asset]() mutable {
+
+            auto& meshSource = asset.Get<MeshSource>();
 
             auto commandList = device->createCommandList({ .enableImmediateExecution = false });
             commandList->open();
-            commandList->writeTexture(texture.texture, 0, 0, data, texture.texture->getDesc().width * 4);
+            commandList->writeBuffer(meshSource.vertexBuffer, meshSource.cpuVertexBuffer.data(), meshSource.cpuVertexBuffer.size());
+            commandList->writeBuffer(meshSource.indexBuffer, meshSource.cpuIndexBuffer.data(), meshSource.cpuIndexBuffer.size() * sizeof(uint32_t));
             commandList->close();
             device->executeCommandList(commandList);
 
-            std::free(data);
-            state = AssetState::Loaded;
-            assetManager->OnAssetLoaded(asset);
+            meshSource.ReleaseCpuGeometry();
 
             assetManager->asyncTaskCount--;
         });
     }
 
-    static void AppendMeshes(cgltf_data* data, MeshSource& meshSource, std::unordered_map<const cgltf_material*, Asset>& materials)
+    // Snorm8x4 directly, finer final formats keep the floats until ConvertVertexFormats
+    static void WriteDirection(MeshSource& meshSource, VertexAttribute attr, size_t vertex, const Math::float4& value)
+    {
+        uint8_t* dst = meshSource.cpuVertexBuffer.data() + meshSource.vertexBufferRanges[int(attr)].byteOffset + vertex * meshSource.GetVertexElementSize(attr);
+        if (meshSource.vertexFormats[int(attr)] == VertexFormat::Snorm8x4)
+        {
+            uint32_t packed = Math::vectorToSnorm8(value);
+            std::memcpy(dst, &packed, sizeof(packed));
+        }
+        else
+        {
+            std::memcpy(dst, &value, meshSource.GetVertexElementSize(attr));
+        }
+    }
+
+    static void AppendMeshes(cgltf_data* data, MeshSource& meshSource, std::unordered_map<const cgltf_material*, Asset>& materials, const MeshSourceImportSettings& settings)
     {
         HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
 
@@ -197,6 +479,7 @@ namespace Assets {
         size_t totalVertices = 0;
         bool hasJoints = false;
         bool hasUV1 = false;
+        bool hasRadius = false;
         uint32_t geometryCount = 0;
 
         for (size_t mesh_idx = 0; mesh_idx < data->meshes_count; mesh_idx++)
@@ -246,19 +529,38 @@ namespace Assets {
                         }
                     }
                 }
+
+                if (!hasRadius)
+                {
+                    for (size_t attr_idx = 0; attr_idx < prim.attributes_count; attr_idx++)
+                    {
+                        const cgltf_attribute& attr = prim.attributes[attr_idx];
+                        if (attr.type == cgltf_attribute_type_custom && attr.name && std::string_view(attr.name) == "_RADIUS")
+                        {
+                            hasRadius = true;
+                            break;
+                        }
+                    }
+                }
             }
         }
 
         meshSource.cpuIndexBuffer.resize(totalIndices);
 
-        uint32_t positionByteSize = uint32_t(totalVertices * GetVertexAttributeSize(VertexAttribute::Position));
-        uint32_t normalByteSize = uint32_t(totalVertices * GetVertexAttributeSize(VertexAttribute::Normal));
-        uint32_t tangentByteSize = uint32_t(totalVertices * GetVertexAttributeSize(VertexAttribute::Tangent));
-        uint32_t texCoordByteSize = uint32_t(totalVertices * GetVertexAttributeSize(VertexAttribute::TexCoord0));
-        uint32_t boneIndicesByteSize = uint32_t(totalVertices * GetVertexAttributeSize(VertexAttribute::BoneIndices));
-        uint32_t boneWeightByteSize = uint32_t(totalVertices * GetVertexAttributeSize(VertexAttribute::BoneWeights));
+        if (settings.normalFormat != VertexFormat::Snorm8x4)
+            meshSource.vertexFormats[int(VertexAttribute::Normal)] = VertexFormat::Float3;
+        if (settings.tangentFormat != VertexFormat::Snorm8x4)
+            meshSource.vertexFormats[int(VertexAttribute::Tangent)] = VertexFormat::Float4;
+
+        uint64_t positionByteSize = totalVertices * GetVertexAttributeSize(VertexAttribute::Position);
+        uint64_t normalByteSize = totalVertices * meshSource.GetVertexElementSize(VertexAttribute::Normal);
+        uint64_t tangentByteSize = totalVertices * meshSource.GetVertexElementSize(VertexAttribute::Tangent);
+        uint64_t texCoordByteSize = totalVertices * GetVertexAttributeSize(VertexAttribute::TexCoord0);
+        uint64_t boneIndicesByteSize = totalVertices * GetVertexAttributeSize(VertexAttribute::BoneIndices);
+        uint64_t boneWeightByteSize = totalVertices * GetVertexAttributeSize(VertexAttribute::BoneWeights);
+        uint64_t radiusByteSize = totalVertices * GetVertexAttributeSize(VertexAttribute::Radius);
 
-        uint32_t bufferSize = 0;
+        uint64_t bufferSize = 0;
         bufferSize += positionByteSize;
         bufferSize += normalByteSize;
         bufferSize += tangentByteSize;
@@ -271,12 +573,17 @@ namespace Assets {
 
         if (hasJoints)
         {
-            bufferSize += uint32_t(totalVertices * GetVertexAttributeSize(VertexAttribute::BoneIndices));
-            bufferSize += uint32_t(totalVertices * GetVertexAttributeSize(VertexAttribute::BoneWeights));
+            bufferSize += boneIndicesByteSize;
+            bufferSize += boneWeightByteSize;
+        }
+
+        if (hasRadius)
+        {
+            bufferSize += radiusByteSize;
         }
 
         meshSource.cpuVertexBuffer.resize(bufferSize);
-        meshSource.vertexCount = (uint32_t)totalVertices;
+        meshSource.vertexCount = totalVertices;
 
         meshSource.vertexBufferRanges[int(VertexAttribute::Position)]  = { 0                                                   , positionByteSize };
         meshSource.vertexBufferRanges[int(VertexAttribute::Normal)]    = { positionByteSize                                    , normalByteSize   };
@@ -288,11 +595,18 @@ namespace Assets {
             meshSource.vertexBufferRanges[int(VertexAttribute::TexCoord1)] = { positionByteSize + normalByteSize + tangentByteSize + texCoordByteSize , texCoordByteSize };
         }
 
+        if (hasRadius)
+        {
+            meshSource.vertexBufferRanges[int(VertexAttribute::Radius)] = { bufferSize - radiusByteSize, radiusByteSize };
+        }
+
         totalIndices = 0;
         totalVertices = 0;
 
         std::vector<Math::float3> computedTangents;
         std::vector<Math::float3> computedBitangents;
+        std::vector<MorphTargetDeltas> morphTargets;
+        std::vector<uint32_t> morphSlots;
 
         meshSource.meshes.reserve(data->meshes_count);
         meshSource.geometries.reserve(geometryCount);
@@ -309,9 +623,8 @@ namespace Assets {
             {
                 mesh.name = cltfMesh.name;
             }
-            mesh.meshSource = &meshSource;
-            mesh.indexOffset = (uint32_t)totalIndices;
-            mesh.vertexOffset = (uint32_t)totalVertices;
+            mesh.indexOffset = totalIndices;
+            mesh.vertexOffset = totalVertices;
            
             mesh.geometryOffset = geometryCount;
             mesh.geometryCount = (uint32_t)cltfMesh.primitives_count;
@@ -344,6 +657,7 @@ namespace Assets {
                 const cgltf_accessor* texcoords1Accessor = nullptr;
                 const cgltf_accessor* joint_weightsAccessor = nullptr;
                 const cgltf_accessor* joint_indicesAccessor = nullptr;
+                const cgltf_accessor* radiusAccessor = nullptr;
 
                 for (size_t attr_idx = 0; attr_idx < prim.attributes_count; attr_idx++)
                 {
@@ -353,22 +667,22 @@ namespace Assets {
                     {
                     case cgltf_attribute_type_position:
                         HE_ASSERT(attr.data->type == cgltf_type_vec3);
-                        HE_ASSERT(attr.data->component_type == cgltf_component_type_r_32f);
+                        HE_ASSERT(attr.data->component_type != cgltf_component_type_r_32u); // float or KHR_mesh_quantization 8/16 bit
                         positionsAccessor = attr.data;
                         break;
                     case cgltf_attribute_type_normal:
                         HE_ASSERT(attr.data->type == cgltf_type_vec3);
-                        HE_ASSERT(attr.data->component_type == cgltf_component_type_r_32f);
+                        HE_ASSERT(attr.data->component_type == cgltf_component_type_r_32f || attr.data->normalized);
                         normalsAccessor = attr.data;
                         break;
                     case cgltf_attribute_type_tangent:
                         HE_ASSERT(attr.data->type == cgltf_type_vec4);
-                        HE_ASSERT(attr.data->component_type == cgltf_component_type_r_32f);
+                        HE_ASSERT(attr.data->component_type == cgltf_component_type_r_32f || attr.data->normalized);
                         tangentsAccessor = attr.data;
                         break;
                     case cgltf_attribute_type_texcoord:
                         HE_ASSERT(attr.data->type == cgltf_type_vec2);
-                        HE_ASSERT(attr.data->component_type == cgltf_component_type_r_32f);
+                        HE_ASSERT(attr.data->component_type != cgltf_component_type_r_32u);
                         if (attr.index == 0)
                             texcoords0Accessor = attr.data;
                         if (attr.index == 1)
@@ -384,6 +698,13 @@ namespace Assets {
                         HE_ASSERT(attr.data->component_type == cgltf_component_type_r_8u || attr.data->component_type == cgltf_component_type_r_16u || attr.data->component_type == cgltf_component_type_r_32f);
                         joint_weightsAccessor = attr.data;
                         break;
+                    case cgltf_attribute_type_custom:
+                        if (attr.name && std::string_view(attr.name) == "_RADIUS")
+                        {
+                            HE_ASSERT(attr.data->type == cgltf_type_scalar);
+                            radiusAccessor = attr.data;
+                        }
+                        break;
                     default:
                         break;
                     }
@@ -457,27 +778,22 @@ namespace Assets {
                 if (normalsAccessor)
                 {
                     HE_ASSERT(normalsAccessor->count == positionsAccessor->count);
-                    uint32_t* normalDst = meshSource.GetAttribute<uint32_t>(VertexAttribute::Normal) + totalVertices;
-
                     for (size_t v_idx = 0; v_idx < normalsAccessor->count; v_idx++)
                     {
                         cgltf_float norm[3];
                         cgltf_accessor_read_float(normalsAccessor, v_idx, norm, 3);
-                        *normalDst = Math::vectorToSnorm8(Math::float3(norm[0], norm[1], norm[2]));
-                        ++normalDst;
+                        WriteDirection(meshSource, VertexAttribute::Normal, totalVertices + v_idx, Math::float4(norm[0], norm[1], norm[2], 0.0f));
                     }
                 }
 
                 if (tangentsAccessor)
                 {
                     HE_ASSERT(tangentsAccessor->count == positionsAccessor->count);
-                    uint32_t* tangentDst = meshSource.GetAttribute<uint32_t>(VertexAttribute::Tangent) + totalVertices;
                     for (size_t v_idx = 0; v_idx < tangentsAccessor->count; v_idx++)
                     {
                         cgltf_float tang[4];
                         cgltf_accessor_read_float(tangentsAccessor, v_idx, tang, 4);
-                        *tangentDst = Math::vectorToSnorm8(Math::float4(tang[0], tang[1], tang[2], tang[3]));
-                        ++tangentDst;
+                        WriteDirection(meshSource, VertexAttribute::Tangent, totalVertices + v_idx, Math::float4(tang[0], tang[1], tang[2], tang[3]));
                     }
                 }
 
@@ -518,6 +834,18 @@ namespace Assets {
                     }
                 }
 
+                if (radiusAccessor)
+                {
+                    HE_ASSERT(radiusAccessor->count == positionsAccessor->count);
+                    float* radiusDst = meshSource.GetAttribute<float>(VertexAttribute::Radius) + totalVertices;
+
+                    for (size_t v_idx = 0; v_idx < radiusAccessor->count; v_idx++)
+                    {
+                        cgltf_accessor_read_float(radiusAccessor, v_idx, radiusDst, 1);
+                        ++radiusDst;
+                    }
+                }
+
                 if (normalsAccessor && texcoords0Accessor && (!tangentsAccessor || c_ForceRebuildTangents))
                 {
                     computedTangents.resize(positionsAccessor->count);
@@ -569,8 +897,6 @@ namespace Assets {
                         computedBitangents[i2] = bitangent2;
                     }
 
-                    uint32_t* tangentDst = meshSource.GetAttribute<uint32_t>(VertexAttribute::Tangent) + totalVertices;
-
                     for (size_t v_idx = 0; v_idx < positionsAccessor->count; v_idx++)
                     {
                         Math::float3 normal;
@@ -590,8 +916,7 @@ namespace Assets {
                             sign = (Math::dot(cross_b, bitangent) > 0) ? -1.f : 1.f;
                         }
 
-                        *tangentDst = Math::vectorToSnorm8(Math::float4(tangent, sign));
-                        ++tangentDst;
+                        WriteDirection(meshSource, VertexAttribute::Tangent, totalVertices + v_idx, Math::float4(tangent, sign));
                     }
                 }
 
@@ -601,8 +926,13 @@ namespace Assets {
                 {
                     geometry.materailHandle = materials.at(prim.material).GetHandle();
                 }
+                else if (prim.material && materials.empty())
+                {
+                    // geometry re-fetch, stand-in handles keep the material grouping of the original import
+                    geometry.materailHandle = AssetHandle(cgltf_material_index(data, prim.material) + 1);
+                }
 
-                geometry.mesh = &mesh;
+                geometry.mesh = (uint32_t)mesh_idx;
                 geometry.indexOffsetInMesh = mesh.indexCount;
                 geometry.vertexOffsetInMesh = mesh.vertexCount;
                 geometry.indexCount = (uint32_t)indexCount;
@@ -617,26 +947,217 @@ namespace Assets {
                 case cgltf_primitive_type_line_strip: geometry.type = MeshGeometryPrimitiveType::LineStrip;  break;
                 }
 
+                // offsets into the source are 64 bit, counts within a mesh stay 32 bit
+                HE_ASSERT(uint64_t(mesh.indexCount) + geometry.indexCount <= std::numeric_limits<uint32_t>::max());
+                HE_ASSERT(uint64_t(mesh.vertexCount) + geometry.vertexCount <= std::numeric_limits<uint32_t>::max());
+
                 mesh.aabb |= bounds;
                 mesh.indexCount += geometry.indexCount;
                 mesh.vertexCount += geometry.vertexCount;
 
+                if (prim.targets_count)
+                    AppendMorphDeltas(prim, geometry.vertexOffsetInMesh, geometry.vertexCount, morphTargets, morphSlots);
+
                 totalIndices += geometry.indexCount;
                 totalVertices += geometry.vertexCount;
                 geometryCount++;
             }
+
+            for (size_t t = 0; t < morphTargets.size(); t++)
+            {
+                const auto& deltas = morphTargets[t];
+                const char* name = t < cltfMesh.target_names_count && cltfMesh.target_names[t] ? cltfMesh.target_names[t] : "Target";
+                float weight = t < cltfMesh.weights_count ? cltfMesh.weights[t] : 0.0f;
+                AppendMorphTarget(meshSource, mesh, name, weight, deltas.vertices, deltas.positions, deltas.normals, deltas.tangents);
+            }
+            morphTargets.clear();
+        }
+    }
+
+    static void ProcessMeshSource(MeshSource& meshSource, const MeshSourceImportSettings& settings, MeshSourceImportStats& stats)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        if (settings.sortGeometriesByMaterial)
+            SortGeometriesByMaterial(meshSource);
+
+        if (settings.processCurves)
+            BuildCurves(meshSource, settings.curveType, settings.curveTolerance, settings.curveRadius, settings.curveChunkSegments, settings.curveTubeSides, settings.keepCurveRadius);
+
+        stats.vertexCountBeforeWeld = meshSource.vertexCount;
+        if (settings.weldVertices)
+            stats.vertexBytesSaved = WeldVertices(meshSource, settings.weldEpsilon);
+        stats.vertexCountAfterWeld = meshSource.vertexCount;
+
+        if (settings.generateLODs)
+            BuildLODs(meshSource, settings.lodCount, settings.lodReduction, settings.lodMaxError);
+
+        if (settings.generateMeshlets)
+            BuildMeshlets(meshSource, settings.maxMeshletVertices, settings.maxMeshletTriangles);
+
+        auto formats = meshSource.vertexFormats;
+        formats[int(VertexAttribute::Position)] = settings.positionFormat;
+        formats[int(VertexAttribute::Normal)] = settings.normalFormat;
+        formats[int(VertexAttribute::Tangent)] = settings.tangentFormat;
+        formats[int(VertexAttribute::TexCoord0)] = settings.texCoordFormat;
+        formats[int(VertexAttribute::TexCoord1)] = settings.texCoordFormat;
+        formats[int(VertexAttribute::BoneWeights)] = settings.boneWeightFormat;
+
+        if (formats != meshSource.vertexFormats)
+            ConvertVertexFormats(meshSource, formats);
+
+        if (settings.vertexLayout != meshSource.vertexLayout)
+            SetVertexLayout(meshSource, settings.vertexLayout);
+
+        BuildMaterialRanges(meshSource);
+
+        if (settings.buildBVH)
+            BuildBVH(meshSource);
+    }
+
+    // Reads a buffer or image uri, either a base64 data uri or a file relative to the .gltf
+    static HE::Ref<MappedFile> LoadGltfUri(const std::filesystem::path& directory, const char* uri, bool map)
+    {
+        if (std::strncmp(uri, "data:", 5) == 0)
+        {
+            const char* base64 = std::strstr(uri, ";base64,");
+            auto file = HE::CreateRef<MappedFile>();
+            if (!base64 || !DecodeBase64(base64 + 8, file->storage))
+            {
+                HE_ERROR("MeshSourceImporter : unsupported data uri");
+                return nullptr;
+            }
+
+            file->data = file->storage.data();
+            file->size = file->storage.size();
+            return file;
         }
+
+        std::string relativePath = uri;
+        cgltf_decode_uri(relativePath.data());
+        relativePath.resize(std::strlen(relativePath.c_str()));
+
+        return MappedFile::Open(directory / relativePath, map);
     }
 
-    static cgltf_data* LoadGltfData(cgltf_options options, const char* cStrFilePath)
+    // EXT_meshopt_compression, each compressed view is decoded in parallel into view.data which cgltf_free releases
+    static bool DecodeMeshoptBufferViews(cgltf_data* data)
     {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        std::atomic<bool> failed = false;
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), size_t(data->buffer_views_count), size_t(1), [&](size_t i) {
+
+            cgltf_buffer_view& view = data->buffer_views[i];
+            if (!view.has_meshopt_compression || view.data)
+                return;
+
+            const cgltf_meshopt_compression& compression = view.meshopt_compression;
+            if (!compression.buffer->data)
+            {
+                HE_ERROR("MeshSourceImporter : meshopt buffer view {} has no data", i);
+                failed = true;
+                return;
+            }
+
+            const uint8_t* src = (const uint8_t*)compression.buffer->data + compression.offset;
+            void* dst = std::malloc(compression.count * compression.stride);
+
+            bool decoded = false;
+            switch (compression.mode)
+            {
+            case cgltf_meshopt_compression_mode_attributes: decoded = DecodeMeshoptVertexBuffer(dst, compression.count, compression.stride, src, compression.size);  break;
+            case cgltf_meshopt_compression_mode_triangles:  decoded = DecodeMeshoptIndexBuffer(dst, compression.count, compression.stride, src, compression.size);   break;
+            case cgltf_meshopt_compression_mode_indices:    decoded = DecodeMeshoptIndexSequence(dst, compression.count, compression.stride, src, compression.size); break;
+            default: break;
+            }
+
+            MeshoptFilter filter = MeshoptFilter::None;
+            switch (compression.filter)
+            {
+            case cgltf_meshopt_compression_filter_octahedral:  filter = MeshoptFilter::Octahedral;  break;
+            case cgltf_meshopt_compression_filter_quaternion:  filter = MeshoptFilter::Quaternion;  break;
+            case cgltf_meshopt_compression_filter_exponential: filter = MeshoptFilter::Exponential; break;
+            default: break;
+            }
+
+            if (!decoded || !DecodeMeshoptFilter(filter, dst, compression.count, compression.stride))
+            {
+                HE_ERROR("MeshSourceImporter : unable to decode meshopt buffer view {}", i);
+                std::free(dst);
+                failed = true;
+                return;
+            }
+
+            view.data = dst;
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        return !failed;
+    }
+
+    // Parses the file in place, for .glb the binary chunk is used as buffer 0 without a copy.
+    // External buffers are loaded in parallel into files[1 + bufferIndex].
+    // files must outlive data and every pointer into its buffers.
+    static cgltf_data* LoadGltfData(cgltf_options options, const char* cStrFilePath, bool map, std::vector<HE::Ref<MappedFile>>& files, MeshSourceImportStats& stats)
+    {
+        HE::Timer t;
+
+        files.clear();
+        auto file = MappedFile::Open(cStrFilePath, map);
+        if (!file)
+            return nullptr;
+
+        files.push_back(file);
+
         cgltf_data* data = nullptr;
-        cgltf_result result = cgltf_parse_file(&options, cStrFilePath, &data);
+        cgltf_result result = cgltf_parse(&options, file->data, file->size, &data);
         if (result != cgltf_result_success)
         {
             HE_ERROR("{}", CgltfErrorToString(result));
             return nullptr;
         }
+
+        stats.parseTime = t.ElapsedMilliseconds();
+
+        // buffers with data already set are skipped by cgltf_load_buffers and left alone by cgltf_free
+        {
+            HE::Timer t;
+
+            auto directory = std::filesystem::path(cStrFilePath).parent_path();
+            files.resize(1 + data->buffers_count);
+            std::atomic<bool> failed = false;
+
+            HE::Jops::Taskflow tf;
+            tf.for_each_index(size_t(0), size_t(data->buffers_count), size_t(1), [&](size_t i) {
+
+                cgltf_buffer& buffer = data->buffers[i];
+                if (buffer.data || !buffer.uri)
+                    return;
+
+                auto bufferFile = LoadGltfUri(directory, buffer.uri, map);
+                if (!bufferFile || bufferFile->size < buffer.size)
+                {
+                    HE_ERROR("MeshSourceImporter : unable to load buffer {}", i);
+                    failed = true;
+                    return;
+                }
+
+                buffer.data = bufferFile->data;
+                files[1 + i] = bufferFile;
+            });
+            HE::Jops::RunTaskflow(tf).wait();
+
+            if (failed)
+            {
+                cgltf_free(data);
+                return nullptr;
+            }
+
+            stats.bufferTime = t.ElapsedMilliseconds();
+        }
     
         result = cgltf_load_buffers(&options, data, cStrFilePath);
         if (result != cgltf_result_success)
@@ -654,13 +1175,41 @@ namespace Assets {
             return nullptr;
         }
 
+        {
+            HE::Timer t;
+
+            if (!DecodeMeshoptBufferViews(data))
+            {
+                cgltf_free(data);
+                return nullptr;
+            }
+
+            stats.decodeTime = t.ElapsedMilliseconds();
+        }
+
         return data;
     }
 
-    static void AppendMaterials(
-        AssetManager* assetManager,
-        cgltf_data* data,
-        std::unordered_map<const cgltf_material*, Asset>& materials,
+    // Encoded image bytes, owner keeps them alive when they come from a separate file or a data uri
+    static std::span<uint8_t> GetGltfImageData(const cgltf_image* image, const std::filesystem::path& directory, bool map, HE::Ref<MappedFile>& owner)
+    {
+        const cgltf_buffer_view* view = image->buffer_view;
+        if (view && view->data)
+            return { (uint8_t*)view->data, view->size };
+
+        if (view && view->buffer->data)
+            return { (uint8_t*)view->buffer->data + view->offset, view->size };
+
+        if (image->uri && (owner = LoadGltfUri(directory, image->uri, map)))
+            return { owner->data, owner->size };
+
+        return {};
+    }
+
+    static void AppendMaterials(
+        AssetManager* assetManager,
+        cgltf_data* data,
+        std::unordered_map<const cgltf_material*, Asset>& materials,
         Asset mainAsset,
         uint32_t materialCount
     )
@@ -781,6 +1330,30 @@ namespace Assets {
             {
                 auto& t = textures[base_color_texture];
                 t.isSRGB = true;
+                if (cgltfMat.alpha_mode == cgltf_alpha_mode_mask)
+                    t.alphaCutoff = cgltfMat.alpha_cutoff;
+            }
+
+            auto normal_texture = cgltfMat.normal_texture.texture;
+            if (normal_texture && !textures.contains(normal_texture))
+            {
+                auto& t = textures[normal_texture];
+                t.usage = TextureUsage::Normal;
+            }
+
+            // occlusion is often packed with metallic roughness, the packed texture keeps all its channels
+            auto metallic_roughness_texture = cgltfMat.pbr_metallic_roughness.metallic_roughness_texture.texture;
+            if (cgltfMat.has_pbr_metallic_roughness && metallic_roughness_texture)
+            {
+                auto& t = textures[metallic_roughness_texture];
+                t.usage = TextureUsage::Data;
+            }
+
+            auto occlusion_texture = cgltfMat.occlusion_texture.texture;
+            if (occlusion_texture && !textures.contains(occlusion_texture))
+            {
+                auto& t = textures[occlusion_texture];
+                t.usage = TextureUsage::Mask;
             }
 
             auto diffuse_texture = cgltfMat.pbr_specular_glossiness.diffuse_texture.texture;
@@ -799,36 +1372,71 @@ namespace Assets {
         }
     }
 
-    static void AppendNodes(Asset asset, cgltf_data* data)
+    // Breadth first without recursion, the node array is the queue : a node's children are appended as one block when it is reached
+    static void AppendNodes(Asset asset, cgltf_data* data, std::unordered_map<const cgltf_node*, uint32_t>& nodeIndices)
     {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
         HE::Timer t;
 
         auto& hierarchy = asset.Add<MeshSourecHierarchy>();
-        auto handle = asset.GetHandle();
 
+        // names are interned, cgltf keeps the keys alive for the duration of the import
+        std::unordered_map<std::string_view, uint32_t> names;
+        auto internName = [&](const char* name) {
+            auto [it, inserted] = names.try_emplace(name, 0);
+            if (inserted)
+                it->second = hierarchy.AddName(name);
+            return it->second;
+        };
+
+        std::vector<const cgltf_node*> order;
+        order.reserve(data->nodes_count);
         hierarchy.nodes.reserve(data->nodes_count);
-        hierarchy.root.name = data->scene->name ? data->scene->name : "Model";
+
+        auto appendNode = [&](const cgltf_node* cgltfNode, const char* defaultName) {
+            nodeIndices[cgltfNode] = (uint32_t)hierarchy.nodes.size();
+            order.push_back(cgltfNode);
+
+            Node& node = hierarchy.nodes.emplace_back();
+            node.name = internName(cgltfNode->name ? cgltfNode->name : defaultName);
+            node.transform = GetNodeTransform((cgltf_node*)cgltfNode);
+
+            if (cgltfNode->mesh)
+            {
+                node.index = (uint32_t)cgltf_mesh_index(data, cgltfNode->mesh);
+                node.type = NodeType::Mesh;
+
+                if (cgltfNode->skin)
+                    node.skin = (uint32_t)cgltf_skin_index(data, cgltfNode->skin);
+            }
+
+            if (cgltfNode->camera)
+            {
+                node.index = (uint32_t)cgltf_camera_index(data, cgltfNode->camera);
+                node.type = NodeType::Camera;
+            }
+        };
+
+        hierarchy.root.name = internName(data->scene->name ? data->scene->name : "Model");
         hierarchy.root.transform = Math::float4x4(1.0f);
         hierarchy.root.childrenOffset = 0;
         hierarchy.root.childrenCount = (uint32_t)data->scene->nodes_count;
 
         for (cgltf_size i = 0; i < data->scene->nodes_count; i++)
-        {
-            cgltf_node* cgltfNode = data->scene->nodes[i];
-            Node& node = hierarchy.nodes.emplace_back();
-            node.name = cgltfNode->name ? cgltfNode->name : "Node";
-            node.transform = GetNodeTransform(cgltfNode);
-        }
+            appendNode(data->scene->nodes[i], "Node");
 
-        for (cgltf_size i = 0; i < data->scene->nodes_count; i++)
+        for (size_t i = 0; i < order.size(); i++)
         {
-            cgltf_node* cgltfNode = data->scene->nodes[i];
-            Node& node = hierarchy.nodes[hierarchy.root.childrenOffset + i];
+            const cgltf_node* cgltfNode = order[i];
+            hierarchy.nodes[i].childrenOffset = (uint32_t)hierarchy.nodes.size();
+            hierarchy.nodes[i].childrenCount = (uint32_t)cgltfNode->children_count;
 
-            AppendNodes(asset, node, cgltfNode, data);
+            for (cgltf_size c = 0; c < cgltfNode->children_count; c++)
+                appendNode(cgltfNode->children[c], "None");
         }
 
-        HE_INFO("Import AppendNodes [{}ms]", t.ElapsedMilliseconds());
+        HE_INFO("Import AppendNodes [{} nodes][{}ms]", hierarchy.nodes.size(), t.ElapsedMilliseconds());
     }
 
     static void AppendCameras(Assets::MeshSource& meshSource, cgltf_data* data)
@@ -865,201 +1473,1730 @@ namespace Assets {
         }
     }
 
-    Asset MeshSourceImporter::Import(AssetHandle handle, const std::filesystem::path& filePath)
+    static void AppendSkins(MeshSource& meshSource, cgltf_data* data, const std::unordered_map<const cgltf_node*, uint32_t>& nodeIndices)
     {
-        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+        auto nodeIndex = [&nodeIndices](const cgltf_node* node) { return node && nodeIndices.contains(node) ? nodeIndices.at(node) : c_Invalid; };
 
-        HE::Timer t;
+        meshSource.skins.resize(data->skins_count);
+        for (cgltf_size i = 0; i < data->skins_count; i++)
+        {
+            const cgltf_skin& cgltfSkin = data->skins[i];
+            auto& skin = meshSource.skins[i];
+            skin.name = cgltfSkin.name ? cgltfSkin.name : "Skin";
+            skin.skeleton = nodeIndex(cgltfSkin.skeleton);
+            skin.joints.resize(cgltfSkin.joints_count);
+            skin.inverseBindMatrices.resize(cgltfSkin.joints_count, Math::float4x4(1.0f));
+
+            for (cgltf_size j = 0; j < cgltfSkin.joints_count; j++)
+            {
+                skin.joints[j] = nodeIndex(cgltfSkin.joints[j]);
+                if (cgltfSkin.inverse_bind_matrices)
+                    cgltf_accessor_read_float(cgltfSkin.inverse_bind_matrices, j, Math::value_ptr(skin.inverseBindMatrices[j]), 16);
+            }
+        }
+    }
 
-        auto path = assetManager->desc.assetsDirectory / filePath;
-        auto pathStr = path.lexically_normal().string();
-        auto cStrFilePath = pathStr.c_str();
+    static BoneTransform GetRestPose(const cgltf_node* node)
+    {
+        BoneTransform rest;
 
-        if (!std::filesystem::exists(path))
+        if (node->has_matrix)
         {
-            HE_ERROR("MeshSourceImporter : file {} not exists", cStrFilePath);
-            return {};
+            Math::float4x4 m = Math::make_mat4(node->matrix);
+            rest.translation = Math::float3(m[3]);
+            rest.scale = { Math::length(Math::float3(m[0])), Math::length(Math::float3(m[1])), Math::length(Math::float3(m[2])) };
+
+            Math::float3x3 r(Math::float3(m[0]) / rest.scale.x, Math::float3(m[1]) / rest.scale.y, Math::float3(m[2]) / rest.scale.z);
+            rest.rotation = Math::normalize(Math::quat_cast(r));
+
+            return rest;
         }
-        
-        cgltf_options options = {};
-        cgltf_data* data = LoadGltfData(options, cStrFilePath);
-        if (!data)
+
+        if (node->has_translation)
+            rest.translation = { node->translation[0], node->translation[1], node->translation[2] };
+
+        if (node->has_rotation)
+            rest.rotation = Math::quat(node->rotation[3], node->rotation[0], node->rotation[1], node->rotation[2]);
+
+        if (node->has_scale)
+            rest.scale = { node->scale[0], node->scale[1], node->scale[2] };
+
+        return rest;
+    }
+
+    // one memory only AnimationClip per glTF animation, bones are the animated nodes in channel order
+    static void AppendAnimations(
+        AssetManager* assetManager,
+        cgltf_data* data,
+        const std::unordered_map<const cgltf_node*, uint32_t>& nodeIndices,
+        std::vector<AssetHandle>& dependencies,
+        uint32_t firstDependency,
+        float tolerance
+    )
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        std::vector<float> times;
+        std::vector<Math::float4> values;
+
+        for (cgltf_size i = 0; i < data->animations_count; i++)
         {
-            return {};
+            const cgltf_animation& animation = data->animations[i];
+
+            AssetHandle newHandle;
+            auto clipAsset = assetManager->CreateAsset(newHandle);
+            auto& clip = clipAsset.Add<AnimationClip>();
+            clip.name = animation.name ? animation.name : "Animation";
+
+            std::unordered_map<const cgltf_node*, uint32_t> bones;
+            for (cgltf_size c = 0; c < animation.channels_count; c++)
+            {
+                const cgltf_node* node = animation.channels[c].target_node;
+                if (!node || bones.contains(node))
+                    continue;
+
+                bones[node] = (uint32_t)clip.restPose.size();
+                clip.boneNodes.push_back(nodeIndices.contains(node) ? nodeIndices.at(node) : c_Invalid);
+                clip.restPose.push_back(GetRestPose(node));
+            }
+
+            for (cgltf_size c = 0; c < animation.channels_count; c++)
+            {
+                const cgltf_animation_channel& channel = animation.channels[c];
+                const cgltf_animation_sampler* sampler = channel.sampler;
+                if (!channel.target_node || !sampler || !sampler->input || !sampler->output)
+                    continue;
+
+                AnimationPath path;
+                switch (channel.target_path)
+                {
+                case cgltf_animation_path_type_translation: path = AnimationPath::Translation; break;
+                case cgltf_animation_path_type_rotation:    path = AnimationPath::Rotation;    break;
+                case cgltf_animation_path_type_scale:       path = AnimationPath::Scale;       break;
+                default: continue; // morph target weights
+                }
+
+                const cgltf_size keyCount = sampler->input->count;
+                const bool cubic = sampler->interpolation == cgltf_interpolation_type_cubic_spline;
+
+                // cubic spline keys are [in tangent, value, out tangent], the values are sampled linearly
+                const cgltf_size stride = cubic ? 3 : 1;
+                if (sampler->output->count < keyCount * stride)
+                    continue;
+
+                times.resize(keyCount);
+                values.assign(keyCount, Math::float4(0.0f));
+                for (cgltf_size k = 0; k < keyCount; k++)
+                {
+                    cgltf_accessor_read_float(sampler->input, k, &times[k], 1);
+                    cgltf_accessor_read_float(sampler->output, k * stride + (cubic ? 1 : 0), Math::value_ptr(values[k]), path == AnimationPath::Rotation ? 4 : 3);
+                }
+
+                bool step = sampler->interpolation == cgltf_interpolation_type_step;
+                AppendAnimationTrack(clip, bones.at(channel.target_node), path, step, times, values, tolerance);
+            }
+
+            dependencies[firstDependency + i] = newHandle;
+            clipAsset.Get<AssetState>() = AssetState::Loaded;
+            assetManager->MarkAsMemoryOnlyAsset(clipAsset, AssetType::AnimationClip);
+            assetManager->OnAssetLoaded(clipAsset);
         }
+    }
 
-        auto asset = assetManager->CreateAsset(handle);
-        auto& assetState = asset.Get<AssetState>();
-        auto& meshSource = asset.Add<MeshSource>();
-        assetState = AssetState::Loading;
+    static bool WriteGeometryCache(const MeshSource& meshSource); // Cooked region
 
-        auto& assetDependencies = asset.Add<AssetDependencies>();
-        assetDependencies.dependencies.resize(data->materials_count + data->textures_count);
+    static bool ImportGltfMeshSource(AssetManager* assetManager, Asset asset, const std::filesystem::path& path)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        const auto& settings = assetManager->desc.meshSourceImportSettings;
+        auto& meshSource = asset.Get<MeshSource>();
+        auto& stats = asset.Add<MeshSourceImportStats>();
+
+        auto filePath = path.lexically_normal().string();
+
+        std::vector<HE::Ref<MappedFile>> files;
+        cgltf_options options = {};
+        cgltf_data* data = LoadGltfData(options, filePath.c_str(), settings.mapFiles, files, stats);
+        if (!data)
+            return false;
+
+        auto& assetDependencies = asset.Add<AssetDependencies>(); // [material][texture][animation]
         meshSource.materialCount = (uint32_t)data->materials_count;
         meshSource.textureCount = (uint32_t)data->textures_count;
-        memset(assetDependencies.dependencies.data(), 0, assetDependencies.dependencies.size());
+        meshSource.animationCount = settings.importAnimations ? (uint32_t)data->animations_count : 0;
+        assetDependencies.dependencies.resize(meshSource.materialCount + meshSource.textureCount + meshSource.animationCount, 0);
 
-        std::unordered_map<const cgltf_material*, Asset> materials;
+        std::unordered_map<const cgltf_texture*, TextureInfo> textureInfos;
+        GetTexturesInfo(data, textureInfos);
+
+        // every asset and component is created before the texture tasks start, they run concurrently with mesh extraction
+        std::vector<Asset> textures(data->textures_count);
+        for (cgltf_size i = 0; i < data->textures_count; i++)
+        {
+            AssetHandle newHandle;
+            textures[i] = assetManager->CreateAsset(newHandle);
+            textures[i].Add<Texture>();
+            assetDependencies.dependencies[meshSource.materialCount + i] = newHandle;
+        }
 
-        std::unordered_map<const cgltf_texture*, TextureInfo> textures;
-        GetTexturesInfo(data, textures);
+        std::unordered_map<const cgltf_material*, Asset> materials;
+        AppendMaterials(assetManager, data, materials, asset, meshSource.materialCount);
+        std::unordered_map<const cgltf_node*, uint32_t> nodeIndices;
+        AppendNodes(asset, data, nodeIndices);
+        AppendCameras(meshSource, data);
+        AppendSkins(meshSource, data, nodeIndices);
 
-        //  Textures 
+        if (meshSource.animationCount)
         {
             HE::Timer t;
+            AppendAnimations(assetManager, data, nodeIndices, assetDependencies.dependencies, meshSource.materialCount + meshSource.textureCount, settings.animationTolerance);
+            stats.animationTime = t.ElapsedMilliseconds();
+        }
+
+        HE::Timer textureTimer;
+        auto directory = path.parent_path();
+
+        HE::Jops::Taskflow tf;
+        auto texturesDone = tf.emplace([&stats, &textureTimer]() { stats.textureTime = textureTimer.ElapsedMilliseconds(); });
+        for (cgltf_size i = 0; i < data->textures_count; i++)
+        {
+            const cgltf_texture* cgltfTexture = &data->textures[i];
+            TextureInfo info = textureInfos.contains(cgltfTexture) ? textureInfos.at(cgltfTexture) : TextureInfo{};
+
+            assetManager->asyncTaskCount++;
+            auto task = tf.emplace([assetManager, texture = textures[i], cgltfTexture, directory, info, map = settings.mapFiles, path, i]() {
 
-            for (cgltf_size i = 0; i < data->textures_count; i++)
-            {
-                const cgltf_texture* cgltfTexture = &data->textures[i];
                 const cgltf_image* image = cgltfTexture->image;
-                std::string name = image->name ? image->name : "Unnamed";
+                std::string name = image && image->name ? image->name : "Unnamed";
                 HE_INFO("Import Memory Only texture [{}]", name);
 
-                uint8_t* dataPtr = static_cast<uint8_t*>(image->buffer_view->buffer->data) + image->buffer_view->offset;
-                const size_t dataSize = image->buffer_view->size;
+                HE::Ref<MappedFile> owner;
+                auto bytes = image ? GetGltfImageData(image, directory, map, owner) : std::span<uint8_t>();
+                if (bytes.empty())
+                {
+                    HE_ERROR("MeshSourceImporter : no image data for texture [{}]", name);
+                    assetManager->asyncTaskCount--;
+                    return;
+                }
+
+                ImportTexture(assetManager, texture, HE::Buffer{ bytes.data(), bytes.size() }, assetManager->device, name, info, path, i);
+            });
+            task.precede(texturesDone);
+        }
+
+        auto textureTasks = HE::Jops::RunTaskflow(tf);
 
-                AssetHandle newHandle;
-                auto texture = assetManager->CreateAsset(newHandle);
-                texture.Add<Texture>();
+        {
+            HE::Timer t;
+            AppendMeshes(data, meshSource, materials, settings);
 
-                bool isSRGB = textures.contains(cgltfTexture) ? textures.at(cgltfTexture).isSRGB : false;
-                ImportTexture(assetManager, texture, HE::Buffer{ dataPtr, dataSize }, assetManager->device, name, isSRGB);
-                assetDependencies.dependencies[meshSource.materialCount + i] = texture.GetHandle();
+            auto& hierarchy = asset.Get<MeshSourecHierarchy>();
+            if (settings.mergeIdenticalMeshes)
+            {
+                auto remap = MergeIdenticalMeshes(meshSource);
+                for (auto& node : hierarchy.nodes)
+                {
+                    if (node.type == NodeType::Mesh && node.index < remap.size())
+                        node.index = remap[node.index];
+                }
             }
 
-            HE_INFO("Import Memory Only textures [{}][{} ms]", data->textures_count, t.ElapsedMilliseconds());
+            UpdateHierarchy(hierarchy, meshSource);
+            BuildMeshInstances(hierarchy, (uint32_t)meshSource.meshes.size());
+            stats.meshTime = t.ElapsedMilliseconds();
         }
 
-        AppendMaterials(assetManager, data, materials, asset, meshSource.materialCount);
-        AppendMeshes(data, meshSource, materials);
-        AppendNodes(asset, data);
-        AppendCameras(meshSource, data);
+        {
+            HE::Timer t;
+            ProcessMeshSource(meshSource, settings, stats);
+            stats.processTime = t.ElapsedMilliseconds();
+        }
 
+        textureTasks.wait();
         cgltf_free(data);
-        assetState = AssetState::Loaded;
 
-        return asset;
+        meshSource.sourcePath = path;
+        meshSource.importSettings = settings;
+        meshSource.residency = settings.geometryResidency;
+        if (settings.geometryResidency != GeometryResidency::KeepCpu)
+        {
+            // dropped geometry is re-fetched from the processed buffers, not by importing the glTF again
+            meshSource.geometryHash = HashGeometry(meshSource);
+            WriteGeometryCache(meshSource);
+        }
+
+        if (settings.uploadGeometry || settings.geometryResidency != GeometryResidency::KeepCpu)
+            UploadGeometry(assetManager, asset, path.filename().string());
+
+        HE_INFO("Import MeshSource [{}][parse {}ms][buffers {}ms][decode {}ms][animations {}ms][textures {}ms][meshes {}ms][process {}ms]",
+            path.filename().string(), stats.parseTime, stats.bufferTime, stats.decodeTime, stats.animationTime, stats.textureTime, stats.meshTime, stats.processTime);
+
+        return true;
     }
 
-    Asset MeshSourceImporter::ImportAsync(AssetHandle handle, const std::filesystem::path& filePath)
+#pragma region Cooked
+
+    // .hmesh layout : [HMeshHeader][sections...], every section is 16 byte aligned and addressed by byte offset, names live in the string section
+    constexpr uint32_t c_HMeshMagic = 0x48534D48; // "HMSH"
+    constexpr uint32_t c_HMeshVersion = 8;
+    constexpr uint64_t c_HMeshAlignment = 16;
+
+    enum class HMeshSection : uint32_t
     {
-        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
-        
-        HE::Timer t;
+        VertexBuffer,
+        IndexBuffer,
+        Meshes,
+        Geometries,
+        Meshlets,
+        MeshletVertices,
+        MeshletTriangles,
+        LODs,
+        CurveChunks,
+        MorphTargets,
+        MorphDeltas,
+        Nodes,          // root first
+        Cameras,
+        Materials,
+        Textures,
+        TextureData,    // encoded image files or block compressed mip chains
+        Skins,
+        SkinJoints,
+        InverseBindMatrices,
+        Animations,
+        AnimationData,  // serialized AnimationClips
+        Strings,
+
+        Count
+    };
 
-        auto path = assetManager->desc.assetsDirectory / filePath;
+    struct HMeshRange
+    {
+        uint64_t offset = 0;
+        uint64_t size = 0;
+    };
 
-        if (!std::filesystem::exists(path))
-        {
-            HE_ERROR("MeshSourceImporter : file {} not exists", path.string());
-            return {};
-        }
+    struct HMeshHeader
+    {
+        uint32_t magic = c_HMeshMagic;
+        uint32_t version = c_HMeshVersion;
+        uint64_t fileSize = 0;
+        uint64_t vertexCount = 0;
+        uint32_t materialCount = 0;
+        uint32_t textureCount = 0;
+        uint32_t animationCount = 0;
+        uint32_t vertexStride = 0;
+        uint8_t vertexLayout = 0;
+        uint8_t vertexFormats[c_VertexAttributeCount] = {};
+        uint64_t geometryHash = 0; // HashGeometry of the vertex and index sections
+        HMeshRange vertexBufferRanges[c_VertexAttributeCount];
+        HMeshRange sections[(int)HMeshSection::Count];
+    };
 
-        auto asset = assetManager->CreateAsset(handle);
-        auto& assetState = asset.Get<AssetState>();
-        auto& meshSource = asset.Add<MeshSource>();
-        assetState = AssetState::Loading;
+    struct HMeshMesh
+    {
+        uint32_t name;
+        uint32_t type;
+        float aabbMin[3];
+        float aabbMax[3];
+        uint64_t indexOffset;
+        uint64_t vertexOffset;
+        uint32_t indexCount;
+        uint32_t vertexCount;
+        uint32_t geometryOffset;
+        uint32_t geometryCount;
+        uint32_t morphTargetOffset;
+        uint32_t morphTargetCount;
+        uint32_t index;
+    };
 
-        HE::Jops::SubmitTask([this, handle, path]() {
+    struct HMeshMorphTarget
+    {
+        uint32_t name;
+        uint32_t deltaOffset; // into MorphDeltas
+        uint32_t deltaCount;
+        float positionScale;
+        float normalScale;
+        float tangentScale;
+        float defaultWeight;
+    };
 
-            HE_PROFILE_SCOPE_NC("ImportAsync::SubmitTask", HE_PROFILE_COLOR);
+    struct HMeshGeometry
+    {
+        uint32_t mesh;
+        uint32_t type;
+        float aabbMin[3];
+        float aabbMax[3];
+        uint32_t indexOffsetInMesh;
+        uint32_t vertexOffsetInMesh;
+        uint32_t indexCount;
+        uint32_t vertexCount;
+        uint32_t material; // material index or c_Invalid
+        uint32_t index;
+        uint32_t meshletOffset;
+        uint32_t meshletCount;
+        uint32_t lodOffset;
+        uint32_t lodCount;
+        uint32_t curveChunkOffset;
+        uint32_t curveChunkCount;
+    };
 
-            auto asset = assetManager->FindAsset(handle);
-            auto& meshSource = asset.Get<MeshSource>();
+    struct HMeshNode
+    {
+        uint32_t name;
+        uint32_t type;
+        float transform[16];
+        uint32_t childrenOffset;
+        uint32_t childrenCount;
+        uint32_t index;
+        uint32_t skin;
+    };
 
-            auto filePath = path.lexically_normal().string();
-            auto cStrFilePath = filePath.c_str();
+    struct HMeshCamera
+    {
+        uint32_t hasAspectRatio;
+        uint32_t hasZfar;
+        float aspectRatio;
+        float yfov;
+        float zFar;
+        float zNear;
+    };
 
-            cgltf_options options = {};
-            cgltf_data* data = LoadGltfData(options, cStrFilePath);
-            if (!data)
-            {
-                assetManager->DestroyAsset(asset);
-                return;
-            }
+    struct HMeshMaterial
+    {
+        uint32_t name;
+        float baseColor[4];
+        float metallic;
+        float roughness;
+        float reflectance;
+        float emissiveColor[3];
+        float emissiveEV;
+        uint32_t baseTexture; // texture index or c_Invalid
+        uint32_t normalTexture;
+        uint32_t metallicRoughnessTexture;
+        uint32_t emissiveTexture;
+        uint32_t uvSet;
+        float offset[2];
+        float scale[2];
+        float rotation;
+    };
 
-            auto& assetDependencies = asset.Add<AssetDependencies>(); // [material][texture]
-            assetDependencies.dependencies.resize(data->materials_count + data->textures_count);
-            meshSource.materialCount = (uint32_t)data->materials_count;
-            meshSource.textureCount = (uint32_t)data->textures_count;
-            memset(assetDependencies.dependencies.data(), 0, assetDependencies.dependencies.size());
+    struct HMeshTexture
+    {
+        uint32_t name;
+        uint32_t isSRGB;
+        uint32_t usage;
+        float alphaCutoff;
+        uint32_t compression; // TextureCompression, the data is then the packed mip chain instead of an image file
+        uint32_t width;
+        uint32_t height;
+        uint32_t mipLevels;
+        uint64_t dataOffset; // into TextureData
+        uint64_t dataSize;
+    };
 
-            HE::Jops::Taskflow tf;
+    struct HMeshSkin
+    {
+        uint32_t name;
+        uint32_t skeleton;
+        uint32_t jointOffset; // into SkinJoints and InverseBindMatrices
+        uint32_t jointCount;
+    };
 
-            std::unordered_map<const cgltf_material*, Asset> materials;
+    struct HMeshAnimation
+    {
+        uint64_t dataOffset; // into AnimationData
+        uint64_t dataSize;
+    };
 
-            std::vector<tf::Task> textureTasks;
-            textureTasks.reserve(data->textures_count);
+    static_assert(std::is_trivially_copyable_v<Meshlet> && std::is_trivially_copyable_v<MeshGeometryLOD> && std::is_trivially_copyable_v<CurveChunk> && std::is_trivially_copyable_v<MorphDelta>);
 
-            std::unordered_map<const cgltf_texture*, TextureInfo> textures;
-            GetTexturesInfo(data, textures);
+    struct CookedTexture
+    {
+        std::string name;
+        TextureInfo info;
+        TextureCompression compression = TextureCompression::None;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mipLevels = 0;
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+    };
 
-            // Textures
-            {
-                HE::Timer t;
+    static bool ValidateCookedHeader(const HMeshHeader& header)
+    {
+        if (header.magic != c_HMeshMagic || header.version != c_HMeshVersion)
+            return false;
 
-                for (cgltf_size i = 0; i < data->textures_count; i++)
-                {
-                    const cgltf_texture* cgltfTexture = &data->textures[i];
-                    const cgltf_image* image = cgltfTexture->image;
-                    std::string name = image->name ? image->name : "Unnamed";
-                    HE_INFO("Import memory only texture [{}]", name);
+        for (const auto& section : header.sections)
+        {
+            if (section.offset % c_HMeshAlignment != 0 || section.offset > header.fileSize || section.size > header.fileSize - section.offset)
+                return false;
+        }
 
-                    uint8_t* dataPtr = static_cast<uint8_t*>(image->buffer_view->buffer->data) + image->buffer_view->offset;
-                    const size_t dataSize = image->buffer_view->size;
+        return true;
+    }
 
-                    AssetHandle newHandle;
-                    auto texture = assetManager->CreateAsset(newHandle);
-                    texture.Add<Texture>();
+    static const HMeshHeader* ValidateCookedFile(const MappedFile& file)
+    {
+        if (file.size < sizeof(HMeshHeader))
+            return nullptr;
 
-                    bool isSRGB = textures.contains(cgltfTexture) ? textures.at(cgltfTexture).isSRGB : false;
-                    auto task = tf.emplace([this, texture, dataPtr, dataSize, name, isSRGB]() { ImportTexture(assetManager, texture, HE::Buffer{ dataPtr ,dataSize }, assetManager->device, name, isSRGB); });
-                    textureTasks.emplace_back(task);
-                    assetManager->asyncTaskCount++;
+        const HMeshHeader* header = (const HMeshHeader*)file.data;
+        if (header->fileSize != file.size || !ValidateCookedHeader(*header))
+            return nullptr;
 
-                    assetDependencies.dependencies[meshSource.materialCount + i] = texture.GetHandle();
-                }
+        return header;
+    }
 
-                HE_INFO("Import memory only textures [{}][{} ms]", data->textures_count, t.ElapsedMilliseconds());
-            }
+    static bool ReadCookedHeader(const std::filesystem::path& path, HMeshHeader& header)
+    {
+        auto headerFile = MappedFile::Open(path, 0, sizeof(HMeshHeader), false);
+        if (!headerFile || headerFile->size < sizeof(HMeshHeader))
+            return false;
 
-            AppendMaterials(assetManager, data, materials, asset, meshSource.materialCount);
-            AppendMeshes(data, meshSource, materials);
-            AppendNodes(asset, data);
-            AppendCameras(meshSource, data);
+        std::memcpy(&header, headerFile->data, sizeof(HMeshHeader));
 
-            auto finalTask = tf.emplace([this, asset, data]() {
+        std::error_code ec;
+        return ValidateCookedHeader(header) && header.fileSize == std::filesystem::file_size(path, ec);
+    }
 
-                cgltf_free(data);
-                assetManager->OnAssetLoaded(asset);
-            });
+    // Maps everything after the index buffer, the vertex and index data are left to the page table.
+    static HE::Ref<MappedFile> OpenCookedMetadata(const std::filesystem::path& path, bool map, HMeshHeader& header)
+    {
+        if (!ReadCookedHeader(path, header))
+            return nullptr;
 
-            for (auto& t : textureTasks)
-                t.precede(finalTask);
+        const HMeshRange& vertices = header.sections[(int)HMeshSection::VertexBuffer];
+        const HMeshRange& indices = header.sections[(int)HMeshSection::IndexBuffer];
+        uint64_t offset = indices.offset + indices.size;
+        if (vertices.offset + vertices.size > indices.offset)
+            return nullptr;
 
-            auto& state = asset.Get<AssetState>();
-            state = AssetState::Loaded;
+        for (int s = (int)HMeshSection::Meshes; s < (int)HMeshSection::Count; s++)
+        {
+            if (header.sections[s].size && header.sections[s].offset < offset)
+                return nullptr;
+        }
 
-            HE::Jops::RunTaskflow(tf).wait();
-        });
+        return MappedFile::Open(path, offset, header.fileSize - offset, map);
+    }
 
-        HE_INFO("[Import meshSource] [{}][{} ms]", path.string(), t.ElapsedMilliseconds());
+    // the file may be a window, sections are addressed relative to MappedFile::offset
+    static const uint8_t* GetCookedData(const MappedFile& file, const HMeshRange& range)
+    {
+        return file.data + (range.offset - file.offset);
+    }
 
-        return asset;
+    template<typename T>
+    static std::span<T> GetCookedSection(const MappedFile& file, const HMeshHeader& header, HMeshSection section)
+    {
+        const HMeshRange& range = header.sections[(int)section];
+        if (range.size == 0 || range.offset < file.offset)
+            return {};
+
+        return std::span<T>((T*)GetCookedData(file, range), range.size / sizeof(T));
     }
 
-    Asset MeshSourceImporter::Create(AssetHandle handle, const std::filesystem::path& filePath)
+    static const char* GetCookedString(std::span<const char> strings, uint32_t offset)
     {
-        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+        return offset < strings.size() ? strings.data() + offset : "";
+    }
 
-        NOT_YET_IMPLEMENTED();
-        return {};
+    static bool IsCookedRange(uint64_t offset, uint64_t count, uint64_t size)
+    {
+        return offset <= size && count <= size - offset;
     }
 
-    void MeshSourceImporter::Save(Asset asset, const std::filesystem::path& filePath)
+    // Every offset that is later used without a check must land inside its section, a stale or corrupt file is rejected as a whole.
+    static bool ValidateCookedRecords(const MappedFile& file, const HMeshHeader& header)
     {
-        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+        if (header.vertexLayout > (uint8_t)VertexLayout::Hybrid)
+            return false;
+
+        const uint64_t vertexBytes = header.sections[(int)HMeshSection::VertexBuffer].size;
+        const uint64_t indexCount = header.sections[(int)HMeshSection::IndexBuffer].size / sizeof(uint32_t);
+        const VertexLayout layout = VertexLayout(header.vertexLayout);
+        for (uint32_t a = 0; a < c_VertexAttributeCount; a++)
+        {
+            const HMeshRange& range = header.vertexBufferRanges[a];
+            if (range.size == 0)
+                continue;
+
+            const uint32_t size = GetVertexFormatSize(VertexFormat(header.vertexFormats[a]));
+            const bool interleaved = layout == VertexLayout::Interleaved || (layout == VertexLayout::Hybrid && a != (uint32_t)VertexAttribute::Position);
+            const uint64_t stride = interleaved ? header.vertexStride : size;
+            if (size == 0 || stride < size || !IsCookedRange(range.offset, range.size, vertexBytes))
+                return false;
+
+            if (header.vertexCount && (range.size < size || (range.size - size) / stride < header.vertexCount - 1))
+                return false;
+        }
+
+        auto meshes = GetCookedSection<const HMeshMesh>(file, header, HMeshSection::Meshes);
+        auto geometries = GetCookedSection<const HMeshGeometry>(file, header, HMeshSection::Geometries);
+        auto meshlets = GetCookedSection<const Meshlet>(file, header, HMeshSection::Meshlets);
+        auto lods = GetCookedSection<const MeshGeometryLOD>(file, header, HMeshSection::LODs);
+        auto curveChunks = GetCookedSection<const CurveChunk>(file, header, HMeshSection::CurveChunks);
+        auto nodes = GetCookedSection<const HMeshNode>(file, header, HMeshSection::Nodes);
+        const uint64_t meshletVertexCount = header.sections[(int)HMeshSection::MeshletVertices].size / sizeof(uint32_t);
+        const uint64_t meshletTriangleBytes = header.sections[(int)HMeshSection::MeshletTriangles].size;
+
+        for (const auto& r : meshes)
+        {
+            if (!IsCookedRange(r.vertexOffset, r.vertexCount, header.vertexCount) || !IsCookedRange(r.indexOffset, r.indexCount, indexCount) || !IsCookedRange(r.geometryOffset, r.geometryCount, geometries.size()))
+                return false;
+        }
+
+        for (const auto& r : geometries)
+        {
+            if (r.mesh >= meshes.size())
+                return false;
+
+            const auto& mesh = meshes[r.mesh];
+            if (!IsCookedRange(r.vertexOffsetInMesh, r.vertexCount, mesh.vertexCount) || !IsCookedRange(r.indexOffsetInMesh, r.indexCount, mesh.indexCount))
+                return false;
+
+            if (!IsCookedRange(r.meshletOffset, r.meshletCount, meshlets.size()) || !IsCookedRange(r.lodOffset, r.lodCount, lods.size()) || !IsCookedRange(r.curveChunkOffset, r.curveChunkCount, curveChunks.size()))
+                return false;
+
+            for (uint32_t c = 0; c < r.curveChunkCount; c++)
+            {
+                const auto& chunk = curveChunks[r.curveChunkOffset + c];
+                if (!IsCookedRange(chunk.indexOffset, chunk.indexCount, r.indexCount))
+                    return false;
+            }
+        }
+
+        for (const auto& meshlet : meshlets)
+        {
+            if (!IsCookedRange(meshlet.vertexOffset, meshlet.vertexCount, meshletVertexCount) || !IsCookedRange(meshlet.triangleOffset, uint64_t(meshlet.triangleCount) * 3, meshletTriangleBytes))
+                return false;
+        }
+
+        for (const auto& lod : lods)
+        {
+            if (!IsCookedRange(lod.indexOffset, lod.indexCount, indexCount))
+                return false;
+        }
+
+        // the root is stored first and is not part of MeshSourecHierarchy::nodes, children always follow their parent
+        const uint64_t nodeCount = nodes.empty() ? 0 : nodes.size() - 1;
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            const auto& r = nodes[i];
+            if (r.childrenCount && (!IsCookedRange(r.childrenOffset, r.childrenCount, nodeCount) || (i > 0 && r.childrenOffset < i)))
+                return false;
+        }
+
+        return true;
+    }
+
+    static void GetCookedTextures(const MappedFile& file, const HMeshHeader& header, std::vector<CookedTexture>& textures)
+    {
+        auto records = GetCookedSection<const HMeshTexture>(file, header, HMeshSection::Textures);
+        auto strings = GetCookedSection<const char>(file, header, HMeshSection::Strings);
+        const HMeshRange& data = header.sections[(int)HMeshSection::TextureData];
+
+        for (const auto& record : records)
+        {
+            auto& texture = textures.emplace_back();
+            texture.name = GetCookedString(strings, record.name);
+            texture.info.isSRGB = record.isSRGB;
+            texture.info.usage = (TextureUsage)record.usage;
+            texture.info.alphaCutoff = record.alphaCutoff;
+            texture.compression = (TextureCompression)record.compression;
+            texture.width = record.width;
+            texture.height = record.height;
+            texture.mipLevels = record.mipLevels;
+            if (record.dataOffset <= data.size && record.dataSize <= data.size - record.dataOffset)
+            {
+                texture.data = GetCookedData(file, data) + record.dataOffset;
+                texture.size = record.dataSize;
+            }
+        }
+    }
+
+    // pages split the vertex and index sections at fixed byte offsets, records may straddle two pages
+    static void InitPageTable(MeshSource& meshSource, const std::filesystem::path& path, const HMeshHeader& header, const MeshSourceImportSettings& settings)
+    {
+        constexpr uint64_t c_PageGranularity = 64 * 1024;
+
+        auto& table = meshSource.pageTable;
+        table = {};
+        table.path = path;
+        table.pageSize = std::max((settings.geometryPageSize + c_PageGranularity - 1) & ~(c_PageGranularity - 1), c_PageGranularity);
+        table.budget = settings.geometryPageBudget;
+
+        const HMeshSection sections[] = { HMeshSection::VertexBuffer, HMeshSection::IndexBuffer };
+        for (int s = 0; s < (int)GeometryStream::Count; s++)
+        {
+            const HMeshRange& range = header.sections[(int)sections[s]];
+            table.fileOffsets[s] = range.offset;
+            table.byteSizes[s] = range.size;
+
+            for (uint64_t offset = 0; offset < range.size; offset += table.pageSize)
+            {
+                auto& page = table.pages[s].emplace_back();
+                page.byteOffset = offset;
+                page.byteSize = std::min(table.pageSize, range.size - offset);
+            }
+        }
+    }
+
+    static bool LoadCookedMeshSource(AssetManager* assetManager, Asset asset, const std::filesystem::path& path)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        const auto& settings = assetManager->desc.meshSourceImportSettings;
+        bool paged = settings.geometryResidency == GeometryResidency::Paged;
+
+        HMeshHeader pagedHeader;
+        auto file = paged ? OpenCookedMetadata(path, settings.mapFiles, pagedHeader) : MappedFile::Open(path, settings.mapFiles);
+        const HMeshHeader* header = !file ? nullptr : paged ? &pagedHeader : ValidateCookedFile(*file);
+        if (!header || !ValidateCookedRecords(*file, *header))
+        {
+            HE_ERROR("MeshSourceImporter : invalid cooked mesh {}", path.string());
+            return false;
+        }
+
+        auto& meshSource = asset.Get<MeshSource>();
+        auto strings = GetCookedSection<const char>(*file, *header, HMeshSection::Strings);
+
+        meshSource.vertexCount = header->vertexCount;
+        meshSource.materialCount = header->materialCount;
+        meshSource.textureCount = header->textureCount;
+        meshSource.animationCount = header->animationCount;
+        meshSource.vertexLayout = VertexLayout(header->vertexLayout);
+        meshSource.vertexStride = header->vertexStride;
+        meshSource.geometryHash = header->geometryHash;
+        for (uint32_t a = 0; a < c_VertexAttributeCount; a++)
+        {
+            meshSource.vertexFormats[a] = VertexFormat(header->vertexFormats[a]);
+            meshSource.vertexBufferRanges[a] = nvrhi::BufferRange(header->vertexBufferRanges[a].offset, header->vertexBufferRanges[a].size);
+        }
+
+        // vertex and index data stay inside the file
+        if (paged)
+        {
+            InitPageTable(meshSource, path, *header, settings);
+        }
+        else
+        {
+            auto vertices = GetCookedSection<uint8_t>(*file, *header, HMeshSection::VertexBuffer);
+            auto indices = GetCookedSection<uint32_t>(*file, *header, HMeshSection::IndexBuffer);
+            meshSource.cpuVertexBuffer = CpuBuffer<uint8_t>::Reference(file, vertices.data(), vertices.size());
+            meshSource.cpuIndexBuffer = CpuBuffer<uint32_t>::Reference(file, indices.data(), indices.size());
+        }
+
+        auto meshes = GetCookedSection<const HMeshMesh>(*file, *header, HMeshSection::Meshes);
+        meshSource.meshes.resize(meshes.size());
+        for (size_t i = 0; i < meshes.size(); i++)
+        {
+            const auto& r = meshes[i];
+            auto& mesh = meshSource.meshes[i];
+            mesh.name = GetCookedString(strings, r.name);
+            mesh.type = MeshType(r.type);
+            mesh.aabb.m_mins = { r.aabbMin[0], r.aabbMin[1], r.aabbMin[2] };
+            mesh.aabb.m_maxs = { r.aabbMax[0], r.aabbMax[1], r.aabbMax[2] };
+            mesh.indexOffset = r.indexOffset;
+            mesh.indexCount = r.indexCount;
+            mesh.vertexOffset = r.vertexOffset;
+            mesh.vertexCount = r.vertexCount;
+            mesh.geometryOffset = r.geometryOffset;
+            mesh.geometryCount = r.geometryCount;
+            mesh.morphTargetOffset = r.morphTargetOffset;
+            mesh.morphTargetCount = r.morphTargetCount;
+            mesh.index = r.index;
+        }
+
+        auto morphTargets = GetCookedSection<const HMeshMorphTarget>(*file, *header, HMeshSection::MorphTargets);
+        auto morphDeltas = GetCookedSection<const MorphDelta>(*file, *header, HMeshSection::MorphDeltas);
+        meshSource.morphDeltas.assign(morphDeltas.begin(), morphDeltas.end());
+        for (const auto& r : morphTargets)
+        {
+            auto& target = meshSource.morphTargets.emplace_back();
+            target.name = GetCookedString(strings, r.name);
+            target.deltaOffset = r.deltaOffset;
+            target.deltaCount = uint64_t(r.deltaOffset) + r.deltaCount <= morphDeltas.size() ? r.deltaCount : 0;
+            target.positionScale = r.positionScale;
+            target.normalScale = r.normalScale;
+            target.tangentScale = r.tangentScale;
+            target.defaultWeight = r.defaultWeight;
+        }
+
+        auto meshlets = GetCookedSection<const Meshlet>(*file, *header, HMeshSection::Meshlets);
+        auto meshletVertices = GetCookedSection<const uint32_t>(*file, *header, HMeshSection::MeshletVertices);
+        auto meshletTriangles = GetCookedSection<const uint8_t>(*file, *header, HMeshSection::MeshletTriangles);
+        auto lods = GetCookedSection<const MeshGeometryLOD>(*file, *header, HMeshSection::LODs);
+        auto curveChunks = GetCookedSection<const CurveChunk>(*file, *header, HMeshSection::CurveChunks);
+        meshSource.meshlets.assign(meshlets.begin(), meshlets.end());
+        meshSource.meshletVertices.assign(meshletVertices.begin(), meshletVertices.end());
+        meshSource.meshletTriangles.assign(meshletTriangles.begin(), meshletTriangles.end());
+        meshSource.lods.assign(lods.begin(), lods.end());
+        meshSource.curveChunks.assign(curveChunks.begin(), curveChunks.end());
+
+        auto cameras = GetCookedSection<const HMeshCamera>(*file, *header, HMeshSection::Cameras);
+        for (const auto& r : cameras)
+        {
+            auto& camera = meshSource.cameras.emplace_back();
+            camera.hasAspectRatio = r.hasAspectRatio;
+            camera.hasZfar = r.hasZfar;
+            camera.aspectRatio = r.aspectRatio;
+            camera.yfov = r.yfov;
+            camera.zFar = r.zFar;
+            camera.zNear = r.zNear;
+        }
+
+        auto skins = GetCookedSection<const HMeshSkin>(*file, *header, HMeshSection::Skins);
+        auto skinJoints = GetCookedSection<const uint32_t>(*file, *header, HMeshSection::SkinJoints);
+        auto inverseBindMatrices = GetCookedSection<const Math::float4x4>(*file, *header, HMeshSection::InverseBindMatrices);
+        for (const auto& r : skins)
+        {
+            auto& skin = meshSource.skins.emplace_back();
+            skin.name = GetCookedString(strings, r.name);
+            skin.skeleton = r.skeleton;
+            if (uint64_t(r.jointOffset) + r.jointCount <= skinJoints.size() && uint64_t(r.jointOffset) + r.jointCount <= inverseBindMatrices.size())
+            {
+                skin.joints.assign(skinJoints.begin() + r.jointOffset, skinJoints.begin() + r.jointOffset + r.jointCount);
+                skin.inverseBindMatrices.assign(inverseBindMatrices.begin() + r.jointOffset, inverseBindMatrices.begin() + r.jointOffset + r.jointCount);
+            }
+        }
+
+        auto& assetDependencies = asset.Add<AssetDependencies>(); // [material][texture][animation]
+        assetDependencies.dependencies.resize(meshSource.materialCount + meshSource.textureCount + meshSource.animationCount, 0);
+
+        auto animations = GetCookedSection<const HMeshAnimation>(*file, *header, HMeshSection::Animations);
+        const HMeshRange& animationData = header->sections[(int)HMeshSection::AnimationData];
+        for (uint32_t i = 0; i < (uint32_t)animations.size() && i < meshSource.animationCount; i++)
+        {
+            const auto& r = animations[i];
+            if (r.dataOffset > animationData.size || r.dataSize > animationData.size - r.dataOffset)
+                continue;
+
+            AssetHandle newHandle;
+            auto clipAsset = assetManager->CreateAsset(newHandle);
+            auto& clip = clipAsset.Add<AnimationClip>();
+            if (!DeserializeAnimationClip(std::span<const uint8_t>(GetCookedData(*file, animationData) + r.dataOffset, r.dataSize), clip))
+            {
+                HE_ERROR("MeshSourceImporter : invalid animation {} in {}", i, path.string());
+                assetManager->DestroyAsset(clipAsset);
+                continue;
+            }
+
+            assetDependencies.dependencies[meshSource.materialCount + meshSource.textureCount + i] = newHandle;
+            clipAsset.Get<AssetState>() = AssetState::Loaded;
+            assetManager->MarkAsMemoryOnlyAsset(clipAsset, AssetType::AnimationClip);
+            assetManager->OnAssetLoaded(clipAsset);
+        }
+
+        std::vector<CookedTexture> textures;
+        GetCookedTextures(*file, *header, textures);
+        std::vector<std::pair<uint32_t, Asset>> decodes;
+        for (uint32_t i = 0; i < (uint32_t)textures.size() && i < meshSource.textureCount; i++)
+        {
+            const auto& cooked = textures[i];
+            HE_INFO("Import Memory Only texture [{}]", cooked.name);
+
+            AssetHandle newHandle;
+            auto texture = assetManager->CreateAsset(newHandle);
+            texture.Add<Texture>();
+
+            // block compressed chains are uploaded and streamed from the file in place
+            if (cooked.data && cooked.compression != TextureCompression::None)
+            {
+                const nvrhi::Format format = GetTextureFormat(cooked.compression, cooked.info.isSRGB);
+                if (auto source = ReferenceTextureFile(file, { cooked.data, cooked.size }, cooked.width, cooked.height, cooked.mipLevels, format))
+                {
+                    source->path = path;
+                    assetManager->asyncTaskCount++;
+                    UploadTexture(assetManager, texture, assetManager->device, cooked.name, source, {});
+                }
+                else
+                {
+                    HE_ERROR("MeshSourceImporter : compressed texture [{}] does not match its mip chain", cooked.name);
+                }
+            }
+            else if (cooked.data)
+            {
+                assetManager->asyncTaskCount++;
+                decodes.emplace_back(i, texture);
+            }
+
+            assetDependencies.dependencies[meshSource.materialCount + i] = texture.GetHandle();
+        }
+
+        // images cooked without compression are decoded and mipped in parallel, only the uploads go to the main thread
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), decodes.size(), size_t(1), [&](size_t d) {
+            const auto& [i, texture] = decodes[d];
+            const auto& cooked = textures[i];
+            ImportTexture(assetManager, texture, HE::Buffer{ (uint8_t*)cooked.data, cooked.size }, assetManager->device, cooked.name, cooked.info, path, i);
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        auto materials = GetCookedSection<const HMeshMaterial>(*file, *header, HMeshSection::Materials);
+        for (uint32_t i = 0; i < (uint32_t)materials.size() && i < meshSource.materialCount; i++)
+        {
+            const auto& r = materials[i];
+
+            AssetHandle newHandle;
+            auto materialAsset = assetManager->CreateAsset(newHandle);
+            auto& material = materialAsset.Add<Material>();
+
+            auto textureHandle = [&](uint32_t index) { return index < meshSource.textureCount ? assetDependencies.dependencies[meshSource.materialCount + index] : AssetHandle(0); };
+
+            material.name = GetCookedString(strings, r.name);
+            material.baseColor = { r.baseColor[0], r.baseColor[1], r.baseColor[2], r.baseColor[3] };
+            material.metallic = r.metallic;
+            material.roughness = r.roughness;
+            material.reflectance = r.reflectance;
+            material.emissiveColor = { r.emissiveColor[0], r.emissiveColor[1], r.emissiveColor[2] };
+            material.emissiveEV = r.emissiveEV;
+            material.baseTextureHandle = textureHandle(r.baseTexture);
+            material.normalTextureHandle = textureHandle(r.normalTexture);
+            material.metallicRoughnessTextureHandle = textureHandle(r.metallicRoughnessTexture);
+            material.emissiveTextureHandle = textureHandle(r.emissiveTexture);
+            material.uvSet = UVSet(r.uvSet);
+            material.offset = { r.offset[0], r.offset[1] };
+            material.scale = { r.scale[0], r.scale[1] };
+            material.rotation = r.rotation;
+
+            assetDependencies.dependencies[i] = newHandle;
+            materialAsset.Get<AssetState>() = AssetState::Loaded;
+            assetManager->MarkAsMemoryOnlyAsset(materialAsset, AssetType::Material);
+            assetManager->OnAssetLoaded(materialAsset);
+        }
+
+        auto geometries = GetCookedSection<const HMeshGeometry>(*file, *header, HMeshSection::Geometries);
+        meshSource.geometries.resize(geometries.size());
+        for (size_t i = 0; i < geometries.size(); i++)
+        {
+            const auto& r = geometries[i];
+            auto& geometry = meshSource.geometries[i];
+            geometry.mesh = r.mesh < meshSource.meshes.size() ? r.mesh : c_Invalid;
+            geometry.type = MeshGeometryPrimitiveType(r.type);
+            geometry.aabb.m_mins = { r.aabbMin[0], r.aabbMin[1], r.aabbMin[2] };
+            geometry.aabb.m_maxs = { r.aabbMax[0], r.aabbMax[1], r.aabbMax[2] };
+            geometry.indexOffsetInMesh = r.indexOffsetInMesh;
+            geometry.vertexOffsetInMesh = r.vertexOffsetInMesh;
+            geometry.indexCount = r.indexCount;
+            geometry.vertexCount = r.vertexCount;
+            geometry.materailHandle = r.material < meshSource.materialCount ? assetDependencies.dependencies[r.material] : AssetHandle(0);
+            geometry.index = r.index;
+            geometry.meshletOffset = r.meshletOffset;
+            geometry.meshletCount = r.meshletCount;
+            geometry.lodOffset = r.lodOffset;
+            geometry.lodCount = r.lodCount;
+            geometry.curveChunkOffset = r.curveChunkOffset;
+            geometry.curveChunkCount = r.curveChunkCount;
+        }
+
+        BuildMaterialRanges(meshSource);
+
+        // the string section becomes the name pool, node names keep their offsets
+        auto& hierarchy = asset.Add<MeshSourecHierarchy>();
+        auto nodes = GetCookedSection<const HMeshNode>(*file, *header, HMeshSection::Nodes);
+        hierarchy.names.assign(strings.begin(), strings.end());
+        hierarchy.nodes.reserve(nodes.empty() ? 0 : nodes.size() - 1);
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            const auto& r = nodes[i];
+            Node& node = i == 0 ? hierarchy.root : hierarchy.nodes.emplace_back();
+            node.name = r.name < strings.size() ? r.name : c_Invalid;
+            node.type = NodeType(r.type);
+            std::memcpy(&node.transform, r.transform, sizeof(r.transform));
+            node.childrenOffset = r.childrenOffset;
+            node.childrenCount = r.childrenCount;
+            node.index = r.index;
+            node.skin = r.skin;
+        }
+
+        UpdateHierarchy(hierarchy, meshSource);
+        BuildMeshInstances(hierarchy, (uint32_t)meshSource.meshes.size());
+
+        meshSource.sourcePath = path;
+        meshSource.importSettings = settings;
+        meshSource.residency = settings.geometryResidency;
+        if (settings.uploadGeometry || settings.geometryResidency != GeometryResidency::KeepCpu)
+            UploadGeometry(assetManager, asset, path.filename().string());
+
+        HE_INFO("Import Cooked MeshSource [{}][{}][{}ms]", path.filename().string(), file->isMapped ? "mapped" : "read", t.ElapsedMilliseconds());
+
+        return true;
+    }
+
+    struct CookedWriter
+    {
+        std::ofstream stream;
+        uint64_t position = 0;
+
+        void Align()
+        {
+            static const uint8_t zeros[c_HMeshAlignment] = {};
+            uint64_t padding = (c_HMeshAlignment - position % c_HMeshAlignment) % c_HMeshAlignment;
+            stream.write((const char*)zeros, padding);
+            position += padding;
+        }
+
+        HMeshRange Write(const void* data, uint64_t size)
+        {
+            Align();
+            HMeshRange range = { position, size };
+            if (size)
+                stream.write((const char*)data, size);
+            position += size;
+            return range;
+        }
+
+        template<typename T>
+        HMeshRange Write(const std::vector<T>& v) { return Write(v.data(), v.size() * sizeof(T)); }
+    };
+
+    // Encoded image bytes of the textures referenced by the source file, the GPU copies cannot be read back
+    static bool GetSourceTextures(const std::filesystem::path& path, std::vector<CookedTexture>& textures, std::vector<std::vector<uint8_t>>& storage, HE::Ref<MappedFile>& cookedFile)
+    {
+        if (path.extension() == ".hmesh")
+        {
+            cookedFile = MappedFile::Open(path, false);
+            const HMeshHeader* header = cookedFile ? ValidateCookedFile(*cookedFile) : nullptr;
+            if (!header)
+                return false;
+
+            GetCookedTextures(*cookedFile, *header, textures);
+            return true;
+        }
+
+        auto pathStr = path.lexically_normal().string();
+
+        std::vector<HE::Ref<MappedFile>> files;
+        MeshSourceImportStats stats;
+        cgltf_options options = {};
+        cgltf_data* data = LoadGltfData(options, pathStr.c_str(), true, files, stats);
+        if (!data)
+            return false;
+
+        std::unordered_map<const cgltf_texture*, TextureInfo> infos;
+        GetTexturesInfo(data, infos);
+
+        storage.resize(data->textures_count);
+        for (cgltf_size i = 0; i < data->textures_count; i++)
+        {
+            const cgltf_texture* cgltfTexture = &data->textures[i];
+            const cgltf_image* image = cgltfTexture->image;
+            auto& texture = textures.emplace_back();
+            texture.name = image && image->name ? image->name : "Unnamed";
+            texture.info = infos.contains(cgltfTexture) ? infos.at(cgltfTexture) : TextureInfo{};
+
+            if (image)
+            {
+                HE::Ref<MappedFile> owner;
+                auto bytes = GetGltfImageData(image, path.parent_path(), true, owner);
+                storage[i].assign(bytes.begin(), bytes.end());
+            }
+
+            texture.data = storage[i].data();
+            texture.size = storage[i].size();
+        }
+
+        cgltf_free(data);
+        return true;
+    }
+
+    // Block compresses the source images once so loading the cooked file skips decoding, mips and encoding
+    static void CompressCookedTextures(AssetManager* assetManager, std::vector<CookedTexture>& textures, std::vector<std::vector<uint8_t>>& storage)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+        uint32_t compressedCount = 0;
+        storage.resize(textures.size());
+        for (size_t i = 0; i < textures.size(); i++)
+        {
+            auto& texture = textures[i];
+            if (!texture.data || texture.compression != TextureCompression::None)
+                continue;
+
+            auto chain = BuildTextureChain(assetManager, HE::Buffer{ (uint8_t*)texture.data, texture.size }, texture.info);
+            if (chain->compression == TextureCompression::None)
+                continue;
+
+            storage[i] = std::move(chain->data);
+            texture.compression = chain->compression;
+            texture.width = chain->width;
+            texture.height = chain->height;
+            texture.mipLevels = chain->GetLevelCount();
+            texture.data = storage[i].data();
+            texture.size = storage[i].size();
+            compressedCount++;
+        }
+
+        HE_INFO("Compress Cooked textures [{}/{}][{}ms]", compressedCount, textures.size(), t.ElapsedMilliseconds());
+    }
+
+    static uint32_t FindDependencyIndex(const std::vector<AssetHandle>& dependencies, uint32_t first, uint32_t count, AssetHandle handle)
+    {
+        if (handle == 0)
+            return c_Invalid;
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (dependencies[first + i] == handle)
+                return i;
+        }
+
+        return c_Invalid;
+    }
+
+    // Copies a stream of a paged source one page at a time, the geometry is never resident as a whole
+    static bool WritePagedStream(CookedWriter& writer, const GeometryPageTable& table, GeometryStream stream, HMeshRange& range)
+    {
+        writer.Align();
+        range = { writer.position, table.byteSizes[(int)stream] };
+
+        for (const auto& page : table.pages[(int)stream])
+        {
+            auto file = MappedFile::Open(table.path, table.fileOffsets[(int)stream] + page.byteOffset, page.byteSize, true);
+            if (!file || file->size != page.byteSize)
+            {
+                HE_ERROR("MeshSourceImporter : unable to read a page of {}", table.path.string());
+                return false;
+            }
+
+            writer.stream.write((const char*)file->data, file->size);
+            writer.position += file->size;
+        }
+
+        return true;
+    }
+
+    static bool WriteCookedMeshSource(AssetManager* assetManager, Asset asset, const std::filesystem::path& path, std::span<const CookedTexture> textures)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        auto& meshSource = asset.Get<MeshSource>();
+        std::vector<AssetHandle> dependencies = asset.Has<AssetDependencies>() ? asset.Get<AssetDependencies>().dependencies : std::vector<AssetHandle>();
+        dependencies.resize(meshSource.materialCount + meshSource.textureCount + meshSource.animationCount, 0);
+
+        std::vector<char> strings = { '\0' };
+        auto addString = [&strings](const std::string& str) {
+            uint32_t offset = (uint32_t)strings.size();
+            strings.insert(strings.end(), str.begin(), str.end());
+            strings.push_back('\0');
+            return offset;
+        };
+
+        HMeshHeader header;
+        header.vertexCount = meshSource.vertexCount;
+        header.materialCount = meshSource.materialCount;
+        header.textureCount = meshSource.textureCount;
+        header.animationCount = meshSource.animationCount;
+        header.vertexLayout = (uint8_t)meshSource.vertexLayout;
+        header.vertexStride = meshSource.vertexStride;
+        header.geometryHash = meshSource.HasCpuGeometry() ? HashGeometry(meshSource) : meshSource.geometryHash;
+        for (uint32_t a = 0; a < c_VertexAttributeCount; a++)
+        {
+            header.vertexFormats[a] = (uint8_t)meshSource.vertexFormats[a];
+            header.vertexBufferRanges[a] = { meshSource.vertexBufferRanges[a].byteOffset, meshSource.vertexBufferRanges[a].byteSize };
+        }
+
+        std::vector<HMeshMesh> meshes;
+        for (const auto& mesh : meshSource.meshes)
+        {
+            meshes.push_back({
+                addString(mesh.name), (uint32_t)mesh.type,
+                { mesh.aabb.m_mins.x, mesh.aabb.m_mins.y, mesh.aabb.m_mins.z },
+                { mesh.aabb.m_maxs.x, mesh.aabb.m_maxs.y, mesh.aabb.m_maxs.z },
+                mesh.indexOffset, mesh.vertexOffset, mesh.indexCount, mesh.vertexCount,
+                mesh.geometryOffset, mesh.geometryCount, mesh.morphTargetOffset, mesh.morphTargetCount, mesh.index
+            });
+        }
+
+        std::vector<HMeshMorphTarget> morphTargets;
+        for (const auto& target : meshSource.morphTargets)
+        {
+            morphTargets.push_back({
+                addString(target.name), target.deltaOffset, target.deltaCount,
+                target.positionScale, target.normalScale, target.tangentScale, target.defaultWeight
+            });
+        }
+
+        std::vector<HMeshGeometry> geometries;
+        for (const auto& geometry : meshSource.geometries)
+        {
+            geometries.push_back({
+                geometry.mesh, (uint32_t)geometry.type,
+                { geometry.aabb.m_mins.x, geometry.aabb.m_mins.y, geometry.aabb.m_mins.z },
+                { geometry.aabb.m_maxs.x, geometry.aabb.m_maxs.y, geometry.aabb.m_maxs.z },
+                geometry.indexOffsetInMesh, geometry.vertexOffsetInMesh, geometry.indexCount, geometry.vertexCount,
+                FindDependencyIndex(dependencies, 0, meshSource.materialCount, geometry.materailHandle),
+                geometry.index, geometry.meshletOffset, geometry.meshletCount, geometry.lodOffset, geometry.lodCount,
+                geometry.curveChunkOffset, geometry.curveChunkCount
+            });
+        }
+
+        std::vector<HMeshNode> nodes;
+        if (asset.Has<MeshSourecHierarchy>())
+        {
+            auto& hierarchy = asset.Get<MeshSourecHierarchy>();
+            auto addNode = [&](const Node& node) {
+                auto& r = nodes.emplace_back();
+                r.name = addString(hierarchy.GetName(node));
+                r.type = (uint32_t)node.type;
+                std::memcpy(r.transform, &node.transform, sizeof(r.transform));
+                r.childrenOffset = node.childrenOffset;
+                r.childrenCount = node.childrenCount;
+                r.index = node.index;
+                r.skin = node.skin;
+            };
+
+            addNode(hierarchy.root);
+            for (const auto& node : hierarchy.nodes)
+                addNode(node);
+        }
+
+        std::vector<HMeshCamera> cameras;
+        for (const auto& camera : meshSource.cameras)
+            cameras.push_back({ camera.hasAspectRatio, camera.hasZfar, camera.aspectRatio, camera.yfov, camera.zFar, camera.zNear });
+
+        std::vector<HMeshSkin> skins;
+        std::vector<uint32_t> skinJoints;
+        std::vector<Math::float4x4> inverseBindMatrices;
+        for (const auto& skin : meshSource.skins)
+        {
+            skins.push_back({ addString(skin.name), skin.skeleton, (uint32_t)skinJoints.size(), (uint32_t)skin.joints.size() });
+            skinJoints.insert(skinJoints.end(), skin.joints.begin(), skin.joints.end());
+            inverseBindMatrices.insert(inverseBindMatrices.end(), skin.inverseBindMatrices.begin(), skin.inverseBindMatrices.end());
+            inverseBindMatrices.resize(skinJoints.size(), Math::float4x4(1.0f));
+        }
+
+        std::vector<HMeshAnimation> animations;
+        std::vector<uint8_t> animationData;
+        for (uint32_t i = 0; i < meshSource.animationCount; i++)
+        {
+            uint64_t offset = animationData.size();
+            if (AnimationClip* clip = assetManager->GetAsset<AnimationClip>(dependencies[meshSource.materialCount + meshSource.textureCount + i]))
+                SerializeAnimationClip(*clip, animationData);
+
+            animations.push_back({ offset, animationData.size() - offset });
+        }
+
+        std::vector<HMeshMaterial> materials;
+        for (uint32_t i = 0; i < meshSource.materialCount; i++)
+        {
+            auto& r = materials.emplace_back();
+            Material* material = assetManager->GetAsset<Material>(dependencies[i]);
+            if (!material)
+            {
+                r = { addString("Unnamed Material"), { 1.0f, 1.0f, 1.0f, 1.0f }, 0.0f, 0.5f, 0.35f, {}, 0.0f, c_Invalid, c_Invalid, c_Invalid, c_Invalid, 0, {}, { 1.0f, 1.0f }, 0.0f };
+                continue;
+            }
+
+            auto textureIndex = [&](AssetHandle handle) { return FindDependencyIndex(dependencies, meshSource.materialCount, meshSource.textureCount, handle); };
+
+            r.name = addString(material->name);
+            std::memcpy(r.baseColor, &material->baseColor, sizeof(r.baseColor));
+            r.metallic = material->metallic;
+            r.roughness = material->roughness;
+            r.reflectance = material->reflectance;
+            std::memcpy(r.emissiveColor, &material->emissiveColor, sizeof(r.emissiveColor));
+            r.emissiveEV = material->emissiveEV;
+            r.baseTexture = textureIndex(material->baseTextureHandle);
+            r.normalTexture = textureIndex(material->normalTextureHandle);
+            r.metallicRoughnessTexture = textureIndex(material->metallicRoughnessTextureHandle);
+            r.emissiveTexture = textureIndex(material->emissiveTextureHandle);
+            r.uvSet = (uint32_t)material->uvSet;
+            r.offset[0] = material->offset.x; r.offset[1] = material->offset.y;
+            r.scale[0] = material->scale.x;   r.scale[1] = material->scale.y;
+            r.rotation = material->rotation;
+        }
+
+        std::vector<HMeshTexture> textureRecords;
+        uint64_t textureDataSize = 0;
+        for (const auto& texture : textures)
+        {
+            HMeshTexture& r = textureRecords.emplace_back();
+            r.name = addString(texture.name);
+            r.isSRGB = texture.info.isSRGB;
+            r.usage = (uint32_t)texture.info.usage;
+            r.alphaCutoff = texture.info.alphaCutoff;
+            r.compression = (uint32_t)texture.compression;
+            r.width = texture.width;
+            r.height = texture.height;
+            r.mipLevels = texture.mipLevels;
+            r.dataOffset = textureDataSize;
+            r.dataSize = texture.size;
+            textureDataSize += (texture.size + c_HMeshAlignment - 1) & ~(c_HMeshAlignment - 1);
+        }
+
+        // write next to the destination and swap, Save drops the mappings of the old file first
+        auto tempPath = path;
+        tempPath += ".tmp";
+
+        CookedWriter writer;
+        writer.stream.open(tempPath, std::ios::binary | std::ios::trunc);
+        if (!writer.stream.is_open())
+        {
+            HE_ERROR("MeshSourceImporter : unable to open {} for writing", tempPath.string());
+            return false;
+        }
+
+        writer.Write(&header, sizeof(header));
+
+        auto& sections = header.sections;
+        if (meshSource.HasCpuGeometry())
+        {
+            sections[(int)HMeshSection::VertexBuffer] = writer.Write(meshSource.cpuVertexBuffer.data(), meshSource.cpuVertexBuffer.size());
+            sections[(int)HMeshSection::IndexBuffer] = writer.Write(meshSource.cpuIndexBuffer.data(), meshSource.cpuIndexBuffer.size() * sizeof(uint32_t));
+        }
+        else if (!WritePagedStream(writer, meshSource.pageTable, GeometryStream::Vertex, sections[(int)HMeshSection::VertexBuffer]) ||
+                 !WritePagedStream(writer, meshSource.pageTable, GeometryStream::Index, sections[(int)HMeshSection::IndexBuffer]))
+        {
+            writer.stream.close();
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        sections[(int)HMeshSection::Meshes] = writer.Write(meshes);
+        sections[(int)HMeshSection::Geometries] = writer.Write(geometries);
+        sections[(int)HMeshSection::Meshlets] = writer.Write(meshSource.meshlets);
+        sections[(int)HMeshSection::MeshletVertices] = writer.Write(meshSource.meshletVertices);
+        sections[(int)HMeshSection::MeshletTriangles] = writer.Write(meshSource.meshletTriangles);
+        sections[(int)HMeshSection::LODs] = writer.Write(meshSource.lods);
+        sections[(int)HMeshSection::CurveChunks] = writer.Write(meshSource.curveChunks);
+        sections[(int)HMeshSection::MorphTargets] = writer.Write(morphTargets);
+        sections[(int)HMeshSection::MorphDeltas] = writer.Write(meshSource.morphDeltas);
+        sections[(int)HMeshSection::Nodes] = writer.Write(nodes);
+        sections[(int)HMeshSection::Cameras] = writer.Write(cameras);
+        sections[(int)HMeshSection::Materials] = writer.Write(materials);
+        sections[(int)HMeshSection::Textures] = writer.Write(textureRecords);
+
+        writer.Align();
+        sections[(int)HMeshSection::TextureData] = { writer.position, textureDataSize };
+        for (const auto& texture : textures)
+        {
+            writer.Align();
+            if (texture.size)
+                writer.stream.write((const char*)texture.data, texture.size);
+            writer.position += texture.size;
+        }
+        writer.Align();
+
+        sections[(int)HMeshSection::Skins] = writer.Write(skins);
+        sections[(int)HMeshSection::SkinJoints] = writer.Write(skinJoints);
+        sections[(int)HMeshSection::InverseBindMatrices] = writer.Write(inverseBindMatrices);
+        sections[(int)HMeshSection::Animations] = writer.Write(animations);
+        sections[(int)HMeshSection::AnimationData] = writer.Write(animationData);
+        sections[(int)HMeshSection::Strings] = writer.Write(strings);
+
+        header.fileSize = writer.position;
+        writer.stream.seekp(0);
+        writer.stream.write((const char*)&header, sizeof(header));
+        writer.stream.close();
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec)
+        {
+            HE_ERROR("MeshSourceImporter : unable to replace {} : {}", path.string(), ec.message());
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        HE_INFO("Save Cooked MeshSource [{}][{} bytes][{}ms]", path.filename().string(), header.fileSize, t.ElapsedMilliseconds());
+
+        return true;
+    }
+
+    static std::filesystem::path GetGeometryCachePath(const std::filesystem::path& sourcePath)
+    {
+        auto path = sourcePath;
+        path.replace_extension(".hgeom");
+        return path;
+    }
+
+    // .hmesh layout with the vertex and index sections only, written once per geometry content
+    static bool WriteGeometryCache(const MeshSource& meshSource)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        auto path = GetGeometryCachePath(meshSource.sourcePath);
+
+        HMeshHeader header;
+        if (ReadCookedHeader(path, header) && header.geometryHash == meshSource.geometryHash)
+            return true;
+
+        header = {};
+        header.vertexCount = meshSource.vertexCount;
+        header.vertexLayout = (uint8_t)meshSource.vertexLayout;
+        header.vertexStride = meshSource.vertexStride;
+        header.geometryHash = meshSource.geometryHash;
+        for (uint32_t a = 0; a < c_VertexAttributeCount; a++)
+        {
+            header.vertexFormats[a] = (uint8_t)meshSource.vertexFormats[a];
+            header.vertexBufferRanges[a] = { meshSource.vertexBufferRanges[a].byteOffset, meshSource.vertexBufferRanges[a].byteSize };
+        }
+
+        auto tempPath = path;
+        tempPath += ".tmp";
+
+        CookedWriter writer;
+        writer.stream.open(tempPath, std::ios::binary | std::ios::trunc);
+        if (!writer.stream.is_open())
+        {
+            HE_ERROR("MeshSourceImporter : unable to open {} for writing", tempPath.string());
+            return false;
+        }
+
+        writer.Write(&header, sizeof(header));
+        header.sections[(int)HMeshSection::VertexBuffer] = writer.Write(meshSource.cpuVertexBuffer.data(), meshSource.cpuVertexBuffer.size());
+        header.sections[(int)HMeshSection::IndexBuffer] = writer.Write(meshSource.cpuIndexBuffer.data(), meshSource.cpuIndexBuffer.size() * sizeof(uint32_t));
+        writer.Align();
+
+        header.fileSize = writer.position;
+        writer.stream.seekp(0);
+        writer.stream.write((const char*)&header, sizeof(header));
+        writer.stream.close();
+
+        std::error_code ec;
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec)
+        {
+            HE_ERROR("MeshSourceImporter : unable to replace {} : {}", path.string(), ec.message());
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        HE_INFO("Save MeshSource Geometry Cache [{}][{} bytes][{}ms]", path.filename().string(), header.fileSize, t.ElapsedMilliseconds());
+
+        return true;
+    }
+
+#pragma endregion
+
+#pragma region Residency
+
+    // the GPU copies are the reference, a stale cooked file, cache or source must not replace the geometry
+    static bool FetchCookedGeometry(MeshSource& meshSource, const std::filesystem::path& path)
+    {
+        auto file = MappedFile::Open(path, true);
+        const HMeshHeader* header = file ? ValidateCookedFile(*file) : nullptr;
+        if (!header || header->geometryHash != meshSource.geometryHash || header->vertexCount != meshSource.vertexCount || header->vertexLayout != (uint8_t)meshSource.vertexLayout)
+            return false;
+
+        auto vertices = GetCookedSection<uint8_t>(*file, *header, HMeshSection::VertexBuffer);
+        auto indices = GetCookedSection<uint32_t>(*file, *header, HMeshSection::IndexBuffer);
+        meshSource.cpuVertexBuffer = CpuBuffer<uint8_t>::Reference(file, vertices.data(), vertices.size());
+        meshSource.cpuIndexBuffer = CpuBuffer<uint32_t>::Reference(file, indices.data(), indices.size());
+        return true;
+    }
+
+    // last resort when the cache is gone, runs the import pipeline again on the geometry only
+    static bool FetchGltfGeometry(MeshSource& meshSource, const std::filesystem::path& path)
+    {
+        auto settings = meshSource.importSettings;
+        settings.buildBVH = false;
+
+        auto pathStr = path.lexically_normal().string();
+
+        std::vector<HE::Ref<MappedFile>> files;
+        MeshSourceImportStats stats;
+        cgltf_options options = {};
+        cgltf_data* data = LoadGltfData(options, pathStr.c_str(), true, files, stats);
+        if (!data)
+            return false;
+
+        MeshSource source;
+        std::unordered_map<const cgltf_material*, Asset> materials;
+        AppendMeshes(data, source, materials, settings);
+        cgltf_free(data);
+
+        if (settings.mergeIdenticalMeshes)
+            MergeIdenticalMeshes(source);
+        ProcessMeshSource(source, settings, stats);
+
+        if (source.vertexCount != meshSource.vertexCount || HashGeometry(source) != meshSource.geometryHash)
+            return false;
+
+        meshSource.cpuVertexBuffer = std::move(source.cpuVertexBuffer);
+        meshSource.cpuIndexBuffer = std::move(source.cpuIndexBuffer);
+        return true;
+    }
+
+    bool MeshSource::AcquireCpuGeometry()
+    {
+        std::scoped_lock<std::mutex> lock(cpuGeometryMutex.mutex);
+
+        if (HasCpuGeometry())
+            return true;
+
+        if (sourcePath.empty())
+            return false;
+
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        auto cookedPath = sourcePath;
+        cookedPath.replace_extension(".hmesh");
+        auto cachePath = GetGeometryCachePath(sourcePath);
+
+        bool fetched = std::filesystem::exists(cookedPath) && FetchCookedGeometry(*this, cookedPath);
+        if (!fetched)
+            fetched = std::filesystem::exists(cachePath) && FetchCookedGeometry(*this, cachePath);
+
+        if (!fetched && sourcePath.extension() != ".hmesh")
+        {
+            fetched = FetchGltfGeometry(*this, sourcePath);
+            if (fetched)
+                WriteGeometryCache(*this);
+        }
+
+        if (!fetched)
+        {
+            HE_ERROR("MeshSource : unable to re-fetch geometry from {}", sourcePath.string());
+            return false;
+        }
+
+        HE_INFO("MeshSource AcquireCpuGeometry [{}][{}ms]", sourcePath.filename().string(), t.ElapsedMilliseconds());
+
+        return true;
+    }
+
+    void MeshSource::ReleaseCpuGeometry()
+    {
+        std::scoped_lock<std::mutex> lock(cpuGeometryMutex.mutex);
+
+        if (residency == GeometryResidency::KeepCpu || !vertexBuffer || !indexBuffer)
+            return;
+
+        cpuVertexBuffer.Free();
+        cpuIndexBuffer.Free();
+    }
+
+    std::span<const uint8_t> MeshSource::LoadPage(GeometryStream stream, uint32_t page)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        auto& pages = pageTable.pages[(int)stream];
+        if (page >= pages.size())
+            return {};
+
+        auto& p = pages[page];
+        p.lastUse = ++pageTable.useCounter;
+        if (p.file)
+            return { p.file->data, p.file->size };
+
+        auto file = MappedFile::Open(pageTable.path, pageTable.fileOffsets[(int)stream] + p.byteOffset, p.byteSize, importSettings.mapFiles);
+        if (!file || file->size != p.byteSize)
+        {
+            HE_ERROR("MeshSource : unable to load page {} of {}", page, pageTable.path.string());
+            return {};
+        }
+
+        p.file = file;
+        pageTable.residentSize += p.byteSize;
+
+        // least recently used first, the page just loaded is the most recent one
+        while (pageTable.budget && pageTable.residentSize > pageTable.budget)
+        {
+            GeometryPage* victim = nullptr;
+            for (auto& streamPages : pageTable.pages)
+            {
+                for (auto& candidate : streamPages)
+                {
+                    if (candidate.file && &candidate != &p && (!victim || candidate.lastUse < victim->lastUse))
+                        victim = &candidate;
+                }
+            }
+
+            if (!victim)
+                break;
+
+            pageTable.residentSize -= victim->byteSize;
+            victim->file.reset();
+        }
+
+        return { file->data, file->size };
+    }
+
+    void MeshSource::EvictPage(GeometryStream stream, uint32_t page)
+    {
+        auto& pages = pageTable.pages[(int)stream];
+        if (page >= pages.size() || !pages[page].file)
+            return;
+
+        pageTable.residentSize -= pages[page].byteSize;
+        pages[page].file.reset();
+    }
+
+    bool MeshSource::ReadPaged(GeometryStream stream, uint64_t byteOffset, std::span<uint8_t> output)
+    {
+        if (pageTable.empty() || byteOffset > pageTable.byteSizes[(int)stream] || output.size() > pageTable.byteSizes[(int)stream] - byteOffset)
+            return false;
+
+        uint64_t copied = 0;
+        while (copied < output.size())
+        {
+            uint64_t offset = byteOffset + copied;
+            uint32_t page = pageTable.GetPageIndex(offset);
+            auto data = LoadPage(stream, page);
+            if (data.empty())
+                return false;
+
+            uint64_t inPage = offset - pageTable.pages[(int)stream][page].byteOffset;
+            uint64_t size = std::min<uint64_t>(data.size() - inPage, output.size() - copied);
+            std::memcpy(output.data() + copied, data.data() + inPage, size);
+            copied += size;
+        }
+
+        return true;
+    }
+
+#pragma endregion
+
+    Asset MeshSourceImporter::Import(AssetHandle handle, const std::filesystem::path& filePath)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        auto path = assetManager->desc.assetsDirectory / filePath;
+
+        if (!std::filesystem::exists(path))
+        {
+            HE_ERROR("MeshSourceImporter : file {} not exists", path.string());
+            return {};
+        }
+
+        auto asset = assetManager->CreateAsset(handle);
+        auto& assetState = asset.Get<AssetState>();
+        asset.Add<MeshSource>();
+        assetState = AssetState::Loading;
+
+        bool loaded = path.extension() == ".hmesh" ? LoadCookedMeshSource(assetManager, asset, path) : ImportGltfMeshSource(assetManager, asset, path);
+        if (!loaded)
+        {
+            assetManager->DestroyAsset(asset);
+            return {};
+        }
+
+        assetState = AssetState::Loaded;
+
+        return asset;
+    }
+
+    Asset MeshSourceImporter::ImportAsync(AssetHandle handle, const std::filesystem::path& filePath)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+        
+        HE::Timer t;
+
+        auto path = assetManager->desc.assetsDirectory / filePath;
+
+        if (!std::filesystem::exists(path))
+        {
+            HE_ERROR("MeshSourceImporter : file {} not exists", path.string());
+            return {};
+        }
+
+        auto asset = assetManager->CreateAsset(handle);
+        auto& assetState = asset.Get<AssetState>();
+        asset.Add<MeshSource>();
+        assetState = AssetState::Loading;
+
+        HE::Jops::SubmitTask([this, handle, path]() {
+
+            HE_PROFILE_SCOPE_NC("ImportAsync::SubmitTask", HE_PROFILE_COLOR);
+
+            auto asset = assetManager->FindAsset(handle);
+
+            bool loaded = path.extension() == ".hmesh" ? LoadCookedMeshSource(assetManager, asset, path) : ImportGltfMeshSource(assetManager, asset, path);
+            if (!loaded)
+            {
+                assetManager->DestroyAsset(asset);
+                return;
+            }
+
+            auto& state = asset.Get<AssetState>();
+            state = AssetState::Loaded;
+            assetManager->OnAssetLoaded(asset);
+        });
+
+        HE_INFO("[Import meshSource] [{}][{} ms]", path.string(), t.ElapsedMilliseconds());
+
+        return asset;
+    }
+
+    Asset MeshSourceImporter::Create(AssetHandle handle, const std::filesystem::path& filePath)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        // an existing cook is never overwritten by an empty one
+        auto path = assetManager->desc.assetsDirectory / filePath;
+        path.replace_extension(".hmesh");
+        if (std::filesystem::exists(path))
+        {
+            HE_ERROR("MeshSourceImporter : {} already exists", path.string());
+            return {};
+        }
+
+        auto asset = assetManager->CreateAsset(handle);
+        asset.Add<MeshSource>();
+        asset.Add<AssetDependencies>();
+        asset.Add<MeshSourecHierarchy>();
+
+        WriteCookedMeshSource(assetManager, asset, path, {});
+
+        return asset;
+    }
+
+    // Cooks the asset into a .hmesh next to its source, the cooked file is loaded without parsing or copying the vertex and index data
+    void MeshSourceImporter::Save(Asset asset, const std::filesystem::path& filePath)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        auto sourcePath = assetManager->desc.assetsDirectory / filePath;
+        auto path = sourcePath;
+        path.replace_extension(".hmesh");
+
+        std::vector<CookedTexture> textures;
+        std::vector<std::vector<uint8_t>> textureStorage;
+        HE::Ref<MappedFile> cookedFile;
+        if (!GetSourceTextures(sourcePath, textures, textureStorage, cookedFile))
+            HE_WARN("MeshSourceImporter : unable to read textures from {}, cooking without textures", sourcePath.string());
+        else if (assetManager->desc.textureImportSettings.blockCompression)
+            CompressCookedTextures(assetManager, textures, textureStorage);
+
+        // paged sources are written from their page table, others need the whole CPU geometry
+        auto& meshSource = asset.Get<MeshSource>();
+        bool paged = !meshSource.HasCpuGeometry() && !meshSource.pageTable.empty();
+        bool acquired = !paged && !meshSource.HasCpuGeometry();
+        if (acquired && !meshSource.AcquireCpuGeometry())
+            return;
+
+        // Windows refuses to replace a file that is still mapped, geometry loaded from the old cook is copied out of it
+        meshSource.cpuVertexBuffer.Detach();
+        meshSource.cpuIndexBuffer.Detach();
+        for (int s = 0; s < (int)GeometryStream::Count; s++)
+        {
+            for (uint32_t page = 0; page < (uint32_t)meshSource.pageTable.pages[s].size(); page++)
+                meshSource.EvictPage(GeometryStream(s), page);
+        }
+
+        bool written = WriteCookedMeshSource(assetManager, asset, path, textures);
+
+        // sources imported from glTF become pageable once cooked, paged ones follow the new file
+        HMeshHeader header;
+        if (written && meshSource.residency == GeometryResidency::Paged && ReadCookedHeader(path, header) && header.vertexCount == meshSource.vertexCount)
+            InitPageTable(meshSource, path, header, meshSource.importSettings);
 
-        NOT_YET_IMPLEMENTED();
+        if (acquired && (meshSource.residency == GeometryResidency::Stream || meshSource.residency == GeometryResidency::Paged))
+            meshSource.ReleaseCpuGeometry();
     }
 }
\ No newline at end of file
@@ -0,0 +1,393 @@
+#include "HydraEngine/Base.h"
+
+import Assets;
+import HE;
+import Math;
+import std;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+    struct GeometryMeshlets
+    {
+        std::vector<Meshlet> meshlets;
+        std::vector<uint32_t> vertices;
+        std::vector<uint8_t> triangles;
+    };
+
+    static void ComputeMeshletBounds(Meshlet& meshlet, const GeometryMeshlets& out, std::span<const Math::float3> positions)
+    {
+        const uint32_t* vertices = out.vertices.data() + meshlet.vertexOffset;
+        const uint8_t* triangles = out.triangles.data() + meshlet.triangleOffset;
+
+        // Ritter bounding sphere, seeded with the pair of axis extremes that are farthest apart
+        uint32_t minV[3] = { 0, 0, 0 };
+        uint32_t maxV[3] = { 0, 0, 0 };
+        for (uint32_t i = 1; i < meshlet.vertexCount; i++)
+        {
+            const Math::float3& p = positions[vertices[i]];
+            for (int axis = 0; axis < 3; axis++)
+            {
+                if (p[axis] < positions[vertices[minV[axis]]][axis]) minV[axis] = i;
+                if (p[axis] > positions[vertices[maxV[axis]]][axis]) maxV[axis] = i;
+            }
+        }
+
+        int bestAxis = 0;
+        float bestDistance = -1.0f;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            Math::float3 d = positions[vertices[maxV[axis]]] - positions[vertices[minV[axis]]];
+            float distance = Math::dot(d, d);
+            if (distance > bestDistance)
+            {
+                bestDistance = distance;
+                bestAxis = axis;
+            }
+        }
+
+        Math::float3 center = (positions[vertices[minV[bestAxis]]] + positions[vertices[maxV[bestAxis]]]) * 0.5f;
+        float radius = Math::sqrt(bestDistance) * 0.5f;
+
+        for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+        {
+            const Math::float3& p = positions[vertices[i]];
+            float distance = Math::length(p - center);
+            if (distance > radius)
+            {
+                float k = (distance - radius) * 0.5f / distance;
+                center += (p - center) * k;
+                radius = (radius + distance) * 0.5f;
+            }
+        }
+
+        meshlet.center = center;
+        meshlet.radius = radius;
+
+        // Normal cone
+        Math::float3 normalSum = { 0.0f, 0.0f, 0.0f };
+        uint32_t validTriangles = 0;
+
+        for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+        {
+            const Math::float3& p0 = positions[vertices[triangles[t * 3 + 0]]];
+            const Math::float3& p1 = positions[vertices[triangles[t * 3 + 1]]];
+            const Math::float3& p2 = positions[vertices[triangles[t * 3 + 2]]];
+
+            Math::float3 n = Math::cross(p1 - p0, p2 - p0);
+            float length = Math::length(n);
+            if (length > 0.0f)
+            {
+                normalSum += n / length;
+                validTriangles++;
+            }
+        }
+
+        meshlet.coneApex = center;
+        meshlet.coneAxis = { 0.0f, 0.0f, 1.0f };
+        meshlet.coneCutoff = 1.0f;
+
+        float axisLength = Math::length(normalSum);
+        if (validTriangles == 0 || axisLength == 0.0f)
+            return;
+
+        Math::float3 axis = normalSum / axisLength;
+        float minDot = 1.0f;
+        for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+        {
+            const Math::float3& p0 = positions[vertices[triangles[t * 3 + 0]]];
+            const Math::float3& p1 = positions[vertices[triangles[t * 3 + 1]]];
+            const Math::float3& p2 = positions[vertices[triangles[t * 3 + 2]]];
+
+            Math::float3 n = Math::cross(p1 - p0, p2 - p0);
+            float length = Math::length(n);
+            if (length > 0.0f)
+                minDot = std::min(minDot, Math::dot(n / length, axis));
+        }
+
+        meshlet.coneAxis = axis;
+
+        // wide cones (> ~84 degrees) are not worth testing
+        if (minDot <= 0.1f)
+            return;
+
+        // move the apex back along the axis until it lies behind every triangle plane
+        float maxT = 0.0f;
+        for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+        {
+            const Math::float3& p0 = positions[vertices[triangles[t * 3 + 0]]];
+            const Math::float3& p1 = positions[vertices[triangles[t * 3 + 1]]];
+            const Math::float3& p2 = positions[vertices[triangles[t * 3 + 2]]];
+
+            Math::float3 n = Math::cross(p1 - p0, p2 - p0);
+            float length = Math::length(n);
+            if (length == 0.0f)
+                continue;
+
+            n /= length;
+            float dc = Math::dot(center - p0, n);
+            float dn = Math::dot(axis, n);
+            maxT = std::max(maxT, dc / dn);
+        }
+
+        meshlet.coneApex = center - axis * maxT;
+        meshlet.coneCutoff = Math::sqrt(1.0f - minDot * minDot);
+    }
+
+    // Greedy fill that grows each meshlet through the triangles around its vertices, fewest new vertices first and the closest
+    // to the meshlet centroid among those, so spheres and normal cones stay tight. Index order only seeds disconnected pieces.
+    static void BuildGeometryMeshlets(MeshSource& meshSource, MeshGeometry& geometry, GeometryMeshlets& out, uint32_t maxVertices, uint32_t maxTriangles)
+    {
+        if (geometry.type != MeshGeometryPrimitiveType::Triangles || geometry.indexCount < 3)
+            return;
+
+        const uint32_t* indices = geometry.Getindices(meshSource);
+        const uint32_t triangleCount = geometry.indexCount / 3;
+
+        auto decoded = geometry.GetDecodedAttribute(meshSource, VertexAttribute::Position);
+        std::vector<Math::float3> positions(decoded.size());
+        for (size_t v = 0; v < positions.size(); v++)
+            positions[v] = decoded.GetFloat3(v);
+
+        // triangles around each vertex
+        std::vector<uint32_t> triangleOffsets(geometry.vertexCount + 1, 0);
+        for (uint32_t i = 0; i < triangleCount * 3; i++)
+            triangleOffsets[indices[i] + 1]++;
+        for (uint32_t v = 0; v < geometry.vertexCount; v++)
+            triangleOffsets[v + 1] += triangleOffsets[v];
+
+        std::vector<uint32_t> triangleList(triangleCount * 3);
+        {
+            std::vector<uint32_t> cursor(triangleOffsets.begin(), triangleOffsets.end() - 1);
+            for (uint32_t i = 0; i < triangleCount * 3; i++)
+                triangleList[cursor[indices[i]]++] = i / 3;
+        }
+
+        std::vector<uint8_t> emitted(triangleCount, 0);
+        std::vector<uint32_t> slots(geometry.vertexCount, c_Invalid);
+        std::vector<uint32_t> candidates; // triangles around the vertices of the current meshlet, without the emitted ones
+        std::vector<uint32_t> candidateMarks(triangleCount, c_Invalid);
+        Meshlet current;
+        Math::float3 vertexSum = { 0.0f, 0.0f, 0.0f };
+
+        auto flush = [&]() {
+
+            if (current.triangleCount == 0)
+                return;
+
+            ComputeMeshletBounds(current, out, positions);
+            out.meshlets.push_back(current);
+
+            for (uint32_t i = 0; i < current.vertexCount; i++)
+                slots[out.vertices[current.vertexOffset + i]] = c_Invalid;
+
+            current = {};
+            current.vertexOffset = (uint32_t)out.vertices.size();
+            current.triangleOffset = (uint32_t)out.triangles.size();
+            vertexSum = { 0.0f, 0.0f, 0.0f };
+            candidates.clear();
+        };
+
+        auto countNewVertices = [&](uint32_t t) {
+            const uint32_t* tri = indices + t * 3;
+            return uint32_t(slots[tri[0]] == c_Invalid) + (slots[tri[1]] == c_Invalid) + (slots[tri[2]] == c_Invalid);
+        };
+
+        auto findAdjacentTriangle = [&]() {
+
+            const Math::float3 center = vertexSum / float(current.vertexCount);
+            uint32_t best = c_Invalid;
+            uint32_t bestNew = 4;
+            float bestDistance = std::numeric_limits<float>::max();
+
+            for (size_t i = 0; i < candidates.size();)
+            {
+                const uint32_t t = candidates[i];
+                if (emitted[t])
+                {
+                    candidates[i] = candidates.back();
+                    candidates.pop_back();
+                    continue;
+                }
+
+                i++;
+                const uint32_t newVertices = countNewVertices(t);
+                if (newVertices > bestNew)
+                    continue;
+
+                const uint32_t* tri = indices + t * 3;
+                Math::float3 d = (positions[tri[0]] + positions[tri[1]] + positions[tri[2]]) * (1.0f / 3.0f) - center;
+                float distance = Math::dot(d, d);
+                if (newVertices < bestNew || distance < bestDistance)
+                {
+                    best = t;
+                    bestNew = newVertices;
+                    bestDistance = distance;
+                }
+            }
+
+            return best;
+        };
+
+        uint32_t seed = 0;
+        for (uint32_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+        {
+            uint32_t t = current.vertexCount ? findAdjacentTriangle() : c_Invalid;
+            if (t == c_Invalid)
+            {
+                while (emitted[seed])
+                    seed++;
+                t = seed;
+            }
+
+            // a triangle that does not fit seeds the next meshlet, which then starts next to this one
+            if (current.vertexCount + countNewVertices(t) > maxVertices || current.triangleCount + 1 > maxTriangles)
+                flush();
+
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                const uint32_t v = indices[t * 3 + k];
+                if (slots[v] == c_Invalid)
+                {
+                    slots[v] = current.vertexCount++;
+                    out.vertices.push_back(v);
+                    vertexSum += positions[v];
+
+                    // marked with the meshlet index so each triangle is listed once per meshlet
+                    for (uint32_t j = triangleOffsets[v]; j < triangleOffsets[v + 1]; j++)
+                    {
+                        const uint32_t n = triangleList[j];
+                        if (!emitted[n] && candidateMarks[n] != out.meshlets.size())
+                        {
+                            candidateMarks[n] = (uint32_t)out.meshlets.size();
+                            candidates.push_back(n);
+                        }
+                    }
+                }
+
+                out.triangles.push_back((uint8_t)slots[v]);
+            }
+
+            emitted[t] = 1;
+            current.triangleCount++;
+        }
+
+        flush();
+    }
+
+    void BuildMeshlets(MeshSource& meshSource, uint32_t maxVertices, uint32_t maxTriangles)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        maxVertices = std::clamp(maxVertices, 3u, 256u);
+        maxTriangles = std::max(maxTriangles, 1u);
+
+        std::vector<GeometryMeshlets> perGeometry(meshSource.geometries.size());
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), meshSource.geometries.size(), size_t(1), [&](size_t i) {
+            BuildGeometryMeshlets(meshSource, meshSource.geometries[i], perGeometry[i], maxVertices, maxTriangles);
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        size_t meshletCount = 0, vertexCount = 0, triangleCount = 0;
+        for (auto& g : perGeometry)
+        {
+            meshletCount += g.meshlets.size();
+            vertexCount += g.vertices.size();
+            triangleCount += g.triangles.size();
+        }
+
+        meshSource.meshlets.clear();
+        meshSource.meshletVertices.clear();
+        meshSource.meshletTriangles.clear();
+        meshSource.meshlets.reserve(meshletCount);
+        meshSource.meshletVertices.reserve(vertexCount);
+        meshSource.meshletTriangles.reserve(triangleCount);
+
+        for (size_t i = 0; i < perGeometry.size(); i++)
+        {
+            auto& g = perGeometry[i];
+            auto& geometry = meshSource.geometries[i];
+
+            uint32_t vertexBase = (uint32_t)meshSource.meshletVertices.size();
+            uint32_t triangleBase = (uint32_t)meshSource.meshletTriangles.size();
+
+            geometry.meshletOffset = (uint32_t)meshSource.meshlets.size();
+            geometry.meshletCount = (uint32_t)g.meshlets.size();
+
+            for (auto& meshlet : g.meshlets)
+            {
+                meshlet.vertexOffset += vertexBase;
+                meshlet.triangleOffset += triangleBase;
+                meshSource.meshlets.push_back(meshlet);
+            }
+
+            meshSource.meshletVertices.insert(meshSource.meshletVertices.end(), g.vertices.begin(), g.vertices.end());
+            meshSource.meshletTriangles.insert(meshSource.meshletTriangles.end(), g.triangles.begin(), g.triangles.end());
+        }
+
+        HE_INFO("Import BuildMeshlets [{}][{}ms]", meshSource.meshlets.size(), t.ElapsedMilliseconds());
+    }
+
+    std::array<Math::float4, 6> ExtractFrustumPlanes(const Math::float4x4& m)
+    {
+        Math::float4 row0 = { m[0][0], m[1][0], m[2][0], m[3][0] };
+        Math::float4 row1 = { m[0][1], m[1][1], m[2][1], m[3][1] };
+        Math::float4 row2 = { m[0][2], m[1][2], m[2][2], m[3][2] };
+        Math::float4 row3 = { m[0][3], m[1][3], m[2][3], m[3][3] };
+
+        // depth range [0, 1]
+        std::array<Math::float4, 6> planes = {
+            row3 + row0,
+            row3 - row0,
+            row3 + row1,
+            row3 - row1,
+            row2,
+            row3 - row2,
+        };
+
+        for (auto& plane : planes)
+            plane /= Math::length(Math::float3(plane));
+
+        return planes;
+    }
+
+    bool IsMeshletCulled(const Meshlet& meshlet, const Math::float3& cameraPosition, const std::array<Math::float4, 6>& frustumPlanes)
+    {
+        for (const auto& plane : frustumPlanes)
+        {
+            if (Math::dot(Math::float3(plane), meshlet.center) + plane.w < -meshlet.radius)
+                return true;
+        }
+
+        if (meshlet.coneCutoff < 1.0f)
+        {
+            Math::float3 view = meshlet.coneApex - cameraPosition;
+            float length = Math::length(view);
+            if (length > 0.0f && Math::dot(view / length, meshlet.coneAxis) >= meshlet.coneCutoff)
+                return true;
+        }
+
+        return false;
+    }
+
+    uint32_t CullMeshlets(std::span<const Meshlet> meshlets, const Math::float3& cameraPosition, const std::array<Math::float4, 6>& frustumPlanes, std::vector<uint32_t>& visibleMeshlets)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        uint32_t culled = 0;
+        for (uint32_t i = 0; i < (uint32_t)meshlets.size(); i++)
+        {
+            if (IsMeshletCulled(meshlets[i], cameraPosition, frustumPlanes))
+                culled++;
+            else
+                visibleMeshlets.push_back(i);
+        }
+
+        return culled;
+    }
+}
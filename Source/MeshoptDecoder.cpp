@@ -0,0 +1,501 @@
+#include "HydraEngine/Base.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+import Assets;
+import HE;
+import std;
+
+namespace Assets {
+
+    // EXT_meshopt_compression bitstream, version 0 vertex codec and version 0/1 index codecs
+
+    constexpr uint8_t c_MeshoptVertexHeader = 0xA0;
+    constexpr uint8_t c_MeshoptIndexHeader = 0xE0;
+    constexpr uint8_t c_MeshoptSequenceHeader = 0xD0;
+    constexpr size_t c_MeshoptByteGroupSize = 16;
+    constexpr size_t c_MeshoptVertexBlockMaxSize = 256;
+    constexpr size_t c_MeshoptVertexBlockSizeBytes = 8192;
+    constexpr size_t c_MeshoptVertexTailMinSize = 32;
+    constexpr size_t c_MeshoptIndexTailSize = 16;
+    constexpr size_t c_MeshoptSequenceTailSize = 4;
+
+    static const uint8_t* DecodeMeshoptBytesGroup(const uint8_t* data, const uint8_t* end, uint8_t* buffer, int bitsLog2)
+    {
+        if (bitsLog2 == 0)
+        {
+            std::memset(buffer, 0, c_MeshoptByteGroupSize);
+            return data;
+        }
+
+        if (bitsLog2 == 3)
+        {
+            if (size_t(end - data) < c_MeshoptByteGroupSize)
+                return nullptr;
+
+            std::memcpy(buffer, data, c_MeshoptByteGroupSize);
+            return data + c_MeshoptByteGroupSize;
+        }
+
+        // 2 or 4 bit values, most significant first, the all ones value is an escape for a byte that follows the group
+        const uint32_t bits = bitsLog2 == 1 ? 2 : 4;
+        const uint32_t sentinel = (1u << bits) - 1;
+        const size_t packedSize = c_MeshoptByteGroupSize * bits / 8;
+        if (size_t(end - data) < packedSize)
+            return nullptr;
+
+        const uint8_t* extra = data + packedSize;
+        for (size_t i = 0; i < c_MeshoptByteGroupSize; i++)
+        {
+            uint32_t shift = 8 - bits - uint32_t(i * bits % 8);
+            uint32_t value = (data[i * bits / 8] >> shift) & sentinel;
+            if (value == sentinel)
+            {
+                if (extra >= end)
+                    return nullptr;
+                value = *extra++;
+            }
+
+            buffer[i] = uint8_t(value);
+        }
+
+        return extra;
+    }
+
+    bool DecodeMeshoptVertexBuffer(void* destination, size_t count, size_t stride, const uint8_t* buffer, size_t size)
+    {
+        if (stride == 0 || stride > 256 || stride % 4 != 0)
+            return false;
+
+        const uint8_t* data = buffer;
+        const uint8_t* end = buffer + size;
+        if (size < 1 + stride || (*data++ & 0xF0) != c_MeshoptVertexHeader || (buffer[0] & 0x0F) != 0)
+            return false;
+
+        const size_t tailSize = std::max(stride, c_MeshoptVertexTailMinSize);
+        if (size < 1 + tailSize)
+            return false;
+
+        uint8_t lastVertex[256];
+        std::memcpy(lastVertex, end - stride, stride);
+        end -= tailSize;
+
+        const size_t blockSize = std::min((c_MeshoptVertexBlockSizeBytes / stride) & ~(c_MeshoptByteGroupSize - 1), c_MeshoptVertexBlockMaxSize);
+        uint8_t deltas[c_MeshoptVertexBlockMaxSize];
+        uint8_t* output = (uint8_t*)destination;
+
+        for (size_t first = 0; first < count; first += blockSize)
+        {
+            const size_t blockCount = std::min(blockSize, count - first);
+            const size_t groupCount = (blockCount + c_MeshoptByteGroupSize - 1) / c_MeshoptByteGroupSize;
+            const size_t headerSize = (groupCount + 3) / 4;
+
+            for (size_t k = 0; k < stride; k++)
+            {
+                if (size_t(end - data) < headerSize)
+                    return false;
+
+                const uint8_t* header = data;
+                data += headerSize;
+
+                for (size_t g = 0; g < groupCount; g++)
+                {
+                    int bitsLog2 = (header[g / 4] >> ((g % 4) * 2)) & 3;
+                    data = DecodeMeshoptBytesGroup(data, end, deltas + g * c_MeshoptByteGroupSize, bitsLog2);
+                    if (!data)
+                        return false;
+                }
+
+                // zigzag deltas against the same byte of the previous vertex
+                uint8_t previous = lastVertex[k];
+                uint8_t* dst = output + first * stride + k;
+                for (size_t i = 0; i < blockCount; i++)
+                {
+                    uint8_t delta = deltas[i];
+                    previous = uint8_t(previous + ((delta >> 1) ^ -(delta & 1)));
+                    dst[i * stride] = previous;
+                }
+
+                lastVertex[k] = previous;
+            }
+        }
+
+        return data == end;
+    }
+
+    static uint32_t DecodeMeshoptVByte(const uint8_t*& data)
+    {
+        uint8_t lead = *data++;
+        if (lead < 128)
+            return lead;
+
+        uint32_t result = lead & 127;
+        uint32_t shift = 7;
+        for (int i = 0; i < 4; i++)
+        {
+            uint8_t group = *data++;
+            result |= uint32_t(group & 127) << shift;
+            shift += 7;
+
+            if (group < 128)
+                break;
+        }
+
+        return result;
+    }
+
+    static uint32_t DecodeMeshoptIndex(const uint8_t*& data, uint32_t last)
+    {
+        uint32_t v = DecodeMeshoptVByte(data);
+        return last + ((v >> 1) ^ -int32_t(v & 1));
+    }
+
+    static void WriteMeshoptIndex(void* destination, size_t i, size_t indexSize, uint32_t value)
+    {
+        if (indexSize == 2)
+            ((uint16_t*)destination)[i] = uint16_t(value);
+        else
+            ((uint32_t*)destination)[i] = value;
+    }
+
+    bool DecodeMeshoptIndexBuffer(void* destination, size_t count, size_t indexSize, const uint8_t* buffer, size_t size)
+    {
+        if (count % 3 != 0 || (indexSize != 2 && indexSize != 4))
+            return false;
+
+        if (size < 1 + count / 3 + c_MeshoptIndexTailSize || (buffer[0] & 0xF0) != c_MeshoptIndexHeader)
+            return false;
+
+        const int version = buffer[0] & 0x0F;
+        if (version > 1)
+            return false;
+
+        uint32_t edgeFifo[16][2];
+        uint32_t vertexFifo[16];
+        std::memset(edgeFifo, -1, sizeof(edgeFifo));
+        std::memset(vertexFifo, -1, sizeof(vertexFifo));
+        size_t edgeFifoOffset = 0;
+        size_t vertexFifoOffset = 0;
+
+        auto pushVertex = [&](uint32_t v, bool cond = true) { vertexFifo[vertexFifoOffset] = v; vertexFifoOffset = (vertexFifoOffset + cond) & 15; };
+        auto pushEdge = [&](uint32_t a, uint32_t b) { edgeFifo[edgeFifoOffset][0] = a; edgeFifo[edgeFifoOffset][1] = b; edgeFifoOffset = (edgeFifoOffset + 1) & 15; };
+        auto writeTriangle = [&](size_t i, uint32_t a, uint32_t b, uint32_t c) {
+            WriteMeshoptIndex(destination, i + 0, indexSize, a);
+            WriteMeshoptIndex(destination, i + 1, indexSize, b);
+            WriteMeshoptIndex(destination, i + 2, indexSize, c);
+        };
+
+        uint32_t next = 0;
+        uint32_t last = 0;
+        const int fecMax = version >= 1 ? 13 : 15;
+
+        const uint8_t* code = buffer + 1;
+        const uint8_t* data = code + count / 3;
+        const uint8_t* dataSafeEnd = buffer + size - c_MeshoptIndexTailSize;
+        const uint8_t* codeAuxTable = dataSafeEnd;
+
+        for (size_t i = 0; i < count; i += 3)
+        {
+            // each triangle reads at most 16 bytes of data, the tail keeps the reads in bounds
+            if (data > dataSafeEnd)
+                return false;
+
+            uint8_t codeTri = *code++;
+
+            if (codeTri < 0xF0)
+            {
+                int fe = codeTri >> 4;
+                uint32_t a = edgeFifo[(edgeFifoOffset - 1 - fe) & 15][0];
+                uint32_t b = edgeFifo[(edgeFifoOffset - 1 - fe) & 15][1];
+
+                int fec = codeTri & 15;
+                if (fec < fecMax)
+                {
+                    uint32_t c = fec == 0 ? next : vertexFifo[(vertexFifoOffset - 1 - fec) & 15];
+                    next += fec == 0;
+
+                    writeTriangle(i, a, b, c);
+                    pushVertex(c, fec == 0);
+                    pushEdge(c, b);
+                    pushEdge(a, c);
+                }
+                else
+                {
+                    // 13 and 14 encode last -1 and +1
+                    uint32_t c = last = fec != 15 ? last + (fec - (fec ^ 3)) : DecodeMeshoptIndex(data, last);
+
+                    writeTriangle(i, a, b, c);
+                    pushVertex(c);
+                    pushEdge(c, b);
+                    pushEdge(a, c);
+                }
+            }
+            else if (codeTri < 0xFE)
+            {
+                uint8_t codeAux = codeAuxTable[codeTri & 15];
+                int feb = codeAux >> 4;
+                int fec = codeAux & 15;
+
+                uint32_t a = next++;
+                uint32_t b = feb == 0 ? next : vertexFifo[(vertexFifoOffset - feb) & 15];
+                next += feb == 0;
+                uint32_t c = fec == 0 ? next : vertexFifo[(vertexFifoOffset - fec) & 15];
+                next += fec == 0;
+
+                writeTriangle(i, a, b, c);
+                pushVertex(a);
+                pushVertex(b, feb == 0);
+                pushVertex(c, fec == 0);
+                pushEdge(b, a);
+                pushEdge(c, b);
+                pushEdge(a, c);
+            }
+            else
+            {
+                uint8_t codeAux = *data++;
+                int fea = codeTri == 0xFE ? 0 : 15;
+                int feb = codeAux >> 4;
+                int fec = codeAux & 15;
+
+                if (codeAux == 0)
+                    next = 0;
+
+                uint32_t a = fea == 0 ? next++ : 0;
+                uint32_t b = feb == 0 ? next++ : vertexFifo[(vertexFifoOffset - feb) & 15];
+                uint32_t c = fec == 0 ? next++ : vertexFifo[(vertexFifoOffset - fec) & 15];
+
+                if (fea == 15) last = a = DecodeMeshoptIndex(data, last);
+                if (feb == 15) last = b = DecodeMeshoptIndex(data, last);
+                if (fec == 15) last = c = DecodeMeshoptIndex(data, last);
+
+                writeTriangle(i, a, b, c);
+                pushVertex(a);
+                pushVertex(b, feb == 0 || feb == 15);
+                pushVertex(c, fec == 0 || fec == 15);
+                pushEdge(b, a);
+                pushEdge(c, b);
+                pushEdge(a, c);
+            }
+        }
+
+        return data == dataSafeEnd;
+    }
+
+    bool DecodeMeshoptIndexSequence(void* destination, size_t count, size_t indexSize, const uint8_t* buffer, size_t size)
+    {
+        if (indexSize != 2 && indexSize != 4)
+            return false;
+
+        if (size < 1 + count + c_MeshoptSequenceTailSize || (buffer[0] & 0xF0) != c_MeshoptSequenceHeader || (buffer[0] & 0x0F) > 1)
+            return false;
+
+        const uint8_t* data = buffer + 1;
+        const uint8_t* dataSafeEnd = buffer + size - c_MeshoptSequenceTailSize;
+
+        // two baselines, the low bit of each value selects one
+        uint32_t last[2] = {};
+        for (size_t i = 0; i < count; i++)
+        {
+            if (data >= dataSafeEnd)
+                return false;
+
+            uint32_t v = DecodeMeshoptVByte(data);
+            uint32_t current = v & 1;
+            v >>= 1;
+
+            uint32_t index = last[current] + ((v >> 1) ^ -int32_t(v & 1));
+            last[current] = index;
+            WriteMeshoptIndex(destination, i, indexSize, index);
+        }
+
+        return data == dataSafeEnd;
+    }
+
+    template<typename T>
+    static void DecodeMeshoptOctahedralFilter(T* data, size_t count)
+    {
+        const float max = float((1 << (sizeof(T) * 8 - 1)) - 1);
+        size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        auto round = [&](__m128 v) { return _mm_cvttps_epi32(_mm_add_ps(v, _mm_or_ps(half, _mm_and_ps(v, signMask)))); };
+
+        for (; i + 4 <= count; i += 4)
+        {
+            alignas(16) float xs[4], ys[4], zs[4];
+            for (int j = 0; j < 4; j++)
+            {
+                xs[j] = float(data[(i + j) * 4 + 0]);
+                ys[j] = float(data[(i + j) * 4 + 1]);
+                zs[j] = float(data[(i + j) * 4 + 2]);
+            }
+
+            __m128 x = _mm_load_ps(xs);
+            __m128 y = _mm_load_ps(ys);
+            __m128 z = _mm_sub_ps(_mm_sub_ps(_mm_load_ps(zs), _mm_andnot_ps(signMask, x)), _mm_andnot_ps(signMask, y));
+
+            // fold the lower hemisphere, t is added towards the sign of each component, x >= 0 keeps +0 positive
+            __m128 t = _mm_min_ps(z, zero);
+            __m128 tx = _mm_or_ps(_mm_and_ps(_mm_cmpge_ps(x, zero), t), _mm_andnot_ps(_mm_cmpge_ps(x, zero), _mm_sub_ps(zero, t)));
+            __m128 ty = _mm_or_ps(_mm_and_ps(_mm_cmpge_ps(y, zero), t), _mm_andnot_ps(_mm_cmpge_ps(y, zero), _mm_sub_ps(zero, t)));
+            x = _mm_add_ps(x, tx);
+            y = _mm_add_ps(y, ty);
+
+            __m128 l = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+            __m128 s = _mm_div_ps(_mm_set1_ps(max), l);
+
+            alignas(16) int32_t xi[4], yi[4], zi[4];
+            _mm_store_si128((__m128i*)xi, round(_mm_mul_ps(x, s)));
+            _mm_store_si128((__m128i*)yi, round(_mm_mul_ps(y, s)));
+            _mm_store_si128((__m128i*)zi, round(_mm_mul_ps(z, s)));
+
+            for (int j = 0; j < 4; j++)
+            {
+                data[(i + j) * 4 + 0] = T(xi[j]);
+                data[(i + j) * 4 + 1] = T(yi[j]);
+                data[(i + j) * 4 + 2] = T(zi[j]);
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            float x = float(data[i * 4 + 0]);
+            float y = float(data[i * 4 + 1]);
+            float z = float(data[i * 4 + 2]) - std::fabs(x) - std::fabs(y);
+
+            float t = z >= 0.0f ? 0.0f : z;
+            x += x >= 0.0f ? t : -t;
+            y += y >= 0.0f ? t : -t;
+
+            float s = max / std::sqrt(x * x + y * y + z * z);
+            data[i * 4 + 0] = T(int(x * s + (x >= 0.0f ? 0.5f : -0.5f)));
+            data[i * 4 + 1] = T(int(y * s + (y >= 0.0f ? 0.5f : -0.5f)));
+            data[i * 4 + 2] = T(int(z * s + (z >= 0.0f ? 0.5f : -0.5f)));
+        }
+    }
+
+    static void DecodeMeshoptQuaternionFilter(int16_t* data, size_t count)
+    {
+        const float scale = 1.0f / std::sqrt(2.0f);
+        size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 max = _mm_set1_ps(32767.0f);
+        auto round = [&](__m128 v) { return _mm_cvttps_epi32(_mm_add_ps(v, _mm_or_ps(half, _mm_and_ps(v, signMask)))); };
+
+        for (; i + 4 <= count; i += 4)
+        {
+            alignas(16) float xs[4], ys[4], zs[4], ss[4];
+            for (int j = 0; j < 4; j++)
+            {
+                const int16_t* q = data + (i + j) * 4;
+                ss[j] = float(q[3] | 3);
+                xs[j] = float(q[0]);
+                ys[j] = float(q[1]);
+                zs[j] = float(q[2]);
+            }
+
+            // the high bits of the fourth component carry the quantization scale, the low 2 bits the index of the dropped component
+            __m128 s = _mm_div_ps(_mm_set1_ps(scale), _mm_load_ps(ss));
+            __m128 x = _mm_mul_ps(_mm_load_ps(xs), s);
+            __m128 y = _mm_mul_ps(_mm_load_ps(ys), s);
+            __m128 z = _mm_mul_ps(_mm_load_ps(zs), s);
+            __m128 ww = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(one, _mm_mul_ps(x, x)), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+            __m128 w = _mm_sqrt_ps(_mm_max_ps(ww, zero));
+
+            alignas(16) int32_t xi[4], yi[4], zi[4], wi[4];
+            _mm_store_si128((__m128i*)xi, round(_mm_mul_ps(x, max)));
+            _mm_store_si128((__m128i*)yi, round(_mm_mul_ps(y, max)));
+            _mm_store_si128((__m128i*)zi, round(_mm_mul_ps(z, max)));
+            _mm_store_si128((__m128i*)wi, round(_mm_mul_ps(w, max)));
+
+            for (int j = 0; j < 4; j++)
+            {
+                int16_t* q = data + (i + j) * 4;
+                int qc = q[3] & 3;
+                q[(qc + 1) & 3] = int16_t(xi[j]);
+                q[(qc + 2) & 3] = int16_t(yi[j]);
+                q[(qc + 3) & 3] = int16_t(zi[j]);
+                q[(qc + 0) & 3] = int16_t(wi[j]);
+            }
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            int16_t* q = data + i * 4;
+            float s = scale / float(q[3] | 3);
+            float x = float(q[0]) * s;
+            float y = float(q[1]) * s;
+            float z = float(q[2]) * s;
+            float ww = 1.0f - x * x - y * y - z * z;
+            float w = std::sqrt(ww >= 0.0f ? ww : 0.0f);
+
+            int qc = q[3] & 3;
+            q[(qc + 1) & 3] = int16_t(int(x * 32767.0f + (x >= 0.0f ? 0.5f : -0.5f)));
+            q[(qc + 2) & 3] = int16_t(int(y * 32767.0f + (y >= 0.0f ? 0.5f : -0.5f)));
+            q[(qc + 3) & 3] = int16_t(int(z * 32767.0f + (z >= 0.0f ? 0.5f : -0.5f)));
+            q[(qc + 0) & 3] = int16_t(int(w * 32767.0f + 0.5f));
+        }
+    }
+
+    // 24 bit signed mantissa and 8 bit signed exponent to float
+    static void DecodeMeshoptExponentialFilter(uint32_t* data, size_t count)
+    {
+        size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(data + i));
+            __m128i m = _mm_srai_epi32(_mm_slli_epi32(v, 8), 8);
+            __m128i e = _mm_srai_epi32(v, 24);
+            __m128 p = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(e, _mm_set1_epi32(127)), 23));
+            _mm_storeu_ps((float*)(data + i), _mm_mul_ps(p, _mm_cvtepi32_ps(m)));
+        }
+#endif
+
+        for (; i < count; i++)
+        {
+            int32_t m = int32_t(data[i] << 8) >> 8;
+            int32_t e = int32_t(data[i]) >> 24;
+            float p = std::bit_cast<float>(uint32_t(e + 127) << 23);
+            data[i] = std::bit_cast<uint32_t>(p * float(m));
+        }
+    }
+
+    bool DecodeMeshoptFilter(MeshoptFilter filter, void* data, size_t count, size_t stride)
+    {
+        switch (filter)
+        {
+        case MeshoptFilter::None:
+            return true;
+        case MeshoptFilter::Octahedral:
+            if (stride == 4) { DecodeMeshoptOctahedralFilter((int8_t*)data, count); return true; }
+            if (stride == 8) { DecodeMeshoptOctahedralFilter((int16_t*)data, count); return true; }
+            return false;
+        case MeshoptFilter::Quaternion:
+            if (stride != 8)
+                return false;
+            DecodeMeshoptQuaternionFilter((int16_t*)data, count);
+            return true;
+        case MeshoptFilter::Exponential:
+            if (stride % 4 != 0)
+                return false;
+            DecodeMeshoptExponentialFilter((uint32_t*)data, count * stride / 4);
+            return true;
+        }
+
+        return false;
+    }
+}
@@ -0,0 +1,192 @@
+#include "HydraEngine/Base.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+import Assets;
+import HE;
+import Math;
+import std;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+    static_assert(sizeof(MorphDelta) == 16);
+
+#pragma region Import
+
+    static float MaxAbsComponent(std::span<const Math::float3> values)
+    {
+        float result = 0.0f;
+        for (const auto& v : values)
+            result = std::max({ result, std::abs(v.x), std::abs(v.y), std::abs(v.z) });
+
+        return result;
+    }
+
+    template<typename T>
+    static void Quantize(const Math::float3& value, float scale, T out[3])
+    {
+        constexpr float c_Max = float(std::numeric_limits<T>::max());
+        const float s = scale > 0.0f ? c_Max / scale : 0.0f;
+        for (int c = 0; c < 3; c++)
+            out[c] = T(std::clamp(std::round(value[c] * s), -c_Max, c_Max));
+    }
+
+    void AppendMorphTarget(MeshSource& meshSource, Mesh& mesh, std::string_view name, float defaultWeight, std::span<const uint32_t> vertices, std::span<const Math::float3> positions, std::span<const Math::float3> normals, std::span<const Math::float3> tangents)
+    {
+        HE_ASSERT(positions.size() == vertices.size() && (normals.empty() || normals.size() == vertices.size()) && (tangents.empty() || tangents.size() == vertices.size()));
+
+        if (mesh.morphTargetCount == 0)
+            mesh.morphTargetOffset = (uint32_t)meshSource.morphTargets.size();
+        HE_ASSERT(mesh.morphTargetOffset + mesh.morphTargetCount == meshSource.morphTargets.size());
+
+        MorphTarget& target = meshSource.morphTargets.emplace_back();
+        target.name = name;
+        target.defaultWeight = defaultWeight;
+        target.deltaOffset = (uint32_t)meshSource.morphDeltas.size();
+        target.positionScale = MaxAbsComponent(positions);
+        target.normalScale = MaxAbsComponent(normals);
+        target.tangentScale = MaxAbsComponent(tangents);
+        mesh.morphTargetCount++;
+
+        std::vector<uint32_t> order(vertices.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return vertices[a] < vertices[b]; });
+
+        for (uint32_t i : order)
+        {
+            HE_ASSERT(vertices[i] < mesh.vertexCount);
+
+            MorphDelta delta;
+            delta.vertex = vertices[i];
+            Quantize(positions[i], target.positionScale, delta.position);
+            if (!normals.empty())
+                Quantize(normals[i], target.normalScale, delta.normal);
+            if (!tangents.empty())
+                Quantize(tangents[i], target.tangentScale, delta.tangent);
+
+            bool zero = std::all_of(delta.position, delta.position + 3, [](int16_t v) { return v == 0; }) &&
+                std::all_of(delta.normal, delta.normal + 3, [](int8_t v) { return v == 0; }) &&
+                std::all_of(delta.tangent, delta.tangent + 3, [](int8_t v) { return v == 0; });
+
+            if (!zero)
+                meshSource.morphDeltas.push_back(delta);
+        }
+
+        target.deltaCount = uint32_t(meshSource.morphDeltas.size() - target.deltaOffset);
+    }
+
+#pragma endregion
+
+#pragma region Blend
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+
+    static inline __m128 LoadFloat3(const Math::float3* p)
+    {
+        const float* f = &p->x;
+        return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd((const double*)f)), _mm_load_ss(f + 2));
+    }
+
+    static inline void StoreFloat3(Math::float3* p, __m128 v)
+    {
+        float* f = &p->x;
+        _mm_store_sd((double*)f, _mm_castps_pd(v));
+        _mm_store_ss(f + 2, _mm_movehl_ps(v, v));
+    }
+
+    // one delta per iteration, the 16 byte delta is loaded once and its three attributes are sign extended in registers
+    static void BlendTarget(const MorphDelta* deltas, uint32_t count, const float scale[3], Math::float3* positions, Math::float3* normals, Math::float3* tangents)
+    {
+        // the 4th lane picks up the neighbouring field, a zero scale drops it
+        const __m128 positionScale = _mm_setr_ps(scale[0], scale[0], scale[0], 0.0f);
+        const __m128 normalScale = _mm_setr_ps(scale[1], scale[1], scale[1], 0.0f);
+        const __m128 tangentScale = _mm_setr_ps(scale[2], scale[2], scale[2], 0.0f);
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const uint32_t vertex = deltas[i].vertex;
+            const __m128i bytes = _mm_loadu_si128((const __m128i*)(deltas + i));
+
+            if (positions)
+            {
+                __m128i p = _mm_srli_si128(bytes, 4);
+                p = _mm_srai_epi32(_mm_unpacklo_epi16(p, p), 16);
+                __m128 v = _mm_add_ps(LoadFloat3(positions + vertex), _mm_mul_ps(_mm_cvtepi32_ps(p), positionScale));
+                StoreFloat3(positions + vertex, v);
+            }
+
+            if (normals)
+            {
+                __m128i n = _mm_srli_si128(bytes, 10);
+                n = _mm_unpacklo_epi8(n, n);
+                n = _mm_srai_epi32(_mm_unpacklo_epi16(n, n), 24);
+                __m128 v = _mm_add_ps(LoadFloat3(normals + vertex), _mm_mul_ps(_mm_cvtepi32_ps(n), normalScale));
+                StoreFloat3(normals + vertex, v);
+            }
+
+            if (tangents)
+            {
+                __m128i t = _mm_srli_si128(bytes, 13);
+                t = _mm_unpacklo_epi8(t, t);
+                t = _mm_srai_epi32(_mm_unpacklo_epi16(t, t), 24);
+                __m128 v = _mm_add_ps(LoadFloat3(tangents + vertex), _mm_mul_ps(_mm_cvtepi32_ps(t), tangentScale));
+                StoreFloat3(tangents + vertex, v);
+            }
+        }
+    }
+
+#else
+
+    static void BlendTarget(const MorphDelta* deltas, uint32_t count, const float scale[3], Math::float3* positions, Math::float3* normals, Math::float3* tangents)
+    {
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const MorphDelta& d = deltas[i];
+            if (positions)
+                positions[d.vertex] += Math::float3(d.position[0], d.position[1], d.position[2]) * scale[0];
+            if (normals)
+                normals[d.vertex] += Math::float3(d.normal[0], d.normal[1], d.normal[2]) * scale[1];
+            if (tangents)
+                tangents[d.vertex] += Math::float3(d.tangent[0], d.tangent[1], d.tangent[2]) * scale[2];
+        }
+    }
+
+#endif
+
+    void BlendMorphTargets(const MeshSource& meshSource, const Mesh& mesh, std::span<const float> weights, std::span<Math::float3> positions, std::span<Math::float3> normals, std::span<Math::float3> tangents)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE_ASSERT((positions.empty() || positions.size() >= mesh.vertexCount) && (normals.empty() || normals.size() >= mesh.vertexCount) && (tangents.empty() || tangents.size() >= mesh.vertexCount));
+
+        auto targets = mesh.GetMorphTargetSpan(meshSource);
+        const size_t count = std::min(targets.size(), weights.size());
+
+        for (size_t t = 0; t < count; t++)
+        {
+            const MorphTarget& target = targets[t];
+            const float w = weights[t];
+            if (w == 0.0f || target.deltaCount == 0)
+                continue;
+
+            const float scale[3] = {
+                w * target.positionScale / 32767.0f,
+                w * target.normalScale / 127.0f,
+                w * target.tangentScale / 127.0f,
+            };
+
+            const MorphDelta* deltas = meshSource.morphDeltas.data() + target.deltaOffset;
+            Math::float3* p = positions.empty() ? nullptr : positions.data();
+            Math::float3* n = normals.empty() ? nullptr : normals.data();
+            Math::float3* tg = tangents.empty() ? nullptr : tangents.data();
+
+            BlendTarget(deltas, target.deltaCount, scale, p, n, tg);
+        }
+    }
+
+#pragma endregion
+}
@@ -12,6 +12,94 @@ namespace Assets {
     {
     }
 
+    // LDR images get a full mip chain, block compressed when the settings ask for it
+    static void BuildMipChain(AssetManager* assetManager, HE::Image& image, MipChain& chain)
+    {
+        const auto& settings = assetManager->desc.textureImportSettings;
+        GenerateMips(image.GetData(), image.GetWidth(), image.GetHeight(), { .filter = settings.mipFilter }, chain);
+
+        MipChain compressed;
+        if (settings.blockCompression && CompressMipChain(chain, ChooseTextureCompression(chain, TextureUsage::Color, settings.preferBC7), compressed))
+            chain = std::move(compressed);
+    }
+
+    // HDR images keep a single level in the compact format of the settings
+    static nvrhi::Format ConvertHDR(AssetManager* assetManager, HE::Image& image, std::vector<uint8_t>& data, size_t& rowPitch)
+    {
+        HDRTextureFormat format = assetManager->desc.textureImportSettings.hdrFormat;
+        const float* rgb = (const float*)image.GetData();
+        if (!ConvertHDRImage(rgb, image.GetWidth(), image.GetHeight(), format, data, rowPitch))
+        {
+            format = HDRTextureFormat::RGBA16Float;
+            ConvertHDRImage(rgb, image.GetWidth(), image.GetHeight(), format, data, rowPitch);
+        }
+
+        return GetHDRTextureFormat(format);
+    }
+
+    // DDS and KTX2 levels and slices are uploaded as stored, block compressed data is never decoded.
+    // Streamed textures only get their mip tail here, see TextureStreamer.
+    static void UploadTextureFile(AssetManager* assetManager, Asset asset, HE::Ref<TextureFile> textureFile)
+    {
+        if (assetManager->desc.textureImportSettings.streaming)
+        {
+            assetManager->textureStreamer.Add(asset, textureFile);
+            return;
+        }
+
+        auto& desc = textureFile->desc;
+        desc.initialState = nvrhi::ResourceStates::ShaderResource;
+        desc.keepInitialState = true;
+
+        auto& texture = asset.Get<Texture>();
+        texture.texture = assetManager->device->createTexture(desc);
+
+        nvrhi::CommandListHandle commandList = assetManager->device->createCommandList({ .enableImmediateExecution = false });
+        commandList->open();
+        WriteTextureFile(commandList, texture.texture, *textureFile);
+        commandList->close();
+        assetManager->device->executeCommandList(commandList);
+        assetManager->device->runGarbageCollection();
+    }
+
+    // .dds and .ktx2 files as they are, other LDR images as their mip chain when streamed, null otherwise.
+    // Streamed sources must be file backed, chains and inflated KTX2 levels are cached as .dds next to the image.
+    static HE::Ref<TextureFile> LoadTextureSource(AssetManager* assetManager, const std::filesystem::path& path, bool& failed)
+    {
+        failed = false;
+        const bool streaming = assetManager->desc.textureImportSettings.streaming;
+        const bool isTextureFile = IsTextureFile(path.extension());
+        if (!isTextureFile && (!streaming || path.extension() == ".hdr"))
+            return nullptr;
+
+        auto cachePath = path;
+        cachePath += ".dds";
+        if (streaming && path.extension() != ".dds")
+        {
+            if (auto cached = LoadTextureCache(cachePath, path))
+            {
+                cached->desc.debugName = path.string();
+                return cached;
+            }
+        }
+
+        if (isTextureFile)
+        {
+            auto textureFile = HE::CreateRef<TextureFile>();
+            failed = !LoadTextureFile(path, *textureFile);
+            return failed || !streaming ? textureFile : CacheTextureFile(textureFile, cachePath);
+        }
+
+        MipChain chain;
+        HE::Image image(path);
+        BuildMipChain(assetManager, image, chain);
+
+        const nvrhi::Format format = GetTextureFormat(chain.compression, false);
+        auto textureFile = CreateTextureFile(std::move(chain), format);
+        textureFile->desc.debugName = path.string();
+        return CacheTextureFile(textureFile, cachePath);
+    }
+
     Asset TextureImporter::Import(AssetHandle handle, const std::filesystem::path& filePath)
     {
         auto path = (assetManager->desc.assetsDirectory / filePath).lexically_normal();
@@ -21,24 +109,53 @@ namespace Assets {
         auto& assetState = asset.Get<AssetState>();
         assetState = AssetState::Loading;
 
+        bool failed = false;
+        if (auto textureFile = LoadTextureSource(assetManager, path, failed))
+        {
+            if (failed)
+            {
+                HE_ERROR("TextureImporter : unable to load {}", path.string());
+                assetManager->DestroyAsset(asset);
+                return {};
+            }
+
+            UploadTextureFile(assetManager, asset, textureFile);
+
+            assetState = AssetState::Loaded;
+            assetManager->OnAssetLoaded(asset);
+
+            return asset;
+        }
+
         bool isHDR = filePath.extension() == ".hdr";
 
         HE::Image image(path);
+
+        MipChain chain;
+        std::vector<uint8_t> hdrData;
+        size_t hdrRowPitch = 0;
+        nvrhi::Format hdrFormat = nvrhi::Format::UNKNOWN;
+        if (isHDR)
+            hdrFormat = ConvertHDR(assetManager, image, hdrData, hdrRowPitch);
+        else
+            BuildMipChain(assetManager, image, chain);
+
         nvrhi::TextureDesc desc;
         desc.width = image.GetWidth();
         desc.height = image.GetHeight();
-        desc.format = isHDR ? nvrhi::Format::RGB32_FLOAT : nvrhi::Format::RGBA8_UNORM;
+        desc.mipLevels = isHDR ? 1 : chain.GetLevelCount();
+        desc.format = isHDR ? hdrFormat : GetTextureFormat(chain.compression, false);
         desc.debugName = path.string();
         desc.initialState = nvrhi::ResourceStates::ShaderResource;
         desc.keepInitialState = true;
         texture.texture = assetManager->device->createTexture(desc);
 
-        int bytesPerPixel = isHDR ? 3 * sizeof(float) : 4;
-        int rowPitch = desc.width * bytesPerPixel;
-
         nvrhi::CommandListHandle commandList = assetManager->device->createCommandList({ .enableImmediateExecution = false });
         commandList->open();
-        commandList->writeTexture(texture.texture, 0, 0, image.GetData(), rowPitch);
+        if (isHDR)
+            commandList->writeTexture(texture.texture, 0, 0, hdrData.data(), hdrRowPitch);
+        else
+            WriteMipChain(commandList, texture.texture, chain);
         commandList->close();
         assetManager->device->executeCommandList(commandList);
         assetManager->device->runGarbageCollection();
@@ -62,15 +179,53 @@ namespace Assets {
             Asset asset = assetManager->GetAsset(handle);
 
             auto path = (assetManager->desc.assetsDirectory / filePath).lexically_normal();
+
+            bool failed = false;
+            if (auto textureFile = LoadTextureSource(assetManager, path, failed))
+            {
+                if (failed)
+                {
+                    HE_ERROR("TextureImporter : unable to load {}", path.string());
+                    assetManager->DestroyAsset(asset);
+                    assetManager->asyncTaskCount--;
+                    return;
+                }
+
+                asset.Add<Texture>();
+                HE::Jops::SubmitToMainThread([this, handle, textureFile]() {
+
+                    Asset asset = assetManager->FindAsset(handle);
+                    auto& state = asset.Get<AssetState>();
+
+                    UploadTextureFile(assetManager, asset, textureFile);
+                    state = AssetState::Loaded;
+
+                    assetManager->OnAssetLoaded(asset);
+                    assetManager->asyncTaskCount--;
+                });
+
+                return;
+            }
+
             HE::Image image(path);
-            uint8_t* data = image.ExtractData();
 
             bool isHDR = filePath.extension() == ".hdr";
 
+            // the chain is built on the worker, the main thread only records the upload
+            auto chain = HE::CreateRef<MipChain>();
+            auto hdrData = HE::CreateRef<std::vector<uint8_t>>();
+            size_t hdrRowPitch = 0;
+            nvrhi::Format hdrFormat = nvrhi::Format::UNKNOWN;
+            if (isHDR)
+                hdrFormat = ConvertHDR(assetManager, image, *hdrData, hdrRowPitch);
+            else
+                BuildMipChain(assetManager, image, *chain);
+
             nvrhi::TextureDesc desc;
             desc.width = image.GetWidth();
             desc.height = image.GetHeight();
-            desc.format = isHDR ? nvrhi::Format::RGB32_FLOAT : nvrhi::Format::RGBA8_UNORM;
+            desc.mipLevels = isHDR ? 1 : chain->GetLevelCount();
+            desc.format = isHDR ? hdrFormat : GetTextureFormat(chain->compression, false);
             desc.debugName = filePath.string();
             desc.initialState = nvrhi::ResourceStates::ShaderResource;
             desc.keepInitialState = true;
@@ -78,7 +233,7 @@ namespace Assets {
             Texture& texture = asset.Add<Texture>();
             texture.texture = assetManager->device->createTexture(desc);
 
-            HE::Jops::SubmitToMainThread([this, handle, data, desc, isHDR]() {
+            HE::Jops::SubmitToMainThread([this, handle, hdrData, hdrRowPitch, chain, isHDR]() {
 
                 Asset asset = assetManager->FindAsset(handle);
                 auto& texture = asset.Get<Texture>();
@@ -86,17 +241,16 @@ namespace Assets {
 
                 nvrhi::CommandListHandle commandList = assetManager->device->createCommandList({ .enableImmediateExecution = false });
 
-                int bytesPerPixel = isHDR ? 3 * sizeof(float) : 4;
-                int rowPitch = desc.width * bytesPerPixel;
-
                 commandList->open();
-                commandList->writeTexture(texture.texture, 0, 0, data, rowPitch);
+                if (isHDR)
+                    commandList->writeTexture(texture.texture, 0, 0, hdrData->data(), hdrRowPitch);
+                else
+                    WriteMipChain(commandList, texture.texture, *chain);
                 commandList->close();
                 
                 assetManager->device->executeCommandList(commandList);
                 assetManager->device->runGarbageCollection();
 
-                std::free(data);
                 state = AssetState::Loaded;
                 
                 assetManager->OnAssetLoaded(asset);
@@ -0,0 +1,452 @@
+#include "HydraEngine/Base.h"
+
+import Assets;
+import HE;
+import nvrhi;
+import std;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+    // palette weights toward the second endpoint, in index order
+    constexpr float c_BC1Weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    constexpr uint8_t c_BC7Weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+#pragma region Endpoints
+
+    using BlockTexels = std::array<std::array<float, 4>, 16>;
+
+    // edge texels are repeated for levels smaller than a block
+    static void LoadBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, BlockTexels& texels)
+    {
+        for (uint32_t y = 0; y < 4; y++)
+        {
+            const uint8_t* row = rgba + size_t(std::min(by * 4 + y, height - 1)) * width * 4;
+            for (uint32_t x = 0; x < 4; x++)
+            {
+                const uint8_t* p = row + size_t(std::min(bx * 4 + x, width - 1)) * 4;
+                for (int c = 0; c < 4; c++)
+                    texels[y * 4 + x][c] = p[c];
+            }
+        }
+    }
+
+    // endpoints on the principal axis of the block, pulled in by inset of the extent
+    template<int C>
+    static void FitEndpoints(const BlockTexels& texels, float inset, float e0[4], float e1[4])
+    {
+        float mean[4] = {};
+        for (const auto& t : texels)
+            for (int c = 0; c < C; c++)
+                mean[c] += t[c] / 16.0f;
+
+        float cov[4][4] = {};
+        for (const auto& t : texels)
+            for (int a = 0; a < C; a++)
+                for (int b = 0; b < C; b++)
+                    cov[a][b] += (t[a] - mean[a]) * (t[b] - mean[b]);
+
+        float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        for (int i = 0; i < 8; i++)
+        {
+            float v[4] = {};
+            float m = 0.0f;
+            for (int a = 0; a < C; a++)
+            {
+                for (int b = 0; b < C; b++)
+                    v[a] += cov[a][b] * axis[b];
+                m = std::max(m, std::abs(v[a]));
+            }
+
+            if (m < 1e-6f)
+                break;
+
+            for (int a = 0; a < C; a++)
+                axis[a] = v[a] / m;
+        }
+
+        float length = 0.0f;
+        for (int c = 0; c < C; c++)
+            length += axis[c] * axis[c];
+        length = std::sqrt(length);
+
+        float tMin = std::numeric_limits<float>::max(), tMax = -std::numeric_limits<float>::max();
+        for (const auto& t : texels)
+        {
+            float d = 0.0f;
+            for (int c = 0; c < C; c++)
+                d += (t[c] - mean[c]) * axis[c] / length;
+            tMin = std::min(tMin, d);
+            tMax = std::max(tMax, d);
+        }
+
+        float pull = (tMax - tMin) * inset;
+        tMin += pull;
+        tMax -= pull;
+
+        for (int c = 0; c < C; c++)
+        {
+            e0[c] = std::clamp(mean[c] + axis[c] / length * tMax, 0.0f, 255.0f);
+            e1[c] = std::clamp(mean[c] + axis[c] / length * tMin, 0.0f, 255.0f);
+        }
+    }
+
+    // least squares endpoints for fixed indices, false when the indices do not span two endpoints
+    template<int C>
+    static bool RefineEndpoints(const BlockTexels& texels, const uint8_t indices[16], const float* weights, float e0[4], float e1[4])
+    {
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float ax[4] = {}, bx[4] = {};
+        for (int i = 0; i < 16; i++)
+        {
+            float b = weights[indices[i]];
+            float a = 1.0f - b;
+            aa += a * a; ab += a * b; bb += b * b;
+            for (int c = 0; c < C; c++)
+            {
+                ax[c] += a * texels[i][c];
+                bx[c] += b * texels[i][c];
+            }
+        }
+
+        float det = aa * bb - ab * ab;
+        if (std::abs(det) < 1e-6f)
+            return false;
+
+        for (int c = 0; c < C; c++)
+        {
+            e0[c] = std::clamp((ax[c] * bb - bx[c] * ab) / det, 0.0f, 255.0f);
+            e1[c] = std::clamp((bx[c] * aa - ax[c] * ab) / det, 0.0f, 255.0f);
+        }
+
+        return true;
+    }
+
+    // LSB first into a zeroed block
+    struct BlockWriter
+    {
+        uint8_t* out;
+        uint32_t bit = 0;
+
+        void Write(uint32_t value, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i++, bit++)
+                out[bit >> 3] |= uint8_t(((value >> i) & 1) << (bit & 7));
+        }
+    };
+
+#pragma endregion
+
+#pragma region BC1 BC4
+
+    static uint16_t PackRGB565(const float c[4])
+    {
+        auto q = [](float v, float max) { return uint16_t(std::clamp(std::round(v * max / 255.0f), 0.0f, max)); };
+        return uint16_t(q(c[0], 31.0f) << 11 | q(c[1], 63.0f) << 5 | q(c[2], 31.0f));
+    }
+
+    static void UnpackRGB565(uint16_t v, int out[3])
+    {
+        int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+        out[0] = (r << 3) | (r >> 2);
+        out[1] = (g << 2) | (g >> 4);
+        out[2] = (b << 3) | (b >> 2);
+    }
+
+    static float BC1Indices(const BlockTexels& texels, uint16_t c0, uint16_t c1, uint8_t indices[16])
+    {
+        int palette[4][3];
+        UnpackRGB565(c0, palette[0]);
+        UnpackRGB565(c1, palette[1]);
+        for (int c = 0; c < 3; c++)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+
+        float error = 0.0f;
+        for (int i = 0; i < 16; i++)
+        {
+            float best = std::numeric_limits<float>::max();
+            for (uint8_t k = 0; k < 4; k++)
+            {
+                float d = 0.0f;
+                for (int c = 0; c < 3; c++)
+                    d += (texels[i][c] - palette[k][c]) * (texels[i][c] - palette[k][c]);
+                if (d < best)
+                {
+                    best = d;
+                    indices[i] = k;
+                }
+            }
+            error += best;
+        }
+
+        return error;
+    }
+
+    // always the four color mode, BC3 color blocks ignore the endpoint order
+    static void EncodeBC1(const BlockTexels& texels, uint8_t* out)
+    {
+        float e0[4], e1[4];
+        FitEndpoints<3>(texels, 1.0f / 16.0f, e0, e1);
+
+        uint16_t c0 = PackRGB565(e0), c1 = PackRGB565(e1);
+        uint8_t indices[16];
+        float error = BC1Indices(texels, c0, c1, indices);
+
+        if (RefineEndpoints<3>(texels, indices, c_BC1Weights, e0, e1))
+        {
+            uint16_t r0 = PackRGB565(e0), r1 = PackRGB565(e1);
+            uint8_t refined[16];
+            float refinedError = BC1Indices(texels, r0, r1, refined);
+            if (refinedError < error)
+            {
+                c0 = r0; c1 = r1;
+                std::copy_n(refined, 16, indices);
+            }
+        }
+
+        if (c0 < c1)
+        {
+            std::swap(c0, c1);
+            for (auto& i : indices)
+                i ^= 1;
+        }
+        else if (c0 == c1)
+        {
+            std::fill_n(indices, 16, uint8_t(0));
+        }
+
+        std::memset(out, 0, 8);
+        BlockWriter writer{ out };
+        writer.Write(c0, 16);
+        writer.Write(c1, 16);
+        for (uint8_t i : indices)
+            writer.Write(i, 2);
+    }
+
+    // eight value mode between the block min and max
+    static void EncodeBC4(const BlockTexels& texels, int channel, uint8_t* out)
+    {
+        float min = 255.0f, max = 0.0f;
+        for (const auto& t : texels)
+        {
+            min = std::min(min, t[channel]);
+            max = std::max(max, t[channel]);
+        }
+
+        std::memset(out, 0, 8);
+        BlockWriter writer{ out };
+        writer.Write(uint32_t(max), 8);
+        writer.Write(uint32_t(min), 8);
+
+        for (const auto& t : texels)
+        {
+            uint32_t step = max > min ? uint32_t(std::round((max - t[channel]) * 7.0f / (max - min))) : 0;
+            writer.Write(step == 0 ? 0 : step == 7 ? 1 : step + 1, 3);
+        }
+    }
+
+#pragma endregion
+
+#pragma region BC7
+
+    // endpoints are 7 bits per channel and a p-bit shared by the channels of each endpoint
+    static void QuantizeBC7Endpoint(const float e[4], int q[4], int& p)
+    {
+        float bestError = std::numeric_limits<float>::max();
+        for (int bit = 0; bit < 2; bit++)
+        {
+            int candidate[4];
+            float error = 0.0f;
+            for (int c = 0; c < 4; c++)
+            {
+                candidate[c] = std::clamp(int(std::round((e[c] - bit) * 0.5f)), 0, 127);
+                float d = float((candidate[c] << 1) | bit) - e[c];
+                error += d * d;
+            }
+
+            if (error < bestError)
+            {
+                bestError = error;
+                p = bit;
+                std::copy_n(candidate, 4, q);
+            }
+        }
+    }
+
+    static float BC7Indices(const BlockTexels& texels, const int q0[4], int p0, const int q1[4], int p1, uint8_t indices[16])
+    {
+        int palette[16][4];
+        for (int k = 0; k < 16; k++)
+        {
+            for (int c = 0; c < 4; c++)
+            {
+                int a = (q0[c] << 1) | p0, b = (q1[c] << 1) | p1;
+                palette[k][c] = ((64 - c_BC7Weights[k]) * a + c_BC7Weights[k] * b + 32) >> 6;
+            }
+        }
+
+        float error = 0.0f;
+        for (int i = 0; i < 16; i++)
+        {
+            float best = std::numeric_limits<float>::max();
+            for (uint8_t k = 0; k < 16; k++)
+            {
+                float d = 0.0f;
+                for (int c = 0; c < 4; c++)
+                    d += (texels[i][c] - palette[k][c]) * (texels[i][c] - palette[k][c]);
+                if (d < best)
+                {
+                    best = d;
+                    indices[i] = k;
+                }
+            }
+            error += best;
+        }
+
+        return error;
+    }
+
+    // mode 6 only : one RGBA subset with 4 bit indices, no partition search
+    static void EncodeBC7(const BlockTexels& texels, uint8_t* out)
+    {
+        static const auto weights = [] {
+            std::array<float, 16> w;
+            for (int k = 0; k < 16; k++)
+                w[k] = c_BC7Weights[k] / 64.0f;
+            return w;
+        }();
+
+        float e0[4], e1[4];
+        FitEndpoints<4>(texels, 1.0f / 32.0f, e0, e1);
+
+        int q0[4], q1[4], p0, p1;
+        QuantizeBC7Endpoint(e0, q0, p0);
+        QuantizeBC7Endpoint(e1, q1, p1);
+
+        uint8_t indices[16];
+        float error = BC7Indices(texels, q0, p0, q1, p1, indices);
+
+        if (RefineEndpoints<4>(texels, indices, weights.data(), e0, e1))
+        {
+            int r0[4], r1[4], rp0, rp1;
+            QuantizeBC7Endpoint(e0, r0, rp0);
+            QuantizeBC7Endpoint(e1, r1, rp1);
+
+            uint8_t refined[16];
+            float refinedError = BC7Indices(texels, r0, rp0, r1, rp1, refined);
+            if (refinedError < error)
+            {
+                std::copy_n(r0, 4, q0); std::copy_n(r1, 4, q1);
+                p0 = rp0; p1 = rp1;
+                std::copy_n(refined, 16, indices);
+            }
+        }
+
+        // the top bit of the first index is implicit zero
+        if (indices[0] & 8)
+        {
+            std::swap(q0, q1);
+            std::swap(p0, p1);
+            for (auto& i : indices)
+                i = 15 - i;
+        }
+
+        std::memset(out, 0, 16);
+        BlockWriter writer{ out };
+        writer.Write(1 << 6, 7);
+        for (int c = 0; c < 4; c++)
+        {
+            writer.Write(q0[c], 7);
+            writer.Write(q1[c], 7);
+        }
+        writer.Write(p0, 1);
+        writer.Write(p1, 1);
+        for (int i = 0; i < 16; i++)
+            writer.Write(indices[i], i == 0 ? 3 : 4);
+    }
+
+#pragma endregion
+
+    TextureCompression ChooseTextureCompression(const MipChain& chain, TextureUsage usage, bool preferBC7)
+    {
+        if (usage == TextureUsage::Normal)
+            return TextureCompression::BC5;
+
+        if (usage == TextureUsage::Mask)
+            return TextureCompression::BC4;
+
+        if (preferBC7)
+            return TextureCompression::BC7;
+
+        const uint8_t* texels = chain.GetLevelData(0);
+        size_t count = size_t(chain.width) * chain.height;
+        bool opaque = true;
+        for (size_t i = 0; i < count && opaque; i++)
+            opaque = texels[i * 4 + 3] == 255;
+
+        return opaque ? TextureCompression::BC1 : TextureCompression::BC3;
+    }
+
+    bool CompressMipChain(const MipChain& source, TextureCompression compression, MipChain& result)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        if (compression == TextureCompression::None || source.compression != TextureCompression::None || source.GetLevelCount() == 0 || source.width % 4 || source.height % 4)
+            return false;
+
+        InitMipChain(result, source.width, source.height, source.GetLevelCount(), compression);
+
+        struct BlockRow { uint32_t level, row; };
+        std::vector<BlockRow> rows;
+        for (uint32_t level = 0; level < result.GetLevelCount(); level++)
+            for (uint32_t row = 0; row < result.GetLevelRowCount(level); row++)
+                rows.push_back({ level, row });
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), rows.size(), size_t(1), [&](size_t i) {
+
+            const uint32_t level = rows[i].level;
+            const uint32_t width = source.GetLevelWidth(level);
+            const uint32_t blocks = (width + 3) / 4;
+            const size_t pitch = result.GetLevelRowPitch(level);
+            const size_t blockSize = pitch / blocks;
+            uint8_t* out = result.data.data() + result.levelOffsets[level] + rows[i].row * pitch;
+
+            BlockTexels texels;
+            for (uint32_t bx = 0; bx < blocks; bx++, out += blockSize)
+            {
+                LoadBlock(source.GetLevelData(level), width, source.GetLevelHeight(level), bx, rows[i].row, texels);
+
+                switch (compression)
+                {
+                case TextureCompression::BC1: EncodeBC1(texels, out); break;
+                case TextureCompression::BC3: EncodeBC4(texels, 3, out); EncodeBC1(texels, out + 8); break;
+                case TextureCompression::BC4: EncodeBC4(texels, 0, out); break;
+                case TextureCompression::BC5: EncodeBC4(texels, 0, out); EncodeBC4(texels, 1, out + 8); break;
+                case TextureCompression::BC7: EncodeBC7(texels, out); break;
+                default: break;
+                }
+            }
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        return true;
+    }
+
+    nvrhi::Format GetTextureFormat(TextureCompression compression, bool isSRGB)
+    {
+        switch (compression)
+        {
+        case TextureCompression::BC1: return isSRGB ? nvrhi::Format::BC1_UNORM_SRGB : nvrhi::Format::BC1_UNORM;
+        case TextureCompression::BC3: return isSRGB ? nvrhi::Format::BC3_UNORM_SRGB : nvrhi::Format::BC3_UNORM;
+        case TextureCompression::BC4: return nvrhi::Format::BC4_UNORM;
+        case TextureCompression::BC5: return nvrhi::Format::BC5_UNORM;
+        case TextureCompression::BC7: return isSRGB ? nvrhi::Format::BC7_UNORM_SRGB : nvrhi::Format::BC7_UNORM;
+        default:                      return isSRGB ? nvrhi::Format::SRGBA8_UNORM : nvrhi::Format::RGBA8_UNORM;
+        }
+    }
+}
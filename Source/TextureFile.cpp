@@ -0,0 +1,572 @@
+#include "HydraEngine/Base.h"
+
+import Assets;
+import HE;
+import nvrhi;
+import std;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+    constexpr uint32_t FourCC(const char (&code)[5])
+    {
+        return uint32_t(uint8_t(code[0])) | uint32_t(uint8_t(code[1])) << 8 | uint32_t(uint8_t(code[2])) << 16 | uint32_t(uint8_t(code[3])) << 24;
+    }
+
+    constexpr uint8_t c_KTX2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+    constexpr size_t c_KTX2HeaderSize = 80;
+    constexpr size_t c_DDSHeaderSize = 128;  // magic and DDS_HEADER
+    constexpr size_t c_DDSHeaderDX10Size = 20;
+
+    static uint32_t ReadU32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+    static uint64_t ReadU64(const uint8_t* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+    static void WriteU32(uint8_t* p, uint32_t v) { std::memcpy(p, &v, 4); }
+
+#pragma region Formats
+
+    static nvrhi::Format FormatFromDxgi(uint32_t format)
+    {
+        switch (format)
+        {
+        case 2:  return nvrhi::Format::RGBA32_FLOAT;
+        case 6:  return nvrhi::Format::RGB32_FLOAT;
+        case 10: return nvrhi::Format::RGBA16_FLOAT;
+        case 11: return nvrhi::Format::RGBA16_UNORM;
+        case 16: return nvrhi::Format::RG32_FLOAT;
+        case 24: return nvrhi::Format::R10G10B10A2_UNORM;
+        case 26: return nvrhi::Format::R11G11B10_FLOAT;
+        case 28: return nvrhi::Format::RGBA8_UNORM;
+        case 29: return nvrhi::Format::SRGBA8_UNORM;
+        case 34: return nvrhi::Format::RG16_FLOAT;
+        case 35: return nvrhi::Format::RG16_UNORM;
+        case 41: return nvrhi::Format::R32_FLOAT;
+        case 49: return nvrhi::Format::RG8_UNORM;
+        case 54: return nvrhi::Format::R16_FLOAT;
+        case 56: return nvrhi::Format::R16_UNORM;
+        case 61: return nvrhi::Format::R8_UNORM;
+        case 71: return nvrhi::Format::BC1_UNORM;
+        case 72: return nvrhi::Format::BC1_UNORM_SRGB;
+        case 74: return nvrhi::Format::BC2_UNORM;
+        case 75: return nvrhi::Format::BC2_UNORM_SRGB;
+        case 77: return nvrhi::Format::BC3_UNORM;
+        case 78: return nvrhi::Format::BC3_UNORM_SRGB;
+        case 80: return nvrhi::Format::BC4_UNORM;
+        case 81: return nvrhi::Format::BC4_SNORM;
+        case 83: return nvrhi::Format::BC5_UNORM;
+        case 84: return nvrhi::Format::BC5_SNORM;
+        case 87: return nvrhi::Format::BGRA8_UNORM;
+        case 91: return nvrhi::Format::SBGRA8_UNORM;
+        case 95: return nvrhi::Format::BC6H_UFLOAT;
+        case 96: return nvrhi::Format::BC6H_SFLOAT;
+        case 98: return nvrhi::Format::BC7_UNORM;
+        case 99: return nvrhi::Format::BC7_UNORM_SRGB;
+        default: return nvrhi::Format::UNKNOWN;
+        }
+    }
+
+    static uint32_t DxgiFromFormat(nvrhi::Format format)
+    {
+        for (uint32_t dxgi = 1; dxgi <= 99; dxgi++)
+        {
+            if (FormatFromDxgi(dxgi) == format)
+                return dxgi;
+        }
+
+        return 0;
+    }
+
+    static nvrhi::Format FormatFromFourCC(uint32_t fourCC)
+    {
+        switch (fourCC)
+        {
+        case FourCC("DXT1"): return nvrhi::Format::BC1_UNORM;
+        case FourCC("DXT2"):
+        case FourCC("DXT3"): return nvrhi::Format::BC2_UNORM;
+        case FourCC("DXT4"):
+        case FourCC("DXT5"): return nvrhi::Format::BC3_UNORM;
+        case FourCC("ATI1"):
+        case FourCC("BC4U"): return nvrhi::Format::BC4_UNORM;
+        case FourCC("BC4S"): return nvrhi::Format::BC4_SNORM;
+        case FourCC("ATI2"):
+        case FourCC("BC5U"): return nvrhi::Format::BC5_UNORM;
+        case FourCC("BC5S"): return nvrhi::Format::BC5_SNORM;
+        case 36:             return nvrhi::Format::RGBA16_UNORM;
+        case 111:            return nvrhi::Format::R16_FLOAT;
+        case 112:            return nvrhi::Format::RG16_FLOAT;
+        case 113:            return nvrhi::Format::RGBA16_FLOAT;
+        case 114:            return nvrhi::Format::R32_FLOAT;
+        case 115:            return nvrhi::Format::RG32_FLOAT;
+        case 116:            return nvrhi::Format::RGBA32_FLOAT;
+        default:             return nvrhi::Format::UNKNOWN;
+        }
+    }
+
+    static nvrhi::Format FormatFromVulkan(uint32_t format)
+    {
+        switch (format)
+        {
+        case 9:   return nvrhi::Format::R8_UNORM;
+        case 16:  return nvrhi::Format::RG8_UNORM;
+        case 37:  return nvrhi::Format::RGBA8_UNORM;
+        case 43:  return nvrhi::Format::SRGBA8_UNORM;
+        case 44:  return nvrhi::Format::BGRA8_UNORM;
+        case 50:  return nvrhi::Format::SBGRA8_UNORM;
+        case 64:  return nvrhi::Format::R10G10B10A2_UNORM;
+        case 70:  return nvrhi::Format::R16_UNORM;
+        case 76:  return nvrhi::Format::R16_FLOAT;
+        case 77:  return nvrhi::Format::RG16_UNORM;
+        case 83:  return nvrhi::Format::RG16_FLOAT;
+        case 91:  return nvrhi::Format::RGBA16_UNORM;
+        case 97:  return nvrhi::Format::RGBA16_FLOAT;
+        case 100: return nvrhi::Format::R32_FLOAT;
+        case 103: return nvrhi::Format::RG32_FLOAT;
+        case 106: return nvrhi::Format::RGB32_FLOAT;
+        case 109: return nvrhi::Format::RGBA32_FLOAT;
+        case 122: return nvrhi::Format::R11G11B10_FLOAT;
+        case 131:
+        case 133: return nvrhi::Format::BC1_UNORM;
+        case 132:
+        case 134: return nvrhi::Format::BC1_UNORM_SRGB;
+        case 135: return nvrhi::Format::BC2_UNORM;
+        case 136: return nvrhi::Format::BC2_UNORM_SRGB;
+        case 137: return nvrhi::Format::BC3_UNORM;
+        case 138: return nvrhi::Format::BC3_UNORM_SRGB;
+        case 139: return nvrhi::Format::BC4_UNORM;
+        case 140: return nvrhi::Format::BC4_SNORM;
+        case 141: return nvrhi::Format::BC5_UNORM;
+        case 142: return nvrhi::Format::BC5_SNORM;
+        case 143: return nvrhi::Format::BC6H_UFLOAT;
+        case 144: return nvrhi::Format::BC6H_SFLOAT;
+        case 145: return nvrhi::Format::BC7_UNORM;
+        case 146: return nvrhi::Format::BC7_UNORM_SRGB;
+        default:  return nvrhi::Format::UNKNOWN;
+        }
+    }
+
+    // rows are whole blocks for compressed formats
+    static void GetImagePitches(nvrhi::Format format, uint32_t width, uint32_t height, size_t& rowPitch, size_t& depthPitch)
+    {
+        const auto& info = nvrhi::getFormatInfo(format);
+        rowPitch = size_t((width + info.blockSize - 1) / info.blockSize) * info.bytesPerBlock;
+        depthPitch = rowPitch * ((height + info.blockSize - 1) / info.blockSize);
+    }
+
+    static void SetTextureDimension(nvrhi::TextureDesc& desc, uint32_t layers, bool isCube)
+    {
+        if (desc.depth > 1)
+            desc.dimension = nvrhi::TextureDimension::Texture3D;
+        else if (isCube)
+            desc.dimension = layers > 1 ? nvrhi::TextureDimension::TextureCubeArray : nvrhi::TextureDimension::TextureCube;
+        else
+            desc.dimension = layers > 1 ? nvrhi::TextureDimension::Texture2DArray : nvrhi::TextureDimension::Texture2D;
+
+        desc.arraySize = layers * (isCube ? 6 : 1);
+    }
+
+#pragma endregion
+
+#pragma region DDS
+
+    // slices are stored one after the other, each with all its levels
+    static bool ParseDDS(const uint8_t* data, size_t size, TextureFile& textureFile)
+    {
+        if (size < c_DDSHeaderSize || ReadU32(data) != FourCC("DDS ") || ReadU32(data + 4) != 124)
+            return false;
+
+        const uint32_t height = ReadU32(data + 12);
+        const uint32_t width = ReadU32(data + 16);
+        const uint32_t depth = ReadU32(data + 24);
+        const uint32_t mipCount = std::max(ReadU32(data + 28), 1u);
+        const uint32_t pixelFlags = ReadU32(data + 80);
+        const uint32_t fourCC = ReadU32(data + 84);
+        const uint32_t bitCount = ReadU32(data + 88);
+        const uint32_t redMask = ReadU32(data + 92);
+        const uint32_t caps2 = ReadU32(data + 112);
+
+        nvrhi::Format format = nvrhi::Format::UNKNOWN;
+        uint32_t layers = 1;
+        bool isCube = caps2 & 0x200;
+        bool isVolume = (caps2 & 0x200000) && depth > 1;
+        size_t offset = c_DDSHeaderSize;
+
+        if ((pixelFlags & 0x4) && fourCC == FourCC("DX10"))
+        {
+            if (size < c_DDSHeaderSize + c_DDSHeaderDX10Size)
+                return false;
+
+            const uint8_t* dx10 = data + c_DDSHeaderSize;
+            format = FormatFromDxgi(ReadU32(dx10));
+            isVolume = ReadU32(dx10 + 4) == 4;
+            isCube = ReadU32(dx10 + 8) & 0x4;
+            layers = std::max(ReadU32(dx10 + 12), 1u);
+            offset += c_DDSHeaderDX10Size;
+        }
+        else if (pixelFlags & 0x4)
+        {
+            format = FormatFromFourCC(fourCC);
+        }
+        else if ((pixelFlags & 0x40) && bitCount == 32)
+        {
+            format = redMask == 0xFF ? nvrhi::Format::RGBA8_UNORM : redMask == 0xFF0000 ? nvrhi::Format::BGRA8_UNORM : nvrhi::Format::UNKNOWN;
+        }
+        else if ((pixelFlags & (0x40 | 0x20000)) && bitCount == 8)
+        {
+            format = nvrhi::Format::R8_UNORM;
+        }
+
+        if (format == nvrhi::Format::UNKNOWN || width == 0 || height == 0)
+        {
+            HE_ERROR("TextureFile : unsupported DDS pixel format");
+            return false;
+        }
+
+        auto& desc = textureFile.desc;
+        desc.width = width;
+        desc.height = height;
+        desc.depth = isVolume ? depth : 1;
+        desc.mipLevels = mipCount;
+        desc.format = format;
+        SetTextureDimension(desc, layers, isCube && !isVolume);
+
+        for (uint32_t slice = 0; slice < desc.arraySize; slice++)
+        {
+            for (uint32_t level = 0; level < mipCount; level++)
+            {
+                TextureSubresource& sub = textureFile.subresources.emplace_back();
+                sub.arraySlice = slice;
+                sub.mipLevel = level;
+                GetImagePitches(format, std::max(width >> level, 1u), std::max(height >> level, 1u), sub.rowPitch, sub.depthPitch);
+
+                const size_t levelSize = sub.depthPitch * std::max(desc.depth >> level, 1u);
+                if (offset + levelSize > size)
+                    return false;
+
+                sub.data = data + offset;
+                offset += levelSize;
+            }
+        }
+
+        return true;
+    }
+
+    // written as ParseDDS reads it back, every slice with all its levels
+    static bool WriteDDS(std::ofstream& stream, const TextureFile& textureFile)
+    {
+        const auto& desc = textureFile.desc;
+        const uint32_t dxgi = DxgiFromFormat(desc.format);
+        if (dxgi == 0)
+        {
+            HE_ERROR("TextureFile : no DXGI format for {}", nvrhi::getFormatInfo(desc.format).name);
+            return false;
+        }
+
+        const bool isCube = desc.dimension == nvrhi::TextureDimension::TextureCube || desc.dimension == nvrhi::TextureDimension::TextureCubeArray;
+        const bool isVolume = desc.dimension == nvrhi::TextureDimension::Texture3D;
+
+        std::vector<const TextureSubresource*> subresources(size_t(desc.arraySize) * desc.mipLevels, nullptr);
+        for (const auto& sub : textureFile.subresources)
+        {
+            if (sub.arraySlice < desc.arraySize && sub.mipLevel < desc.mipLevels)
+                subresources[size_t(sub.arraySlice) * desc.mipLevels + sub.mipLevel] = &sub;
+        }
+
+        if (std::find(subresources.begin(), subresources.end(), nullptr) != subresources.end())
+            return false;
+
+        uint8_t header[c_DDSHeaderSize + c_DDSHeaderDX10Size] = {};
+        WriteU32(header, FourCC("DDS "));
+        WriteU32(header + 4, 124);
+        WriteU32(header + 8, 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000 | (isVolume ? 0x800000 : 0));
+        WriteU32(header + 12, desc.height);
+        WriteU32(header + 16, desc.width);
+        WriteU32(header + 20, uint32_t(subresources[0]->depthPitch));
+        WriteU32(header + 24, isVolume ? desc.depth : 0);
+        WriteU32(header + 28, desc.mipLevels);
+        WriteU32(header + 76, 32);
+        WriteU32(header + 80, 0x4);
+        WriteU32(header + 84, FourCC("DX10"));
+        WriteU32(header + 108, 0x1000 | (desc.mipLevels > 1 ? 0x400008 : 0) | (isCube ? 0x8 : 0));
+        WriteU32(header + 112, (isCube ? 0xFE00 : 0) | (isVolume ? 0x200000 : 0));
+
+        uint8_t* dx10 = header + c_DDSHeaderSize;
+        WriteU32(dx10, dxgi);
+        WriteU32(dx10 + 4, isVolume ? 4 : 3);
+        WriteU32(dx10 + 8, isCube ? 0x4 : 0);
+        WriteU32(dx10 + 12, isCube ? desc.arraySize / 6 : desc.arraySize);
+        stream.write((const char*)header, sizeof(header));
+
+        for (const TextureSubresource* sub : subresources)
+        {
+            const size_t size = sub->depthPitch * (isVolume ? std::max(desc.depth >> sub->mipLevel, 1u) : 1);
+            stream.write((const char*)sub->data, size);
+        }
+
+        return bool(stream);
+    }
+
+#pragma endregion
+
+#pragma region KTX2
+
+    // BasisLZ (ETC1S) and UASTC payloads need the Basis Universal transcoder, which this plugin does not ship, UASTC is told by its DFD color model
+    static const char* GetKTX2BasisPayload(const uint8_t* data, size_t size, uint32_t vkFormat, uint32_t scheme)
+    {
+        constexpr uint8_t c_DFDModelUASTC = 166;
+
+        if (scheme == 1)
+            return "BasisLZ";
+
+        const uint32_t dfdOffset = ReadU32(data + 48);
+        if (vkFormat != 0 || dfdOffset > size || size - dfdOffset < 13)
+            return nullptr;
+
+        return data[dfdOffset + 12] == c_DFDModelUASTC ? "UASTC" : nullptr;
+    }
+
+    // levels are stored smallest first but indexed from level 0, each level holds its layers, faces and depth slices
+    static bool ParseKTX2(const uint8_t* data, size_t size, TextureFile& textureFile)
+    {
+        if (size < c_KTX2HeaderSize || std::memcmp(data, c_KTX2Identifier, sizeof(c_KTX2Identifier)) != 0)
+            return false;
+
+        const uint32_t vkFormat = ReadU32(data + 12);
+        const uint32_t width = ReadU32(data + 20);
+        const uint32_t height = std::max(ReadU32(data + 24), 1u);
+        const uint32_t depth = std::max(ReadU32(data + 28), 1u);
+        const uint32_t layers = std::max(ReadU32(data + 32), 1u);
+        const uint32_t faces = ReadU32(data + 36);
+        const uint32_t levelCount = std::max(ReadU32(data + 40), 1u);
+        const uint32_t scheme = ReadU32(data + 44);
+
+        if (const char* payload = GetKTX2BasisPayload(data, size, vkFormat, scheme))
+        {
+            HE_ERROR("TextureFile : KTX2 {} payloads need a Basis Universal transcoder and are not supported, re-export the texture with a BCn format", payload);
+            return false;
+        }
+
+        const nvrhi::Format format = FormatFromVulkan(vkFormat);
+        if (format == nvrhi::Format::UNKNOWN || scheme > 3)
+        {
+            HE_ERROR("TextureFile : unsupported KTX2 format {} with supercompression {}", vkFormat, scheme);
+            return false;
+        }
+
+        if (width == 0 || (faces != 1 && faces != 6) || c_KTX2HeaderSize + size_t(levelCount) * 24 > size)
+            return false;
+
+        auto& desc = textureFile.desc;
+        desc.width = width;
+        desc.height = height;
+        desc.depth = depth;
+        desc.mipLevels = levelCount;
+        desc.format = format;
+        SetTextureDimension(desc, layers, faces == 6);
+
+        // supercompressed levels are independent streams
+        std::vector<std::span<const uint8_t>> levels(levelCount);
+        std::atomic<bool> failed = false;
+        if (scheme != 0)
+            textureFile.storage.resize(levelCount);
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), size_t(levelCount), size_t(1), [&](size_t level) {
+
+            const uint8_t* index = data + c_KTX2HeaderSize + level * 24;
+            const uint64_t offset = ReadU64(index);
+            const uint64_t length = ReadU64(index + 8);
+            const uint64_t uncompressedLength = ReadU64(index + 16);
+            if (offset > size || length > size - offset)
+            {
+                failed = true;
+                return;
+            }
+
+            std::span<const uint8_t> bytes(data + offset, size_t(length));
+            if (scheme == 0)
+            {
+                levels[level] = bytes;
+                return;
+            }
+
+            auto& storage = textureFile.storage[level];
+            storage.reserve(size_t(std::min<uint64_t>(uncompressedLength, uint64_t(length) * 1024)));
+            bool decoded = scheme == 2 ? DecodeZstd(bytes, storage) : DecodeZlib(bytes, storage);
+            if (!decoded || storage.size() != uncompressedLength)
+            {
+                failed = true;
+                return;
+            }
+
+            levels[level] = storage;
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        if (failed)
+            return false;
+
+        for (uint32_t level = 0; level < levelCount; level++)
+        {
+            size_t rowPitch, depthPitch;
+            GetImagePitches(format, std::max(width >> level, 1u), std::max(height >> level, 1u), rowPitch, depthPitch);
+
+            const size_t imageSize = depthPitch * std::max(depth >> level, 1u);
+            if (imageSize * desc.arraySize > levels[level].size())
+                return false;
+
+            for (uint32_t slice = 0; slice < desc.arraySize; slice++)
+            {
+                TextureSubresource& sub = textureFile.subresources.emplace_back();
+                sub.arraySlice = slice;
+                sub.mipLevel = level;
+                sub.data = levels[level].data() + slice * imageSize;
+                sub.rowPitch = rowPitch;
+                sub.depthPitch = depthPitch;
+            }
+        }
+
+        return true;
+    }
+
+#pragma endregion
+
+    bool IsTextureFile(const std::filesystem::path& extension)
+    {
+        std::string extensionStr = extension.string();
+        std::transform(extensionStr.begin(), extensionStr.end(), extensionStr.begin(), [](uint8_t c) { return (char)std::tolower(c); });
+
+        return extensionStr == ".dds" || extensionStr == ".ktx2";
+    }
+
+    bool ParseTextureFile(const uint8_t* data, size_t size, TextureFile& textureFile)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        textureFile.subresources.clear();
+        textureFile.storage.clear();
+
+        if (size >= sizeof(c_KTX2Identifier) && std::memcmp(data, c_KTX2Identifier, sizeof(c_KTX2Identifier)) == 0)
+            return ParseKTX2(data, size, textureFile);
+
+        return ParseDDS(data, size, textureFile);
+    }
+
+    bool LoadTextureFile(const std::filesystem::path& filePath, TextureFile& textureFile)
+    {
+        textureFile.file = MappedFile::Open(filePath);
+        if (!textureFile.file)
+            return false;
+
+        textureFile.desc.debugName = filePath.string();
+        textureFile.path = filePath;
+        return ParseTextureFile(textureFile.file->data, textureFile.file->size, textureFile);
+    }
+
+    HE::Ref<TextureFile> CreateTextureFile(MipChain&& chain, nvrhi::Format format)
+    {
+        auto textureFile = HE::CreateRef<TextureFile>();
+        auto& desc = textureFile->desc;
+        desc.width = chain.width;
+        desc.height = chain.height;
+        desc.mipLevels = chain.GetLevelCount();
+        desc.format = format;
+
+        for (uint32_t level = 0; level < chain.GetLevelCount(); level++)
+        {
+            TextureSubresource& sub = textureFile->subresources.emplace_back();
+            sub.mipLevel = level;
+            sub.rowPitch = chain.GetLevelRowPitch(level);
+            sub.depthPitch = sub.rowPitch * chain.GetLevelRowCount(level);
+        }
+
+        // the vector buffer does not move with it
+        textureFile->storage.emplace_back(std::move(chain.data));
+        for (uint32_t level = 0; level < chain.GetLevelCount(); level++)
+            textureFile->subresources[level].data = textureFile->storage[0].data() + chain.levelOffsets[level];
+
+        return textureFile;
+    }
+
+    HE::Ref<TextureFile> ReferenceTextureFile(HE::Ref<MappedFile> file, std::span<const uint8_t> data, uint32_t width, uint32_t height, uint32_t mipLevels, nvrhi::Format format)
+    {
+        auto textureFile = HE::CreateRef<TextureFile>();
+        auto& desc = textureFile->desc;
+        desc.width = width;
+        desc.height = height;
+        desc.mipLevels = mipLevels;
+        desc.format = format;
+
+        size_t offset = 0;
+        for (uint32_t level = 0; level < mipLevels; level++)
+        {
+            TextureSubresource& sub = textureFile->subresources.emplace_back();
+            sub.mipLevel = level;
+            GetImagePitches(format, std::max(width >> level, 1u), std::max(height >> level, 1u), sub.rowPitch, sub.depthPitch);
+            sub.data = data.data() + offset;
+            offset += sub.depthPitch;
+        }
+
+        if (offset != data.size())
+            return nullptr;
+
+        textureFile->file = file;
+        return textureFile;
+    }
+
+    bool SaveTextureFile(const std::filesystem::path& filePath, const TextureFile& textureFile)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        // a reader of the old file never sees a partial one
+        auto tempPath = filePath;
+        tempPath += ".tmp";
+
+        std::ofstream stream(tempPath, std::ios::binary | std::ios::trunc);
+        bool written = stream && WriteDDS(stream, textureFile);
+        stream.close();
+
+        std::error_code ec;
+        if (written)
+            std::filesystem::rename(tempPath, filePath, ec);
+
+        if (!written || ec)
+        {
+            HE_ERROR("TextureFile : unable to save {}", filePath.string());
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        return true;
+    }
+
+    HE::Ref<TextureFile> CacheTextureFile(HE::Ref<TextureFile> textureFile, const std::filesystem::path& cachePath)
+    {
+        if (textureFile->IsFileBacked() || cachePath.empty() || !SaveTextureFile(cachePath, *textureFile))
+            return textureFile;
+
+        auto cached = HE::CreateRef<TextureFile>();
+        if (!LoadTextureFile(cachePath, *cached))
+            return textureFile;
+
+        cached->desc.debugName = textureFile->desc.debugName;
+        return cached;
+    }
+
+    HE::Ref<TextureFile> LoadTextureCache(const std::filesystem::path& cachePath, const std::filesystem::path& sourcePath)
+    {
+        std::error_code cacheError, sourceError;
+        auto cacheTime = std::filesystem::last_write_time(cachePath, cacheError);
+        auto sourceTime = std::filesystem::last_write_time(sourcePath, sourceError);
+        if (cacheError || sourceError || cacheTime < sourceTime)
+            return nullptr;
+
+        auto cached = HE::CreateRef<TextureFile>();
+        return LoadTextureFile(cachePath, *cached) ? cached : nullptr;
+    }
+
+    void WriteTextureFile(nvrhi::ICommandList* commandList, nvrhi::ITexture* texture, const TextureFile& textureFile)
+    {
+        for (const auto& sub : textureFile.subresources)
+            commandList->writeTexture(texture, sub.arraySlice, sub.mipLevel, sub.data, sub.rowPitch, sub.depthPitch);
+    }
+}
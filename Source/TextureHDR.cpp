@@ -0,0 +1,423 @@
+#include "HydraEngine/Base.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+import Assets;
+import HE;
+import nvrhi;
+import std;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+    constexpr float c_HalfMax = 65504.0f;
+    constexpr uint16_t c_HalfOne = 0x3c00;
+    constexpr uint8_t c_BC6HWeights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+#pragma region Half
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+
+    // FloatToHalf on four lanes, the magnitude is clamped to the largest half first so no texel turns into infinity
+    static __m128i FloatToHalf4(__m128 value)
+    {
+#if defined(__F16C__) || defined(__AVX2__)
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        __m128 clamped = _mm_or_ps(_mm_min_ps(_mm_andnot_ps(signMask, value), _mm_set1_ps(c_HalfMax)), _mm_and_ps(signMask, value));
+        return _mm_cvtepu16_epi32(_mm_cvtps_ph(clamped, _MM_FROUND_TO_NEAREST_INT));
+#else
+        const __m128i denormMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+
+        __m128i u = _mm_castps_si128(value);
+        __m128i sign = _mm_and_si128(u, _mm_set1_epi32(int(0x80000000u)));
+        u = _mm_castps_si128(_mm_min_ps(_mm_castsi128_ps(_mm_xor_si128(u, sign)), _mm_set1_ps(c_HalfMax)));
+
+        // subnormal or zero, let the FPU do the rounding
+        __m128i denorm = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(u), _mm_castsi128_ps(denormMagic))), denormMagic);
+
+        // round to nearest even
+        __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(u, 13), _mm_set1_epi32(1));
+        __m128i normal = _mm_add_epi32(_mm_add_epi32(u, _mm_set1_epi32(int((uint32_t(15 - 127) << 23) + 0xfff))), mantissaOdd);
+        normal = _mm_srli_epi32(normal, 13);
+
+        __m128i isDenorm = _mm_cmplt_epi32(u, _mm_set1_epi32(113 << 23));
+        __m128i result = _mm_or_si128(_mm_and_si128(isDenorm, denorm), _mm_andnot_si128(isDenorm, normal));
+        return _mm_or_si128(result, _mm_srli_epi32(sign, 16));
+#endif
+    }
+
+    // two RGB texels into two RGBA16 texels, the fourth float of the second load belongs to the next texel and becomes alpha
+    static void ConvertRowToRGBA16(const float* src, uint16_t* dst, uint32_t width)
+    {
+        const __m128 alphaMask = _mm_castsi128_ps(_mm_set_epi32(-1, 0, 0, 0));
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        uint32_t x = 0;
+        for (; x + 2 < width; x += 2)
+        {
+            __m128 a = _mm_or_ps(_mm_andnot_ps(alphaMask, _mm_loadu_ps(src + x * 3)), _mm_and_ps(alphaMask, one));
+            __m128 b = _mm_or_ps(_mm_andnot_ps(alphaMask, _mm_loadu_ps(src + x * 3 + 3)), _mm_and_ps(alphaMask, one));
+
+            // sign extend so the signed saturation of the pack keeps the bits
+            __m128i ha = _mm_srai_epi32(_mm_slli_epi32(FloatToHalf4(a), 16), 16);
+            __m128i hb = _mm_srai_epi32(_mm_slli_epi32(FloatToHalf4(b), 16), 16);
+            _mm_storeu_si128((__m128i*)(dst + x * 4), _mm_packs_epi32(ha, hb));
+        }
+
+        for (; x < width; x++)
+        {
+            for (int c = 0; c < 3; c++)
+                dst[x * 4 + c] = FloatToHalf(std::clamp(src[x * 3 + c], -c_HalfMax, c_HalfMax));
+            dst[x * 4 + 3] = c_HalfOne;
+        }
+    }
+
+#else
+
+    static void ConvertRowToRGBA16(const float* src, uint16_t* dst, uint32_t width)
+    {
+        for (uint32_t x = 0; x < width; x++)
+        {
+            for (int c = 0; c < 3; c++)
+                dst[x * 4 + c] = FloatToHalf(std::clamp(src[x * 3 + c], -c_HalfMax, c_HalfMax));
+            dst[x * 4 + 3] = c_HalfOne;
+        }
+    }
+
+#endif
+
+    // unsigned float with a 5 bit exponent and mantissaBits of mantissa, rounded to nearest even and clamped to the largest value
+    template<uint32_t MantissaBits>
+    static uint32_t FloatToSmallFloat(float value)
+    {
+        constexpr uint32_t shift = 23 - MantissaBits;
+        constexpr uint32_t maxValue = (30u << MantissaBits) | ((1u << MantissaBits) - 1);
+        constexpr uint32_t denormMagic = ((127u - 15u) + (23u - MantissaBits) + 1u) << 23;
+
+        uint32_t u = std::bit_cast<uint32_t>(value);
+        if (u & 0x80000000u || value != value)
+            return 0;
+
+        if (u >= (127u + 16u) << 23)
+            return maxValue;
+
+        if (u < (113u << 23))
+            return std::bit_cast<uint32_t>(std::bit_cast<float>(u) + std::bit_cast<float>(denormMagic)) - denormMagic;
+
+        uint32_t mantissaOdd = (u >> shift) & 1;
+        u += (uint32_t(15 - 127) << 23) + (1u << (shift - 1)) - 1;
+        u += mantissaOdd;
+        return std::min(u >> shift, maxValue);
+    }
+
+    static void ConvertRowToR11G11B10(const float* src, uint32_t* dst, uint32_t width)
+    {
+        for (uint32_t x = 0; x < width; x++)
+        {
+            const float* p = src + x * 3;
+            dst[x] = FloatToSmallFloat<6>(p[0]) | FloatToSmallFloat<6>(p[1]) << 11 | FloatToSmallFloat<5>(p[2]) << 22;
+        }
+    }
+
+#pragma endregion
+
+#pragma region BC6H
+
+    // Mode 11 only, one region with 10 bit endpoints and 4 bit indices. Endpoints are fitted on the half bit patterns,
+    // which the format interpolates in, so the error is close to relative.
+    using HalfBlock = std::array<std::array<float, 3>, 16>;
+
+    static int QuantizeBC6HEndpoint(float value)
+    {
+        // the unquantized endpoint e reads back as about 31 * e + 15.5
+        return std::clamp(int(std::lround((value - 15.5f) / 31.0f)), 0, 1023);
+    }
+
+    static int UnquantizeBC6HEndpoint(int value)
+    {
+        return value == 0 ? 0 : value == 1023 ? 0xffff : ((value << 16) + 0x8000) >> 10;
+    }
+
+    static float BC6HIndices(const HalfBlock& texels, const int q0[3], const int q1[3], uint8_t indices[16])
+    {
+        float palette[16][3];
+        for (int i = 0; i < 16; i++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                int value = (UnquantizeBC6HEndpoint(q0[c]) * (64 - c_BC6HWeights[i]) + UnquantizeBC6HEndpoint(q1[c]) * c_BC6HWeights[i] + 32) >> 6;
+                palette[i][c] = float((value * 31) >> 6);
+            }
+        }
+
+        // the palette lies close to a line, project onto it and only compare the neighbouring entries
+        float axis[3], axisLength = 0.0f;
+        for (int c = 0; c < 3; c++)
+        {
+            axis[c] = palette[15][c] - palette[0][c];
+            axisLength += axis[c] * axis[c];
+        }
+
+        float error = 0.0f;
+        for (int t = 0; t < 16; t++)
+        {
+            int guess = 0;
+            if (axisLength > 0.0f)
+            {
+                float d = 0.0f;
+                for (int c = 0; c < 3; c++)
+                    d += (texels[t][c] - palette[0][c]) * axis[c];
+
+                const float weight = std::clamp(d / axisLength, 0.0f, 1.0f) * 64.0f;
+                while (guess < 15 && c_BC6HWeights[guess + 1] <= weight)
+                    guess++;
+            }
+
+            float best = std::numeric_limits<float>::max();
+            for (int i = std::max(guess - 1, 0); i <= std::min(guess + 2, 15); i++)
+            {
+                float d = 0.0f;
+                for (int c = 0; c < 3; c++)
+                    d += (texels[t][c] - palette[i][c]) * (texels[t][c] - palette[i][c]);
+
+                if (d < best)
+                {
+                    best = d;
+                    indices[t] = uint8_t(i);
+                }
+            }
+
+            error += best;
+        }
+
+        return error;
+    }
+
+    static void FitBC6HEndpoints(const HalfBlock& texels, float e0[3], float e1[3])
+    {
+        float mean[3] = {};
+        for (const auto& t : texels)
+            for (int c = 0; c < 3; c++)
+                mean[c] += t[c] / 16.0f;
+
+        float cov[3][3] = {};
+        for (const auto& t : texels)
+            for (int a = 0; a < 3; a++)
+                for (int b = 0; b < 3; b++)
+                    cov[a][b] += (t[a] - mean[a]) * (t[b] - mean[b]);
+
+        float axis[3] = { 1.0f, 1.0f, 1.0f };
+        for (int i = 0; i < 8; i++)
+        {
+            float v[3] = {};
+            float m = 0.0f;
+            for (int a = 0; a < 3; a++)
+            {
+                for (int b = 0; b < 3; b++)
+                    v[a] += cov[a][b] * axis[b];
+                m = std::max(m, std::abs(v[a]));
+            }
+
+            if (m < 1e-6f)
+                break;
+
+            for (int a = 0; a < 3; a++)
+                axis[a] = v[a] / m;
+        }
+
+        const float length = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+        float tMin = std::numeric_limits<float>::max(), tMax = -std::numeric_limits<float>::max();
+        for (const auto& t : texels)
+        {
+            float d = 0.0f;
+            for (int c = 0; c < 3; c++)
+                d += (t[c] - mean[c]) * axis[c] / length;
+            tMin = std::min(tMin, d);
+            tMax = std::max(tMax, d);
+        }
+
+        for (int c = 0; c < 3; c++)
+        {
+            e0[c] = mean[c] + axis[c] / length * tMin;
+            e1[c] = mean[c] + axis[c] / length * tMax;
+        }
+    }
+
+    // least squares endpoints for fixed indices, false when the indices do not span two endpoints
+    static bool RefineBC6HEndpoints(const HalfBlock& texels, const uint8_t indices[16], float e0[3], float e1[3])
+    {
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float ax[3] = {}, bx[3] = {};
+        for (int i = 0; i < 16; i++)
+        {
+            float b = c_BC6HWeights[indices[i]] / 64.0f;
+            float a = 1.0f - b;
+            aa += a * a; ab += a * b; bb += b * b;
+            for (int c = 0; c < 3; c++)
+            {
+                ax[c] += a * texels[i][c];
+                bx[c] += b * texels[i][c];
+            }
+        }
+
+        float det = aa * bb - ab * ab;
+        if (std::abs(det) < 1e-6f)
+            return false;
+
+        for (int c = 0; c < 3; c++)
+        {
+            e0[c] = (ax[c] * bb - bx[c] * ab) / det;
+            e1[c] = (bx[c] * aa - ax[c] * ab) / det;
+        }
+
+        return true;
+    }
+
+    static void EncodeBC6H(const HalfBlock& texels, uint8_t* out)
+    {
+        float e0[3], e1[3];
+        FitBC6HEndpoints(texels, e0, e1);
+
+        int q0[3], q1[3];
+        for (int c = 0; c < 3; c++)
+        {
+            q0[c] = QuantizeBC6HEndpoint(e0[c]);
+            q1[c] = QuantizeBC6HEndpoint(e1[c]);
+        }
+
+        uint8_t indices[16];
+        float error = BC6HIndices(texels, q0, q1, indices);
+
+        for (int iteration = 0; iteration < 2 && error > 0.0f; iteration++)
+        {
+            if (!RefineBC6HEndpoints(texels, indices, e0, e1))
+                break;
+
+            int r0[3], r1[3];
+            for (int c = 0; c < 3; c++)
+            {
+                r0[c] = QuantizeBC6HEndpoint(e0[c]);
+                r1[c] = QuantizeBC6HEndpoint(e1[c]);
+            }
+
+            uint8_t refined[16];
+            float refinedError = BC6HIndices(texels, r0, r1, refined);
+            if (refinedError >= error)
+                break;
+
+            error = refinedError;
+            std::copy_n(r0, 3, q0);
+            std::copy_n(r1, 3, q1);
+            std::copy_n(refined, 16, indices);
+        }
+
+        // the anchor index drops its high bit
+        if (indices[0] & 8)
+        {
+            std::swap(q0, q1);
+            for (auto& index : indices)
+                index = uint8_t(15 - index);
+        }
+
+        std::memset(out, 0, 16);
+        uint32_t bit = 0;
+        auto write = [&](uint32_t value, uint32_t count) {
+            for (uint32_t i = 0; i < count; i++, bit++)
+                out[bit >> 3] |= uint8_t(((value >> i) & 1) << (bit & 7));
+        };
+
+        write(0x03, 5);
+        for (int c = 0; c < 3; c++)
+            write(q0[c], 10);
+        for (int c = 0; c < 3; c++)
+            write(q1[c], 10);
+
+        write(indices[0], 3);
+        for (int i = 1; i < 16; i++)
+            write(indices[i], 4);
+    }
+
+    // edge texels are repeated past the image, negative values clamp to zero
+    static void LoadHalfBlock(const float* rgb, uint32_t width, uint32_t height, uint32_t bx, uint32_t by, HalfBlock& texels)
+    {
+        for (uint32_t y = 0; y < 4; y++)
+        {
+            const float* row = rgb + size_t(std::min(by * 4 + y, height - 1)) * width * 3;
+            for (uint32_t x = 0; x < 4; x++)
+            {
+                const float* p = row + size_t(std::min(bx * 4 + x, width - 1)) * 3;
+                for (int c = 0; c < 3; c++)
+                    texels[y * 4 + x][c] = float(FloatToHalf(std::clamp(p[c], 0.0f, c_HalfMax)));
+            }
+        }
+    }
+
+#pragma endregion
+
+    nvrhi::Format GetHDRTextureFormat(HDRTextureFormat format)
+    {
+        switch (format)
+        {
+        case HDRTextureFormat::RGBA16Float:    return nvrhi::Format::RGBA16_FLOAT;
+        case HDRTextureFormat::R11G11B10Float: return nvrhi::Format::R11G11B10_FLOAT;
+        case HDRTextureFormat::BC6H:           return nvrhi::Format::BC6H_UFLOAT;
+        default:                               return nvrhi::Format::RGB32_FLOAT;
+        }
+    }
+
+    bool ConvertHDRImage(const float* rgb, uint32_t width, uint32_t height, HDRTextureFormat format, std::vector<uint8_t>& output, size_t& rowPitch)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        if (width == 0 || height == 0 || (format == HDRTextureFormat::BC6H && (width % 4 || height % 4)))
+            return false;
+
+        // rows of texels, block rows for BC6H
+        uint32_t rowCount = height;
+        switch (format)
+        {
+        case HDRTextureFormat::RGBA16Float:    rowPitch = size_t(width) * 8; break;
+        case HDRTextureFormat::R11G11B10Float: rowPitch = size_t(width) * 4; break;
+        case HDRTextureFormat::BC6H:           rowPitch = size_t(width / 4) * 16; rowCount = height / 4; break;
+        default:                               rowPitch = size_t(width) * 12; break;
+        }
+
+        output.resize(rowPitch * rowCount);
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), size_t(rowCount), size_t(1), [&](size_t row) {
+
+            const float* src = rgb + row * width * 3;
+            uint8_t* dst = output.data() + row * rowPitch;
+
+            switch (format)
+            {
+            case HDRTextureFormat::RGBA16Float:
+                ConvertRowToRGBA16(src, (uint16_t*)dst, width);
+                break;
+            case HDRTextureFormat::R11G11B10Float:
+                ConvertRowToR11G11B10(src, (uint32_t*)dst, width);
+                break;
+            case HDRTextureFormat::BC6H:
+            {
+                HalfBlock texels;
+                for (uint32_t bx = 0; bx < width / 4; bx++)
+                {
+                    LoadHalfBlock(rgb, width, height, bx, uint32_t(row), texels);
+                    EncodeBC6H(texels, dst + bx * 16);
+                }
+                break;
+            }
+            default:
+                std::memcpy(dst, src, rowPitch);
+                break;
+            }
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        return true;
+    }
+}
@@ -0,0 +1,407 @@
+#include "HydraEngine/Base.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+import Assets;
+import HE;
+import nvrhi;
+import Math;
+import std;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+    constexpr uint32_t c_MipTileRows = 32;
+    constexpr float c_KaiserWidth = 1.5f;   // half width in destination texels
+    constexpr float c_KaiserAlpha = 4.0f;
+
+#pragma region Conversion
+
+    struct MipTables
+    {
+        std::array<float, 256> srgbToLinear;
+        std::array<uint8_t, 4097> linearToSrgb; // linear quantized to 12 bits, within half a step of 8 bit sRGB
+
+        MipTables()
+        {
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                float c = float(i) / 255.0f;
+                srgbToLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+
+            for (uint32_t i = 0; i < 4097; i++)
+            {
+                float l = float(i) / 4096.0f;
+                float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                linearToSrgb[i] = uint8_t(std::clamp(c * 255.0f + 0.5f, 0.0f, 255.0f));
+            }
+        }
+    };
+
+    static const MipTables& GetMipTables()
+    {
+        static const MipTables tables;
+        return tables;
+    }
+
+    static void DecodeRow(const uint8_t* src, uint32_t width, const MipGenerationDesc& desc, Math::float4* dst)
+    {
+        const auto& tables = GetMipTables();
+
+        for (uint32_t x = 0; x < width; x++)
+        {
+            const uint8_t* p = src + size_t(x) * 4;
+            Math::float4& d = dst[x];
+
+            if (desc.isNormalMap)
+                d = Math::float4(p[0] / 127.5f - 1.0f, p[1] / 127.5f - 1.0f, p[2] / 127.5f - 1.0f, 0.0f);
+            else if (desc.isSRGB)
+                d = Math::float4(tables.srgbToLinear[p[0]], tables.srgbToLinear[p[1]], tables.srgbToLinear[p[2]], 0.0f);
+            else
+                d = Math::float4(p[0] / 255.0f, p[1] / 255.0f, p[2] / 255.0f, 0.0f);
+
+            d.w = p[3] / 255.0f;
+        }
+    }
+
+    static void EncodeRow(const Math::float4* src, uint32_t width, const MipGenerationDesc& desc, uint8_t* dst)
+    {
+        const auto& tables = GetMipTables();
+        auto unorm = [](float v) { return uint8_t(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f); };
+
+        for (uint32_t x = 0; x < width; x++)
+        {
+            const Math::float4& s = src[x];
+            uint8_t* p = dst + size_t(x) * 4;
+
+            for (int c = 0; c < 3; c++)
+            {
+                if (desc.isNormalMap)
+                    p[c] = unorm(s[c] * 0.5f + 0.5f);
+                else if (desc.isSRGB)
+                    p[c] = tables.linearToSrgb[uint32_t(std::clamp(s[c], 0.0f, 1.0f) * 4096.0f + 0.5f)];
+                else
+                    p[c] = unorm(s[c]);
+            }
+
+            p[3] = unorm(s.w);
+        }
+    }
+
+    // filtered texels leave the unit range through the negative lobes of the Kaiser filter, normals are renormalized
+    static void ResolveRow(Math::float4* row, uint32_t width, const MipGenerationDesc& desc)
+    {
+        for (uint32_t x = 0; x < width; x++)
+        {
+            Math::float4& p = row[x];
+            if (desc.isNormalMap)
+            {
+                Math::float3 n(p);
+                float length = Math::length(n);
+                n = length > 1e-6f ? n / length : Math::float3(0.0f, 0.0f, 1.0f);
+                p = Math::float4(n, std::clamp(p.w, 0.0f, 1.0f));
+            }
+            else
+            {
+                p = Math::clamp(p, Math::float4(0.0f), Math::float4(1.0f));
+            }
+        }
+    }
+
+#pragma endregion
+
+#pragma region Filters
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+
+    using Vec = __m128;
+    static inline Vec Zero() { return _mm_setzero_ps(); }
+    static inline Vec Load(const Math::float4& p) { return _mm_loadu_ps(&p.x); }
+    static inline void Store(Math::float4& p, Vec v) { _mm_storeu_ps(&p.x, v); }
+    static inline Vec Add(Vec a, Vec b) { return _mm_add_ps(a, b); }
+    static inline Vec MulAdd(Vec acc, Vec a, float w) { return _mm_add_ps(acc, _mm_mul_ps(a, _mm_set1_ps(w))); }
+    static inline Vec Scale(Vec a, float s) { return _mm_mul_ps(a, _mm_set1_ps(s)); }
+
+#else
+
+    using Vec = Math::float4;
+    static inline Vec Zero() { return Math::float4(0.0f); }
+    static inline Vec Load(const Math::float4& p) { return p; }
+    static inline void Store(Math::float4& p, Vec v) { p = v; }
+    static inline Vec Add(Vec a, Vec b) { return a + b; }
+    static inline Vec MulAdd(Vec acc, Vec a, float w) { return acc + a * w; }
+    static inline Vec Scale(Vec a, float s) { return a * s; }
+
+#endif
+
+    // Rows of the level being filtered, level 0 is decoded into scratch rows on demand
+    struct MipSource
+    {
+        const uint8_t* encoded = nullptr;
+        const Math::float4* linear = nullptr;
+        uint32_t width = 0;
+        uint32_t height = 0;
+
+        const Math::float4* Row(uint32_t y, const MipGenerationDesc& desc, Math::float4* scratch) const
+        {
+            if (linear)
+                return linear + size_t(y) * width;
+
+            DecodeRow(encoded + size_t(y) * width * 4, width, desc, scratch);
+            return scratch;
+        }
+    };
+
+    static void BoxFilterRows(const MipSource& src, uint32_t y0, uint32_t y1, uint32_t dstWidth, const MipGenerationDesc& desc, Math::float4* dst)
+    {
+        std::vector<Math::float4> scratch(src.encoded ? size_t(src.width) * 2 : 0);
+
+        for (uint32_t y = y0; y < y1; y++)
+        {
+            const Math::float4* r0 = src.Row(std::min(y * 2, src.height - 1), desc, scratch.data());
+            const Math::float4* r1 = src.Row(std::min(y * 2 + 1, src.height - 1), desc, scratch.data() + (src.encoded ? src.width : 0));
+            Math::float4* out = dst + size_t(y) * dstWidth;
+
+            for (uint32_t x = 0; x < dstWidth; x++)
+            {
+                uint32_t x0 = std::min(x * 2, src.width - 1);
+                uint32_t x1 = std::min(x * 2 + 1, src.width - 1);
+                Vec sum = Add(Add(Load(r0[x0]), Load(r0[x1])), Add(Load(r1[x0]), Load(r1[x1])));
+                Store(out[x], Scale(sum, 0.25f));
+            }
+
+            ResolveRow(out, dstWidth, desc);
+        }
+    }
+
+    static float BesselI0(float x)
+    {
+        float sum = 1.0f, term = 1.0f;
+        for (int k = 1; k < 16; k++)
+        {
+            term *= (x * 0.5f / float(k)) * (x * 0.5f / float(k));
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    // Windowed sinc taps of one axis, clamped to the edge
+    struct KaiserTaps
+    {
+        uint32_t count = 0;
+        std::vector<int32_t> first;
+        std::vector<float> weights;
+
+        KaiserTaps(uint32_t srcSize, uint32_t dstSize)
+        {
+            const float scale = float(srcSize) / float(dstSize);
+            count = uint32_t(std::ceil(2.0f * c_KaiserWidth * scale)) + 1;
+            first.resize(dstSize);
+            weights.resize(size_t(dstSize) * count);
+
+            for (uint32_t i = 0; i < dstSize; i++)
+            {
+                float center = (float(i) + 0.5f) * scale - 0.5f;
+                first[i] = int32_t(std::floor(center - c_KaiserWidth * scale)) + 1;
+
+                float sum = 0.0f;
+                float* w = weights.data() + size_t(i) * count;
+                for (uint32_t t = 0; t < count; t++)
+                {
+                    float d = (float(first[i] + int32_t(t)) - center) / scale;
+                    float r = d / (c_KaiserWidth + 0.5f / scale);
+                    float sinc = d == 0.0f ? 1.0f : std::sin(std::numbers::pi_v<float> * d) / (std::numbers::pi_v<float> * d);
+                    w[t] = std::abs(r) < 1.0f ? sinc * BesselI0(c_KaiserAlpha * std::sqrt(1.0f - r * r)) / BesselI0(c_KaiserAlpha) : 0.0f;
+                    sum += w[t];
+                }
+
+                for (uint32_t t = 0; t < count; t++)
+                    w[t] /= sum;
+            }
+        }
+
+        uint32_t Index(uint32_t i, uint32_t t, uint32_t size) const { return uint32_t(std::clamp(first[i] + int32_t(t), 0, int32_t(size) - 1)); }
+        const float* Weights(uint32_t i) const { return weights.data() + size_t(i) * count; }
+    };
+
+    // separable, the source rows of the tile are filtered horizontally once then combined vertically
+    static void KaiserFilterRows(const MipSource& src, uint32_t y0, uint32_t y1, uint32_t dstWidth, const KaiserTaps& tapsX, const KaiserTaps& tapsY, const MipGenerationDesc& desc, Math::float4* dst)
+    {
+        const uint32_t rowFirst = tapsY.Index(y0, 0, src.height);
+        const uint32_t rowLast = tapsY.Index(y1 - 1, tapsY.count - 1, src.height);
+
+        std::vector<Math::float4> scratch(src.encoded ? src.width : 0);
+        std::vector<Math::float4> rows(size_t(rowLast - rowFirst + 1) * dstWidth);
+
+        for (uint32_t sy = rowFirst; sy <= rowLast; sy++)
+        {
+            const Math::float4* in = src.Row(sy, desc, scratch.data());
+            Math::float4* out = rows.data() + size_t(sy - rowFirst) * dstWidth;
+
+            for (uint32_t x = 0; x < dstWidth; x++)
+            {
+                const float* w = tapsX.Weights(x);
+                Vec sum = Zero();
+                for (uint32_t t = 0; t < tapsX.count; t++)
+                    sum = MulAdd(sum, Load(in[tapsX.Index(x, t, src.width)]), w[t]);
+                Store(out[x], sum);
+            }
+        }
+
+        for (uint32_t y = y0; y < y1; y++)
+        {
+            const float* w = tapsY.Weights(y);
+            Math::float4* out = dst + size_t(y) * dstWidth;
+
+            for (uint32_t x = 0; x < dstWidth; x++)
+            {
+                Vec sum = Zero();
+                for (uint32_t t = 0; t < tapsY.count; t++)
+                    sum = MulAdd(sum, Load(rows[size_t(tapsY.Index(y, t, src.height) - rowFirst) * dstWidth + x]), w[t]);
+                Store(out[x], sum);
+            }
+
+            ResolveRow(out, dstWidth, desc);
+        }
+    }
+
+#pragma endregion
+
+#pragma region Alpha Coverage
+
+    static float AlphaCoverage(const uint8_t* rgba, size_t texelCount, float cutoff, float scale)
+    {
+        size_t covered = 0;
+        for (size_t i = 0; i < texelCount; i++)
+            covered += std::min(rgba[i * 4 + 3] * scale, 255.0f) > cutoff * 255.0f;
+
+        return texelCount ? float(covered) / float(texelCount) : 0.0f;
+    }
+
+    // scales alpha so the share of texels passing the alpha test matches the top level
+    static void PreserveAlphaCoverage(uint8_t* rgba, size_t texelCount, float cutoff, float coverage)
+    {
+        // coverage is a step function of the scale on small levels, the closest probe wins
+        float low = 0.0f, high = 4.0f, scale = 1.0f;
+        float error = std::abs(AlphaCoverage(rgba, texelCount, cutoff, 1.0f) - coverage);
+        for (int i = 0; i < 12 && error > 0.001f; i++)
+        {
+            float mid = (low + high) * 0.5f;
+            float c = AlphaCoverage(rgba, texelCount, cutoff, mid);
+            if (std::abs(c - coverage) < error)
+            {
+                error = std::abs(c - coverage);
+                scale = mid;
+            }
+
+            (c < coverage ? low : high) = mid;
+        }
+
+        for (size_t i = 0; i < texelCount; i++)
+            rgba[i * 4 + 3] = uint8_t(std::min(rgba[i * 4 + 3] * scale + 0.5f, 255.0f));
+    }
+
+#pragma endregion
+
+    uint32_t GetMipLevelCount(uint32_t width, uint32_t height)
+    {
+        return std::bit_width(std::max({ width, height, 1u }));
+    }
+
+    void InitMipChain(MipChain& chain, uint32_t width, uint32_t height, uint32_t levelCount, TextureCompression compression)
+    {
+        chain.width = width;
+        chain.height = height;
+        chain.compression = compression;
+        chain.levelOffsets.resize(levelCount);
+
+        size_t size = 0;
+        for (uint32_t level = 0; level < levelCount; level++)
+        {
+            chain.levelOffsets[level] = size;
+            size += chain.GetLevelRowPitch(level) * chain.GetLevelRowCount(level);
+        }
+
+        chain.data.resize(size);
+    }
+
+    void GenerateMips(const uint8_t* rgba, uint32_t width, uint32_t height, const MipGenerationDesc& desc, MipChain& chain)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        const uint32_t levelCount = desc.filter == MipFilter::None ? 1 : GetMipLevelCount(width, height);
+
+        InitMipChain(chain, width, height, levelCount, TextureCompression::None);
+        std::memcpy(chain.data.data(), rgba, size_t(width) * height * 4);
+
+        // each level is filtered from the unquantized previous one, tiles of rows in parallel
+        std::vector<Math::float4> previous, current;
+        for (uint32_t level = 1; level < levelCount; level++)
+        {
+            MipSource src;
+            src.width = chain.GetLevelWidth(level - 1);
+            src.height = chain.GetLevelHeight(level - 1);
+            if (level == 1)
+                src.encoded = rgba;
+            else
+                src.linear = previous.data();
+
+            const uint32_t dstWidth = chain.GetLevelWidth(level);
+            const uint32_t dstHeight = chain.GetLevelHeight(level);
+            current.resize(size_t(dstWidth) * dstHeight);
+
+            std::optional<KaiserTaps> tapsX, tapsY;
+            if (desc.filter == MipFilter::Kaiser)
+            {
+                tapsX.emplace(src.width, dstWidth);
+                tapsY.emplace(src.height, dstHeight);
+            }
+
+            uint8_t* dst = chain.data.data() + chain.levelOffsets[level];
+            const uint32_t tileCount = (dstHeight + c_MipTileRows - 1) / c_MipTileRows;
+
+            HE::Jops::Taskflow tf;
+            tf.for_each_index(size_t(0), size_t(tileCount), size_t(1), [&](size_t tile) {
+
+                uint32_t y0 = uint32_t(tile) * c_MipTileRows;
+                uint32_t y1 = std::min(y0 + c_MipTileRows, dstHeight);
+
+                if (desc.filter == MipFilter::Kaiser)
+                    KaiserFilterRows(src, y0, y1, dstWidth, *tapsX, *tapsY, desc, current.data());
+                else
+                    BoxFilterRows(src, y0, y1, dstWidth, desc, current.data());
+
+                for (uint32_t y = y0; y < y1; y++)
+                    EncodeRow(current.data() + size_t(y) * dstWidth, dstWidth, desc, dst + size_t(y) * dstWidth * 4);
+            });
+            HE::Jops::RunTaskflow(tf).wait();
+
+            std::swap(previous, current);
+        }
+
+        // levels are independent once filtered
+        if (desc.alphaCutoff > 0.0f && levelCount > 1)
+        {
+            const float coverage = AlphaCoverage(rgba, size_t(width) * height, desc.alphaCutoff, 1.0f);
+
+            HE::Jops::Taskflow tf;
+            tf.for_each_index(size_t(1), size_t(levelCount), size_t(1), [&](size_t level) {
+                size_t texelCount = size_t(chain.GetLevelWidth(uint32_t(level))) * chain.GetLevelHeight(uint32_t(level));
+                PreserveAlphaCoverage(chain.data.data() + chain.levelOffsets[level], texelCount, desc.alphaCutoff, coverage);
+            });
+            HE::Jops::RunTaskflow(tf).wait();
+        }
+    }
+
+    void WriteMipChain(nvrhi::ICommandList* commandList, nvrhi::ITexture* texture, const MipChain& chain)
+    {
+        const uint32_t levelCount = std::min(chain.GetLevelCount(), texture->getDesc().mipLevels);
+        for (uint32_t level = 0; level < levelCount; level++)
+            commandList->writeTexture(texture, 0, level, chain.GetLevelData(level), chain.GetLevelRowPitch(level));
+    }
+}
@@ -0,0 +1,342 @@
+#include "HydraEngine/Base.h"
+
+import Assets;
+import HE;
+import nvrhi;
+import std;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+    static size_t GetSubresourceSize(const nvrhi::TextureDesc& desc, const TextureSubresource& sub)
+    {
+        return sub.depthPitch * (desc.dimension == nvrhi::TextureDimension::Texture3D ? std::max(desc.depth >> sub.mipLevel, 1u) : 1);
+    }
+
+    void TextureStreamingEntry::Init(HE::Ref<TextureFile> textureFile, uint32_t tailSize)
+    {
+        const auto& desc = textureFile->desc;
+
+        source = textureFile;
+        levelSizes.assign(desc.mipLevels, 0);
+        for (const auto& sub : source->subresources)
+            levelSizes[sub.mipLevel] += GetSubresourceSize(desc, sub);
+
+        // the first level that fits the tail size, moved finer until a block compressed texture can start there
+        tailMip = 0;
+        while (tailMip + 1 < desc.mipLevels && std::max(desc.width >> tailMip, desc.height >> tailMip) > tailSize)
+            tailMip++;
+        while (!IsValidFirstMip(tailMip))
+            tailMip--;
+
+        residentMip = desc.mipLevels;
+        targetMip = tailMip;
+        requestedMip = tailMip;
+    }
+
+    uint64_t TextureStreamingEntry::GetResidentSize(uint32_t firstMip) const
+    {
+        uint64_t size = 0;
+        for (uint32_t level = firstMip; level < (uint32_t)levelSizes.size(); level++)
+            size += levelSizes[level];
+
+        return size;
+    }
+
+    bool TextureStreamingEntry::IsValidFirstMip(uint32_t mip) const
+    {
+        const auto& desc = source->desc;
+        const uint32_t blockSize = nvrhi::getFormatInfo(desc.format).blockSize;
+
+        return mip == 0 || (std::max(desc.width >> mip, 1u) % blockSize == 0 && std::max(desc.height >> mip, 1u) % blockSize == 0);
+    }
+
+    // Reads levels [first, last) of a file backed source with one read on the worker, the subresources point into it
+    static HE::Ref<TextureFile> ReadLevels(const TextureFile& source, std::span<const uint64_t> fileOffsets, uint32_t first, uint32_t last)
+    {
+        uint64_t begin = std::numeric_limits<uint64_t>::max();
+        uint64_t end = 0;
+        for (size_t i = 0; i < source.subresources.size(); i++)
+        {
+            const auto& sub = source.subresources[i];
+            if (sub.mipLevel < first || sub.mipLevel >= last)
+                continue;
+
+            begin = std::min(begin, fileOffsets[i]);
+            end = std::max(end, fileOffsets[i] + GetSubresourceSize(source.desc, sub));
+        }
+
+        if (begin >= end)
+            return nullptr;
+
+        auto staged = HE::CreateRef<TextureFile>();
+        staged->desc = source.desc;
+        staged->file = MappedFile::Open(source.path, begin, end - begin, false);
+        if (!staged->file || staged->file->size != end - begin)
+            return nullptr;
+
+        for (size_t i = 0; i < source.subresources.size(); i++)
+        {
+            const auto& sub = source.subresources[i];
+            if (sub.mipLevel >= first && sub.mipLevel < last)
+                staged->subresources.push_back({ sub.arraySlice, sub.mipLevel, staged->file->data + (fileOffsets[i] - begin), sub.rowPitch, sub.depthPitch });
+        }
+
+        return staged;
+    }
+
+    // Levels resident in both textures are copied on the GPU, the new ones are written from the staged levels when given
+    static void SetResidentMip(AssetManager* assetManager, Asset asset, TextureStreamingEntry& entry, uint32_t mip, const TextureFile* staged = nullptr)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        auto& texture = asset.Get<Texture>();
+        const auto& sourceDesc = entry.source->desc;
+
+        nvrhi::TextureDesc desc = sourceDesc;
+        desc.width = std::max(sourceDesc.width >> mip, 1u);
+        desc.height = std::max(sourceDesc.height >> mip, 1u);
+        desc.depth = sourceDesc.dimension == nvrhi::TextureDimension::Texture3D ? std::max(sourceDesc.depth >> mip, 1u) : sourceDesc.depth;
+        desc.mipLevels = sourceDesc.mipLevels - mip;
+        desc.initialState = nvrhi::ResourceStates::ShaderResource;
+        desc.keepInitialState = true;
+        nvrhi::TextureHandle resized = assetManager->device->createTexture(desc);
+
+        const bool hasOld = texture.texture != nullptr;
+        auto commandList = assetManager->device->createCommandList({ .enableImmediateExecution = false });
+        commandList->open();
+
+        for (const auto& sub : entry.source->subresources)
+        {
+            if (sub.mipLevel < mip)
+                continue;
+
+            if (hasOld && sub.mipLevel >= entry.residentMip)
+            {
+                auto dst = nvrhi::TextureSlice().setMipLevel(sub.mipLevel - mip).setArraySlice(sub.arraySlice);
+                auto src = nvrhi::TextureSlice().setMipLevel(sub.mipLevel - entry.residentMip).setArraySlice(sub.arraySlice);
+                commandList->copyTexture(resized, dst, texture.texture, src);
+            }
+            else
+            {
+                // sources that are not file backed keep their data and need no staging
+                const TextureSubresource* write = &sub;
+                if (staged)
+                {
+                    auto it = std::find_if(staged->subresources.begin(), staged->subresources.end(), [&](const TextureSubresource& s) {
+                        return s.mipLevel == sub.mipLevel && s.arraySlice == sub.arraySlice;
+                    });
+                    write = it != staged->subresources.end() ? &*it : nullptr;
+                }
+
+                HE_ASSERT(write && write->data);
+                if (write && write->data)
+                    commandList->writeTexture(resized, sub.arraySlice, sub.mipLevel - mip, write->data, write->rowPitch, write->depthPitch);
+            }
+        }
+
+        commandList->close();
+        assetManager->device->executeCommandList(commandList);
+
+        auto& streamer = assetManager->textureStreamer;
+        streamer.residentSize -= hasOld ? entry.GetResidentSize(entry.residentMip) : 0;
+        streamer.residentSize += entry.GetResidentSize(mip);
+
+        texture.texture = resized;
+        entry.residentMip = mip;
+
+        if (hasOld)
+        {
+            for (auto& [id, subscriber] : assetManager->subscribers)
+                subscriber->OnAssetReloaded(asset);
+        }
+    }
+
+    void TextureStreamer::Add(Asset asset, HE::Ref<TextureFile> source)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        TextureStreamingEntry entry;
+        entry.Init(source, assetManager->desc.textureImportSettings.streamingTailSize);
+        SetResidentMip(assetManager, asset, entry, entry.tailMip);
+
+        // only the layout of a file backed source is kept, finer levels are read back from the file
+        if (source->IsFileBacked())
+        {
+            auto layout = HE::CreateRef<TextureFile>();
+            layout->desc = source->desc;
+            layout->path = source->path;
+            layout->subresources = source->subresources;
+
+            const MappedFile& file = *source->file;
+            for (auto& sub : layout->subresources)
+            {
+                entry.fileOffsets.push_back(file.offset + uint64_t(sub.data - file.data));
+                sub.data = nullptr;
+            }
+
+            entry.source = layout;
+        }
+
+        entries[asset.GetHandle()] = std::move(entry);
+    }
+
+    void TextureStreamer::Remove(AssetHandle handle)
+    {
+        auto it = entries.find(handle);
+        if (it == entries.end())
+            return;
+
+        residentSize -= it->second.GetResidentSize(it->second.residentMip);
+        entries.erase(it);
+    }
+
+    void TextureStreamer::RequestMip(AssetHandle handle, uint32_t mipLevel)
+    {
+        auto it = entries.find(handle);
+        if (it == entries.end())
+            return;
+
+        auto& entry = it->second;
+        entry.requestedMip = entry.lastRequestFrame == frameIndex ? std::min(entry.requestedMip, mipLevel) : mipLevel;
+        entry.lastRequestFrame = frameIndex;
+    }
+
+    uint64_t TextureStreamer::UpdateTargets()
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        const auto& settings = assetManager->desc.textureImportSettings;
+
+        // targets from the feedback, textures not sampled for a while fall back to their tail
+        uint64_t targetSize = 0;
+        for (auto& [handle, entry] : entries)
+        {
+            const bool isRequested = entry.lastRequestFrame + settings.streamingRetainFrames >= frameIndex;
+            uint32_t mip = isRequested ? std::min(entry.requestedMip, entry.tailMip) : entry.tailMip;
+            while (!entry.IsValidFirstMip(mip))
+                mip++;
+
+            entry.targetMip = mip;
+            targetSize += entry.GetResidentSize(mip);
+        }
+
+        // over budget the finest target level goes first, from textures without recent feedback before the others
+        if (settings.streamingBudget != 0 && targetSize > settings.streamingBudget)
+        {
+            using Candidate = std::tuple<bool, uint64_t, TextureStreamingEntry*>;
+            std::priority_queue<Candidate> candidates;
+            for (auto& [handle, entry] : entries)
+            {
+                if (entry.targetMip < entry.tailMip)
+                    candidates.emplace(entry.lastRequestFrame + settings.streamingRetainFrames < frameIndex, entry.levelSizes[entry.targetMip], &entry);
+            }
+
+            while (targetSize > settings.streamingBudget && !candidates.empty())
+            {
+                auto [isStale, size, entry] = candidates.top();
+                candidates.pop();
+
+                uint32_t mip = entry->targetMip + 1;
+                while (!entry->IsValidFirstMip(mip))
+                    mip++;
+
+                targetSize -= entry->GetResidentSize(entry->targetMip) - entry->GetResidentSize(mip);
+                entry->targetMip = mip;
+
+                if (mip < entry->tailMip)
+                    candidates.emplace(isStale, entry->levelSizes[mip], entry);
+            }
+        }
+
+        return targetSize;
+    }
+
+    void TextureStreamer::Update()
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        const auto& settings = assetManager->desc.textureImportSettings;
+        UpdateTargets();
+
+        // trimming only copies on the GPU and happens right away, finer levels are read on a worker
+        std::vector<std::pair<AssetHandle, TextureStreamingEntry*>> streamIns;
+        for (auto& [handle, entry] : entries)
+        {
+            Asset asset = assetManager->FindAsset(handle);
+            if (!asset)
+                continue;
+
+            if (entry.targetMip > entry.residentMip)
+                SetResidentMip(assetManager, asset, entry, entry.targetMip);
+            else if (entry.targetMip < entry.residentMip && !entry.isPending)
+                streamIns.emplace_back(handle, &entry);
+        }
+
+        // the largest gaps first
+        std::sort(streamIns.begin(), streamIns.end(), [](const auto& a, const auto& b) {
+            return a.second->residentMip - a.second->targetMip > b.second->residentMip - b.second->targetMip;
+        });
+
+        for (auto& [handle, entry] : streamIns)
+        {
+            if (pendingCount >= settings.streamingMaxRequests)
+                break;
+
+            pendingCount++;
+            assetManager->asyncTaskCount++;
+            entry->isPending = true;
+
+            HE::Jops::SubmitTask([this, handle, source = entry->source, fileOffsets = entry->fileOffsets, first = entry->targetMip, last = entry->residentMip, requestGeneration = generation]() {
+
+                HE_PROFILE_SCOPE_NC("TextureStreamer::StreamIn", HE_PROFILE_COLOR);
+
+                // the new levels are read from the file here, the main thread only records the GPU writes
+                HE::Ref<TextureFile> staged;
+                const bool isFileBacked = !fileOffsets.empty();
+                if (isFileBacked)
+                {
+                    staged = ReadLevels(*source, fileOffsets, first, last);
+                    if (!staged)
+                        HE_ERROR("TextureStreamer : unable to read levels {} to {} of {}", first, last, source->path.string());
+                }
+
+                HE::Jops::SubmitToMainThread([this, handle, first, last, staged, isFileBacked, requestGeneration]() {
+
+                    // requests from before a Clear are already out of the counts
+                    if (requestGeneration != generation)
+                        return;
+
+                    pendingCount--;
+                    assetManager->asyncTaskCount--;
+
+                    auto it = entries.find(handle);
+                    if (it == entries.end())
+                        return;
+
+                    // the target may have moved while the levels were read, levels trimmed meanwhile are not staged and wait for the next request
+                    auto& entry = it->second;
+                    entry.isPending = false;
+
+                    Asset asset = assetManager->FindAsset(handle);
+                    if (asset && (staged || !isFileBacked) && first < entry.residentMip && first >= entry.targetMip && entry.residentMip <= last)
+                        SetResidentMip(assetManager, asset, entry, first, staged.get());
+                });
+            });
+        }
+
+        frameIndex++;
+    }
+
+    void TextureStreamer::Clear()
+    {
+        if (assetManager)
+            assetManager->asyncTaskCount -= std::min(pendingCount, assetManager->asyncTaskCount);
+
+        entries.clear();
+        residentSize = 0;
+        pendingCount = 0;
+        generation++;
+    }
+}
@@ -1,5 +1,9 @@
 #include "HydraEngine/Base.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
 import Assets;
 import HE;
 import Math;
@@ -152,38 +156,172 @@ namespace Assets {
 
     uint32_t GetVertexAttributeSize(VertexAttribute attr)
     {
-        switch (attr)
+        return GetVertexFormatSize(c_DefaultVertexFormats[int(attr)]);
+    }
+
+    uint16_t FloatToHalf(float value)
+    {
+        constexpr uint32_t f32Infinity = 255u << 23;
+        constexpr uint32_t f16Max = (127u + 16u) << 23;
+        constexpr uint32_t denormMagic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+
+        uint32_t u = std::bit_cast<uint32_t>(value);
+        uint32_t sign = u & 0x80000000u;
+        u ^= sign;
+
+        uint16_t result;
+        if (u >= f16Max)
+        {
+            result = (u > f32Infinity) ? 0x7e00 : 0x7c00;
+        }
+        else if (u < (113u << 23))
+        {
+            // subnormal or zero, let the FPU do the rounding
+            float f = std::bit_cast<float>(u) + std::bit_cast<float>(denormMagic);
+            result = uint16_t(std::bit_cast<uint32_t>(f) - denormMagic);
+        }
+        else
+        {
+            // round to nearest even
+            uint32_t mantissaOdd = (u >> 13) & 1;
+            u += (uint32_t(15 - 127) << 23) + 0xfff;
+            u += mantissaOdd;
+            result = uint16_t(u >> 13);
+        }
+
+        return uint16_t(result | (sign >> 16));
+    }
+
+    float HalfToFloat(uint16_t value)
+    {
+        constexpr uint32_t shiftedExponent = 0x7c00u << 13;
+
+        uint32_t result = (value & 0x7fffu) << 13;
+        uint32_t exponent = shiftedExponent & result;
+        result += (127u - 15u) << 23;
+
+        if (exponent == shiftedExponent)
+        {
+            result += (128u - 16u) << 23; // Inf / NaN
+        }
+        else if (exponent == 0)
+        {
+            result += 1u << 23; // subnormal, renormalize
+            result = std::bit_cast<uint32_t>(std::bit_cast<float>(result) - std::bit_cast<float>(113u << 23));
+        }
+
+        result |= uint32_t(value & 0x8000u) << 16;
+        return std::bit_cast<float>(result);
+    }
+
+    static uint8_t Base64Value(char c)
+    {
+        if (c >= 'A' && c <= 'Z') return uint8_t(c - 'A');
+        if (c >= 'a' && c <= 'z') return uint8_t(c - 'a' + 26);
+        if (c >= '0' && c <= '9') return uint8_t(c - '0' + 52);
+        if (c == '+' || c == '-') return 62;
+        if (c == '/' || c == '_') return 63;
+        return 0xFF;
+    }
+
+    bool DecodeBase64(std::string_view input, std::vector<uint8_t>& output)
+    {
+        while (!input.empty() && input.back() == '=')
+            input.remove_suffix(1);
+
+        output.resize(input.size() / 4 * 3 + (input.size() % 4 ? input.size() % 4 - 1 : 0));
+        if (input.size() % 4 == 1)
+            return false;
+
+        const char* src = input.data();
+        uint8_t* dst = output.data();
+        size_t i = 0;
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+        // 16 characters -> 12 bytes, classify the characters with range compares and pack the 6 bit values with madd
+        auto inRange = [](__m128i c, char lo, char hi) { return _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8(lo - 1)), _mm_cmplt_epi8(c, _mm_set1_epi8(hi + 1))); };
+
+        for (; i + 16 <= input.size(); i += 16)
+        {
+            __m128i c = _mm_loadu_si128((const __m128i*)(src + i));
+
+            __m128i upper = inRange(c, 'A', 'Z');
+            __m128i lower = inRange(c, 'a', 'z');
+            __m128i digit = inRange(c, '0', '9');
+            __m128i plus = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('+')), _mm_cmpeq_epi8(c, _mm_set1_epi8('-')));
+            __m128i slash = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('/')), _mm_cmpeq_epi8(c, _mm_set1_epi8('_')));
+
+            __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(digit, _mm_or_si128(plus, slash)));
+            if (_mm_movemask_epi8(valid) != 0xFFFF)
+                break;
+
+            __m128i offset = _mm_and_si128(upper, _mm_set1_epi8(-'A'));
+            offset = _mm_or_si128(offset, _mm_and_si128(lower, _mm_set1_epi8(26 - 'a')));
+            offset = _mm_or_si128(offset, _mm_and_si128(digit, _mm_set1_epi8(52 - '0')));
+            __m128i v = _mm_add_epi8(c, offset);
+            v = _mm_or_si128(_mm_andnot_si128(_mm_or_si128(plus, slash), v), _mm_and_si128(plus, _mm_set1_epi8(62)));
+            v = _mm_or_si128(v, _mm_and_si128(slash, _mm_set1_epi8(63)));
+
+            // [a b] -> a << 6 | b in 16 bits, then [ab cd] -> ab << 12 | cd in 32 bits
+            __m128i pairs = _mm_or_si128(_mm_slli_epi16(_mm_and_si128(v, _mm_set1_epi16(0x00FF)), 6), _mm_srli_epi16(v, 8));
+            __m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+
+            alignas(16) uint32_t words[4];
+            _mm_store_si128((__m128i*)words, quads);
+            for (uint32_t w : words)
+            {
+                *dst++ = uint8_t(w >> 16);
+                *dst++ = uint8_t(w >> 8);
+                *dst++ = uint8_t(w);
+            }
+        }
+#endif
+
+        uint32_t bits = 0;
+        uint32_t bitCount = 0;
+        for (; i < input.size(); i++)
         {
-        case VertexAttribute::Position:    return sizeof(Math::float3);
-        case VertexAttribute::Normal:
-        case VertexAttribute::Tangent:     return sizeof(uint32_t);
-        case VertexAttribute::TexCoord0:
-        case VertexAttribute::TexCoord1:   return sizeof(Math::float2);
-        case VertexAttribute::BoneIndices: return sizeof(uint16_t) * 4;
-        case VertexAttribute::BoneWeights: return sizeof(Math::float4);
+            uint8_t value = Base64Value(src[i]);
+            if (value == 0xFF)
+                return false;
+
+            bits = (bits << 6) | value;
+            bitCount += 6;
+            if (bitCount >= 8)
+            {
+                bitCount -= 8;
+                *dst++ = uint8_t(bits >> bitCount);
+            }
         }
 
-        return 0;
+        return true;
     }
 
-    nvrhi::TextureHandle LoadTexture(const std::filesystem::path& filePath, nvrhi::IDevice* device, nvrhi::ICommandList* commandList)
+    nvrhi::TextureHandle LoadTexture(const std::filesystem::path& filePath, nvrhi::IDevice* device, nvrhi::ICommandList* commandList, HDRTextureFormat hdrFormat)
     {
         bool isHDR = filePath.extension() == ".hdr";
 
         HE::Image image(filePath);
+
+        // BC6H needs a multiple of 4
+        std::vector<uint8_t> hdrData;
+        size_t rowPitch = size_t(image.GetWidth()) * 4;
+        if (isHDR && !ConvertHDRImage((const float*)image.GetData(), image.GetWidth(), image.GetHeight(), hdrFormat, hdrData, rowPitch))
+        {
+            hdrFormat = HDRTextureFormat::RGBA16Float;
+            ConvertHDRImage((const float*)image.GetData(), image.GetWidth(), image.GetHeight(), hdrFormat, hdrData, rowPitch);
+        }
+
         nvrhi::TextureDesc desc;
         desc.width = image.GetWidth();
         desc.height = image.GetHeight();
-        desc.format = isHDR ? nvrhi::Format::RGB32_FLOAT : nvrhi::Format::RGBA8_UNORM;
+        desc.format = isHDR ? GetHDRTextureFormat(hdrFormat) : nvrhi::Format::RGBA8_UNORM;
         desc.initialState = nvrhi::ResourceStates::ShaderResource;
         desc.keepInitialState = true;
         desc.debugName = filePath.string();
         auto texture = device->createTexture(desc);
 
-        int bytesPerPixel = isHDR ? 3 * sizeof(float) : 4;
-        int rowPitch = desc.width * bytesPerPixel;
-
-        commandList->writeTexture(texture, 0, 0, image.GetData(), rowPitch);
+        commandList->writeTexture(texture, 0, 0, isHDR ? hdrData.data() : image.GetData(), rowPitch);
 
         return texture;
     }
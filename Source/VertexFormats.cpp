@@ -0,0 +1,610 @@
+#include "HydraEngine/Base.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#define ASSETS_OCT_SSE 1
+#endif
+
+import Assets;
+import HE;
+import nvrhi;
+import Math;
+import std;
+import magic_enum;
+
+#define HE_PROFILE_COLOR 0xAA0000
+
+namespace Assets {
+
+    uint32_t GetVertexFormatSize(VertexFormat format)
+    {
+        switch (format)
+        {
+        case VertexFormat::Float2:    return sizeof(float) * 2;
+        case VertexFormat::Float3:    return sizeof(float) * 3;
+        case VertexFormat::Float4:    return sizeof(float) * 4;
+        case VertexFormat::Half2:     return sizeof(uint16_t) * 2;
+        case VertexFormat::Unorm16x2: return sizeof(uint16_t) * 2;
+        case VertexFormat::Unorm16x4: return sizeof(uint16_t) * 4;
+        case VertexFormat::Unorm8x4:  return sizeof(uint8_t) * 4;
+        case VertexFormat::Snorm8x4:  return sizeof(uint8_t) * 4;
+        case VertexFormat::Uint16x4:  return sizeof(uint16_t) * 4;
+        case VertexFormat::Oct16:     return sizeof(int16_t) * 2;
+        case VertexFormat::Oct8:      return sizeof(int8_t) * 2;
+        case VertexFormat::OctSign16: return sizeof(uint32_t);
+        case VertexFormat::OctSign8:  return sizeof(uint16_t);
+        case VertexFormat::Float1:    return sizeof(float);
+        }
+
+        return 0;
+    }
+
+    nvrhi::Format GetVertexFormatNvrhiFormat(VertexFormat format)
+    {
+        switch (format)
+        {
+        case VertexFormat::Float2:    return nvrhi::Format::RG32_FLOAT;
+        case VertexFormat::Float3:    return nvrhi::Format::RGB32_FLOAT;
+        case VertexFormat::Float4:    return nvrhi::Format::RGBA32_FLOAT;
+        case VertexFormat::Half2:     return nvrhi::Format::RG16_FLOAT;
+        case VertexFormat::Unorm16x2: return nvrhi::Format::RG16_UNORM;
+        case VertexFormat::Unorm16x4: return nvrhi::Format::RGBA16_UNORM;
+        case VertexFormat::Unorm8x4:  return nvrhi::Format::RGBA8_UNORM;
+        case VertexFormat::Snorm8x4:  return nvrhi::Format::RGBA8_SNORM;
+        case VertexFormat::Uint16x4:  return nvrhi::Format::RGBA16_UINT;
+        case VertexFormat::Oct16:     return nvrhi::Format::RG16_SNORM;
+        case VertexFormat::Oct8:      return nvrhi::Format::RG8_SNORM;
+        case VertexFormat::OctSign16: return nvrhi::Format::R32_UINT;
+        case VertexFormat::OctSign8:  return nvrhi::Format::R16_UINT;
+        case VertexFormat::Float1:    return nvrhi::Format::R32_FLOAT;
+        }
+
+        return nvrhi::Format::UNKNOWN;
+    }
+
+    template<typename T>
+    static T Load(const uint8_t* src, int i)
+    {
+        T value;
+        std::memcpy(&value, src + i * sizeof(T), sizeof(T));
+        return value;
+    }
+
+    template<typename T>
+    static void Store(uint8_t* dst, int i, T value)
+    {
+        std::memcpy(dst + i * sizeof(T), &value, sizeof(T));
+    }
+
+    static uint16_t ToUnorm16(float v) { return uint16_t(std::clamp(v, 0.0f, 1.0f) * 65535.0f + 0.5f); }
+    static uint8_t ToUnorm8(float v) { return uint8_t(std::clamp(v, 0.0f, 1.0f) * 255.0f + 0.5f); }
+    static int8_t ToSnorm8(float v) { return int8_t(std::round(std::clamp(v, -1.0f, 1.0f) * 127.0f)); }
+
+    bool IsOctahedralFormat(VertexFormat format)
+    {
+        return format == VertexFormat::Oct16 || format == VertexFormat::Oct8 || format == VertexFormat::OctSign16 || format == VertexFormat::OctSign8;
+    }
+
+    Math::float2 OctEncode(const Math::float3& n)
+    {
+        float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+        if (l1 == 0.0f)
+            return { 0.0f, 0.0f };
+
+        Math::float2 p = { n.x / l1 + 0.0f, n.y / l1 + 0.0f };
+        if (n.z < 0.0f)
+        {
+            p = {
+                (1.0f - std::abs(p.y)) * (std::signbit(p.x) ? -1.0f : 1.0f),
+                (1.0f - std::abs(p.x)) * (std::signbit(p.y) ? -1.0f : 1.0f),
+            };
+        }
+
+        return p;
+    }
+
+    Math::float3 OctDecode(const Math::float2& e)
+    {
+        Math::float3 n = { e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y) };
+        float t = std::max(-n.z, 0.0f);
+        n.x += n.x >= 0.0f ? -t : t;
+        n.y += n.y >= 0.0f ? -t : t;
+
+        return Math::normalize(n);
+    }
+
+    // Per format quantization of the two octahedral coordinates, signed formats are snorm, the sign carrying ones are unorm with the sign in the top bit
+    struct OctQuantization
+    {
+        float scaleX;
+        float scaleY;
+        bool isSigned;
+        bool hasSign;
+    };
+
+    static OctQuantization GetOctQuantization(VertexFormat format)
+    {
+        switch (format)
+        {
+        case VertexFormat::Oct16:     return { 32767.0f, 32767.0f, true, false };
+        case VertexFormat::Oct8:      return { 127.0f, 127.0f, true, false };
+        case VertexFormat::OctSign16: return { 65535.0f, 32767.0f, false, true };
+        case VertexFormat::OctSign8:  return { 255.0f, 127.0f, false, true };
+        default:                      return { 1.0f, 1.0f, true, false };
+        }
+    }
+
+    static void PackOct(VertexFormat format, int32_t x, int32_t y, bool negative, uint8_t* dst)
+    {
+        switch (format)
+        {
+        case VertexFormat::Oct16:
+            Store<int16_t>(dst, 0, int16_t(x));
+            Store<int16_t>(dst, 1, int16_t(y));
+            break;
+        case VertexFormat::Oct8:
+            dst[0] = uint8_t(int8_t(x));
+            dst[1] = uint8_t(int8_t(y));
+            break;
+        case VertexFormat::OctSign16:
+            Store<uint32_t>(dst, 0, uint32_t(x) | (uint32_t(y) << 16) | (negative ? 0x80000000u : 0u));
+            break;
+        case VertexFormat::OctSign8:
+            Store<uint16_t>(dst, 0, uint16_t(uint32_t(x) | (uint32_t(y) << 8) | (negative ? 0x8000u : 0u)));
+            break;
+        default:
+            break;
+        }
+    }
+
+    static void UnpackOct(VertexFormat format, const uint8_t* src, int32_t& x, int32_t& y, bool& negative)
+    {
+        negative = false;
+        switch (format)
+        {
+        case VertexFormat::Oct16:
+            x = Load<int16_t>(src, 0);
+            y = Load<int16_t>(src, 1);
+            break;
+        case VertexFormat::Oct8:
+            x = int8_t(src[0]);
+            y = int8_t(src[1]);
+            break;
+        case VertexFormat::OctSign16:
+        {
+            uint32_t bits = Load<uint32_t>(src, 0);
+            x = int32_t(bits & 0xFFFF);
+            y = int32_t((bits >> 16) & 0x7FFF);
+            negative = (bits & 0x80000000u) != 0;
+            break;
+        }
+        case VertexFormat::OctSign8:
+        {
+            uint16_t bits = Load<uint16_t>(src, 0);
+            x = int32_t(bits & 0xFF);
+            y = int32_t((bits >> 8) & 0x7F);
+            negative = (bits & 0x8000u) != 0;
+            break;
+        }
+        default:
+            x = y = 0;
+            break;
+        }
+    }
+
+    static int32_t QuantizeOct(float v, float scale, bool isSigned)
+    {
+        v = std::clamp(v, -1.0f, 1.0f);
+        return int32_t(std::nearbyint(isSigned ? v * scale : (v * 0.5f + 0.5f) * scale));
+    }
+
+    static float DequantizeOct(int32_t q, float scale, bool isSigned)
+    {
+        return isSigned ? std::max(float(q) / scale, -1.0f) : float(q) / scale * 2.0f - 1.0f;
+    }
+
+    static void EncodeOctElement(VertexFormat format, const Math::float4& value, uint8_t* dst)
+    {
+        OctQuantization q = GetOctQuantization(format);
+        Math::float2 e = OctEncode(Math::float3(value));
+        PackOct(format, QuantizeOct(e.x, q.scaleX, q.isSigned), QuantizeOct(e.y, q.scaleY, q.isSigned), std::signbit(value.w), dst);
+    }
+
+    static Math::float4 DecodeOctElement(VertexFormat format, const uint8_t* src)
+    {
+        OctQuantization q = GetOctQuantization(format);
+
+        int32_t x, y;
+        bool negative;
+        UnpackOct(format, src, x, y, negative);
+
+        Math::float3 n = OctDecode({ DequantizeOct(x, q.scaleX, q.isSigned), DequantizeOct(y, q.scaleY, q.isSigned) });
+        return Math::float4(n, q.hasSign ? (negative ? -1.0f : 1.0f) : 0.0f);
+    }
+
+    void EncodeOctahedralBatch(VertexFormat format, const Math::float4* src, uint32_t count, uint8_t* dst)
+    {
+        HE_ASSERT(IsOctahedralFormat(format));
+
+        uint32_t stride = GetVertexFormatSize(format);
+        uint32_t i = 0;
+
+#ifdef ASSETS_OCT_SSE
+        OctQuantization q = GetOctQuantization(format);
+
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 scaleX = _mm_set1_ps(q.scaleX);
+        const __m128 scaleY = _mm_set1_ps(q.scaleY);
+
+        alignas(16) int32_t qx[4];
+        alignas(16) int32_t qy[4];
+
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 x = _mm_loadu_ps(&src[i + 0].x);
+            __m128 y = _mm_loadu_ps(&src[i + 1].x);
+            __m128 z = _mm_loadu_ps(&src[i + 2].x);
+            __m128 w = _mm_loadu_ps(&src[i + 3].x);
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+
+            __m128 l1 = _mm_add_ps(_mm_add_ps(_mm_andnot_ps(signMask, x), _mm_andnot_ps(signMask, y)), _mm_andnot_ps(signMask, z));
+            __m128 valid = _mm_cmpgt_ps(l1, zero);
+            __m128 inv = _mm_and_ps(_mm_div_ps(one, _mm_or_ps(l1, _mm_andnot_ps(valid, one))), valid);
+
+            // + 0 turns -0 into +0 so the fold matches the scalar reference
+            __m128 px = _mm_add_ps(_mm_mul_ps(x, inv), zero);
+            __m128 py = _mm_add_ps(_mm_mul_ps(y, inv), zero);
+
+            __m128 fx = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, py)), _mm_or_ps(_mm_and_ps(px, signMask), one));
+            __m128 fy = _mm_mul_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, px)), _mm_or_ps(_mm_and_ps(py, signMask), one));
+
+            __m128 lower = _mm_cmplt_ps(z, zero);
+            __m128 ex = _mm_or_ps(_mm_and_ps(lower, fx), _mm_andnot_ps(lower, px));
+            __m128 ey = _mm_or_ps(_mm_and_ps(lower, fy), _mm_andnot_ps(lower, py));
+
+            ex = _mm_min_ps(_mm_max_ps(ex, _mm_set1_ps(-1.0f)), one);
+            ey = _mm_min_ps(_mm_max_ps(ey, _mm_set1_ps(-1.0f)), one);
+
+            if (!q.isSigned)
+            {
+                ex = _mm_add_ps(_mm_mul_ps(ex, half), half);
+                ey = _mm_add_ps(_mm_mul_ps(ey, half), half);
+            }
+
+            _mm_store_si128((__m128i*)qx, _mm_cvtps_epi32(_mm_mul_ps(ex, scaleX)));
+            _mm_store_si128((__m128i*)qy, _mm_cvtps_epi32(_mm_mul_ps(ey, scaleY)));
+            int negative = _mm_movemask_ps(w);
+
+            for (int k = 0; k < 4; k++)
+                PackOct(format, qx[k], qy[k], (negative >> k) & 1, dst + size_t(i + k) * stride);
+        }
+#endif
+
+        for (; i < count; i++)
+            EncodeOctElement(format, src[i], dst + size_t(i) * stride);
+    }
+
+    void DecodeOctahedralBatch(VertexFormat format, const uint8_t* src, uint32_t count, Math::float4* dst)
+    {
+        HE_ASSERT(IsOctahedralFormat(format));
+
+        uint32_t stride = GetVertexFormatSize(format);
+        uint32_t i = 0;
+
+#ifdef ASSETS_OCT_SSE
+        OctQuantization q = GetOctQuantization(format);
+
+        const __m128 signMask = _mm_set1_ps(-0.0f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 invScaleX = _mm_set1_ps(1.0f / q.scaleX);
+        const __m128 invScaleY = _mm_set1_ps(1.0f / q.scaleY);
+
+        alignas(16) int32_t qx[4];
+        alignas(16) int32_t qy[4];
+        alignas(16) float sign[4];
+
+        for (; i + 4 <= count; i += 4)
+        {
+            for (int k = 0; k < 4; k++)
+            {
+                bool negative;
+                UnpackOct(format, src + size_t(i + k) * stride, qx[k], qy[k], negative);
+                sign[k] = q.hasSign ? (negative ? -1.0f : 1.0f) : 0.0f;
+            }
+
+            __m128 x = _mm_mul_ps(_mm_cvtepi32_ps(_mm_load_si128((const __m128i*)qx)), invScaleX);
+            __m128 y = _mm_mul_ps(_mm_cvtepi32_ps(_mm_load_si128((const __m128i*)qy)), invScaleY);
+
+            if (q.isSigned)
+            {
+                x = _mm_max_ps(x, _mm_set1_ps(-1.0f));
+                y = _mm_max_ps(y, _mm_set1_ps(-1.0f));
+            }
+            else
+            {
+                x = _mm_sub_ps(_mm_add_ps(x, x), one);
+                y = _mm_sub_ps(_mm_add_ps(y, y), one);
+            }
+
+            __m128 z = _mm_sub_ps(_mm_sub_ps(one, _mm_andnot_ps(signMask, x)), _mm_andnot_ps(signMask, y));
+            __m128 t = _mm_max_ps(_mm_sub_ps(zero, z), zero);
+
+            // x += x >= 0 ? -t : t
+            x = _mm_sub_ps(x, _mm_or_ps(t, _mm_andnot_ps(_mm_cmpge_ps(x, zero), signMask)));
+            y = _mm_sub_ps(y, _mm_or_ps(t, _mm_andnot_ps(_mm_cmpge_ps(y, zero), signMask)));
+
+            __m128 invLength = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z))));
+            x = _mm_mul_ps(x, invLength);
+            y = _mm_mul_ps(y, invLength);
+            z = _mm_mul_ps(z, invLength);
+            __m128 w = _mm_load_ps(sign);
+
+            _MM_TRANSPOSE4_PS(x, y, z, w);
+            _mm_storeu_ps(&dst[i + 0].x, x);
+            _mm_storeu_ps(&dst[i + 1].x, y);
+            _mm_storeu_ps(&dst[i + 2].x, z);
+            _mm_storeu_ps(&dst[i + 3].x, w);
+        }
+#endif
+
+        for (; i < count; i++)
+            dst[i] = DecodeOctElement(format, src + size_t(i) * stride);
+    }
+
+    Math::float4 DecodeVertexElement(VertexFormat format, const uint8_t* src)
+    {
+        switch (format)
+        {
+        case VertexFormat::Float2:    return { Load<float>(src, 0), Load<float>(src, 1), 0.0f, 0.0f };
+        case VertexFormat::Float3:    return { Load<float>(src, 0), Load<float>(src, 1), Load<float>(src, 2), 0.0f };
+        case VertexFormat::Float4:    return { Load<float>(src, 0), Load<float>(src, 1), Load<float>(src, 2), Load<float>(src, 3) };
+        case VertexFormat::Half2:     return { HalfToFloat(Load<uint16_t>(src, 0)), HalfToFloat(Load<uint16_t>(src, 1)), 0.0f, 0.0f };
+        case VertexFormat::Unorm16x2: return { Load<uint16_t>(src, 0) / 65535.0f, Load<uint16_t>(src, 1) / 65535.0f, 0.0f, 0.0f };
+        case VertexFormat::Unorm16x4: return Math::float4(Load<uint16_t>(src, 0), Load<uint16_t>(src, 1), Load<uint16_t>(src, 2), Load<uint16_t>(src, 3)) / 65535.0f;
+        case VertexFormat::Unorm8x4:  return Math::float4(src[0], src[1], src[2], src[3]) / 255.0f;
+        case VertexFormat::Snorm8x4:  return Math::max(Math::float4(int8_t(src[0]), int8_t(src[1]), int8_t(src[2]), int8_t(src[3])) / 127.0f, Math::float4(-1.0f));
+        case VertexFormat::Uint16x4:  return Math::float4(Load<uint16_t>(src, 0), Load<uint16_t>(src, 1), Load<uint16_t>(src, 2), Load<uint16_t>(src, 3));
+        case VertexFormat::Oct16:
+        case VertexFormat::Oct8:
+        case VertexFormat::OctSign16:
+        case VertexFormat::OctSign8:  return DecodeOctElement(format, src);
+        case VertexFormat::Float1:    return { Load<float>(src, 0), 0.0f, 0.0f, 0.0f };
+        }
+
+        return Math::float4(0.0f);
+    }
+
+    void EncodeVertexElement(VertexFormat format, const Math::float4& value, uint8_t* dst)
+    {
+        switch (format)
+        {
+        case VertexFormat::Float1:
+        case VertexFormat::Float2:
+        case VertexFormat::Float3:
+        case VertexFormat::Float4:
+            for (uint32_t i = 0; i < GetVertexFormatSize(format) / sizeof(float); i++)
+                Store<float>(dst, i, value[i]);
+            break;
+        case VertexFormat::Half2:
+            for (int i = 0; i < 2; i++)
+                Store<uint16_t>(dst, i, FloatToHalf(value[i]));
+            break;
+        case VertexFormat::Unorm16x2:
+            for (int i = 0; i < 2; i++)
+                Store<uint16_t>(dst, i, ToUnorm16(value[i]));
+            break;
+        case VertexFormat::Unorm16x4:
+            for (int i = 0; i < 4; i++)
+                Store<uint16_t>(dst, i, ToUnorm16(value[i]));
+            break;
+        case VertexFormat::Unorm8x4:
+            for (int i = 0; i < 4; i++)
+                dst[i] = ToUnorm8(value[i]);
+            break;
+        case VertexFormat::Snorm8x4:
+            for (int i = 0; i < 4; i++)
+                dst[i] = uint8_t(ToSnorm8(value[i]));
+            break;
+        case VertexFormat::Uint16x4:
+            for (int i = 0; i < 4; i++)
+                Store<uint16_t>(dst, i, uint16_t(std::clamp(value[i], 0.0f, 65535.0f)));
+            break;
+        case VertexFormat::Oct16:
+        case VertexFormat::Oct8:
+        case VertexFormat::OctSign16:
+        case VertexFormat::OctSign8:
+            EncodeOctElement(format, value, dst);
+            break;
+        }
+    }
+
+    static bool IsNormalizedWeightFormat(VertexFormat format)
+    {
+        return format == VertexFormat::Unorm8x4 || format == VertexFormat::Unorm16x4;
+    }
+
+    // Quantized weights must still sum to one, push the rounding error into the largest weight
+    static void FixupQuantizedWeights(VertexFormat format, uint8_t* dst)
+    {
+        int values[4];
+        int maxValue = format == VertexFormat::Unorm8x4 ? 255 : 65535;
+
+        for (int i = 0; i < 4; i++)
+            values[i] = format == VertexFormat::Unorm8x4 ? dst[i] : Load<uint16_t>(dst, i);
+
+        int sum = values[0] + values[1] + values[2] + values[3];
+        if (sum == 0)
+            return;
+
+        int largest = int(std::max_element(values, values + 4) - values);
+        values[largest] = std::clamp(values[largest] + maxValue - sum, 0, maxValue);
+
+        for (int i = 0; i < 4; i++)
+        {
+            if (format == VertexFormat::Unorm8x4)
+                dst[i] = uint8_t(values[i]);
+            else
+                Store<uint16_t>(dst, i, uint16_t(values[i]));
+        }
+    }
+
+    static DecodedVertexAttribute MakeDecodedAttribute(const MeshSource& meshSource, VertexAttribute attr, uint64_t firstVertex, size_t count)
+    {
+        DecodedVertexAttribute view;
+        if (!meshSource.HasAttribute(attr))
+            return view;
+
+        view.format = meshSource.vertexFormats[int(attr)];
+        view.stride = meshSource.GetVertexStride(attr);
+        view.data = meshSource.cpuVertexBuffer.data() + meshSource.vertexBufferRanges[int(attr)].byteOffset + firstVertex * view.stride;
+        view.count = count;
+
+        return view;
+    }
+
+    static void ApplyPositionDequantization(DecodedVertexAttribute& view, const Mesh& mesh)
+    {
+        if (view.format != VertexFormat::Unorm16x4)
+            return;
+
+        Math::float3 extents = mesh.aabb.m_maxs - mesh.aabb.m_mins;
+        view.scale = Math::float4(extents, 0.0f);
+        view.offset = Math::float4(mesh.aabb.m_mins, 0.0f);
+    }
+
+    DecodedVertexAttribute MeshSource::GetDecodedAttribute(VertexAttribute attr) const
+    {
+        HE_ASSERT(attr != VertexAttribute::Position || vertexFormats[int(attr)] == VertexFormat::Float3);
+        return MakeDecodedAttribute(*this, attr, 0, vertexCount);
+    }
+
+    DecodedVertexAttribute Mesh::GetDecodedAttribute(const MeshSource& meshSource, VertexAttribute attr) const
+    {
+        DecodedVertexAttribute view = MakeDecodedAttribute(meshSource, attr, vertexOffset, vertexCount);
+        if (attr == VertexAttribute::Position)
+            ApplyPositionDequantization(view, *this);
+
+        return view;
+    }
+
+    DecodedVertexAttribute MeshGeometry::GetDecodedAttribute(const MeshSource& meshSource, VertexAttribute attr) const
+    {
+        const Mesh& m = meshSource.meshes[mesh];
+        DecodedVertexAttribute view = MakeDecodedAttribute(meshSource, attr, uint64_t(m.vertexOffset) + vertexOffsetInMesh, vertexCount);
+        if (attr == VertexAttribute::Position)
+            ApplyPositionDequantization(view, m);
+
+        return view;
+    }
+
+    void ConvertVertexFormats(MeshSource& meshSource, const std::array<VertexFormat, c_VertexAttributeCount>& requestedFormats)
+    {
+        HE_PROFILE_SCOPE_COLOR(HE_PROFILE_COLOR);
+
+        HE::Timer t;
+
+        auto formats = requestedFormats;
+
+        if (formats[int(VertexAttribute::TexCoord0)] == VertexFormat::Unorm16x2 || formats[int(VertexAttribute::TexCoord1)] == VertexFormat::Unorm16x2)
+        {
+            for (auto attr : { VertexAttribute::TexCoord0, VertexAttribute::TexCoord1 })
+            {
+                if (formats[int(attr)] != VertexFormat::Unorm16x2 || !meshSource.HasAttribute(attr))
+                    continue;
+
+                auto view = meshSource.GetDecodedAttribute(attr);
+                for (size_t v = 0; v < view.size(); v++)
+                {
+                    Math::float2 uv = view.GetFloat2(v);
+                    if (uv.x < 0.0f || uv.x > 1.0f || uv.y < 0.0f || uv.y > 1.0f)
+                    {
+                        HE_WARN("ConvertVertexFormats : {} outside [0, 1], using Half2", magic_enum::enum_name(attr));
+                        formats[int(attr)] = VertexFormat::Half2;
+                        break;
+                    }
+                }
+            }
+        }
+
+        std::array<nvrhi::BufferRange, c_VertexAttributeCount> ranges = {};
+        uint64_t bufferSize = 0;
+        for (uint32_t a = 0; a < c_VertexAttributeCount; a++)
+        {
+            if (!meshSource.HasAttribute(VertexAttribute(a)))
+                continue;
+
+            uint64_t byteSize = uint64_t(meshSource.vertexCount) * GetVertexFormatSize(formats[a]);
+            ranges[a] = nvrhi::BufferRange(bufferSize, byteSize);
+            bufferSize += byteSize;
+        }
+
+        std::vector<uint8_t> buffer(bufferSize);
+
+        HE::Jops::Taskflow tf;
+        tf.for_each_index(size_t(0), meshSource.meshes.size(), size_t(1), [&](size_t i) {
+
+            const Mesh& mesh = meshSource.meshes[i];
+
+            Math::float3 extents = mesh.aabb.m_maxs - mesh.aabb.m_mins;
+            Math::float4 invExtents = {
+                extents.x > 0.0f ? 1.0f / extents.x : 0.0f,
+                extents.y > 0.0f ? 1.0f / extents.y : 0.0f,
+                extents.z > 0.0f ? 1.0f / extents.z : 0.0f,
+                0.0f
+            };
+
+            for (uint32_t a = 0; a < c_VertexAttributeCount; a++)
+            {
+                auto attr = VertexAttribute(a);
+                if (ranges[a].byteSize == 0)
+                    continue;
+
+                auto src = mesh.GetDecodedAttribute(meshSource, attr);
+                uint32_t stride = GetVertexFormatSize(formats[a]);
+                uint8_t* dst = buffer.data() + ranges[a].byteOffset + uint64_t(mesh.vertexOffset) * stride;
+
+                if (IsOctahedralFormat(formats[a]))
+                {
+                    std::vector<Math::float4> values(src.size());
+                    if (IsOctahedralFormat(src.format) && src.stride == GetVertexFormatSize(src.format))
+                        DecodeOctahedralBatch(src.format, src.data, src.count, values.data());
+                    else
+                        for (uint32_t v = 0; v < src.size(); v++)
+                            values[v] = src[v];
+
+                    EncodeOctahedralBatch(formats[a], values.data(), (uint32_t)values.size(), dst);
+                    continue;
+                }
+
+                bool quantizePosition = attr == VertexAttribute::Position && formats[a] == VertexFormat::Unorm16x4;
+                bool fixupWeights = attr == VertexAttribute::BoneWeights && IsNormalizedWeightFormat(formats[a]);
+
+                for (uint32_t v = 0; v < src.size(); v++)
+                {
+                    Math::float4 value = src[v];
+                    if (quantizePosition)
+                        value = (value - Math::float4(mesh.aabb.m_mins, 0.0f)) * invExtents;
+
+                    EncodeVertexElement(formats[a], value, dst + size_t(v) * stride);
+
+                    if (fixupWeights)
+                        FixupQuantizedWeights(formats[a], dst + size_t(v) * stride);
+                }
+            }
+        });
+        HE::Jops::RunTaskflow(tf).wait();
+
+        uint64_t bytesBefore = meshSource.cpuVertexBuffer.size();
+        meshSource.cpuVertexBuffer = std::move(buffer);
+        meshSource.vertexBufferRanges = ranges;
+        meshSource.vertexFormats = formats;
+        meshSource.vertexLayout = VertexLayout::Separate;
+        meshSource.vertexStride = 0;
+
+        HE_INFO("Import ConvertVertexFormats [{} -> {} bytes][{}ms]", bytesBefore, meshSource.cpuVertexBuffer.size(), t.ElapsedMilliseconds());
+    }
+}
@@ -0,0 +1,290 @@
+#include "HydraEngine/Base.h"
+
+import Assets;
+import HE;
+import std;
+
+namespace Assets {
+
+    // zlib streams (RFC 1950) around DEFLATE (RFC 1951), preset dictionaries are not supported
+
+    constexpr uint32_t c_InflateMaxBits = 15;
+    constexpr uint8_t c_InflateCodeLengthOrder[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+    constexpr uint16_t c_InflateLengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    constexpr uint8_t c_InflateLengthBits[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    constexpr uint16_t c_InflateDistanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    constexpr uint8_t c_InflateDistanceBits[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    struct InflateBits
+    {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        size_t position = 0;
+        uint64_t buffer = 0;
+        uint32_t count = 0;
+        bool isOverflowed = false;
+
+        uint32_t Read(uint32_t bits)
+        {
+            while (count < bits)
+            {
+                if (position < size)
+                    buffer |= uint64_t(data[position]) << count;
+                else
+                    isOverflowed = true;
+                position++;
+                count += 8;
+            }
+
+            uint32_t value = uint32_t(buffer & ((uint64_t(1) << bits) - 1));
+            buffer >>= bits;
+            count -= bits;
+            return value;
+        }
+
+        void AlignToByte()
+        {
+            buffer >>= count % 8;
+            count -= count % 8;
+        }
+    };
+
+    // canonical code, counts of each length and the symbols ordered by code
+    struct InflateHuffman
+    {
+        uint16_t counts[c_InflateMaxBits + 1];
+        uint16_t symbols[288];
+    };
+
+    static bool BuildInflateHuffman(InflateHuffman& huffman, const uint8_t* lengths, uint32_t count)
+    {
+        std::memset(huffman.counts, 0, sizeof(huffman.counts));
+        for (uint32_t i = 0; i < count; i++)
+            huffman.counts[lengths[i]]++;
+
+        // over subscribed sets are invalid, incomplete ones are allowed for single distance codes
+        int32_t left = 1;
+        for (uint32_t length = 1; length <= c_InflateMaxBits; length++)
+        {
+            left = (left << 1) - huffman.counts[length];
+            if (left < 0)
+                return false;
+        }
+
+        uint16_t offsets[c_InflateMaxBits + 1] = {};
+        for (uint32_t length = 1; length < c_InflateMaxBits; length++)
+            offsets[length + 1] = offsets[length] + huffman.counts[length];
+
+        for (uint32_t i = 0; i < count; i++)
+            if (lengths[i] != 0)
+                huffman.symbols[offsets[lengths[i]]++] = uint16_t(i);
+
+        return true;
+    }
+
+    // codes are stored most significant bit first, one bit at a time
+    static int32_t DecodeInflateSymbol(InflateBits& bits, const InflateHuffman& huffman)
+    {
+        int32_t code = 0, first = 0, index = 0;
+        for (uint32_t length = 1; length <= c_InflateMaxBits; length++)
+        {
+            code |= int32_t(bits.Read(1));
+            int32_t count = huffman.counts[length];
+            if (code - count < first)
+                return huffman.symbols[index + (code - first)];
+
+            index += count;
+            first = (first + count) << 1;
+            code <<= 1;
+        }
+
+        return -1;
+    }
+
+    static bool InflateCodes(InflateBits& bits, const InflateHuffman& lengthCodes, const InflateHuffman& distanceCodes, std::vector<uint8_t>& output, size_t streamStart)
+    {
+        for (;;)
+        {
+            int32_t symbol = DecodeInflateSymbol(bits, lengthCodes);
+            if (symbol < 0 || bits.isOverflowed)
+                return false;
+
+            if (symbol < 256)
+            {
+                output.push_back(uint8_t(symbol));
+                continue;
+            }
+
+            if (symbol == 256)
+                return true;
+
+            symbol -= 257;
+            if (symbol >= 29)
+                return false;
+            const uint32_t length = c_InflateLengthBase[symbol] + bits.Read(c_InflateLengthBits[symbol]);
+
+            int32_t distanceSymbol = DecodeInflateSymbol(bits, distanceCodes);
+            if (distanceSymbol < 0 || distanceSymbol >= 30)
+                return false;
+            const uint32_t distance = c_InflateDistanceBase[distanceSymbol] + bits.Read(c_InflateDistanceBits[distanceSymbol]);
+
+            const size_t position = output.size();
+            if (distance > position - streamStart)
+                return false;
+
+            output.resize(position + length);
+            uint8_t* dst = output.data() + position;
+            for (uint32_t i = 0; i < length; i++)
+                dst[i] = dst[int64_t(i) - distance];
+        }
+    }
+
+    static bool ReadDynamicCodes(InflateBits& bits, InflateHuffman& lengthCodes, InflateHuffman& distanceCodes)
+    {
+        const uint32_t lengthCount = bits.Read(5) + 257;
+        const uint32_t distanceCount = bits.Read(5) + 1;
+        const uint32_t codeLengthCount = bits.Read(4) + 4;
+        if (lengthCount > 286 || distanceCount > 30)
+            return false;
+
+        uint8_t lengths[320] = {};
+        for (uint32_t i = 0; i < codeLengthCount; i++)
+            lengths[c_InflateCodeLengthOrder[i]] = uint8_t(bits.Read(3));
+
+        InflateHuffman codeLengthCodes;
+        if (!BuildInflateHuffman(codeLengthCodes, lengths, 19))
+            return false;
+
+        // 16 repeats the previous length, 17 and 18 are runs of zeros
+        uint32_t index = 0;
+        while (index < lengthCount + distanceCount)
+        {
+            int32_t symbol = DecodeInflateSymbol(bits, codeLengthCodes);
+            if (symbol < 0 || bits.isOverflowed)
+                return false;
+
+            if (symbol < 16)
+            {
+                lengths[index++] = uint8_t(symbol);
+                continue;
+            }
+
+            uint8_t value = 0;
+            uint32_t repeat = 0;
+            if (symbol == 16)
+            {
+                if (index == 0)
+                    return false;
+                value = lengths[index - 1];
+                repeat = 3 + bits.Read(2);
+            }
+            else
+            {
+                repeat = symbol == 17 ? 3 + bits.Read(3) : 11 + bits.Read(7);
+            }
+
+            if (index + repeat > lengthCount + distanceCount)
+                return false;
+            while (repeat--)
+                lengths[index++] = value;
+        }
+
+        if (lengths[256] == 0)
+            return false;
+
+        return BuildInflateHuffman(lengthCodes, lengths, lengthCount) && BuildInflateHuffman(distanceCodes, lengths + lengthCount, distanceCount);
+    }
+
+    static uint32_t Adler32(const uint8_t* data, size_t size)
+    {
+        uint32_t a = 1, b = 0;
+        while (size)
+        {
+            // largest run before the sums can overflow
+            size_t run = std::min<size_t>(size, 5552);
+            for (size_t i = 0; i < run; i++)
+            {
+                a += data[i];
+                b += a;
+            }
+
+            a %= 65521;
+            b %= 65521;
+            data += run;
+            size -= run;
+        }
+
+        return (b << 16) | a;
+    }
+
+    bool DecodeZlib(std::span<const uint8_t> input, std::vector<uint8_t>& output)
+    {
+        if (input.size() < 6)
+            return false;
+
+        const uint32_t cmf = input[0], flags = input[1];
+        if ((cmf & 15) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flags) % 31 != 0 || (flags & 0x20))
+            return false;
+
+        InflateBits bits{ input.data() + 2, input.size() - 2 };
+        const size_t streamStart = output.size();
+
+        bool last = false;
+        while (!last)
+        {
+            last = bits.Read(1);
+            const uint32_t type = bits.Read(2);
+
+            if (type == 0)
+            {
+                bits.AlignToByte();
+                const uint32_t length = bits.Read(16);
+                const uint32_t inverse = bits.Read(16);
+                if (length != (~inverse & 0xFFFF) || bits.count != 0 || bits.position + length > bits.size)
+                    return false;
+
+                output.insert(output.end(), bits.data + bits.position, bits.data + bits.position + length);
+                bits.position += length;
+            }
+            else if (type == 1)
+            {
+                static const auto fixedCodes = [] {
+                    std::pair<InflateHuffman, InflateHuffman> codes;
+                    uint8_t lengths[288];
+                    std::fill_n(lengths, 144, uint8_t(8));
+                    std::fill_n(lengths + 144, 112, uint8_t(9));
+                    std::fill_n(lengths + 256, 24, uint8_t(7));
+                    std::fill_n(lengths + 280, 8, uint8_t(8));
+                    BuildInflateHuffman(codes.first, lengths, 288);
+                    std::fill_n(lengths, 30, uint8_t(5));
+                    BuildInflateHuffman(codes.second, lengths, 30);
+                    return codes;
+                }();
+
+                if (!InflateCodes(bits, fixedCodes.first, fixedCodes.second, output, streamStart))
+                    return false;
+            }
+            else if (type == 2)
+            {
+                InflateHuffman lengthCodes, distanceCodes;
+                if (!ReadDynamicCodes(bits, lengthCodes, distanceCodes) || !InflateCodes(bits, lengthCodes, distanceCodes, output, streamStart))
+                    return false;
+            }
+            else
+            {
+                return false;
+            }
+
+            if (bits.isOverflowed)
+                return false;
+        }
+
+        // the big endian Adler-32 of the decoded data follows the last block
+        bits.AlignToByte();
+        uint32_t checksum = 0;
+        for (int i = 0; i < 4; i++)
+            checksum = (checksum << 8) | bits.Read(8);
+
+        return !bits.isOverflowed && checksum == Adler32(output.data() + streamStart, output.size() - streamStart);
+    }
+}
@@ -0,0 +1,721 @@
+#include "HydraEngine/Base.h"
+
+import Assets;
+import HE;
+import std;
+
+namespace Assets {
+
+    // Zstandard frames (RFC 8878) without dictionaries, the optional content checksum is skipped
+
+    constexpr uint32_t c_ZstdMagic = 0xFD2FB528;
+    constexpr uint32_t c_ZstdSkippableMagic = 0x184D2A50; // low 4 bits are free
+    constexpr uint32_t c_ZstdMaxBlockSize = 128 << 10;
+    constexpr uint32_t c_ZstdMaxHuffmanBits = 11;
+    constexpr uint32_t c_ZstdMaxFseLog = 9;
+
+    constexpr uint32_t c_ZstdLiteralLengthBase[36] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 18, 20, 22, 24, 28, 32, 40, 48, 64, 128, 256, 512, 1024, 2048, 4096, 8192, 16384, 32768, 65536 };
+    constexpr uint8_t c_ZstdLiteralLengthBits[36] = { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 3, 3, 4, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+    constexpr uint32_t c_ZstdMatchLengthBase[53] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, 33, 34,
+        35, 37, 39, 41, 43, 47, 51, 59, 67, 83, 99, 131, 259, 515, 1027, 2051, 4099, 8195, 16387, 32771, 65539 };
+    constexpr uint8_t c_ZstdMatchLengthBits[53] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        1, 1, 1, 1, 2, 2, 3, 3, 4, 4, 5, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16 };
+
+    // default distributions of the sequence codes, -1 is a "less than one" probability
+    constexpr int16_t c_ZstdLiteralLengthDefault[36] = { 4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1, -1, -1, -1, -1 };
+    constexpr int16_t c_ZstdMatchLengthDefault[53] = {
+        1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+        1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1 };
+    constexpr int16_t c_ZstdOffsetDefault[29] = { 1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1 };
+
+    static uint64_t ReadLittleEndian(const uint8_t* p, uint32_t bytes)
+    {
+        uint64_t value = 0;
+        for (uint32_t i = 0; i < bytes; i++)
+            value |= uint64_t(p[i]) << (i * 8);
+
+        return value;
+    }
+
+    static uint32_t HighBit(uint32_t value)
+    {
+        return 31 - std::countl_zero(value);
+    }
+
+#pragma region Bit Streams
+
+    // least significant bit first, used by the FSE table descriptions
+    struct ZstdForwardBits
+    {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        size_t bit = 0;
+
+        uint32_t Read(uint32_t count)
+        {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < count; i++, bit++)
+            {
+                if ((bit >> 3) < size)
+                    value |= uint32_t((data[bit >> 3] >> (bit & 7)) & 1) << i;
+            }
+
+            return value;
+        }
+
+        bool IsOverflowed() const { return bit > size * 8; }
+    };
+
+    // read from the end, the highest set bit of the last byte marks the start. Bits past the beginning read as zero,
+    // decoders check the position is exactly 0 once done
+    struct ZstdBackwardBits
+    {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        int64_t bit = 0;
+
+        bool Init(const uint8_t* p, size_t bytes)
+        {
+            if (bytes == 0 || p[bytes - 1] == 0)
+                return false;
+
+            data = p;
+            size = bytes;
+            bit = int64_t(bytes - 1) * 8 + HighBit(p[bytes - 1]);
+            return true;
+        }
+
+        // bits [position, position + count) as written, count is at most 56
+        uint64_t Gather(int64_t position, uint32_t count) const
+        {
+            if (count == 0)
+                return 0;
+
+            if (position < 0)
+            {
+                uint32_t shift = uint32_t(std::min<int64_t>(-position, count));
+                return shift == count ? 0 : Gather(0, count - shift) << shift;
+            }
+
+            size_t byte = size_t(position >> 3);
+            uint64_t word = 0;
+            if (byte + 8 <= size)
+                std::memcpy(&word, data + byte, 8);
+            else
+                word = ReadLittleEndian(data + byte, uint32_t(size - byte));
+
+            return (word >> (position & 7)) & ((uint64_t(1) << count) - 1);
+        }
+
+        uint64_t Peek(uint32_t count) const { return Gather(bit - count, count); }
+        void Skip(uint32_t count) { bit -= count; }
+        uint64_t Read(uint32_t count) { bit -= count; return Gather(bit, count); }
+    };
+
+#pragma endregion
+
+#pragma region FSE
+
+    struct ZstdFseEntry
+    {
+        uint16_t baseState;
+        uint8_t symbol;
+        uint8_t bits;
+    };
+
+    struct ZstdFseTable
+    {
+        uint32_t log = 0;
+        bool isValid = false;
+        std::array<ZstdFseEntry, 1 << c_ZstdMaxFseLog> entries;
+    };
+
+    static bool BuildFseTable(const int16_t* distribution, uint32_t symbolCount, uint32_t log, ZstdFseTable& table)
+    {
+        const uint32_t size = 1u << log;
+        uint32_t highThreshold = size - 1;
+        uint16_t next[256];
+
+        for (uint32_t s = 0; s < symbolCount; s++)
+        {
+            if (distribution[s] == -1)
+            {
+                table.entries[highThreshold--].symbol = uint8_t(s);
+                next[s] = 1;
+            }
+            else
+            {
+                next[s] = uint16_t(distribution[s]);
+            }
+        }
+
+        const uint32_t step = (size >> 1) + (size >> 3) + 3;
+        uint32_t position = 0;
+        for (uint32_t s = 0; s < symbolCount; s++)
+        {
+            for (int32_t i = 0; i < distribution[s]; i++)
+            {
+                table.entries[position].symbol = uint8_t(s);
+                do
+                {
+                    position = (position + step) & (size - 1);
+                } while (position > highThreshold);
+            }
+        }
+
+        if (position != 0)
+            return false;
+
+        for (uint32_t u = 0; u < size; u++)
+        {
+            ZstdFseEntry& e = table.entries[u];
+            uint32_t state = next[e.symbol]++;
+            e.bits = uint8_t(log - HighBit(state));
+            e.baseState = uint16_t((state << e.bits) - size);
+        }
+
+        table.log = log;
+        table.isValid = true;
+        return true;
+    }
+
+    // normalized counts followed by the table, returns the bytes consumed or 0
+    static size_t ReadFseTable(const uint8_t* p, size_t size, uint32_t maxLog, uint32_t maxSymbol, ZstdFseTable& table)
+    {
+        ZstdForwardBits bits{ p, size };
+        const uint32_t log = bits.Read(4) + 5;
+        if (log > maxLog)
+            return 0;
+
+        int16_t distribution[256] = {};
+        int32_t remaining = (1 << log) + 1;
+        int32_t threshold = 1 << log;
+        uint32_t bitCount = log + 1;
+        uint32_t symbol = 0;
+
+        while (remaining > 1 && symbol <= maxSymbol)
+        {
+            const int32_t max = (2 * threshold - 1) - remaining;
+            int32_t count = int32_t(bits.Read(bitCount - 1));
+            if (count >= max)
+            {
+                count |= int32_t(bits.Read(1)) << (bitCount - 1);
+                if (count >= threshold)
+                    count -= max;
+            }
+
+            count--;
+            remaining -= std::abs(count);
+            distribution[symbol++] = int16_t(count);
+
+            // zero probabilities are followed by 2 bit repeat flags
+            if (count == 0)
+            {
+                uint32_t repeat;
+                do
+                {
+                    repeat = bits.Read(2);
+                    for (uint32_t r = 0; r < repeat; r++)
+                    {
+                        if (symbol > maxSymbol)
+                            return 0;
+                        distribution[symbol++] = 0;
+                    }
+                } while (repeat == 3);
+            }
+
+            while (remaining < threshold)
+            {
+                bitCount--;
+                threshold >>= 1;
+            }
+        }
+
+        if (remaining != 1 || bits.IsOverflowed() || !BuildFseTable(distribution, symbol, log, table))
+            return 0;
+
+        return (bits.bit + 7) / 8;
+    }
+
+#pragma endregion
+
+#pragma region Literals
+
+    struct ZstdHuffmanEntry
+    {
+        uint8_t symbol;
+        uint8_t bits;
+    };
+
+    struct ZstdHuffmanTable
+    {
+        uint32_t maxBits = 0;
+        bool isValid = false;
+        std::array<ZstdHuffmanEntry, 1 << c_ZstdMaxHuffmanBits> entries;
+    };
+
+    struct ZstdFrame
+    {
+        ZstdHuffmanTable huffman;
+        ZstdFseTable literalLengths;
+        ZstdFseTable offsets;
+        ZstdFseTable matchLengths;
+        uint32_t repeatOffsets[3] = { 1, 4, 8 };
+        std::vector<uint8_t> literals;
+    };
+
+    // weights are either 4 bit direct values or FSE compressed, the last one is implied by the total
+    static bool ReadHuffmanTable(const uint8_t*& p, const uint8_t* end, ZstdHuffmanTable& table)
+    {
+        if (p >= end)
+            return false;
+
+        const uint32_t header = *p++;
+        uint8_t weights[258] = {};
+        uint32_t count = 0;
+
+        if (header >= 128)
+        {
+            count = header - 127;
+            const size_t bytes = (count + 1) / 2;
+            if (size_t(end - p) < bytes)
+                return false;
+
+            for (uint32_t i = 0; i < count; i++)
+                weights[i] = i % 2 == 0 ? p[i / 2] >> 4 : p[i / 2] & 15;
+            p += bytes;
+        }
+        else
+        {
+            if (size_t(end - p) < header)
+                return false;
+
+            ZstdFseTable fse;
+            size_t consumed = ReadFseTable(p, header, 6, 255, fse);
+            ZstdBackwardBits bits;
+            if (consumed == 0 || consumed >= header || !bits.Init(p + consumed, header - consumed))
+                return false;
+
+            // two interleaved states, the stream ends when an update reads past its start
+            uint32_t state1 = uint32_t(bits.Read(fse.log));
+            uint32_t state2 = uint32_t(bits.Read(fse.log));
+            auto decode = [&](uint32_t& state) {
+                const ZstdFseEntry& e = fse.entries[state];
+                weights[count++] = e.symbol;
+                state = e.baseState + uint32_t(bits.Read(e.bits));
+            };
+
+            while (count < 255)
+            {
+                decode(state1);
+                if (bits.bit < 0)
+                {
+                    weights[count++] = fse.entries[state2].symbol;
+                    break;
+                }
+
+                decode(state2);
+                if (bits.bit < 0)
+                {
+                    weights[count++] = fse.entries[state1].symbol;
+                    break;
+                }
+            }
+
+            if (bits.bit >= 0 || count > 255)
+                return false;
+
+            p += header;
+        }
+
+        uint32_t total = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (weights[i] > c_ZstdMaxHuffmanBits)
+                return false;
+            total += weights[i] ? 1u << (weights[i] - 1) : 0;
+        }
+
+        if (total == 0 || count >= 256)
+            return false;
+
+        const uint32_t maxBits = HighBit(total) + 1;
+        const uint32_t left = (1u << maxBits) - total;
+        if (maxBits > c_ZstdMaxHuffmanBits || (left & (left - 1)) != 0)
+            return false;
+        weights[count++] = uint8_t(HighBit(left) + 1);
+
+        // the longest codes (lowest weights) fill the table first, symbols in order within a weight
+        uint32_t rankStart[c_ZstdMaxHuffmanBits + 2] = {};
+        uint32_t position = 0;
+        for (uint32_t w = 1; w <= maxBits; w++)
+        {
+            rankStart[w] = position;
+            for (uint32_t s = 0; s < count; s++)
+                position += weights[s] == w ? (1u << w) >> 1 : 0;
+        }
+
+        for (uint32_t s = 0; s < count; s++)
+        {
+            const uint32_t w = weights[s];
+            if (w == 0)
+                continue;
+
+            const uint32_t length = (1u << w) >> 1;
+            for (uint32_t i = 0; i < length; i++)
+                table.entries[rankStart[w] + i] = { uint8_t(s), uint8_t(maxBits + 1 - w) };
+            rankStart[w] += length;
+        }
+
+        table.maxBits = maxBits;
+        table.isValid = true;
+        return true;
+    }
+
+    static bool DecodeHuffmanStream(const uint8_t* p, size_t size, const ZstdHuffmanTable& table, uint8_t* out, size_t count)
+    {
+        ZstdBackwardBits bits;
+        if (!bits.Init(p, size))
+            return false;
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const ZstdHuffmanEntry& e = table.entries[bits.Peek(table.maxBits)];
+            out[i] = e.symbol;
+            bits.Skip(e.bits);
+        }
+
+        return bits.bit == 0;
+    }
+
+    static bool DecodeLiterals(const uint8_t*& p, const uint8_t* end, ZstdFrame& frame)
+    {
+        if (p >= end)
+            return false;
+
+        const uint32_t type = p[0] & 3;
+        const uint32_t sizeFormat = (p[0] >> 2) & 3;
+
+        // raw and RLE
+        if (type <= 1)
+        {
+            const uint32_t headerSize = sizeFormat == 1 ? 2 : sizeFormat == 3 ? 3 : 1;
+            if (size_t(end - p) < headerSize)
+                return false;
+
+            size_t regenerated = headerSize == 1 ? p[0] >> 3 : (p[0] >> 4) + (p[1] << 4) + (headerSize == 3 ? p[2] << 12 : 0);
+            p += headerSize;
+
+            const size_t stored = type == 0 ? regenerated : 1;
+            if (size_t(end - p) < stored)
+                return false;
+
+            if (type == 0)
+                frame.literals.assign(p, p + regenerated);
+            else
+                frame.literals.assign(regenerated, *p);
+
+            p += stored;
+            return true;
+        }
+
+        // Huffman, type 3 reuses the previous table
+        const uint32_t headerSize = sizeFormat <= 1 ? 3 : sizeFormat + 2;
+        const uint32_t sizeBits = sizeFormat <= 1 ? 10 : sizeFormat == 2 ? 14 : 18;
+        const uint32_t streams = sizeFormat == 0 ? 1 : 4;
+        if (size_t(end - p) < headerSize)
+            return false;
+
+        const uint64_t header = ReadLittleEndian(p, headerSize);
+        const size_t regenerated = size_t((header >> 4) & ((1u << sizeBits) - 1));
+        const size_t compressed = size_t((header >> (4 + sizeBits)) & ((1u << sizeBits) - 1));
+        p += headerSize;
+        if (size_t(end - p) < compressed)
+            return false;
+
+        const uint8_t* q = p;
+        const uint8_t* qEnd = p + compressed;
+        p = qEnd;
+
+        if (type == 2 && !ReadHuffmanTable(q, qEnd, frame.huffman))
+            return false;
+        if (!frame.huffman.isValid)
+            return false;
+
+        frame.literals.resize(regenerated);
+        if (streams == 1)
+            return DecodeHuffmanStream(q, size_t(qEnd - q), frame.huffman, frame.literals.data(), regenerated);
+
+        if (qEnd - q < 6)
+            return false;
+
+        size_t sizes[4] = { size_t(ReadLittleEndian(q, 2)), size_t(ReadLittleEndian(q + 2, 2)), size_t(ReadLittleEndian(q + 4, 2)), 0 };
+        q += 6;
+        const size_t total = size_t(qEnd - q);
+        if (sizes[0] + sizes[1] + sizes[2] > total)
+            return false;
+        sizes[3] = total - sizes[0] - sizes[1] - sizes[2];
+
+        const size_t segment = (regenerated + 3) / 4;
+        if (segment * 3 > regenerated)
+            return false;
+
+        uint8_t* out = frame.literals.data();
+        for (int i = 0; i < 4; i++)
+        {
+            const size_t count = i < 3 ? segment : regenerated - segment * 3;
+            if (!DecodeHuffmanStream(q, sizes[i], frame.huffman, out, count))
+                return false;
+            q += sizes[i];
+            out += count;
+        }
+
+        return true;
+    }
+
+#pragma endregion
+
+#pragma region Sequences
+
+    static bool ReadSequenceTable(const uint8_t*& p, const uint8_t* end, uint32_t mode, std::span<const int16_t> defaultDistribution, uint32_t defaultLog, uint32_t maxLog, uint32_t maxSymbol, ZstdFseTable& table)
+    {
+        switch (mode)
+        {
+        case 0: return BuildFseTable(defaultDistribution.data(), (uint32_t)defaultDistribution.size(), defaultLog, table);
+        case 1:
+        {
+            if (p >= end || *p > maxSymbol)
+                return false;
+
+            table.entries[0] = { 0, *p++, 0 };
+            table.log = 0;
+            table.isValid = true;
+            return true;
+        }
+        case 2:
+        {
+            size_t consumed = ReadFseTable(p, size_t(end - p), maxLog, maxSymbol, table);
+            p += consumed;
+            return consumed != 0;
+        }
+        default: return table.isValid;
+        }
+    }
+
+    static bool DecodeBlock(const uint8_t* p, size_t size, ZstdFrame& frame, std::vector<uint8_t>& output, size_t frameStart)
+    {
+        const uint8_t* end = p + size;
+        if (!DecodeLiterals(p, end, frame) || p >= end)
+            return false;
+
+        uint32_t sequenceCount = *p++;
+        if (sequenceCount >= 128)
+        {
+            if (sequenceCount < 255)
+            {
+                if (p >= end)
+                    return false;
+                sequenceCount = ((sequenceCount - 128) << 8) + *p++;
+            }
+            else
+            {
+                if (end - p < 2)
+                    return false;
+                sequenceCount = p[0] + (p[1] << 8) + 0x7F00;
+                p += 2;
+            }
+        }
+
+        if (sequenceCount == 0)
+        {
+            output.insert(output.end(), frame.literals.begin(), frame.literals.end());
+            return p == end;
+        }
+
+        if (p >= end || (*p & 3) != 0)
+            return false;
+
+        const uint32_t modes = *p++;
+        if (!ReadSequenceTable(p, end, modes >> 6, c_ZstdLiteralLengthDefault, 6, 9, 35, frame.literalLengths) ||
+            !ReadSequenceTable(p, end, (modes >> 4) & 3, c_ZstdOffsetDefault, 5, 8, 31, frame.offsets) ||
+            !ReadSequenceTable(p, end, (modes >> 2) & 3, c_ZstdMatchLengthDefault, 6, 9, 52, frame.matchLengths))
+            return false;
+
+        ZstdBackwardBits bits;
+        if (!bits.Init(p, size_t(end - p)))
+            return false;
+
+        uint32_t literalLengthState = uint32_t(bits.Read(frame.literalLengths.log));
+        uint32_t offsetState = uint32_t(bits.Read(frame.offsets.log));
+        uint32_t matchLengthState = uint32_t(bits.Read(frame.matchLengths.log));
+
+        const uint8_t* literals = frame.literals.data();
+        const uint8_t* literalsEnd = literals + frame.literals.size();
+        uint32_t* repeat = frame.repeatOffsets;
+
+        for (uint32_t s = 0; s < sequenceCount; s++)
+        {
+            const ZstdFseEntry& ll = frame.literalLengths.entries[literalLengthState];
+            const ZstdFseEntry& of = frame.offsets.entries[offsetState];
+            const ZstdFseEntry& ml = frame.matchLengths.entries[matchLengthState];
+            if (of.symbol > 31)
+                return false;
+
+            const uint32_t offsetValue = uint32_t((uint64_t(1) << of.symbol) + bits.Read(of.symbol));
+            const uint32_t matchLength = c_ZstdMatchLengthBase[ml.symbol] + uint32_t(bits.Read(c_ZstdMatchLengthBits[ml.symbol]));
+            const uint32_t literalLength = c_ZstdLiteralLengthBase[ll.symbol] + uint32_t(bits.Read(c_ZstdLiteralLengthBits[ll.symbol]));
+
+            // values 1 to 3 pick a repeated offset, shifted by one when there are no literals
+            uint32_t offset;
+            if (offsetValue > 3)
+            {
+                offset = offsetValue - 3;
+                repeat[2] = repeat[1];
+                repeat[1] = repeat[0];
+                repeat[0] = offset;
+            }
+            else
+            {
+                const uint32_t index = offsetValue - 1 + (literalLength == 0 ? 1 : 0);
+                offset = index == 0 ? repeat[0] : index < 3 ? repeat[index] : repeat[0] - 1;
+                if (index > 0)
+                {
+                    if (index > 1)
+                        repeat[2] = repeat[1];
+                    repeat[1] = repeat[0];
+                    repeat[0] = offset;
+                }
+            }
+
+            if (size_t(literalsEnd - literals) < literalLength)
+                return false;
+            output.insert(output.end(), literals, literals + literalLength);
+            literals += literalLength;
+
+            const size_t position = output.size();
+            if (offset == 0 || offset > position - frameStart)
+                return false;
+
+            output.resize(position + matchLength);
+            uint8_t* dst = output.data() + position;
+            const uint8_t* src = dst - offset;
+            if (offset >= matchLength)
+                std::memcpy(dst, src, matchLength);
+            else
+                for (uint32_t i = 0; i < matchLength; i++)
+                    dst[i] = src[i];
+
+            if (s + 1 < sequenceCount)
+            {
+                literalLengthState = ll.baseState + uint32_t(bits.Read(ll.bits));
+                matchLengthState = ml.baseState + uint32_t(bits.Read(ml.bits));
+                offsetState = of.baseState + uint32_t(bits.Read(of.bits));
+            }
+        }
+
+        if (bits.bit != 0)
+            return false;
+
+        output.insert(output.end(), literals, literalsEnd);
+        return true;
+    }
+
+#pragma endregion
+
+    bool DecodeZstd(std::span<const uint8_t> input, std::vector<uint8_t>& output)
+    {
+        const uint8_t* p = input.data();
+        const uint8_t* end = p + input.size();
+
+        auto frame = std::make_unique<ZstdFrame>();
+        while (p < end)
+        {
+            if (end - p < 4)
+                return false;
+
+            const uint32_t magic = uint32_t(ReadLittleEndian(p, 4));
+            if ((magic & 0xFFFFFFF0) == c_ZstdSkippableMagic)
+            {
+                if (end - p < 8 || ReadLittleEndian(p + 4, 4) > uint64_t(end - p - 8))
+                    return false;
+                p += 8 + ReadLittleEndian(p + 4, 4);
+                continue;
+            }
+
+            if (magic != c_ZstdMagic || end - p < 5)
+                return false;
+            p += 4;
+
+            const uint32_t descriptor = *p++;
+            const uint32_t contentSizeFlag = descriptor >> 6;
+            const bool singleSegment = (descriptor >> 5) & 1;
+            const bool hasChecksum = (descriptor >> 2) & 1;
+            const uint32_t dictionaryBytes = (descriptor & 3) == 3 ? 4 : descriptor & 3;
+            const uint32_t contentSizeBytes = contentSizeFlag == 0 ? (singleSegment ? 1 : 0) : 1u << contentSizeFlag;
+            if (descriptor & 0x08)
+                return false;
+
+            const size_t headerBytes = (singleSegment ? 0 : 1) + dictionaryBytes + contentSizeBytes;
+            if (size_t(end - p) < headerBytes)
+                return false;
+            p += singleSegment ? 0 : 1;
+
+            if (dictionaryBytes && ReadLittleEndian(p, dictionaryBytes) != 0)
+                return false;
+            p += dictionaryBytes;
+
+            uint64_t contentSize = 0;
+            if (contentSizeBytes)
+            {
+                contentSize = ReadLittleEndian(p, contentSizeBytes) + (contentSizeBytes == 2 ? 256 : 0);
+                output.reserve(output.size() + size_t(std::min<uint64_t>(contentSize, uint64_t(input.size()) * 1024)));
+            }
+            p += contentSizeBytes;
+
+            const size_t frameStart = output.size();
+            frame->huffman.isValid = false;
+            frame->literalLengths.isValid = frame->offsets.isValid = frame->matchLengths.isValid = false;
+            frame->repeatOffsets[0] = 1; frame->repeatOffsets[1] = 4; frame->repeatOffsets[2] = 8;
+
+            bool last = false;
+            while (!last)
+            {
+                if (end - p < 3)
+                    return false;
+
+                const uint32_t header = uint32_t(ReadLittleEndian(p, 3));
+                const uint32_t type = (header >> 1) & 3;
+                const uint32_t size = header >> 3;
+                last = header & 1;
+                p += 3;
+
+                const size_t stored = type == 1 ? 1 : size;
+                if (type == 3 || size > c_ZstdMaxBlockSize || size_t(end - p) < stored)
+                    return false;
+
+                if (type == 0)
+                    output.insert(output.end(), p, p + size);
+                else if (type == 1)
+                    output.insert(output.end(), size, *p);
+                else if (!DecodeBlock(p, size, *frame, output, frameStart))
+                    return false;
+
+                p += stored;
+            }
+
+            if (hasChecksum)
+            {
+                if (end - p < 4)
+                    return false;
+                p += 4;
+            }
+
+            if (contentSizeBytes && output.size() - frameStart != contentSize)
+                return false;
+        }
+
+        return true;
+    }
+}